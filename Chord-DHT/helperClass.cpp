@@ -108,6 +108,22 @@ vector< pair<lli,string> > Helper::seperateKeysAndValues(string keysAndValues){
     return res;
 }
 
+/* arrange keys and values in form of key1:val1;key2:val2 */
+string Helper::joinKeysAndValues(const vector< pair<lli,string> > &keysAndValues){
+    string res;
+
+    for(size_t i=0;i<keysAndValues.size();i++){
+        if(0 < i) {
+            res += ';';
+        }
+        res += to_string(keysAndValues[i].first);
+        res += ':';
+        res += keysAndValues[i].second;
+    }
+
+    return res;
+}
+
 /* string is in form of ip:port;ip:port;... will seperate all these ip's and ports */
 vector< string > Helper::seperateSuccessorList(string succList){
     int size = succList.size();
@@ -13,6 +13,7 @@ class Helper {
 public:
 		static vector<string> splitCommand(string command);
 		static vector< pair<lli,string> > seperateKeysAndValues(string keysAndValues);
+		static string joinKeysAndValues(const vector< pair<lli,string> > &keysAndValues);
 		static vector< string > seperateSuccessorList(string succList);
 		static string splitSuccessorList(vector<pair<string, lli>> list);
 		
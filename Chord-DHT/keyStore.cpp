@@ -0,0 +1,253 @@
+#include "keyStore.hpp"
+
+#include <algorithm>
+
+namespace {
+
+struct EntryKeyLess {
+	template<typename Entry>
+	bool operator()(const Entry &entry, lli key) const {
+		return entry.key < key;
+	}
+	template<typename Entry>
+	bool operator()(lli key, const Entry &entry) const {
+		return key < entry.key;
+	}
+};
+
+}
+
+KeyStore::KeyStore()
+	: m_size(0)
+{
+}
+
+uint32_t KeyStore::acquireValue(const string &value){
+	unordered_map< string, uint32_t >::iterator it = m_valueIds.find(value);
+	if(it != m_valueIds.end()) {
+		m_valueRefs[it->second]++;
+		return it->second;
+	}
+
+	uint32_t id;
+	if(m_freeValues.empty() == false) {
+		id = m_freeValues.back();
+		m_freeValues.pop_back();
+		m_values[id] = value;
+		m_valueRefs[id] = 1;
+	} else {
+		id = m_values.size();
+		m_values.push_back(value);
+		m_valueRefs.push_back(1);
+	}
+	m_valueIds[value] = id;
+
+	return id;
+}
+
+void KeyStore::releaseValue(uint32_t id){
+	if(--m_valueRefs[id] > 0) {
+		return;
+	}
+
+	m_valueIds.erase(m_values[id]);
+	string().swap(m_values[id]);
+	m_freeValues.push_back(id);
+}
+
+/* the block whose key range contains key (the first block for keys below every block) */
+size_t KeyStore::findBlock(lli key) const{
+	size_t index = std::upper_bound(m_firstKeys.begin(), m_firstKeys.end(), key) - m_firstKeys.begin();
+	return index == 0 ? 0 : index - 1;
+}
+
+void KeyStore::splitBlock(size_t index){
+	vector< Entry > &block = m_blocks[index];
+	size_t half = block.size() / 2;
+
+	vector< Entry > upper;
+	upper.reserve(BLOCK_SIZE);
+	upper.assign(block.begin() + half, block.end());
+	block.erase(block.begin() + half, block.end());
+
+	m_firstKeys.insert(m_firstKeys.begin() + index + 1, upper.front().key);
+	m_blocks.insert(m_blocks.begin() + index + 1, std::move(upper));
+}
+
+void KeyStore::removeBlock(size_t index){
+	m_blocks.erase(m_blocks.begin() + index);
+	m_firstKeys.erase(m_firstKeys.begin() + index);
+}
+
+void KeyStore::insert(lli key, const string &value){
+	if(m_blocks.empty()) {
+		m_blocks.push_back(vector< Entry >());
+		m_blocks.back().reserve(BLOCK_SIZE);
+		m_firstKeys.push_back(key);
+	}
+
+	size_t index = findBlock(key);
+	vector< Entry > &block = m_blocks[index];
+	vector< Entry >::iterator it = std::lower_bound(block.begin(), block.end(), key, EntryKeyLess());
+	if(it != block.end() && it->key == key) {
+		uint32_t id = acquireValue(value);
+		releaseValue(it->value);
+		it->value = id;
+		return;
+	}
+
+	// split a full block before inserting so that blocks never grow past their reserved capacity
+	if(block.size() == BLOCK_SIZE) {
+		splitBlock(index);
+		index = findBlock(key);
+		it = std::lower_bound(m_blocks[index].begin(), m_blocks[index].end(), key, EntryKeyLess());
+	}
+
+	Entry entry = { key, acquireValue(value) };
+	m_blocks[index].insert(it, entry);
+	m_firstKeys[index] = m_blocks[index].front().key;
+	m_size++;
+}
+
+bool KeyStore::erase(lli key){
+	if(m_blocks.empty()) {
+		return false;
+	}
+
+	size_t index = findBlock(key);
+	vector< Entry > &block = m_blocks[index];
+	vector< Entry >::iterator it = std::lower_bound(block.begin(), block.end(), key, EntryKeyLess());
+	if(it == block.end() || it->key != key) {
+		return false;
+	}
+
+	releaseValue(it->value);
+	block.erase(it);
+	m_size--;
+
+	if(block.empty()) {
+		removeBlock(index);
+		return true;
+	}
+	m_firstKeys[index] = block.front().key;
+
+	// keep blocks at least a quarter full by merging with the next one
+	if(block.size() < BLOCK_SIZE / 4 && index + 1 < m_blocks.size() && block.size() + m_blocks[index + 1].size() <= BLOCK_SIZE) {
+		block.insert(block.end(), m_blocks[index + 1].begin(), m_blocks[index + 1].end());
+		removeBlock(index + 1);
+	}
+
+	return true;
+}
+
+const string *KeyStore::find(lli key) const{
+	if(m_blocks.empty()) {
+		return NULL;
+	}
+
+	const vector< Entry > &block = m_blocks[findBlock(key)];
+	vector< Entry >::const_iterator it = std::lower_bound(block.begin(), block.end(), key, EntryKeyLess());
+	if(it == block.end() || it->key != key) {
+		return NULL;
+	}
+
+	return &m_values[it->value];
+}
+
+size_t KeyStore::size() const{
+	return m_size;
+}
+
+void KeyStore::clear(){
+	vector< vector< Entry > >().swap(m_blocks);
+	vector< lli >().swap(m_firstKeys);
+	m_size = 0;
+
+	vector< string >().swap(m_values);
+	vector< uint32_t >().swap(m_valueRefs);
+	vector< uint32_t >().swap(m_freeValues);
+	m_valueIds.clear();
+}
+
+/*
+ * move at most maxCount keys of (from, to] into res, erasing them block by block.
+ * returns true when no key of the span is left.
+ */
+bool KeyStore::extractSpan(lli from, lli to, size_t maxCount, vector< pair<lli, string> > &res){
+	size_t count = 0;
+	size_t index = findBlock(from);
+
+	while(index < m_blocks.size() && m_firstKeys[index] <= to) {
+		vector< Entry > &block = m_blocks[index];
+		vector< Entry >::iterator first = std::upper_bound(block.begin(), block.end(), from, EntryKeyLess());
+		vector< Entry >::iterator last = std::upper_bound(first, block.end(), to, EntryKeyLess());
+		if((size_t)(last - first) > maxCount - count) {
+			last = first + (maxCount - count);
+		}
+
+		for(vector< Entry >::iterator it = first; it != last; it++) {
+			res.push_back(make_pair(it->key, m_values[it->value]));
+			releaseValue(it->value);
+		}
+		count += last - first;
+		m_size -= last - first;
+
+		bool isFull = last != block.end() && last->key <= to;
+		block.erase(first, last);
+
+		if(block.empty()) {
+			removeBlock(index);
+		} else {
+			m_firstKeys[index] = block.front().key;
+			index++;
+		}
+
+		if(isFull) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * move keys of the ring range (from, to] into res, at most maxCount of them.
+ * if from >= to the range wraps around and is split into (from, max] and [0, to].
+ * returns true when no key of the range is left in the store.
+ */
+bool KeyStore::extractRange(lli from, lli to, size_t maxCount, vector< pair<lli, string> > &res){
+	if(from < to) {
+		return extractSpan(from, to, maxCount, res);
+	}
+
+	size_t count = res.size();
+	if(extractSpan(from, INT64_MAX, maxCount, res) == false) {
+		return false;
+	}
+
+	return extractSpan(-1, to, maxCount - (res.size() - count), res);
+}
+
+size_t KeyStore::getMemoryUsage() const{
+	size_t bytes = sizeof(*this);
+
+	bytes += m_blocks.capacity() * sizeof(vector< Entry >);
+	for(const vector< Entry > &block : m_blocks) {
+		bytes += block.capacity() * sizeof(Entry);
+	}
+	bytes += m_firstKeys.capacity() * sizeof(lli);
+
+	bytes += m_values.capacity() * sizeof(string);
+	bytes += m_valueRefs.capacity() * sizeof(uint32_t);
+	bytes += m_freeValues.capacity() * sizeof(uint32_t);
+	for(const string &value : m_values) {
+		if(value.capacity() > 15) {
+			bytes += value.capacity() + 1;
+		}
+	}
+	// value index: one node (key string, id, next pointer, cached hash) per distinct value plus the buckets
+	bytes += m_valueIds.size() * (sizeof(string) + sizeof(uint32_t) + 2 * sizeof(void *));
+	bytes += m_valueIds.bucket_count() * sizeof(void *);
+
+	return bytes;
+}
@@ -0,0 +1,98 @@
+#ifndef keyStore_h
+#define keyStore_h
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+typedef long long int lli;
+
+/*
+ * key -> value store of a chord node.
+ *
+ * keys are kept in sorted blocks of up to BLOCK_SIZE 16 byte entries (a two level
+ * B+-tree: m_firstKeys is the inner node, m_blocks are the leaves), so lookups are
+ * two binary searches and range scans walk contiguous memory.
+ * values are interned - most of them are the same few RN names - and referenced
+ * by a 32 bit id.
+ */
+class KeyStore {
+
+private:
+		struct Entry {
+			lli key;
+			uint32_t value;
+		};
+
+		static const size_t BLOCK_SIZE = 512;
+
+		vector< vector< Entry > > m_blocks;
+		vector< lli > m_firstKeys;
+		size_t m_size;
+
+		vector< string > m_values;
+		vector< uint32_t > m_valueRefs;
+		vector< uint32_t > m_freeValues;
+		unordered_map< string, uint32_t > m_valueIds;
+
+		uint32_t acquireValue(const string &value);
+		void releaseValue(uint32_t id);
+
+		size_t findBlock(lli key) const;
+		void splitBlock(size_t index);
+		void removeBlock(size_t index);
+		bool extractSpan(lli from, lli to, size_t maxCount, vector< pair<lli, string> > &res);
+
+		template<typename Visitor>
+		void visitSpan(lli from, lli to, Visitor &visitor) const {
+			for(size_t i = findBlock(from); i < m_blocks.size() && m_firstKeys[i] <= to; i++) {
+				for(const Entry &entry : m_blocks[i]) {
+					if(entry.key > to) {
+						return;
+					}
+					if(entry.key > from) {
+						visitor(entry.key, m_values[entry.value]);
+					}
+				}
+			}
+		}
+
+	public:
+		KeyStore();
+
+		void insert(lli key, const string &value);
+		bool erase(lli key);
+		const string *find(lli key) const;
+		size_t size() const;
+		void clear();
+
+		bool extractRange(lli from, lli to, size_t maxCount, vector< pair<lli, string> > &res);
+
+		size_t getMemoryUsage() const;
+
+		/* visit all keys in ascending order */
+		template<typename Visitor>
+		void forEach(Visitor visitor) const {
+			for(const vector< Entry > &block : m_blocks) {
+				for(const Entry &entry : block) {
+					visitor(entry.key, m_values[entry.value]);
+				}
+			}
+		}
+
+		/* visit keys of the ring range (from, to] without removing them */
+		template<typename Visitor>
+		void forEachInRange(lli from, lli to, Visitor visitor) const {
+			if(from < to) {
+				visitSpan(from, to, visitor);
+				return;
+			}
+			visitSpan(from, INT64_MAX, visitor);
+			visitSpan(-1, to, visitor);
+		}
+};
+
+#endif
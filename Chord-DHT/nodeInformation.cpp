@@ -78,23 +78,17 @@ void NodeInformation::setFingerTable(int index, string nodeName,lli hash){
 }
 
 void NodeInformation::storeKey(lli key,string val){
-	m_dictionary[key] = val;
+	m_dictionary.insert(key, val);
 }
 
 void NodeInformation::removeKey(lli key){
-	map<lli, string>::iterator iter = m_dictionary.find(key);
-	if(iter == m_dictionary.end()) {
-		return;
-	}
-	m_dictionary.erase(iter);
+	m_dictionary.erase(key);
 }
 
 void NodeInformation::printKeys(){
-	map<lli,string>::iterator it;
-
-	for(it = m_dictionary.begin(); it != m_dictionary.end() ; it++){
-		cout<<it->first<<" "<<it->second<<endl;
-	}
+	m_dictionary.forEach([](lli key, const string &value) {
+		cout<<key<<" "<<value<<endl;
+	});
 }
 
 void NodeInformation::updateSuccessorList(vector< string > list){
@@ -116,44 +110,51 @@ void NodeInformation::updateSuccessorList(vector< string > list){
 
 /* send all keys of this node to it's successor after it leaves the ring */
 vector< pair<lli , string> > NodeInformation::getAllKeysForSuccessor(){
-	map<lli,string>::iterator it;
+	bool done;
+	return getAllKeysForSuccessor(m_dictionary.size(), done);
+}
+
+/* same as above, but moves at most maxCount keys so that the handoff can be streamed */
+vector< pair<lli , string> > NodeInformation::getAllKeysForSuccessor(size_t maxCount, bool &done){
 	vector< pair<lli , string> > res;
 
-	for(it = m_dictionary.begin(); it != m_dictionary.end() ; it++){
-		res.push_back(make_pair(it->first , it->second));
-		m_dictionary.erase(it);
-	}
+	/* (m_id, m_id] is the whole ring */
+	done = m_dictionary.extractRange(m_id, m_id, maxCount, res);
 
 	return res;
 }
 
 vector< pair<lli , string> > NodeInformation::getKeysForPredecessor(lli nodeId){
-	map<lli,string>::iterator it;
+	bool done;
+	return getKeysForPredecessor(nodeId, m_dictionary.size(), done);
+}
 
+/* keys in (m_id, nodeId] on the ring now belong to the joining predecessor */
+vector< pair<lli , string> > NodeInformation::getKeysForPredecessor(lli nodeId, size_t maxCount, bool &done){
 	vector< pair<lli , string> > res;
-	for(it = m_dictionary.begin(); it != m_dictionary.end() ; it++){
-		lli keyId = it->first;
-
-		/* if predecessor's id is more than current node's id */
-		if(m_id < nodeId){
-			if(keyId > m_id && keyId <= nodeId){
-				res.push_back(make_pair(keyId , it->second));
-				m_dictionary.erase(it);
-			}
-		}
 
-		/* if predecessor's id is less than current node's id */
-		else{
-			if(keyId <= nodeId || keyId > m_id){
-				res.push_back(make_pair(keyId , it->second));
-				m_dictionary.erase(it);
-			}
-		}
-	}
+	done = extractKeyRange(m_id, nodeId, maxCount, res);
 
 	return res;
 }
 
+/*
+ * move keys of the ring range (from, to] into res, at most maxCount of them.
+ * if from >= to the range wraps around 2^M and is split into (from, max] and [0, to].
+ * returns true when no key of the range is left in the dictionary.
+ */
+bool NodeInformation::extractKeyRange(lli from, lli to, size_t maxCount, vector< pair<lli , string> > &res){
+	return m_dictionary.extractRange(from, to, maxCount, res);
+}
+
+size_t NodeInformation::getKeyCount(){
+	return m_dictionary.size();
+}
+
+size_t NodeInformation::getKeyMemoryUsage(){
+	return m_dictionary.getMemoryUsage();
+}
+
 tuple<int, int> NodeInformation::findSuccessor(lli nodeId, pair<string, lli> &successor){
 
 //	pair < string, lli > self;
@@ -333,8 +334,9 @@ pair<string, lli > NodeInformation::getPredecessor(){
 }
 
 string NodeInformation::getValue(lli key){
-	if(m_dictionary.find(key) != m_dictionary.end()){
-		return m_dictionary[key];
+	const string *value = m_dictionary.find(key);
+	if(value != NULL){
+		return *value;
 	}
 	else
 		return "";
@@ -7,6 +7,7 @@
 #include <tuple>
 
 #include "M.h"
+#include "keyStore.hpp"
 
 using namespace std;
 
@@ -19,7 +20,7 @@ private:
 		pair< string, lli > m_predecessor;
 		pair< string, lli > m_successor;
 		vector< pair< string, lli > > m_fingerTable;
-		map<lli, string> m_dictionary;
+		KeyStore m_dictionary;
 		vector< pair< string, lli > > m_successorList;
 
 		bool m_isInRing;
@@ -47,7 +48,12 @@ private:
 		void storeKey(lli key, string val);
 		void removeKey(lli key);
 		vector< pair<lli, string> > getAllKeysForSuccessor();
+		vector< pair<lli, string> > getAllKeysForSuccessor(size_t maxCount, bool &done);
 		vector< pair<lli, string> > getKeysForPredecessor(lli nodeId);
+		vector< pair<lli, string> > getKeysForPredecessor(lli nodeId, size_t maxCount, bool &done);
+		bool extractKeyRange(lli from, lli to, size_t maxCount, vector< pair<lli, string> > &res);
+		size_t getKeyCount();
+		size_t getKeyMemoryUsage();
 
 		void setSuccessor(string nodeName, lli hash);
 		void setSuccessorList(string nodeName, lli hash);
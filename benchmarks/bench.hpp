@@ -0,0 +1,132 @@
+/*
+ * bench.hpp
+ *
+ * small helpers shared by the programs in benchmarks/
+ */
+
+#ifndef BENCHMARKS_BENCH_HPP_
+#define BENCHMARKS_BENCH_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <malloc.h>
+
+typedef long long int lli;
+
+class BenchTimer
+{
+public:
+	BenchTimer()
+		: m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	void
+	reset() {
+		m_start = std::chrono::steady_clock::now();
+	}
+
+	double
+	elapsedNs() const {
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+	double
+	elapsedMs() const {
+		return elapsedNs() / 1e6;
+	}
+
+private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+// key counts given on the command line, or the defaults
+static inline
+std::vector<size_t> benchSizes(int argc, char *argv[], std::vector<size_t> defaults) {
+	std::vector<size_t> sizes;
+	for(int i = 1; i < argc; i++) {
+		sizes.push_back(std::strtoull(argv[i], NULL, 10));
+	}
+
+	return sizes.empty() ? defaults : sizes;
+}
+
+// uniformly distributed ids in the M bit chord keyspace
+static inline
+std::vector<lli> benchKeys(size_t count, lli space, uint32_t seed = 1) {
+	std::mt19937_64 rng(seed);
+	std::uniform_int_distribution<lli> dist(0, space - 1);
+
+	std::vector<lli> keys(count);
+	for(size_t i = 0; i < count; i++) {
+		keys[i] = dist(rng);
+	}
+
+	return keys;
+}
+
+// bytes allocated from the heap
+static inline
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return mallinfo2().uordblks;
+#else
+	return mallinfo().uordblks;
+#endif
+}
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+// heap allocations through operator new, the program defines BENCH_COUNT_ALLOCATIONS before it includes bench.hpp.
+// replaces the global operator new/delete of the program, so only one translation unit may define it
+#include <atomic>
+#include <new>
+
+static std::atomic<uint64_t> s_benchAllocations(0);
+
+void *
+operator new(size_t size) {
+	s_benchAllocations.fetch_add(1, std::memory_order_relaxed);
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+
+	return p;
+}
+
+void *
+operator new[](size_t size) {
+	return operator new(size);
+}
+
+void
+operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void
+operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept {
+	std::free(p);
+}
+
+void
+operator delete[](void *p, size_t) noexcept {
+	std::free(p);
+}
+
+static inline
+uint64_t benchAllocations() {
+	return s_benchAllocations.load(std::memory_order_relaxed);
+}
+#endif
+
+#endif /* BENCHMARKS_BENCH_HPP_ */
@@ -0,0 +1,108 @@
+/*
+ * command-dispatch.cpp
+ *
+ * per packet cost of finding the command of a DRN name:
+ * toUri() of the component and a compare() chain (the previous dispatch) against parseCommand().
+ *
+ * usage: build/command-dispatch [packets ...]
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+#include "extensions/drn-protocol.hpp"
+
+#include "bench.hpp"
+
+static const char *s_names[] = {
+	"/RN-00012/TM/a/b/c",
+	"/RN-00012/TS/a/b/c",
+	"/RN-00012/PA/a/b/c",
+	"/RN-00012/DM/a/b/c/RN-00003",
+	"/RN-00012/DR/a/b/c/RN-00003",
+	"/RN-00012/stabilize/checkSuccessor/alive",
+	"/RN-00012/stabilize/updateSuccessorList/sendSuccList",
+	"/RN-00012/fixFingers/successor",
+	"/RN-00012/join/storeKeys",
+	"/RN-00012/unknown/a/b/c",
+};
+
+static int
+dispatchString(const ndn::Name &name) {
+	std::string cmd = name.get(1).toUri();
+
+	if (cmd.compare("PA") == 0) return 1;
+	else if (cmd.compare("PU") == 0) return 2;
+	else if (cmd.compare("DP") == 0) return 3;
+	else if (cmd.compare("TS") == 0) return 4;
+	else if (cmd.compare("TM") == 0) return 5;
+	else if (cmd.compare("DM") == 0) return 6;
+	else if (cmd.compare("DR") == 0) return 7;
+	else if (cmd.compare("join") == 0) return 8;
+	else if (cmd.compare("stabilize") == 0) return 9;
+	else if (cmd.compare("fixFingers") == 0) return 10;
+
+	return 0;
+}
+
+static int
+dispatchTable(const ndn::Name &name) {
+	switch (parseCommand(name, 1)) {
+	case CMD_PA: return 1;
+	case CMD_PU: return 2;
+	case CMD_DP: return 3;
+	case CMD_TS: return 4;
+	case CMD_TM: return 5;
+	case CMD_DM: return 6;
+	case CMD_DR: return 7;
+	case CMD_JOIN: return 8;
+	case CMD_STABILIZE: return 9;
+	case CMD_FIX_FINGERS: return 10;
+	default: return 0;
+	}
+}
+
+template<typename Dispatch>
+static double
+measure(const std::vector<ndn::Name> &names, size_t packets, Dispatch dispatch, uint64_t &checksum) {
+	BenchTimer timer;
+	for (size_t i = 0; i < packets; i++) {
+		checksum += dispatch(names[i % names.size()]);
+	}
+
+	return timer.elapsedNs() / packets;
+}
+
+int
+main(int argc, char *argv[]) {
+	std::vector<size_t> sizes = benchSizes(argc, argv, {1000000, 10000000});
+
+	std::vector<ndn::Name> names;
+	for (const char *uri : s_names) {
+		names.push_back(ndn::Name(uri));
+		// the wire encoding is cached by the first get(), as for a received Interest
+		names.back().wireEncode();
+	}
+
+	for (const ndn::Name &name : names) {
+		if (dispatchString(name) != dispatchTable(name)) {
+			fprintf(stderr, "dispatch mismatch: %s\n", name.toUri().c_str());
+			return 1;
+		}
+	}
+
+	printf("%12s %16s %16s %10s\n", "packets", "string(ns/pkt)", "table(ns/pkt)", "speedup");
+
+	for (size_t packets : sizes) {
+		uint64_t checksum = 0;
+		double stringNs = measure(names, packets, dispatchString, checksum);
+		double tableNs = measure(names, packets, dispatchTable, checksum);
+
+		printf("%12zu %16.2f %16.2f %10.2f   (%llu)\n", packets, stringNs, tableNs, stringNs / tableNs, (unsigned long long)checksum);
+	}
+
+	return 0;
+}
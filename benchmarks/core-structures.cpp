@@ -0,0 +1,254 @@
+/*
+ * core-structures.cpp
+ *
+ * ns/op and allocs/op of the data structures on the DRN packet paths, for each size:
+ *
+ *   getHash, Helper::getHash        : key of size bytes
+ *   split                           : list of size topics "a/b/topic-i, ..."
+ *   parsePair, trim                 : line with a value of size bytes
+ *   pa-exact, pa-wildcard           : m_PAMap of size topics, m_PAMap.find(interner.find(name)) and
+ *                                     the regex scan of a TS/TM "/x/y/*" request
+ *   findSuccessor, closestPreceding : finger table of a ring of size nodes, random keys
+ *   timeout-insert, timeout-remove  : appendPendingTimeoutEvent/removePendingTimeoutEvent with size
+ *                                     interests already pending
+ *
+ * usage: build/core-structures [sizes ...]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+#include "ns3/core-module.h"
+
+#include "Chord-DHT/M.h"
+#include "Chord-DHT/helperClass.h"
+#include "Chord-DHT/nodeInformation.hpp"
+#include "extensions/name-interner.hpp"
+#include "extensions/ndn-timeout-app.hpp"
+#include "extensions/utils.hpp"
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "bench.hpp"
+
+// 한 size 의 op 수: 크기에 비례하는 op 는 1MB 분량, 그 외는 고정
+static const size_t s_work = 1 << 20;
+static const size_t s_lookups = 200000;
+static const size_t s_timeoutBatch = 256;
+static const size_t s_timeoutRounds = 200;
+
+static volatile lli s_sink;
+
+template<typename Op>
+static void
+run(const char *name, size_t size, size_t ops, Op op) {
+	lli sink = 0;
+	uint64_t allocs = benchAllocations();
+	BenchTimer timer;
+	for (size_t i = 0; i < ops; i++) {
+		sink += op(i);
+	}
+	double ns = timer.elapsedNs();
+	allocs = benchAllocations() - allocs;
+	s_sink = sink;
+
+	printf("%-18s %10zu %12.1f %12.2f\n", name, size, ns / ops, (double)allocs / ops);
+}
+
+static size_t
+scaled(size_t size) {
+	return std::max((size_t)100, s_work / std::max(size, (size_t)1));
+}
+
+static std::string
+topicUri(size_t i) {
+	char name[64];
+	snprintf(name, sizeof(name), "/%c/%c/topic-%zu", 'a' + (char)(i % 7), 'a' + (char)(i % 5), i);
+	return name;
+}
+
+static void
+benchStrings(size_t size) {
+	std::vector<std::string> keys;
+	for (size_t i = 0; i < 64; i++) {
+		std::string key = topicUri(i);
+		key.resize(size, 'a' + (char)(i % 26));
+		keys.push_back(key);
+	}
+
+	run("getHash", size, scaled(size), [&](size_t i) {
+		return getHash(keys[i % keys.size()]);
+	});
+
+	run("Helper::getHash", size, scaled(size), [&](size_t i) {
+		return Helper::getHash(keys[i % keys.size()]);
+	});
+
+	std::string list;
+	for (size_t i = 0; i < size; i++) {
+		list += (i == 0 ? "" : ", ") + topicUri(i).substr(1);
+	}
+	run("split", size, scaled(list.size()), [&](size_t i) {
+		return (lli)split(list, ',').size();
+	});
+
+	std::string line = "  RN-00001  : " + std::string(size, 'v');
+	run("parsePair", size, scaled(size), [&](size_t i) {
+		return (lli)parsePair(line, ':').second.size();
+	});
+
+	std::string padded = "    " + std::string(size, 't') + "    ";
+	run("trim", size, scaled(size), [&](size_t i) {
+		std::string value(padded);
+		return (lli)trim(value).size();
+	});
+}
+
+static void
+benchPAMap(size_t size) {
+	NameInterner &interner = NameInterner::Get();
+	interner.clear();
+
+	std::vector<NameId> nodes;
+	for (int i = 0; i < 100; i++) {
+		nodes.push_back(interner.intern(stringf("/RN-%05d", i)));
+	}
+
+	std::map<NameId, NameId> paMap;
+	std::vector<::ndn::Name> names;
+	for (size_t i = 0; i < size; i++) {
+		names.push_back(::ndn::Name(topicUri(i)));
+		paMap[interner.intern(names.back())] = nodes[i % nodes.size()];
+	}
+
+	std::vector<lli> order = benchKeys(s_lookups, size, 7);
+	run("pa-exact", size, s_lookups, [&](size_t i) {
+		NameIdMapIterator mapIter = paMap.find(interner.find(names[order[i]]));
+		return (lli)(mapIter != paMap.end() ? mapIter->second : 0);
+	});
+
+	// /c/d/* : 1/35 of the topics
+	run("pa-wildcard", size, std::max((size_t)10, scaled(size) / 10), [&](size_t i) {
+		std::string topic("/c/d/*");
+		std::string exp(topic);
+		exp.insert(topic.find('*'), 1, '.');
+		std::regex reg(exp);
+		lli count = 0;
+		for (NameIdMapIterator mapIter = paMap.begin(); mapIter != paMap.end(); mapIter++) {
+			if (std::regex_match(interner.getUri(mapIter->first), reg)) {
+				count++;
+			}
+		}
+		return count;
+	});
+}
+
+static void
+benchFingerTable(size_t size) {
+	lli space = 1LL << M;
+	std::vector<lli> ring = benchKeys(std::max(size, (size_t)2), space, 3);
+	std::sort(ring.begin(), ring.end());
+	ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+
+	// finger i: successor of id + 2^(i-1)
+	NodeInformation node("RN-00000", 10);
+	node.setId(ring[0]);
+	node.setSuccessor("RN-00001", ring[1]);
+	node.setPredecessor(stringf("RN-%05zu", ring.size() - 1), ring.back());
+	for (int i = 1; i <= M; i++) {
+		lli start = (ring[0] + (1LL << (i - 1))) % space;
+		size_t at = std::lower_bound(ring.begin(), ring.end(), start) - ring.begin();
+		at = at % ring.size();
+		node.setFingerTable(i, stringf("RN-%05zu", at), ring[at]);
+	}
+
+	std::vector<lli> keys = benchKeys(s_lookups, space, 5);
+	pair<string, lli> successor;
+
+	run("findSuccessor", size, s_lookups, [&](size_t i) {
+		return (lli)std::get<0>(node.findSuccessor(keys[i], successor));
+	});
+
+	run("closestPreceding", size, s_lookups, [&](size_t i) {
+		return (lli)std::get<1>(node.closestPrecedingNode(keys[i], M, successor));
+	});
+}
+
+// the pending list of a rendezvous node: every interest is a pending target
+class BenchTimeoutApp : public TimeoutApp
+{
+public:
+	virtual bool
+	IsPendingTarget(const Name &name) {
+		return true;
+	}
+
+	size_t
+	getPendingCount() const {
+		return m_pendingEvent.size();
+	}
+};
+
+static void
+benchTimeout(size_t size) {
+	ns3::Ptr<BenchTimeoutApp> app = ns3::CreateObject<BenchTimeoutApp>();
+
+	std::vector<shared_ptr<const Interest>> interests;
+	for (size_t i = 0; i < size + s_timeoutBatch; i++) {
+		interests.push_back(make_shared<Interest>(Name(stringf("/RN/TM%s/%zu", topicUri(i).c_str(), i))));
+	}
+	for (size_t i = 0; i < size; i++) {
+		app->appendPendingTimeoutEvent(interests[i]);
+	}
+
+	// 같은 batch 를 넣고 빼서 pending 수를 size ~ size + batch 로 유지한다
+	double insertNs = 0, removeNs = 0;
+	uint64_t insertAllocs = 0, removeAllocs = 0;
+	for (size_t round = 0; round < s_timeoutRounds; round++) {
+		uint64_t allocs = benchAllocations();
+		BenchTimer timer;
+		for (size_t i = size; i < size + s_timeoutBatch; i++) {
+			app->appendPendingTimeoutEvent(interests[i]);
+		}
+		insertNs += timer.elapsedNs();
+		insertAllocs += benchAllocations() - allocs;
+
+		allocs = benchAllocations();
+		timer.reset();
+		for (size_t i = size; i < size + s_timeoutBatch; i++) {
+			app->removePendingTimeoutEvent(interests[i]->getName());
+		}
+		removeNs += timer.elapsedNs();
+		removeAllocs += benchAllocations() - allocs;
+	}
+	s_sink = app->getPendingCount();
+
+	size_t ops = s_timeoutRounds * s_timeoutBatch;
+	printf("%-18s %10zu %12.1f %12.2f\n", "timeout-insert", size, insertNs / ops, (double)insertAllocs / ops);
+	printf("%-18s %10zu %12.1f %12.2f\n", "timeout-remove", size, removeNs / ops, (double)removeAllocs / ops);
+
+	app->StopApplication();
+	ns3::Simulator::Destroy();
+}
+
+int
+main(int argc, char *argv[]) {
+	std::vector<size_t> sizes = benchSizes(argc, argv, {10, 100, 1000, 10000});
+
+	printf("%-18s %10s %12s %12s\n", "op", "size", "ns/op", "allocs/op");
+
+	for (size_t size : sizes) {
+		benchStrings(size);
+		benchPAMap(size);
+		benchFingerTable(size);
+		benchTimeout(size);
+	}
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * join-handoff.cpp
+ *
+ * join time of a new chord node against the number of keys stored on its successor.
+ *
+ *   full-scan : the previous getKeysForPredecessor(), a pass over the whole dictionary
+ *   range     : NodeInformation::getKeysForPredecessor() in one call
+ *   streamed  : getKeys segments of KeyChunkSize keys, encoded as they are sent,
+ *               first = time until the joiner gets its first segment
+ *
+ * usage: build/benchmarks/join-handoff [keys ...]
+ */
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Chord-DHT/M.h"
+#include "Chord-DHT/helperClass.h"
+#include "Chord-DHT/nodeInformation.hpp"
+
+#include "bench.hpp"
+
+static const size_t s_chunkSize = 256;
+
+static vector< pair<lli, string> >
+fullScan(map<lli, string> &dictionary, lli id, lli nodeId) {
+	vector< pair<lli, string> > res;
+
+	for(map<lli, string>::iterator it = dictionary.begin(); it != dictionary.end(); ) {
+		lli keyId = it->first;
+		bool move = (id < nodeId) ? (keyId > id && keyId <= nodeId) : (keyId <= nodeId || keyId > id);
+		if(move) {
+			res.push_back(make_pair(keyId, it->second));
+			it = dictionary.erase(it);
+		} else {
+			it++;
+		}
+	}
+
+	return res;
+}
+
+int
+main(int argc, char *argv[]) {
+	lli space = 1LL << M;
+	std::vector<size_t> sizes = benchSizes(argc, argv, {1000, 10000, 100000, 1000000});
+
+	// the joiner takes 1/16 of the successor's keyspace
+	lli id = Helper::getHash("RN-00001");
+	lli joinerId = (id + space / 16) % space;
+
+	printf("%10s %10s %12s %14s %14s %14s %14s\n", "keys", "moved", "bytes", "full-scan(ms)", "range(ms)", "streamed(ms)", "first(ms)");
+
+	for(size_t n : sizes) {
+		std::vector<lli> keys = benchKeys(n, space);
+
+		map<lli, string> dictionary;
+		NodeInformation single("RN-00001", 10);
+		NodeInformation streamed("RN-00001", 10);
+		single.setId(id);
+		streamed.setId(id);
+		for(lli key : keys) {
+			dictionary[key] = "RN-00002";
+			single.storeKey(key, "RN-00002");
+			streamed.storeKey(key, "RN-00002");
+		}
+
+		BenchTimer timer;
+		size_t moved = fullScan(dictionary, id, joinerId).size();
+		double fullScanMs = timer.elapsedMs();
+
+		timer.reset();
+		single.getKeysForPredecessor(joinerId);
+		double rangeMs = timer.elapsedMs();
+
+		timer.reset();
+		double firstMs = 0;
+		bool done = false;
+		size_t bytes = 0;
+		while(done == false) {
+			vector< pair<lli, string> > chunk = streamed.getKeysForPredecessor(joinerId, s_chunkSize, done);
+			bytes += Helper::joinKeysAndValues(chunk).size();
+			if(firstMs == 0) {
+				firstMs = timer.elapsedMs();
+			}
+		}
+		double streamedMs = timer.elapsedMs();
+
+		printf("%10zu %10zu %12zu %14.3f %14.3f %14.3f %14.3f\n", n, moved, bytes, fullScanMs, rangeMs, streamedMs, firstMs);
+	}
+
+	return 0;
+}
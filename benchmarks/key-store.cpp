@@ -0,0 +1,147 @@
+/*
+ * key-store.cpp
+ *
+ * std::map<lli, string> (the previous NodeInformation::m_dictionary) against KeyStore:
+ * memory per key, point lookups and range scans over the chord keyspace.
+ *
+ * usage: build/key-store [keys ...]
+ */
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Chord-DHT/M.h"
+#include "Chord-DHT/keyStore.hpp"
+
+#include "bench.hpp"
+
+static const int s_rnCount = 100;
+
+static std::string
+rnName(size_t i) {
+	char name[16];
+	snprintf(name, sizeof(name), "RN-%05zu", i % s_rnCount);
+	return name;
+}
+
+struct Result {
+	double insertMs;
+	double bytesPerKey;
+	double lookupNs;
+	double rangeKeysPerSec;
+	double fullKeysPerSec;
+};
+
+static void
+printResult(const char *name, size_t n, const Result &r) {
+	printf("%-10s %10zu %12.3f %12.1f %12.1f %16.3e %16.3e\n", name, n, r.insertMs, r.bytesPerKey, r.lookupNs, r.rangeKeysPerSec, r.fullKeysPerSec);
+}
+
+int
+main(int argc, char *argv[]) {
+	lli space = 1LL << M;
+	std::vector<size_t> sizes = benchSizes(argc, argv, {1000000});
+
+	printf("%-10s %10s %12s %12s %12s %16s %16s\n", "store", "keys", "insert(ms)", "bytes/key", "lookup(ns)", "range(keys/s)", "full(keys/s)");
+
+	for(size_t n : sizes) {
+		std::vector<lli> keys = benchKeys(n, space);
+		std::vector<lli> probes = benchKeys(n, space, 2);
+		for(size_t i = 0; i < probes.size(); i += 2) {
+			probes[i] = keys[i];
+		}
+		std::vector<std::string> values;
+		for(size_t i = 0; i < n; i++) {
+			values.push_back(rnName(i));
+		}
+
+		// every scan visits 1/16 of the keyspace, starting at a different place each time
+		const int rounds = 64;
+		size_t found = 0;
+
+		{
+			Result r;
+			size_t heap = heapInUse();
+			BenchTimer timer;
+			std::map<lli, std::string> *dictionary = new std::map<lli, std::string>();
+			for(size_t i = 0; i < n; i++) {
+				(*dictionary)[keys[i]] = values[i];
+			}
+			r.insertMs = timer.elapsedMs();
+			r.bytesPerKey = (double)(heapInUse() - heap) / dictionary->size();
+
+			timer.reset();
+			for(lli probe : probes) {
+				found += dictionary->count(probe);
+			}
+			r.lookupNs = timer.elapsedNs() / probes.size();
+
+			size_t visited = 0;
+			timer.reset();
+			for(int i = 0; i < rounds; i++) {
+				lli from = (space / rounds) * i;
+				lli to = from + space / 16;
+				for(auto it = dictionary->upper_bound(from); it != dictionary->end() && it->first <= to; it++) {
+					visited += it->second.size();
+				}
+			}
+			r.rangeKeysPerSec = (double)visited / 8 / (timer.elapsedNs() / 1e9);
+
+			visited = 0;
+			timer.reset();
+			for(auto &entry : *dictionary) {
+				visited += entry.second.size();
+			}
+			r.fullKeysPerSec = (double)visited / 8 / (timer.elapsedNs() / 1e9);
+
+			delete dictionary;
+			printResult("std::map", n, r);
+		}
+
+		{
+			Result r;
+			size_t heap = heapInUse();
+			BenchTimer timer;
+			KeyStore *dictionary = new KeyStore();
+			for(size_t i = 0; i < n; i++) {
+				dictionary->insert(keys[i], values[i]);
+			}
+			r.insertMs = timer.elapsedMs();
+			dictionary->forEach([](lli, const std::string &) {});
+			r.bytesPerKey = (double)(heapInUse() - heap) / dictionary->size();
+
+			timer.reset();
+			for(lli probe : probes) {
+				found += dictionary->find(probe) != NULL;
+			}
+			r.lookupNs = timer.elapsedNs() / probes.size();
+
+			size_t visited = 0;
+			timer.reset();
+			for(int i = 0; i < rounds; i++) {
+				lli from = (space / rounds) * i;
+				lli to = (from + space / 16) % space;
+				dictionary->forEachInRange(from, to, [&visited](lli, const std::string &value) {
+					visited += value.size();
+				});
+			}
+			r.rangeKeysPerSec = (double)visited / 8 / (timer.elapsedNs() / 1e9);
+
+			visited = 0;
+			timer.reset();
+			dictionary->forEach([&visited](lli, const std::string &value) {
+				visited += value.size();
+			});
+			r.fullKeysPerSec = (double)visited / 8 / (timer.elapsedNs() / 1e9);
+
+			delete dictionary;
+			printResult("KeyStore", n, r);
+		}
+
+		printf("# %zu probes hit\n", found / 2);
+	}
+
+	return 0;
+}
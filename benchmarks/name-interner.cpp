@@ -0,0 +1,152 @@
+/*
+ * name-interner.cpp
+ *
+ * topic state keyed on toUri() strings (the previous m_PAMap, m_DPMap, m_topicSequences)
+ * against the same maps keyed on NameInterner ids: memory per topic, lookup of a received name
+ * and the self check of a node name(m_drnPrefix.equals(Name(nodeName))).
+ *
+ * the interned memory includes the interner itself, which is shared by all apps of a simulation.
+ *
+ * usage: build/name-interner [topics ...]
+ */
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+#include "extensions/name-interner.hpp"
+
+#include "bench.hpp"
+
+static const int s_rnCount = 100;
+static const size_t s_lookups = 1000000;
+
+static std::string
+rnName(size_t i) {
+	char name[16];
+	snprintf(name, sizeof(name), "RN-%05zu", i % s_rnCount);
+	return name;
+}
+
+static ndn::Name
+topicName(size_t i) {
+	char name[64];
+	snprintf(name, sizeof(name), "/%c/%c/topic-%zu", 'a' + (char)(i % 7), 'a' + (char)(i % 5), i);
+	return ndn::Name(name);
+}
+
+struct Result {
+	double insertMs;
+	double bytesPerTopic;
+	double lookupNs;
+	double selfNs;
+};
+
+static void
+printResult(const char *name, size_t n, const Result &r) {
+	printf("%-10s %10zu %12.3f %14.1f %12.1f %12.1f\n", name, n, r.insertMs, r.bytesPerTopic, r.lookupNs, r.selfNs);
+}
+
+int
+main(int argc, char *argv[]) {
+	std::vector<size_t> sizes = benchSizes(argc, argv, {100000});
+
+	printf("%-10s %10s %12s %14s %12s %12s\n", "keys", "topics", "insert(ms)", "bytes/topic", "lookup(ns)", "self(ns)");
+
+	for (size_t n : sizes) {
+		std::vector<ndn::Name> names;
+		for (size_t i = 0; i < n; i++) {
+			names.push_back(topicName(i));
+		}
+
+		std::vector<std::string> nodeNames;
+		for (int i = 0; i < s_rnCount; i++) {
+			nodeNames.push_back(rnName(i));
+		}
+
+		// received names in random order
+		std::vector<lli> order = benchKeys(s_lookups, n, 7);
+
+		ndn::Name drnPrefix(std::string("/") + rnName(3));
+		size_t found = 0;
+
+		{
+			Result r;
+			size_t heap = heapInUse();
+			BenchTimer timer;
+
+			std::map<std::string, std::string> paMap;
+			std::map<std::string, BufferListPtr> dpMap;
+			std::map<std::string, uint32_t> sequences;
+			for (size_t i = 0; i < n; i++) {
+				paMap.insert(std::make_pair(names[i].toUri(), nodeNames[i % s_rnCount]));
+				dpMap.insert(std::make_pair(names[i].toUri(), BufferListPtr()));
+				sequences[names[i].toUri()] = 0;
+			}
+
+			r.insertMs = timer.elapsedMs();
+			r.bytesPerTopic = (double)(heapInUse() - heap) / n;
+
+			timer.reset();
+			for (size_t i = 0; i < s_lookups; i++) {
+				found += paMap.count(names[order[i]].toUri());
+			}
+			r.lookupNs = timer.elapsedNs() / s_lookups;
+
+			timer.reset();
+			for (size_t i = 0; i < s_lookups; i++) {
+				found += drnPrefix.equals(ndn::Name(nodeNames[order[i] % s_rnCount]));
+			}
+			r.selfNs = timer.elapsedNs() / s_lookups;
+
+			printResult("string", n, r);
+		}
+
+		{
+			Result r;
+			NameInterner &interner = NameInterner::Get();
+			interner.clear();
+
+			size_t heap = heapInUse();
+			BenchTimer timer;
+
+			std::map<NameId, NameId> paMap;
+			std::map<NameId, BufferListPtr> dpMap;
+			std::map<NameId, uint32_t> sequences;
+			for (size_t i = 0; i < n; i++) {
+				NameId topicId = interner.intern(names[i]);
+				paMap.insert(std::make_pair(topicId, interner.intern(nodeNames[i % s_rnCount])));
+				dpMap.insert(std::make_pair(topicId, BufferListPtr()));
+				sequences[topicId] = 0;
+			}
+
+			r.insertMs = timer.elapsedMs();
+			r.bytesPerTopic = (double)(heapInUse() - heap) / n;
+
+			timer.reset();
+			for (size_t i = 0; i < s_lookups; i++) {
+				found += paMap.count(interner.find(names[order[i]]));
+			}
+			r.lookupNs = timer.elapsedNs() / s_lookups;
+
+			NameId drnPrefixId = interner.intern(drnPrefix);
+
+			timer.reset();
+			for (size_t i = 0; i < s_lookups; i++) {
+				found += (interner.intern(nodeNames[order[i] % s_rnCount]) == drnPrefixId);
+			}
+			r.selfNs = timer.elapsedNs() / s_lookups;
+
+			printResult("interned", n, r);
+			printf("%-10s %10zu %12s %14.1f\n", "interner", interner.size(), "", (double)interner.memoryUsage() / n);
+		}
+
+		printf("(%zu)\n", found);
+	}
+
+	return 0;
+}
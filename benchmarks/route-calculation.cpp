@@ -0,0 +1,197 @@
+/*
+ * route-calculation.cpp
+ *
+ * route computation of an annotated rocketfuel topology towards RN origins on backbone nodes:
+ *
+ *   per-source : one single threaded Dijkstra per node over all nodes, the CalculateRoutes() pattern
+ *   graph(t)   : RouteGraph, one reversed Dijkstra per origin on t threads
+ *
+ * every distance of graph(t) is checked against per-source, and the next hops of graph(t)
+ * against graph(1).
+ *
+ * usage: build/route-calculation [topology [origins ...]]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "extensions/route-graph.hpp"
+
+#include "bench.hpp"
+
+struct Link {
+	uint32_t from;
+	uint32_t to;
+	uint32_t metric;
+};
+
+static int
+readTopology(const char *path, std::vector<std::string> &names, std::vector<Link> &links) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return -1;
+	}
+
+	std::map<std::string, uint32_t> ids;
+	std::string line;
+	int section = 0;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		if (line.compare(0, 6, "router") == 0) {
+			section = 1;
+			continue;
+		}
+		if (line.compare(0, 4, "link") == 0) {
+			section = 2;
+			continue;
+		}
+
+		std::istringstream tokens(line);
+		std::string from, to, bandwidth;
+		uint32_t metric = 1;
+		if (section == 1 && (tokens >> from)) {
+			ids[from] = names.size();
+			names.push_back(from);
+		} else if (section == 2 && (tokens >> from >> to)) {
+			tokens >> bandwidth >> metric;
+			if (ids.count(from) && ids.count(to)) {
+				links.push_back({ids[from], ids[to], metric});
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* distances from source, the per node run of CalculateRoutes() */
+static void
+forwardDijkstra(uint32_t source, const std::vector<std::vector<std::pair<uint32_t, uint32_t>>> &adjacency, std::vector<uint64_t> &distances) {
+	typedef std::pair<uint64_t, uint32_t> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+	distances.assign(adjacency.size(), RouteGraph::UNREACHABLE);
+	distances[source] = 0;
+	queue.push(std::make_pair(0, source));
+	while (!queue.empty()) {
+		QueueEntry top = queue.top();
+		queue.pop();
+		if (distances[top.second] < top.first) {
+			continue;
+		}
+		for (const std::pair<uint32_t, uint32_t> &edge : adjacency[top.second]) {
+			uint64_t distance = top.first + edge.second;
+			if (distance < distances[edge.first]) {
+				distances[edge.first] = distance;
+				queue.push(std::make_pair(distance, edge.first));
+			}
+		}
+	}
+}
+
+static RouteGraph
+makeGraph(uint32_t nodes, const std::vector<Link> &links, const std::vector<uint32_t> &origins) {
+	RouteGraph graph(nodes);
+	// links are bidirectional, one face each way
+	for (const Link &link : links) {
+		graph.addEdge(link.from, link.to, link.metric);
+		graph.addEdge(link.to, link.from, link.metric);
+	}
+	for (uint32_t origin : origins) {
+		graph.addTarget(origin);
+	}
+
+	return graph;
+}
+
+int
+main(int argc, char *argv[]) {
+	const char *path = (1 < argc) ? argv[1] : "topologies/bw-delay-rand-1/1239.r0-conv-annotated.txt";
+	std::vector<size_t> sizes = benchSizes(argc - 1, argv + 1, {10, 50, 200});
+
+	std::vector<std::string> names;
+	std::vector<Link> links;
+	if (readTopology(path, names, links) != 0) {
+		fprintf(stderr, "cannot read %s\n", path);
+		return 1;
+	}
+
+	std::vector<uint32_t> backbone;
+	std::vector<std::vector<std::pair<uint32_t, uint32_t>>> adjacency(names.size());
+	for (uint32_t i = 0; i < names.size(); i++) {
+		if (names[i].compare(0, 3, "bb-") == 0) {
+			backbone.push_back(i);
+		}
+	}
+	for (const Link &link : links) {
+		adjacency[link.from].push_back(std::make_pair(link.to, link.metric));
+		adjacency[link.to].push_back(std::make_pair(link.from, link.metric));
+	}
+
+	printf("%s: %zu nodes, %zu links, %zu backbone\n", path, names.size(), links.size(), backbone.size());
+
+	std::vector<uint32_t> threadCounts = {1, 2, 4, 8};
+	uint32_t cores = std::thread::hardware_concurrency();
+	if (8 < cores) {
+		threadCounts.push_back(cores);
+	}
+
+	printf("%8s %16s", "origins", "per-source(ms)");
+	for (uint32_t threads : threadCounts) {
+		printf(" %9s(%2u)", "graph", threads);
+	}
+	printf(" %10s\n", "speedup");
+
+	for (size_t count : sizes) {
+		std::vector<uint32_t> origins;
+		for (size_t i = 0; i < count && i < backbone.size(); i++) {
+			origins.push_back(backbone[i * backbone.size() / std::min(count, backbone.size())]);
+		}
+
+		BenchTimer timer;
+		std::vector<std::vector<uint64_t>> forward(names.size());
+		for (uint32_t source = 0; source < names.size(); source++) {
+			forwardDijkstra(source, adjacency, forward[source]);
+		}
+		double forwardMs = timer.elapsedMs();
+
+		printf("%8zu %16.2f", origins.size(), forwardMs);
+
+		RouteGraph serial = makeGraph(names.size(), links, origins);
+		serial.compute(1);
+
+		double bestMs = forwardMs;
+		size_t mismatches = 0;
+		for (uint32_t threads : threadCounts) {
+			RouteGraph graph = makeGraph(names.size(), links, origins);
+
+			timer.reset();
+			graph.compute(threads);
+			double graphMs = timer.elapsedMs();
+			bestMs = std::min(bestMs, graphMs);
+
+			for (uint32_t t = 0; t < origins.size(); t++) {
+				for (uint32_t v = 0; v < names.size(); v++) {
+					mismatches += (graph.getDistance(v, t) != forward[v][origins[t]]);
+					mismatches += (graph.getNextHop(v, t) != serial.getNextHop(v, t));
+				}
+			}
+
+			printf(" %13.2f", graphMs);
+		}
+
+		printf(" %10.2f   %s\n", forwardMs / bestMs, mismatches == 0 ? "identical" : "MISMATCH");
+	}
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * topic-manifest.cpp
+ *
+ * TM answer of a wildcard topic: the text list "{topic}:{node},..." built with stringf/stringstream and parsed with
+ * split/parsePair, against the front coded TLV manifest(extensions/topic-manifest.hpp).
+ * bytes per entry, build and parse time per entry, of unique topics. the parsed entries are compared with the input
+ * (sorted for the manifest) before the numbers are printed.
+ *
+ * usage: build/topic-manifest [entries ...]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "extensions/topic-manifest.hpp"
+#include "extensions/utils.hpp"
+
+#include "bench.hpp"
+
+// RNs that answer the topics of a prefix
+static const uint32_t s_nodeCount = 64;
+
+struct Result
+{
+	size_t bytes;
+	double buildNs;
+	double parseNs;
+	size_t parsed;
+	// parsed entries equal the input
+	bool verified;
+};
+
+static Result
+measureText(const std::vector<std::pair<std::string, std::string>> &entries) {
+	Result result;
+
+	BenchTimer timer;
+	std::stringstream sio;
+	for (size_t i = 0; i < entries.size(); i++) {
+		if (0 < i) {
+			sio << ',';
+		}
+		sio << stringf("%s:%s", entries[i].first.c_str(), entries[i].second.c_str());
+	}
+	std::string text = sio.str();
+	result.buildNs = timer.elapsedNs();
+	result.bytes = text.size();
+
+	timer.reset();
+	std::vector<std::pair<std::string, std::string>> parsed;
+	std::vector<std::string> list = split(text, ',');
+	for (const std::string &pair : list) {
+		if (pair.size() == 0) {
+			continue;
+		}
+		parsed.push_back(parsePair(pair, ':'));
+	}
+	result.parseNs = timer.elapsedNs();
+	result.parsed = parsed.size();
+	result.verified = parsed == entries;
+
+	return result;
+}
+
+static Result
+measureManifest(const std::vector<std::pair<std::string, std::string>> &entries) {
+	Result result;
+
+	BenchTimer timer;
+	TopicManifest manifest;
+	for (const std::pair<std::string, std::string> &entry : entries) {
+		manifest.add(entry.first, entry.second);
+	}
+	std::shared_ptr<::ndn::Buffer> wire = manifest.wireEncode();
+	result.buildNs = timer.elapsedNs();
+	result.bytes = wire->size();
+
+	timer.reset();
+	TopicManifest decoded;
+	if (decoded.wireDecode(wire->data(), wire->size()) != 0) {
+		fprintf(stderr, "malformed manifest\n");
+	}
+	result.parseNs = timer.elapsedNs();
+	result.parsed = decoded.getEntries().size();
+
+	std::vector<std::pair<std::string, std::string>> sorted(entries);
+	std::sort(sorted.begin(), sorted.end());
+	result.verified = decoded.getEntries() == sorted;
+
+	return result;
+}
+
+int
+main(int argc, char *argv[]) {
+	std::vector<size_t> sizes = benchSizes(argc, argv, {10, 100, 1000, 10000});
+
+	printf("%10s %22s %22s %22s\n", "", "bytes/entry", "build(ns/entry)", "parse(ns/entry)");
+	printf("%10s %10s %11s %10s %11s %10s %11s\n", "entries", "text", "manifest", "text", "manifest", "text", "manifest");
+
+	std::mt19937 rng(1);
+	for (size_t count : sizes) {
+		// m_PAMap 순서: 이름이 interned 된 순서, 곧 정렬되지 않은 서로 다른 topic
+		std::vector<uint32_t> ids(count * 10);
+		for (size_t i = 0; i < ids.size(); i++) {
+			ids[i] = (uint32_t)i;
+		}
+		std::shuffle(ids.begin(), ids.end(), rng);
+
+		std::vector<std::pair<std::string, std::string>> entries;
+		for (size_t i = 0; i < count; i++) {
+			entries.push_back(std::make_pair(stringf("/a/b/topic-%05u", ids[i]),
+					stringf("RN-%05u", (uint32_t)(rng() % s_nodeCount))));
+		}
+
+		Result text = measureText(entries);
+		Result manifest = measureManifest(entries);
+		if (!text.verified || !manifest.verified) {
+			fprintf(stderr, "%zu entries: text %zu%s, manifest %zu%s\n", count,
+					text.parsed, text.verified ? "" : " mismatch", manifest.parsed, manifest.verified ? "" : " mismatch");
+			return 1;
+		}
+
+		printf("%10zu %10.2f %11.2f %10.1f %11.1f %10.1f %11.1f\n", count,
+				(double)text.bytes / text.parsed, (double)manifest.bytes / manifest.parsed,
+				text.buildNs / text.parsed, manifest.buildNs / manifest.parsed,
+				text.parseNs / text.parsed, manifest.parseNs / manifest.parsed);
+	}
+
+	return 0;
+}
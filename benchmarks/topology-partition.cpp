@@ -0,0 +1,54 @@
+/*
+ * topology-partition.cpp
+ *
+ * partition of the annotated rocketfuel topologies over 2..8 ranks of a distributed simulation:
+ *
+ *   cut        : links between ranks and their cost(1 + 100ms / delay)
+ *   lookahead  : smallest delay of a cut link, the time the ranks can run ahead of each other
+ *   imbalance  : largest rank load / mean rank load
+ *
+ * usage: build/topology-partition [topology ...]
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "extensions/topology-partition.hpp"
+
+#include "bench.hpp"
+
+int
+main(int argc, char *argv[]) {
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; i++) {
+		paths.push_back(argv[i]);
+	}
+	if (paths.empty()) {
+		for (const char *as : {"1221", "1239", "1755", "3257", "3967", "6461"}) {
+			paths.push_back(std::string("topologies/bw-delay-rand-1/") + as + ".r0-conv-annotated.txt");
+		}
+	}
+
+	printf("%-48s %6s %5s %8s %10s %10s %10s %9s\n", "topology", "nodes", "ranks", "cut", "cut cost", "lookahead", "imbalance", "time(ms)");
+
+	for (const std::string &path : paths) {
+		TopologyPartition partition;
+		if (partition.read(path) != 0) {
+			fprintf(stderr, "cannot read %s\n", path.c_str());
+			continue;
+		}
+
+		for (uint32_t ranks : {2, 4, 8}) {
+			BenchTimer timer;
+			partition.partition(ranks);
+			double ms = timer.elapsedMs();
+
+			printf("%-48s %6u %5u %8u %10llu %8lluus %10.3f %9.2f\n", path.c_str(), partition.getNodeCount(), ranks,
+					partition.getCutCount(), (unsigned long long)partition.getCutCost(),
+					(unsigned long long)partition.getLookahead(), partition.getImbalance(), ms);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,451 @@
+/*
+ * churn-generator.cpp
+ */
+
+#include "churn-generator.hpp"
+
+#include <fstream>
+#include <queue>
+#include <sstream>
+
+#include <ns3/ndnSIM/helper/ndn-link-control-helper.hpp>
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.ChurnGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(ChurnGenerator);
+
+ns3::TypeId
+ChurnGenerator::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("ChurnGenerator")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<ChurnGenerator>()
+
+			.AddAttribute("JoinRate", "Poisson rate(per second) of joins of inactive nodes", ns3::DoubleValue(0.0),
+							ns3::MakeDoubleAccessor(&ChurnGenerator::m_joinRate), ns3::MakeDoubleChecker<double>(0.0))
+
+			.AddAttribute("LeaveRate", "Poisson rate(per second) of graceful leaves of active nodes", ns3::DoubleValue(0.0),
+							ns3::MakeDoubleAccessor(&ChurnGenerator::m_leaveRate), ns3::MakeDoubleChecker<double>(0.0))
+
+			.AddAttribute("FailureRate", "Poisson rate(per second) of crash failures", ns3::DoubleValue(0.0),
+							ns3::MakeDoubleAccessor(&ChurnGenerator::m_failureRate), ns3::MakeDoubleChecker<double>(0.0))
+
+			.AddAttribute("FailureRadius", "Hops around a crashed node within which all nodes fail together(0: independent)", ns3::UintegerValue(0),
+							ns3::MakeUintegerAccessor(&ChurnGenerator::m_failureRadius), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("RepairTime", "Mean time until crashed nodes recover(0: never)", ns3::StringValue("0s"),
+							ns3::MakeTimeAccessor(&ChurnGenerator::m_repairTime), ns3::MakeTimeChecker())
+
+			.AddAttribute("StartTime", "Time when churn starts", ns3::StringValue("0s"),
+							ns3::MakeTimeAccessor(&ChurnGenerator::m_startTime), ns3::MakeTimeChecker())
+
+			.AddAttribute("StopTime", "Time when churn stops", ns3::StringValue("0s"),
+							ns3::MakeTimeAccessor(&ChurnGenerator::m_stopTime), ns3::MakeTimeChecker())
+
+			.AddAttribute("MinActive", "Leaves and failures never bring the active nodes below this count", ns3::UintegerValue(1),
+							ns3::MakeUintegerAccessor(&ChurnGenerator::m_minActive), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("TraceFile", "Scheduled events, lines of '<seconds> <join|leave|fail|recover> <node name>'", ns3::StringValue(""),
+							ns3::MakeStringAccessor(&ChurnGenerator::m_traceFile), ns3::MakeStringChecker())
+			;
+
+	return tid;
+}
+
+ChurnGenerator::ChurnGenerator()
+	: m_joinRate(0.0)
+	, m_leaveRate(0.0)
+	, m_failureRate(0.0)
+	, m_failureRadius(0)
+	, m_minActive(1)
+	, m_nJoinCount(0)
+	, m_nLeaveCount(0)
+	, m_nFailureCount(0)
+	, m_nFailedNodeCount(0)
+	, m_nRecoverCount(0)
+{
+	m_interval = ns3::CreateObject<ns3::ExponentialRandomVariable>();
+	m_pick = ns3::CreateObject<ns3::UniformRandomVariable>();
+}
+
+ChurnGenerator::~ChurnGenerator() {
+}
+
+void
+ChurnGenerator::AddTarget(ns3::Ptr<ns3::Node> node, ns3::Callback<void> join, ns3::Callback<void> leave, ns3::Time start) {
+	Target target;
+	target.node = node;
+	target.join = join;
+	target.leave = leave;
+	target.started = false;
+	target.active = false;
+	target.failed = false;
+	target.rejoin = false;
+
+	uint32_t index = m_targets.size();
+	m_nodeToTarget[node->GetId()] = index;
+	m_targets.push_back(target);
+
+	ns3::Simulator::Schedule(start, &ChurnGenerator::Start, this, index);
+}
+
+/**
+ * application이 StartTime에 시작했다. 그 전에 장애가 났으면 복구 때 join 하도록 멈춘다.
+ */
+void
+ChurnGenerator::Start(uint32_t index) {
+	Target &target = m_targets[index];
+	target.started = true;
+	if (target.failed == false) {
+		target.active = true;
+		return;
+	}
+
+	// 같은 시각의 StartApplication 다음에 멈춘다
+	target.rejoin = true;
+	ns3::Simulator::ScheduleNow(&ChurnGenerator::Halt, this, index);
+}
+
+void
+ChurnGenerator::Halt(uint32_t index) {
+	Target &target = m_targets[index];
+	if (!target.leave.IsNull()) {
+		target.leave();
+	}
+}
+
+int64_t
+ChurnGenerator::AssignStreams(int64_t stream) {
+	m_interval->SetStream(stream);
+	m_pick->SetStream(stream + 1);
+
+	return 2;
+}
+
+int
+ChurnGenerator::Install() {
+	if (0 < m_traceFile.size() && ReadTrace(m_traceFile) != 0) {
+		return -1;
+	}
+
+	ScheduleNext(m_joinRate, &ChurnGenerator::OnJoinEvent, m_startTime);
+	ScheduleNext(m_leaveRate, &ChurnGenerator::OnLeaveEvent, m_startTime);
+	ScheduleNext(m_failureRate, &ChurnGenerator::OnFailureEvent, m_startTime);
+
+	return 0;
+}
+
+void
+ChurnGenerator::Report() {
+	NS_LOG_INFO(stringf("Churn JoinCount:       %5u", m_nJoinCount));
+	NS_LOG_INFO(stringf("Churn LeaveCount:      %5u", m_nLeaveCount));
+	NS_LOG_INFO(stringf("Churn FailureCount:    %5u", m_nFailureCount));
+	NS_LOG_INFO(stringf("Churn FailedNodeCount: %5u", m_nFailedNodeCount));
+	NS_LOG_INFO(stringf("Churn RecoverCount:    %5u", m_nRecoverCount));
+	NS_LOG_INFO(stringf("Churn ActiveCount:     %5u/%u", GetActiveCount(), (uint32_t)m_targets.size()));
+}
+
+void
+ChurnGenerator::Join(uint32_t index) {
+	Target &target = m_targets[index];
+	if (target.active || target.failed || target.started == false) {
+		return;
+	}
+
+	NS_LOG_INFO("Join: " << ns3::Names::FindName(target.node));
+
+	target.active = true;
+	if (!target.join.IsNull()) {
+		target.join();
+	}
+	m_nJoinCount += 1;
+}
+
+void
+ChurnGenerator::Leave(uint32_t index) {
+	Target &target = m_targets[index];
+	if (target.active == false || GetActiveCount() <= m_minActive) {
+		return;
+	}
+
+	NS_LOG_INFO("Leave: " << ns3::Names::FindName(target.node));
+
+	target.active = false;
+	if (!target.leave.IsNull()) {
+		target.leave();
+	}
+	m_nLeaveCount += 1;
+}
+
+/**
+ * 장애 노드와 FailureRadius hop 이내의 target 노드들의 link를 모두 끊는다.
+ * link가 끊긴 뒤에 application을 멈추므로 leave 메시지는 전달되지 않고, 노드의 상태는 사라진다.
+ */
+void
+ChurnGenerator::Fail(uint32_t index) {
+	std::vector<uint32_t> group = FindNeighbours(index, m_failureRadius);
+
+	m_nFailureCount += 1;
+
+	std::vector<uint32_t>::iterator iter = group.begin();
+	for (; iter != group.end(); iter++) {
+		Target &target = m_targets[*iter];
+		if (target.failed || (target.active && GetActiveCount() <= m_minActive)) {
+			continue;
+		}
+
+		NS_LOG_INFO("Fail: " << ns3::Names::FindName(target.node));
+
+		target.failed = true;
+		target.rejoin = target.active;
+		SetLinks(*iter, false);
+		if (target.active) {
+			target.active = false;
+			if (!target.leave.IsNull()) {
+				target.leave();
+			}
+		}
+		m_nFailedNodeCount += 1;
+
+		if (m_repairTime.IsStrictlyPositive()) {
+			double delay = m_interval->GetValue(m_repairTime.GetSeconds(), 0);
+			ns3::Simulator::Schedule(ns3::Seconds(delay), &ChurnGenerator::Recover, this, *iter);
+		}
+	}
+}
+
+void
+ChurnGenerator::Recover(uint32_t index) {
+	Target &target = m_targets[index];
+	if (target.failed == false) {
+		return;
+	}
+
+	NS_LOG_INFO("Recover: " << ns3::Names::FindName(target.node));
+
+	target.failed = false;
+	SetLinks(index, true);
+	m_nRecoverCount += 1;
+
+	// 장애 전에 leave 한 노드는 다시 join 하지 않는다
+	if (target.rejoin) {
+		target.rejoin = false;
+		Join(index);
+	}
+}
+
+void
+ChurnGenerator::OnJoinEvent() {
+	int32_t index = PickTarget(false);
+	if (0 <= index) {
+		Join(index);
+	}
+
+	ScheduleNext(m_joinRate, &ChurnGenerator::OnJoinEvent, ns3::Seconds(0));
+}
+
+void
+ChurnGenerator::OnLeaveEvent() {
+	int32_t index = PickTarget(true);
+	if (0 <= index) {
+		Leave(index);
+	}
+
+	ScheduleNext(m_leaveRate, &ChurnGenerator::OnLeaveEvent, ns3::Seconds(0));
+}
+
+void
+ChurnGenerator::OnFailureEvent() {
+	int32_t index = PickTarget(true);
+	if (0 <= index) {
+		Fail(index);
+	}
+
+	ScheduleNext(m_failureRate, &ChurnGenerator::OnFailureEvent, ns3::Seconds(0));
+}
+
+void
+ChurnGenerator::ScheduleNext(double rate, void (ChurnGenerator::*event)(), ns3::Time base) {
+	if (rate <= 0.0) {
+		return;
+	}
+
+	ns3::Time delay = base + ns3::Seconds(m_interval->GetValue(1.0 / rate, 0));
+	if (m_stopTime.IsStrictlyPositive() && m_stopTime <= ns3::Simulator::Now() + delay) {
+		return;
+	}
+
+	ns3::Simulator::Schedule(delay, event, this);
+}
+
+int
+ChurnGenerator::ReadTrace(const std::string &path) {
+	std::ifstream trace(path.c_str());
+	if (trace.is_open() == false) {
+		NS_LOG_UNCOND("can not open churn trace: " << path);
+		return -1;
+	}
+
+	while (!trace.eof()) {
+		std::string line;
+		getline(trace, line);
+		trim(line);
+		if (line.size() == 0 || line[0] == '#') {
+			continue;
+		}
+
+		double seconds;
+		std::string action;
+		std::string name;
+		std::istringstream tokens(line);
+		if (!(tokens >> seconds >> action >> name)) {
+			NS_LOG_UNCOND("invalid churn trace line: " << line);
+			return -1;
+		}
+
+		int32_t index = FindTarget(name);
+		if (index < 0) {
+			NS_LOG_UNCOND("unknown churn trace node: " << name);
+			return -1;
+		}
+
+		ns3::Time at = ns3::Seconds(seconds);
+		if (action == "join") {
+			ns3::Simulator::Schedule(at, &ChurnGenerator::Join, this, index);
+		} else if (action == "leave") {
+			ns3::Simulator::Schedule(at, &ChurnGenerator::Leave, this, index);
+		} else if (action == "fail" || action == "kill") {
+			ns3::Simulator::Schedule(at, &ChurnGenerator::Fail, this, index);
+		} else if (action == "recover") {
+			ns3::Simulator::Schedule(at, &ChurnGenerator::Recover, this, index);
+		} else {
+			NS_LOG_UNCOND("unknown churn trace action: " << action);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * topology 노드 이름(bb-1234) 또는 rendezvous 이름(RN-00012)으로 target을 찾는다.
+ */
+int32_t
+ChurnGenerator::FindTarget(const std::string &name) {
+	for (uint32_t index = 0; index < m_targets.size(); index++) {
+		ns3::Ptr<ns3::Node> node = m_targets[index].node;
+		if (ns3::Names::FindName(node) == name || stringf("RN-%05d", node->GetId()) == name) {
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+int32_t
+ChurnGenerator::PickTarget(bool active) {
+	std::vector<uint32_t> candidates;
+	for (uint32_t index = 0; index < m_targets.size(); index++) {
+		if (m_targets[index].started && m_targets[index].failed == false && m_targets[index].active == active) {
+			candidates.push_back(index);
+		}
+	}
+
+	if (candidates.size() == 0) {
+		return -1;
+	}
+
+	return candidates[m_pick->GetInteger(0, candidates.size() - 1)];
+}
+
+uint32_t
+ChurnGenerator::GetActiveCount() {
+	uint32_t count = 0;
+	for (uint32_t index = 0; index < m_targets.size(); index++) {
+		if (m_targets[index].active) {
+			count += 1;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * index target 노드로부터 radius hop 이내에 있는 target 목록(자신 포함)
+ */
+std::vector<uint32_t>
+ChurnGenerator::FindNeighbours(uint32_t index, uint32_t radius) {
+	std::vector<uint32_t> group;
+	std::set<uint32_t> visited;
+	std::queue<std::pair<ns3::Ptr<ns3::Node>, uint32_t>> queue;
+
+	queue.push(std::make_pair(m_targets[index].node, 0));
+	visited.insert(m_targets[index].node->GetId());
+
+	while (queue.empty() == false) {
+		ns3::Ptr<ns3::Node> node = queue.front().first;
+		uint32_t hops = queue.front().second;
+		queue.pop();
+
+		std::map<uint32_t, uint32_t>::iterator targetIter = m_nodeToTarget.find(node->GetId());
+		if (targetIter != m_nodeToTarget.end()) {
+			group.push_back(targetIter->second);
+		}
+
+		if (hops == radius) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+			ns3::Ptr<ns3::Channel> channel = node->GetDevice(i)->GetChannel();
+			if (channel == 0) {
+				continue;
+			}
+
+			for (uint32_t j = 0; j < channel->GetNDevices(); j++) {
+				ns3::Ptr<ns3::Node> peer = channel->GetDevice(j)->GetNode();
+				if (visited.insert(peer->GetId()).second) {
+					queue.push(std::make_pair(peer, hops + 1));
+				}
+			}
+		}
+	}
+
+	return group;
+}
+
+/**
+ * up 이면 장애 상태가 아닌 이웃과의 link만 복구한다.
+ */
+void
+ChurnGenerator::SetLinks(uint32_t index, bool up) {
+	ns3::Ptr<ns3::Node> node = m_targets[index].node;
+
+	for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+		ns3::Ptr<ns3::Channel> channel = node->GetDevice(i)->GetChannel();
+		if (channel == 0) {
+			continue;
+		}
+
+		for (uint32_t j = 0; j < channel->GetNDevices(); j++) {
+			ns3::Ptr<ns3::Node> peer = channel->GetDevice(j)->GetNode();
+			if (peer == node) {
+				continue;
+			}
+
+			if (up == false) {
+				ns3::ndn::LinkControlHelper::FailLink(node, peer);
+				continue;
+			}
+
+			std::map<uint32_t, uint32_t>::iterator targetIter = m_nodeToTarget.find(peer->GetId());
+			if (targetIter != m_nodeToTarget.end() && m_targets[targetIter->second].failed) {
+				continue;
+			}
+			ns3::ndn::LinkControlHelper::UpLink(node, peer);
+		}
+	}
+}
@@ -0,0 +1,151 @@
+/*
+ * churn-generator.hpp
+ *
+ * ring membership churn and failure injection for the rendezvous nodes.
+ *
+ *  - Poisson join/leave    : JoinRate/LeaveRate events per second, leave calls StopApplication and
+ *                            join calls StartApplication of a random inactive/active target
+ *  - correlated failures   : FailureRate events per second, every target within FailureRadius hops
+ *                            of the victim loses all of its links (and its state) until RepairTime
+ *  - scheduled events      : TraceFile lines "<seconds> <join|leave|fail|recover> <node name>"
+ *
+ * a target is inactive until its application starts, join events before that are ignored. a recovered target
+ * joins again only if it was active when it failed.
+ *
+ * the chord RendezvousDrn leaves and joins the ring. RendezvousDrnF maps topics on the static "dht-nodes"
+ * list(m_dhtNodes), so the other RNs keep routing the topics of a stopped DrnF RN to it.
+ */
+
+#ifndef EXTENSIONS_CHURN_GENERATOR_HPP_
+#define EXTENSIONS_CHURN_GENERATOR_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+class ChurnGenerator : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	ChurnGenerator();
+
+	virtual
+	~ChurnGenerator();
+
+	/**
+	 * @brief node whose application is driven by the generator.
+	 * join/leave are bound to the StartApplication/StopApplication of the application on the node,
+	 * null for a node of another MPI rank(the churn state is kept on every rank, only the links change).
+	 * start is the start time of the application, the target is active from then on
+	 */
+	void
+	AddTarget(ns3::Ptr<ns3::Node> node, ns3::Callback<void> join, ns3::Callback<void> leave, ns3::Time start);
+
+	/**
+	 * @brief fixed random streams, so that every MPI rank draws the same churn events
+	 */
+	int64_t
+	AssignStreams(int64_t stream);
+
+	/**
+	 * @brief schedule the churn processes and the trace file events, call after all targets are added
+	 */
+	int
+	Install();
+
+	void
+	Report();
+
+	void
+	Join(uint32_t index);
+
+	void
+	Leave(uint32_t index);
+
+	void
+	Fail(uint32_t index);
+
+	void
+	Recover(uint32_t index);
+
+private:
+	struct Target
+	{
+		ns3::Ptr<ns3::Node> node;
+		ns3::Callback<void> join;
+		ns3::Callback<void> leave;
+		// the application has started(StartTime)
+		bool started;
+		bool active;
+		bool failed;
+		// active when it failed: join again on recovery
+		bool rejoin;
+	};
+
+	void
+	Start(uint32_t index);
+
+	void
+	Halt(uint32_t index);
+
+	void
+	OnJoinEvent();
+
+	void
+	OnLeaveEvent();
+
+	void
+	OnFailureEvent();
+
+	void
+	ScheduleNext(double rate, void (ChurnGenerator::*event)(), ns3::Time base);
+
+	int
+	ReadTrace(const std::string &path);
+
+	int32_t
+	FindTarget(const std::string &name);
+
+	int32_t
+	PickTarget(bool active);
+
+	uint32_t
+	GetActiveCount();
+
+	std::vector<uint32_t>
+	FindNeighbours(uint32_t index, uint32_t radius);
+
+	void
+	SetLinks(uint32_t index, bool up);
+
+private:
+	double m_joinRate;
+	double m_leaveRate;
+	double m_failureRate;
+	uint32_t m_failureRadius;
+	ns3::Time m_repairTime;
+	ns3::Time m_startTime;
+	ns3::Time m_stopTime;
+	uint32_t m_minActive;
+	std::string m_traceFile;
+
+	ns3::Ptr<ns3::ExponentialRandomVariable> m_interval;
+	ns3::Ptr<ns3::UniformRandomVariable> m_pick;
+
+	std::vector<Target> m_targets;
+	std::map<uint32_t, uint32_t> m_nodeToTarget;
+
+	uint32_t m_nJoinCount;
+	uint32_t m_nLeaveCount;
+	uint32_t m_nFailureCount;
+	uint32_t m_nFailedNodeCount;
+	uint32_t m_nRecoverCount;
+};
+
+#endif /* EXTENSIONS_CHURN_GENERATOR_HPP_ */
@@ -0,0 +1,90 @@
+/*
+ * count-min-sketch.cpp
+ */
+
+#include "count-min-sketch.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/* 64 bit finalizer(splitmix64), std::hash of string is not well mixed on every platform */
+static uint64_t
+mix(uint64_t x) {
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+CountMinSketch::CountMinSketch(uint32_t width, uint32_t depth) {
+	resize(width, depth);
+}
+
+void
+CountMinSketch::resize(uint32_t width, uint32_t depth) {
+	m_width = std::max<uint32_t>(width, 1);
+	m_depth = std::max<uint32_t>(depth, 1);
+	m_counters.assign((size_t)m_width * m_depth, 0);
+	m_slots.resize(m_depth);
+}
+
+uint32_t
+CountMinSketch::add(const std::string &key, uint32_t count) {
+	locate(key, m_slots);
+
+	uint32_t current = std::numeric_limits<uint32_t>::max();
+	for (uint32_t row = 0; row < m_depth; row++) {
+		current = std::min(current, m_counters[m_slots[row]]);
+	}
+
+	uint64_t updated = std::min<uint64_t>((uint64_t)current + count, std::numeric_limits<uint32_t>::max());
+	for (uint32_t row = 0; row < m_depth; row++) {
+		uint32_t &counter = m_counters[m_slots[row]];
+		if (counter < updated) {
+			counter = (uint32_t)updated;
+		}
+	}
+
+	return (uint32_t)updated;
+}
+
+uint32_t
+CountMinSketch::estimate(const std::string &key) const {
+	std::vector<uint32_t> slots(m_depth);
+	locate(key, slots);
+
+	uint32_t result = std::numeric_limits<uint32_t>::max();
+	for (uint32_t row = 0; row < m_depth; row++) {
+		result = std::min(result, m_counters[slots[row]]);
+	}
+
+	return result;
+}
+
+void
+CountMinSketch::decay() {
+	std::vector<uint32_t>::iterator iter = m_counters.begin();
+	for (; iter != m_counters.end(); iter++) {
+		*iter >>= 1;
+	}
+}
+
+void
+CountMinSketch::clear() {
+	std::fill(m_counters.begin(), m_counters.end(), 0);
+}
+
+/**
+ * row 별 독립 hash 대신 두 개의 hash로 만든 h1 + row * h2 를 사용한다(Kirsch-Mitzenmacher)
+ */
+void
+CountMinSketch::locate(const std::string &key, std::vector<uint32_t> &slots) const {
+	uint64_t hash = mix(std::hash<std::string>()(key));
+	uint32_t h1 = (uint32_t)hash;
+	uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+
+	for (uint32_t row = 0; row < m_depth; row++) {
+		slots[row] = row * m_width + (h1 + row * h2) % m_width;
+	}
+}
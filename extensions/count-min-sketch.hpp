@@ -0,0 +1,56 @@
+/*
+ * count-min-sketch.hpp
+ *
+ * approximate per key request counters in a fixed width x depth table.
+ *
+ *  - estimate never under counts, over counts are bounded by total/width with high probability
+ *  - conservative update: only the smallest counters of a key are incremented
+ *  - decay halves every counter, so estimates follow the recent request rate
+ */
+
+#ifndef EXTENSIONS_COUNT_MIN_SKETCH_HPP_
+#define EXTENSIONS_COUNT_MIN_SKETCH_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CountMinSketch
+{
+public:
+	CountMinSketch(uint32_t width = 256, uint32_t depth = 4);
+
+	/**
+	 * @brief change the table size, all counts are cleared
+	 */
+	void
+	resize(uint32_t width, uint32_t depth);
+
+	/**
+	 * @brief count key, returns the estimate after the update
+	 */
+	uint32_t
+	add(const std::string &key, uint32_t count = 1);
+
+	uint32_t
+	estimate(const std::string &key) const;
+
+	void
+	decay();
+
+	void
+	clear();
+
+private:
+	void
+	locate(const std::string &key, std::vector<uint32_t> &slots) const;
+
+private:
+	uint32_t m_width;
+	uint32_t m_depth;
+	// row major, m_depth rows of m_width counters
+	std::vector<uint32_t> m_counters;
+	std::vector<uint32_t> m_slots;
+};
+
+#endif /* EXTENSIONS_COUNT_MIN_SKETCH_HPP_ */
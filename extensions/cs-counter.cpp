@@ -0,0 +1,79 @@
+/*
+ * cs-counter.cpp
+ */
+
+#include "cs-counter.hpp"
+
+#include <ns3/ndnSIM/model/ndn-l3-protocol.hpp>
+#include <ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp>
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "ns3/network-module.h"
+
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.CsCounter");
+
+NS_OBJECT_ENSURE_REGISTERED(CsCounter);
+
+ns3::TypeId
+CsCounter::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("CsCounter")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<CsCounter>()
+			;
+
+	return tid;
+}
+
+CsCounter::CsCounter()
+	: m_nHitCount()
+	, m_nMissCount()
+{
+}
+
+void
+CsCounter::Install() {
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::ndn::L3Protocol> l3 = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::L3Protocol>();
+		if (l3 == 0) {
+			continue;
+		}
+
+		// forwarder 가 node 와 함께 없어지므로 연결을 끊지 않는다.
+		l3->getForwarder()->afterCsHit.connect([this] (const ::ndn::Interest &interest, const ::ndn::Data &data) {
+			countHit(interest);
+		});
+		l3->getForwarder()->afterCsMiss.connect([this] (const ::ndn::Interest &interest) {
+			countMiss(interest);
+		});
+	}
+}
+
+void
+CsCounter::countHit(const ::ndn::Interest &interest) {
+	m_nHitCount[parseCommand(interest.getName(), 1)] += 1;
+}
+
+void
+CsCounter::countMiss(const ::ndn::Interest &interest) {
+	m_nMissCount[parseCommand(interest.getName(), 1)] += 1;
+}
+
+void
+CsCounter::Report() const {
+	static const DrnCommand commands[] = { CMD_TS, CMD_TM, CMD_DM, CMD_DR };
+
+	uint64_t hits = 0;
+	uint64_t lookups = 0;
+	for (DrnCommand cmd : commands) {
+		uint64_t count = m_nHitCount[cmd] + m_nMissCount[cmd];
+		hits += m_nHitCount[cmd];
+		lookups += count;
+		NS_LOG_INFO(stringf("CS %s hit: %8llu / %8llu, ratio %.3f", commandName(cmd), (unsigned long long)m_nHitCount[cmd],
+				(unsigned long long)count, (0 < count) ? (double)m_nHitCount[cmd] / count : 0.0));
+	}
+	NS_LOG_INFO(stringf("CS TS-DR hit: %8llu / %8llu, ratio %.3f", (unsigned long long)hits, (unsigned long long)lookups,
+			(0 < lookups) ? (double)hits / lookups : 0.0));
+}
@@ -0,0 +1,61 @@
+/*
+ * cs-counter.hpp
+ *
+ * content store hits and misses of the NFD forwarders of all nodes, per DRN command of the
+ * Interest name(/RN/{cmd}/..., /RN-{xxx}/{cmd}/...).
+ *
+ * with the cacheable TS/TM names(ConsumerDrn ManifestSlot, RendezvousDrnF TMFreshness, ...) the
+ * hit ratio of TS/TM is the part of the polls answered on the path instead of by the owner RN.
+ */
+
+#ifndef EXTENSIONS_CS_COUNTER_HPP_
+#define EXTENSIONS_CS_COUNTER_HPP_
+
+#include <cstdint>
+
+#include "ns3/core-module.h"
+
+#include <ndn-cxx/interest.hpp>
+
+#include "drn-protocol.hpp"
+
+class CsCounter : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	CsCounter();
+
+	/**
+	 * @brief connect to the forwarders of the nodes with an NDN stack, call after the stack install
+	 */
+	void
+	Install();
+
+	void
+	Report() const;
+
+	uint64_t
+	getHitCount(DrnCommand cmd) const {
+		return m_nHitCount[cmd];
+	}
+
+	uint64_t
+	getMissCount(DrnCommand cmd) const {
+		return m_nMissCount[cmd];
+	}
+
+private:
+	void
+	countHit(const ::ndn::Interest &interest);
+
+	void
+	countMiss(const ::ndn::Interest &interest);
+
+private:
+	uint64_t m_nHitCount[CMD_COUNT];
+	uint64_t m_nMissCount[CMD_COUNT];
+};
+
+#endif /* EXTENSIONS_CS_COUNTER_HPP_ */
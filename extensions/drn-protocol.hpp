@@ -0,0 +1,119 @@
+/*
+ * drn-protocol.hpp
+ *
+ * command components of the DRN names(/RN/{cmd}/..., /RN-{xxx}/{cmd}/...).
+ *
+ * the command is found from the raw bytes of the name component without building a string:
+ * FNV-1a of the bytes selects the case of a switch whose labels are computed at compile time
+ * (duplicated labels do not compile, so the hash is perfect over the table), and one memcmp
+ * confirms the match.
+ */
+
+#ifndef EXTENSIONS_DRN_PROTOCOL_HPP_
+#define EXTENSIONS_DRN_PROTOCOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <ndn-cxx/name.hpp>
+
+// X(enum, component)
+#define DRN_COMMAND_TABLE(X) \
+	/* rendezvous */ \
+	X(CMD_PA, "PA") \
+	X(CMD_PU, "PU") \
+	X(CMD_DP, "DP") \
+	X(CMD_TS, "TS") \
+	X(CMD_TM, "TM") \
+	X(CMD_DM, "DM") \
+	X(CMD_DR, "DR") \
+	/* bulk advertisement: topic names in the parameters */ \
+	X(CMD_PAB, "PAB") \
+	X(CMD_PUB, "PUB") \
+	/* coalesced publish: consecutive sequences in the parameters */ \
+	X(CMD_DPB, "DPB") \
+	/* chord ring */ \
+	X(CMD_JOIN, "join") \
+	X(CMD_STABILIZE, "stabilize") \
+	X(CMD_STORE_KEYS, "storeKeys") \
+	X(CMD_SEND_SUCC_LIST, "sendSuccList") \
+	X(CMD_ALIVE, "alive") \
+	X(CMD_PUT, "put") \
+	X(CMD_GET, "k") \
+	X(CMD_P1, "p1") \
+	X(CMD_P2, "p2") \
+	X(CMD_SUCCESSOR, "successor") \
+	X(CMD_PREDECESSOR, "predecessor") \
+	X(CMD_FINGER, "finger") \
+	X(CMD_GET_KEYS, "getKeys") \
+	X(CMD_CHECK_PREDECESSOR, "checkPredecessor") \
+	X(CMD_CHECK_SUCCESSOR, "checkSuccessor") \
+	X(CMD_UPDATE_SUCCESSOR_LIST, "updateSuccessorList") \
+	X(CMD_FIX_FINGERS, "fixFingers")
+
+#define DRN_COMMAND_ENUM(cmd, str) cmd,
+
+enum DrnCommand : uint8_t {
+	CMD_UNKNOWN = 0,
+	DRN_COMMAND_TABLE(DRN_COMMAND_ENUM)
+	CMD_COUNT
+};
+
+#undef DRN_COMMAND_ENUM
+
+static constexpr uint32_t
+commandHash(const char *str, size_t size, uint32_t hash = 2166136261u) {
+	return size == 0 ? hash : commandHash(str + 1, size - 1, (hash ^ (uint8_t)*str) * 16777619u);
+}
+
+inline const char *
+commandName(DrnCommand cmd) {
+#define DRN_COMMAND_NAME(cmd, str) str,
+	static const char *const names[CMD_COUNT] = { "", DRN_COMMAND_TABLE(DRN_COMMAND_NAME) };
+#undef DRN_COMMAND_NAME
+	return cmd < CMD_COUNT ? names[cmd] : "";
+}
+
+inline DrnCommand
+parseCommand(const uint8_t *value, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ value[i]) * 16777619u;
+	}
+
+	DrnCommand cmd;
+	switch (hash) {
+#define DRN_COMMAND_CASE(id, str) case commandHash(str, sizeof(str) - 1): cmd = id; break;
+	DRN_COMMAND_TABLE(DRN_COMMAND_CASE)
+#undef DRN_COMMAND_CASE
+	default:
+		return CMD_UNKNOWN;
+	}
+
+	const char *name = commandName(cmd);
+	if (std::strlen(name) != size || std::memcmp(name, value, size) != 0) {
+		return CMD_UNKNOWN;
+	}
+
+	return cmd;
+}
+
+inline DrnCommand
+parseCommand(const ::ndn::name::Component &component) {
+	return parseCommand(component.value(), component.value_size());
+}
+
+/**
+ * command at index of name, CMD_UNKNOWN if name is shorter
+ */
+inline DrnCommand
+parseCommand(const ::ndn::Name &name, size_t index) {
+	if (name.size() <= index) {
+		return CMD_UNKNOWN;
+	}
+
+	return parseCommand(name.get(index));
+}
+
+#endif /* EXTENSIONS_DRN_PROTOCOL_HPP_ */
@@ -0,0 +1,169 @@
+/*
+ * event-tracer.cpp
+ */
+
+#include "event-tracer.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "ns3/network-module.h"
+
+#include "drn-protocol.hpp"
+
+static const char TRACE_MAGIC[8] = { 'D', 'R', 'N', 'T', 'R', 'C', '0', '1' };
+
+EventTracer &
+EventTracer::Get() {
+	static EventTracer tracer;
+	return tracer;
+}
+
+EventTracer::EventTracer()
+	: m_header(nullptr)
+	, m_records(nullptr)
+	, m_mask(0)
+	, m_size(0)
+{
+}
+
+EventTracer::~EventTracer() {
+	// 다른 static 객체(NameInterner)가 먼저 사라질 수 있으므로 names 파일은 close()에서만 쓴다
+	if (m_header != nullptr) {
+		::munmap(m_header, m_size);
+	}
+}
+
+int
+EventTracer::open(const std::string &path, uint64_t capacity) {
+	if (isOpen()) {
+		close();
+	}
+
+	uint64_t records = 1;
+	while (records < capacity) {
+		records <<= 1;
+	}
+
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		return -1;
+	}
+
+	size_t size = sizeof(TraceHeader) + records * sizeof(TraceRecord);
+	if (::ftruncate(fd, size) != 0) {
+		::close(fd);
+		return -1;
+	}
+
+	void *map = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) {
+		return -1;
+	}
+
+	m_path = path;
+	m_size = size;
+	m_mask = records - 1;
+	m_header = (TraceHeader *)map;
+	m_records = (TraceRecord *)((uint8_t *)map + sizeof(TraceHeader));
+
+	std::memset(m_header, 0, sizeof(TraceHeader));
+	std::memcpy(m_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	m_header->version = 1;
+	m_header->recordSize = sizeof(TraceRecord);
+	m_header->capacity = records;
+
+	return 0;
+}
+
+void
+EventTracer::close() {
+	if (m_header == nullptr) {
+		return;
+	}
+
+	// 실행이 중간에 끊겨도 ring buffer 는 파일에 남는다
+	::munmap(m_header, m_size);
+	m_header = nullptr;
+	m_records = nullptr;
+
+	writeNames(m_path + ".names");
+}
+
+uint64_t
+EventTracer::getCount() const {
+	return m_header != nullptr ? m_header->count : 0;
+}
+
+void
+EventTracer::recordName(TraceEvent event, uint32_t node, const ::ndn::Name &name, size_t commandIndex, uint32_t value) {
+	NameInterner &interner = NameInterner::Get();
+	DrnCommand cmd = parseCommand(name, commandIndex);
+
+	size_t first = commandIndex + 1;
+	// regional DM/DR: /RN/DM/RN-{nnnnn}/{topic}
+	if (first + 1 < name.size()) {
+		const ::ndn::name::Component &component = name.get(first);
+		if (3 < component.value_size() && std::memcmp(component.value(), "RN-", 3) == 0) {
+			first += 1;
+		}
+	}
+	if (name.size() <= first) {
+		record(event, cmd, node, NAME_ID_NONE, TRACE_NO_SEQ, value);
+		return;
+	}
+
+	NameId topic = interner.find(name.getSubName(first));
+	uint64_t seq = TRACE_NO_SEQ;
+	if (topic == NAME_ID_NONE && first + 1 < name.size()) {
+		// {topic}/{seq}
+		const ::ndn::name::Component &last = name.get(-1);
+		std::string digits((const char *)last.value(), last.value_size());
+		char *end = nullptr;
+		uint64_t number = std::strtoull(digits.c_str(), &end, 10);
+		if (0 < digits.size() && *end == '\0') {
+			seq = number;
+			topic = interner.find(name.getSubName(first, name.size() - 1 - first));
+		}
+	}
+
+	record(event, cmd, node, topic, seq, value);
+}
+
+/**
+ * {path}.names: "<kind>\t<id>\t<name>" lines of the events, commands, nodes and topics,
+ * the decoder's lookup tables
+ */
+int
+EventTracer::writeNames(const std::string &path) {
+	std::ofstream file(path.c_str(), std::ios::trunc);
+	if (!file.is_open()) {
+		return -1;
+	}
+
+#define DRN_TRACE_EVENT_LINE(id, name) file << "event\t" << (uint32_t)id << "\t" << name << "\n";
+	DRN_TRACE_EVENT_TABLE(DRN_TRACE_EVENT_LINE)
+#undef DRN_TRACE_EVENT_LINE
+
+	for (uint32_t cmd = 1; cmd < CMD_COUNT; cmd++) {
+		file << "command\t" << cmd << "\t" << commandName((DrnCommand)cmd) << "\n";
+	}
+
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		std::string name = ns3::Names::FindName(ns3::NodeList::GetNode(id));
+		file << "node\t" << id << "\t" << (name.empty() ? std::to_string(id) : name) << "\n";
+	}
+
+	NameInterner &interner = NameInterner::Get();
+	for (NameId id = 0; id < interner.size(); id++) {
+		file << "topic\t" << id << "\t" << interner.getUri(id) << "\n";
+	}
+
+	return file.good() ? 0 : -1;
+}
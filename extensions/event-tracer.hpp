@@ -0,0 +1,153 @@
+/*
+ * event-tracer.hpp
+ *
+ * binary event trace of the DRN apps, next to the NS_LOG_DEBUG lines of the packet paths.
+ * RendezvousDrnF, ProducerDrn, ConsumerDrn and TimeoutApp record, drnf-rocketfuel opens it(--trace).
+ * the chord RendezvousDrn and RendezvousDHT of drn-rocketfuel are not instrumented, they keep NS_LOG only.
+ *
+ *  - record : 32 byte (time, seq, node, topic id, event, command, value), written into a memory mapped
+ *             ring buffer file, the oldest records are overwritten when it is full
+ *  - names  : at close() the topic ids, node ids, events and commands are written to {path}.names
+ *  - decode : trace-decode.py {path} [--csv]
+ *
+ * nothing is formatted while the simulation runs, and an unopened tracer costs one branch per record.
+ */
+
+#ifndef EXTENSIONS_EVENT_TRACER_HPP_
+#define EXTENSIONS_EVENT_TRACER_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include <ndn-cxx/name.hpp>
+
+#include "ns3/simulator.h"
+
+#include "name-interner.hpp"
+
+// X(enum, name)
+#define DRN_TRACE_EVENT_TABLE(X) \
+	X(TRACE_SEND_INTEREST, "send-interest") \
+	X(TRACE_RECV_INTEREST, "recv-interest") \
+	X(TRACE_SEND_DATA, "send-data") \
+	X(TRACE_RECV_DATA, "recv-data") \
+	X(TRACE_RECV_NACK, "recv-nack") \
+	X(TRACE_STORE, "store") \
+	X(TRACE_TIMEOUT, "timeout")
+
+#define DRN_TRACE_EVENT_ENUM(id, name) id,
+enum TraceEvent : uint8_t {
+	TRACE_NONE = 0,
+	DRN_TRACE_EVENT_TABLE(DRN_TRACE_EVENT_ENUM)
+	TRACE_EVENT_COUNT
+};
+#undef DRN_TRACE_EVENT_ENUM
+
+static const uint64_t TRACE_NO_SEQ = 0xffffffffffffffffULL;
+
+struct TraceHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t capacity;
+	// records written, the ring holds the last min(count, capacity)
+	uint64_t count;
+	uint8_t reserved[32];
+};
+
+struct TraceRecord
+{
+	// simulation time(ns)
+	int64_t time;
+	uint64_t seq;
+	uint32_t node;
+	NameId topic;
+	uint8_t event;
+	uint8_t command;
+	uint16_t reserved;
+	// event specific: content bytes, list size
+	uint32_t value;
+};
+
+class EventTracer
+{
+public:
+	/**
+	 * @brief the tracer shared by all apps
+	 */
+	static EventTracer &
+	Get();
+
+	EventTracer();
+
+	~EventTracer();
+
+	/**
+	 * @brief map a ring buffer of capacity(rounded up to a power of 2) records at path, -1 on error
+	 */
+	int
+	open(const std::string &path, uint64_t capacity);
+
+	/**
+	 * @brief unmap the ring buffer and write {path}.names
+	 */
+	void
+	close();
+
+	bool
+	isOpen() const {
+		return m_records != nullptr;
+	}
+
+	void
+	record(TraceEvent event, uint8_t command, uint32_t node, NameId topic, uint64_t seq = TRACE_NO_SEQ, uint32_t value = 0) {
+		if (m_records == nullptr) {
+			return;
+		}
+
+		TraceRecord &entry = m_records[m_header->count & m_mask];
+		entry.time = ns3::Simulator::Now().GetNanoSeconds();
+		entry.seq = seq;
+		entry.node = node;
+		entry.topic = topic;
+		entry.event = event;
+		entry.command = command;
+		entry.reserved = 0;
+		entry.value = value;
+
+		m_header->count += 1;
+	}
+
+	/**
+	 * @brief record of a DRN name /{RN|RN-nnnnn}/{command}[/RN-{nnnnn}]/{topic}[/{seq}].
+	 * the topic is looked up only when the tracer is open
+	 */
+	void
+	record(TraceEvent event, uint32_t node, const ::ndn::Name &name, uint32_t value = 0, size_t commandIndex = 1) {
+		if (m_records == nullptr) {
+			return;
+		}
+
+		recordName(event, node, name, commandIndex, value);
+	}
+
+	uint64_t
+	getCount() const;
+
+private:
+	void
+	recordName(TraceEvent event, uint32_t node, const ::ndn::Name &name, size_t commandIndex, uint32_t value);
+
+	int
+	writeNames(const std::string &path);
+
+private:
+	std::string m_path;
+	TraceHeader *m_header;
+	TraceRecord *m_records;
+	uint64_t m_mask;
+	size_t m_size;
+};
+
+#endif /* EXTENSIONS_EVENT_TRACER_HPP_ */
@@ -0,0 +1,73 @@
+/*
+ * manifest-name.hpp
+ *
+ * name components after the topic of the TS/TM names: the time slot of the cacheable names(ConsumerDrn ManifestSlot)
+ * and the page token of the paged binary manifests(topic-manifest.hpp).
+ *
+ *   /RN/TM/a/b/c[/{page token}][/{slot}]
+ */
+
+#ifndef EXTENSIONS_MANIFEST_NAME_HPP_
+#define EXTENSIONS_MANIFEST_NAME_HPP_
+
+#include <cstdint>
+
+#include <ndn-cxx/name.hpp>
+
+/**
+ * time slot of a cacheable TS/TM name: /RN/TM/a/b/c/{version slot}
+ * the consumers of a topic ask the same name during a slot, so PIT aggregation and the content
+ * stores answer them instead of the owner RN.
+ */
+inline ::ndn::Name &
+appendSlot(::ndn::Name &name, uint64_t slot) {
+	return name.appendVersion(slot);
+}
+
+inline bool
+hasSlot(const ::ndn::Name &name) {
+	return 0 < name.size() && name.get(-1).isVersion();
+}
+
+/**
+ * topic name without the slot component
+ */
+inline ::ndn::Name
+stripSlot(const ::ndn::Name &topicName) {
+	if (hasSlot(topicName)) {
+		return topicName.getPrefix(-1);
+	}
+
+	return topicName;
+}
+
+/**
+ * continuation token of a paged TM answer: /RN/TM/a/b/*/{sequence number token}[/{slot}]
+ * the first page asks token 0, the next pages ask the token of the previous answer. every TM to a binary manifest RN
+ * carries a token(ConsumerDrn BinaryManifest), so the name of a page is never a prefix of another page(TM Interests
+ * are CanBePrefix). the text answers of DrnF and Drn have no pages and their TM no token.
+ */
+inline ::ndn::Name &
+appendPageToken(::ndn::Name &name, uint64_t token) {
+	return name.appendSequenceNumber(token);
+}
+
+inline bool
+hasPageToken(const ::ndn::Name &name) {
+	return 0 < name.size() && name.get(-1).isSequenceNumber();
+}
+
+/**
+ * topic name without the slot and the page token
+ */
+inline ::ndn::Name
+stripPageToken(const ::ndn::Name &topicName) {
+	::ndn::Name name = stripSlot(topicName);
+	if (hasPageToken(name)) {
+		return name.getPrefix(-1);
+	}
+
+	return name;
+}
+
+#endif /* EXTENSIONS_MANIFEST_NAME_HPP_ */
@@ -0,0 +1,112 @@
+/*
+ * memory-sampler.cpp
+ */
+
+#include "memory-sampler.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "ns3/network-module.h"
+
+#include "ndn-timeout-app.hpp"
+#include "sim-stats.hpp"
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.MemorySampler");
+
+NS_OBJECT_ENSURE_REGISTERED(MemorySampler);
+
+ns3::TypeId
+MemorySampler::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("MemorySampler")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<MemorySampler>()
+
+			.AddAttribute("File", "Time series file of the table sizes", ns3::StringValue(""),
+							ns3::MakeStringAccessor(&MemorySampler::m_file), ns3::MakeStringChecker())
+
+			.AddAttribute("Interval", "Time between samples", ns3::StringValue("10s"),
+							ns3::MakeTimeAccessor(&MemorySampler::m_interval), ns3::MakeTimeChecker())
+			;
+
+	return tid;
+}
+
+MemorySampler::MemorySampler()
+	: m_nSampleCount(0)
+{
+}
+
+MemorySampler::~MemorySampler() {
+}
+
+int
+MemorySampler::Install() {
+	m_output.open(m_file.c_str(), std::ios::trunc);
+	if (!m_output.is_open()) {
+		return -1;
+	}
+
+	m_output << "time\tnode\tapp\ttable\tentries\tbytes\n";
+	ns3::Simulator::Schedule(m_interval, &MemorySampler::Sample, this);
+
+	return 0;
+}
+
+void
+MemorySampler::Sample() {
+	double now = ns3::Simulator::Now().GetSeconds();
+
+	m_totals.clear();
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(id);
+		std::string name = ns3::Names::FindName(node);
+		if (name.empty()) {
+			name = std::to_string(id);
+		}
+
+		for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+			ns3::Ptr<TimeoutApp> app = ns3::DynamicCast<TimeoutApp>(node->GetApplication(i));
+			if (app == 0) {
+				continue;
+			}
+
+			MemoryUsage usage;
+			app->GetMemoryUsage(usage);
+
+			std::string appName = app->GetInstanceTypeId().GetName();
+			for (const TableUsage &table : usage) {
+				m_output << stringf("%.3f\t%s\t%s\t%s\t%llu\t%llu\n", now, name.c_str(), appName.c_str(), table.table,
+						(unsigned long long)table.entries, (unsigned long long)table.bytes);
+
+				std::pair<uint64_t, uint64_t> &total = m_totals[appName + "::" + table.table];
+				total.first += table.entries;
+				total.second += table.bytes;
+			}
+		}
+	}
+	m_output << stringf("%.3f\tprocess\t-\theap\t0\t%llu\n", now, (unsigned long long)SimStats::getHeapInUse());
+	m_output.flush();
+
+	m_nSampleCount += 1;
+	ns3::Simulator::Schedule(m_interval, &MemorySampler::Sample, this);
+}
+
+void
+MemorySampler::Report() {
+	std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> totals(m_totals.begin(), m_totals.end());
+	std::sort(totals.begin(), totals.end(), [](const std::pair<std::string, std::pair<uint64_t, uint64_t>> &a,
+			const std::pair<std::string, std::pair<uint64_t, uint64_t>> &b) {
+		return a.second.second > b.second.second;
+	});
+
+	NS_LOG_INFO(stringf("Memory SampleCount: %5u", m_nSampleCount));
+	for (const std::pair<std::string, std::pair<uint64_t, uint64_t>> &total : totals) {
+		NS_LOG_INFO(stringf("Memory %-30s %10llu entries %12llu bytes", total.first.c_str(),
+				(unsigned long long)total.second.first, (unsigned long long)total.second.second));
+	}
+}
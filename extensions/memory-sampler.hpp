@@ -0,0 +1,55 @@
+/*
+ * memory-sampler.hpp
+ *
+ * time series of the state table sizes of the DRN apps(TimeoutApp::GetMemoryUsage).
+ *
+ *  - every Interval : one line per (node, app, table) "<seconds>\t<node>\t<app>\t<table>\t<entries>\t<bytes>"
+ *                     and a "process heap" line of the bytes allocated from the heap
+ *  - Report()       : totals per table of the last sample, largest first
+ */
+
+#ifndef EXTENSIONS_MEMORY_SAMPLER_HPP_
+#define EXTENSIONS_MEMORY_SAMPLER_HPP_
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "ns3/core-module.h"
+
+class MemorySampler : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	MemorySampler();
+
+	virtual
+	~MemorySampler();
+
+	/**
+	 * @brief open File and schedule the samples, -1 on error
+	 */
+	int
+	Install();
+
+	void
+	Report();
+
+private:
+	void
+	Sample();
+
+private:
+	std::string m_file;
+	ns3::Time m_interval;
+
+	std::ofstream m_output;
+	uint32_t m_nSampleCount;
+
+	// table -> (entries, bytes) of the last sample
+	std::map<std::string, std::pair<uint64_t, uint64_t>> m_totals;
+};
+
+#endif /* EXTENSIONS_MEMORY_SAMPLER_HPP_ */
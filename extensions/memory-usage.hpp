@@ -0,0 +1,99 @@
+/*
+ * memory-usage.hpp
+ *
+ * size estimators of the state tables of the DRN apps, sampled by MemorySampler.
+ *
+ * an estimate is the heap of the container nodes(node header + value + malloc chunk overhead) and of
+ * what the values own(name components, buffers, strings longer than the small string buffer).
+ * shared objects(interned names, Interest packets) are counted by the table that keeps them alive.
+ */
+
+#ifndef EXTENSIONS_MEMORY_USAGE_HPP_
+#define EXTENSIONS_MEMORY_USAGE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/encoding/buffer.hpp>
+#include <ndn-cxx/name.hpp>
+
+struct TableUsage
+{
+	const char *table;
+	uint64_t entries;
+	uint64_t bytes;
+};
+
+typedef std::vector<TableUsage> MemoryUsage;
+
+// glibc malloc: 8 byte header, 16 byte alignment
+static inline uint64_t
+heapChunk(uint64_t bytes) {
+	return (bytes + 8 + 15) & ~(uint64_t)15;
+}
+
+// red black tree node: color, parent, left, right + value
+template<typename T>
+static inline uint64_t
+treeNodeBytes() {
+	return heapChunk(4 * sizeof(void *) + sizeof(T));
+}
+
+template<typename K, typename V>
+static inline uint64_t
+mapBytes(const std::map<K, V> &map) {
+	return map.size() * treeNodeBytes<std::pair<const K, V>>();
+}
+
+template<typename K>
+static inline uint64_t
+setBytes(const std::set<K> &set) {
+	return set.size() * treeNodeBytes<K>();
+}
+
+static inline uint64_t
+stringBytes(const std::string &value) {
+	return (15 < value.capacity()) ? heapChunk(value.capacity() + 1) : 0;
+}
+
+static inline uint64_t
+bufferBytes(const ::ndn::Buffer &buffer) {
+	return heapChunk(sizeof(::ndn::Buffer)) + heapChunk(buffer.capacity());
+}
+
+// components vector and their values, the wire encoding is not cached by the tables
+static inline uint64_t
+nameBytes(const ::ndn::Name &name) {
+	uint64_t bytes = heapChunk(name.size() * sizeof(::ndn::name::Component));
+	for (const ::ndn::name::Component &component : name) {
+		bytes += heapChunk(component.size());
+	}
+
+	return bytes;
+}
+
+static inline uint64_t
+bufferListBytes(const std::vector<std::shared_ptr<::ndn::Buffer>> &list) {
+	uint64_t bytes = heapChunk(sizeof(list)) + heapChunk(list.capacity() * sizeof(list[0]));
+	for (const std::shared_ptr<::ndn::Buffer> &buffer : list) {
+		bytes += bufferBytes(*buffer);
+	}
+
+	return bytes;
+}
+
+static inline uint64_t
+stringListBytes(const std::vector<std::string> &list) {
+	uint64_t bytes = heapChunk(sizeof(list)) + heapChunk(list.capacity() * sizeof(list[0]));
+	for (const std::string &value : list) {
+		bytes += stringBytes(value);
+	}
+
+	return bytes;
+}
+
+#endif /* EXTENSIONS_MEMORY_USAGE_HPP_ */
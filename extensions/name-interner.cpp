@@ -0,0 +1,217 @@
+/*
+ * name-interner.cpp
+ */
+
+#include "name-interner.hpp"
+
+#include <cstring>
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+static const size_t MIN_SLOTS = 1024;
+
+NameInterner &
+NameInterner::Get() {
+	static NameInterner interner;
+	return interner;
+}
+
+NameInterner::NameInterner() {
+	clear();
+}
+
+NameId
+NameInterner::intern(const ::ndn::Name &name) {
+	size_t hash = hashName(name);
+	size_t slot = findSlot(name, hash);
+	if (m_slots[slot] != NAME_ID_NONE) {
+		return m_slots[slot];
+	}
+
+	NameId id = (NameId)m_entries.size();
+	m_entries.push_back(Entry());
+
+	Entry &entry = m_entries.back();
+	for (size_t i = 0; i < name.size(); i++) {
+		const ::ndn::name::Component &component = name.get(i);
+		entry.wire.append((const char *)component.wire(), component.size());
+	}
+	entry.wire.shrink_to_fit();
+	entry.uri = name.toUri();
+	entry.hash = hash;
+	entry.placementHash = -1;
+
+	m_slots[slot] = id;
+
+	// load factor 1/2 이하로 유지한다
+	if (m_slots.size() < m_entries.size() * 2) {
+		grow();
+	}
+
+	return id;
+}
+
+NameId
+NameInterner::intern(const std::string &uri) {
+	std::unordered_map<std::string, NameId>::iterator iter = m_uris.find(uri);
+	if (iter != m_uris.end()) {
+		return iter->second;
+	}
+
+	NameId id = intern(::ndn::Name(uri));
+	m_uris.insert(std::make_pair(uri, id));
+
+	return id;
+}
+
+NameId
+NameInterner::find(const ::ndn::Name &name) const {
+	return m_slots[findSlot(name, hashName(name))];
+}
+
+NameId
+NameInterner::find(const std::string &uri) const {
+	std::unordered_map<std::string, NameId>::const_iterator iter = m_uris.find(uri);
+	if (iter != m_uris.end()) {
+		return iter->second;
+	}
+
+	return find(::ndn::Name(uri));
+}
+
+::ndn::Name
+NameInterner::getName(NameId id) const {
+	const std::string &wire = m_entries.at(id).wire;
+	return ::ndn::Name(::ndn::encoding::makeBinaryBlock(::ndn::tlv::Name, (const uint8_t *)wire.data(), wire.size()));
+}
+
+const std::string &
+NameInterner::getUri(NameId id) const {
+	return m_entries.at(id).uri;
+}
+
+size_t
+NameInterner::getHash(NameId id) const {
+	return m_entries.at(id).hash;
+}
+
+lli
+NameInterner::getPlacementHash(NameId id) {
+	Entry &entry = m_entries.at(id);
+	if (entry.placementHash < 0) {
+		// sha1은 비싸므로 처음 요청될 때 한번만 계산한다
+		::ndn::Name name = getName(id);
+		entry.placementHash = ::getHash(name.size() == 0 ? std::string() : name.get(0).toUri());
+	}
+
+	return entry.placementHash;
+}
+
+lli
+NameInterner::getPlacementHash(const std::string &uri) {
+	return getPlacementHash(intern(uri));
+}
+
+size_t
+NameInterner::size() const {
+	return m_entries.size();
+}
+
+size_t
+NameInterner::memoryUsage() const {
+	size_t bytes = m_entries.size() * sizeof(Entry) + m_slots.capacity() * sizeof(NameId);
+
+	// short strings are stored inside std::string
+	std::deque<Entry>::const_iterator iter = m_entries.begin();
+	for (; iter != m_entries.end(); iter++) {
+		if (iter->wire.capacity() >= sizeof(std::string)) {
+			bytes += iter->wire.capacity() + 1;
+		}
+		if (iter->uri.capacity() >= sizeof(std::string)) {
+			bytes += iter->uri.capacity() + 1;
+		}
+	}
+
+	// unordered_map node: next pointer, key, value, cached hash
+	std::unordered_map<std::string, NameId>::const_iterator uriIter = m_uris.begin();
+	for (; uriIter != m_uris.end(); uriIter++) {
+		bytes += sizeof(void *) + sizeof(std::string) + sizeof(NameId) + sizeof(size_t);
+		if (uriIter->first.capacity() >= sizeof(std::string)) {
+			bytes += uriIter->first.capacity() + 1;
+		}
+	}
+	bytes += m_uris.bucket_count() * sizeof(void *);
+
+	return bytes;
+}
+
+void
+NameInterner::clear() {
+	m_entries.clear();
+	m_slots.assign(MIN_SLOTS, NAME_ID_NONE);
+	m_uris.clear();
+}
+
+/* FNV-1a over the component TLVs */
+size_t
+NameInterner::hashName(const ::ndn::Name &name) {
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < name.size(); i++) {
+		const ::ndn::name::Component &component = name.get(i);
+		const uint8_t *wire = component.wire();
+		for (size_t j = 0; j < component.size(); j++) {
+			hash = (hash ^ wire[j]) * 1099511628211ULL;
+		}
+	}
+
+	return (size_t)hash;
+}
+
+bool
+NameInterner::equals(const ::ndn::Name &name, const std::string &wire) {
+	size_t offset = 0;
+
+	for (size_t i = 0; i < name.size(); i++) {
+		const ::ndn::name::Component &component = name.get(i);
+		if (wire.size() - offset < component.size() || std::memcmp(wire.data() + offset, component.wire(), component.size()) != 0) {
+			return false;
+		}
+		offset += component.size();
+	}
+
+	return offset == wire.size();
+}
+
+/**
+ * name 의 slot, 없으면 넣을 빈 slot(linear probing)
+ */
+size_t
+NameInterner::findSlot(const ::ndn::Name &name, size_t hash) const {
+	size_t mask = m_slots.size() - 1;
+	size_t slot = hash & mask;
+
+	while (m_slots[slot] != NAME_ID_NONE) {
+		const Entry &entry = m_entries[m_slots[slot]];
+		if (entry.hash == hash && equals(name, entry.wire)) {
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+void
+NameInterner::grow() {
+	m_slots.assign(m_slots.size() * 2, NAME_ID_NONE);
+
+	size_t mask = m_slots.size() - 1;
+	for (NameId id = 0; id < m_entries.size(); id++) {
+		size_t slot = m_entries[id].hash & mask;
+		while (m_slots[slot] != NAME_ID_NONE) {
+			slot = (slot + 1) & mask;
+		}
+		m_slots[slot] = id;
+	}
+}
@@ -0,0 +1,134 @@
+/*
+ * name-interner.hpp
+ *
+ * dense 32 bit ids of the topic and node names used by producer, consumer and rendezvous state.
+ *
+ *  - one id per unique ndn::Name, shared by all apps of the simulation
+ *  - the component TLVs, uri, hash and placement hash(getHash of the first component) are kept
+ *    once per id, so maps keyed on ids do not hold a string copy of the name
+ *  - a received Name is found by comparing its component TLVs, without toUri()
+ *  - a uri string given to intern(string) once is resolved without building a Name
+ */
+
+#ifndef EXTENSIONS_NAME_INTERNER_HPP_
+#define EXTENSIONS_NAME_INTERNER_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ndn-cxx/name.hpp>
+
+#include "utils.hpp"
+
+typedef uint32_t NameId;
+
+static const NameId NAME_ID_NONE = 0xffffffff;
+
+typedef std::map<NameId, NameId>::iterator NameIdMapIterator;
+typedef std::map<NameId, BufferListPtr>::iterator NameBufferListMapIterator;
+
+class NameInterner
+{
+public:
+	/**
+	 * @brief the interner shared by all apps
+	 */
+	static NameInterner &
+	Get();
+
+	NameInterner();
+
+	/**
+	 * @brief id of name, a new id is given to a name not seen before
+	 */
+	NameId
+	intern(const ::ndn::Name &name);
+
+	NameId
+	intern(const std::string &uri);
+
+	/**
+	 * @brief id of name, NAME_ID_NONE if it was never interned
+	 */
+	NameId
+	find(const ::ndn::Name &name) const;
+
+	NameId
+	find(const std::string &uri) const;
+
+	/**
+	 * @brief the name rebuilt from its component TLVs
+	 */
+	::ndn::Name
+	getName(NameId id) const;
+
+	const std::string &
+	getUri(NameId id) const;
+
+	size_t
+	getHash(NameId id) const;
+
+	/**
+	 * @brief getHash(first component), the rendezvous placement key of a topic
+	 */
+	lli
+	getPlacementHash(NameId id);
+
+	lli
+	getPlacementHash(const std::string &uri);
+
+	size_t
+	size() const;
+
+	/**
+	 * @brief approximate heap bytes held by the interner
+	 */
+	size_t
+	memoryUsage() const;
+
+	void
+	clear();
+
+private:
+	static size_t
+	hashName(const ::ndn::Name &name);
+
+	size_t
+	findSlot(const ::ndn::Name &name, size_t hash) const;
+
+	void
+	grow();
+
+private:
+	static bool
+	equals(const ::ndn::Name &name, const std::string &wire);
+
+	struct Entry {
+		// component TLVs of the name
+		std::string wire;
+		std::string uri;
+		size_t hash;
+		lli placementHash;
+	};
+
+	// deque: getUri() references and nodeLabel() pointers stay valid while new names are interned
+	std::deque<Entry> m_entries;
+	// open addressing, hash of the name -> id
+	std::vector<NameId> m_slots;
+	// uri strings given to intern(string), also the ones not in canonical form("RN-00001")
+	std::unordered_map<std::string, NameId> m_uris;
+};
+
+/**
+ * @brief RN-{nnnnn} of a one component node name id, the node name format of the TS/TM content
+ */
+inline const char *
+nodeLabel(NameId node) {
+	return NameInterner::Get().getUri(node).c_str() + 1;
+}
+
+#endif /* EXTENSIONS_NAME_INTERNER_HPP_ */
@@ -20,14 +20,24 @@
 #include "ndn-consumer-drn.hpp"
 #include <ns3/ndnSIM/model/ndn-common.hpp>
 #include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+#include "ns3/boolean.h"
 
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/util/random.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <memory>
 
+#include "drn-protocol.hpp"
+#include "event-tracer.hpp"
+#include "manifest-name.hpp"
+#include "negative-reply.hpp"
+#include "scope-profiler.hpp"
+#include "topic-manifest.hpp"
 #include "utils.hpp"
 
 using namespace ns3::ndn;
@@ -62,6 +72,24 @@ ConsumerDrn::GetTypeId() {
 		.AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("4s"),
 						MakeTimeAccessor(&ConsumerDrn::m_interestLifeTime), MakeTimeChecker())
 
+		.AddAttribute("Regional", "Send DM/DR to the regional RN(/RN) instead of the topic RN", BooleanValue(false),
+						MakeBooleanAccessor(&ConsumerDrn::m_regional), MakeBooleanChecker())
+
+		.AddAttribute("ManifestSlot", "Time slot of the TS/TM names, the consumers of a slot share one cacheable name(0: no slot)", StringValue("0s"),
+						MakeTimeAccessor(&ConsumerDrn::m_manifestSlot), MakeTimeChecker())
+
+		.AddAttribute("BinaryManifest", "The RNs answer TM by paged binary manifests(RendezvousDrnF BinaryManifest), the first TM asks page token 0", BooleanValue(false),
+						MakeBooleanAccessor(&ConsumerDrn::m_binaryManifest), MakeBooleanChecker())
+
+		.AddAttribute("SegmentWindow", "DR segments in flight per object(0: one DR per object)", ns3::UintegerValue(0),
+						ns3::MakeUintegerAccessor(&ConsumerDrn::m_segmentWindow), ns3::MakeUintegerChecker<uint32_t>())
+
+		.AddAttribute("MaxBackoff", "Longest wait before a TM/DM retry, the negative replies of an unchanged topic double the wait", StringValue("8s"),
+						MakeTimeAccessor(&ConsumerDrn::m_maxBackoff), MakeTimeChecker())
+
+		.AddAttribute("MaxBackoffDM", "Longest wait before a DM retry, the negative DM replies have no version and always double the wait", StringValue("2s"),
+						MakeTimeAccessor(&ConsumerDrn::m_maxBackoffDM), MakeTimeChecker())
+
 		.AddAttribute("CustomAttributes", "Custom Attributes", PointerValue (),
 						ns3::MakePointerAccessor(&ConsumerDrn::m_objectContainer), 
                         ns3::MakePointerChecker<ObjectContainer>())
@@ -76,7 +104,15 @@ ConsumerDrn::GetTypeId() {
 ConsumerDrn::ConsumerDrn()
 	: m_nSub(100)
 	, m_nTotalDS(200)
+	, m_regional(false)
+	, m_binaryManifest(false)
+	, m_segmentWindow(0)
+	, m_maxBackoff(Seconds(8))
+	, m_maxBackoffDM(Seconds(2))
 	, m_frequency(1.0)
+	, m_fetchStats()
+	, m_retryStats()
+	, m_nWorkloadIndex(0)
 	, m_rng(::ndn::random::getRandomNumberEngine())
 	, m_rangeUniformRandom(0, 60000)
 	, m_nTSInterestCount(0)
@@ -91,6 +127,12 @@ ConsumerDrn::ConsumerDrn()
 	, m_nTMDataCount(0)
 	, m_nDMDataCount(0)
 	, m_nDRDataCount(0)
+	, m_nRedundantDMCount(0)
+	, m_nStaleDMCount(0)
+	, m_nTMPageCount(0)
+	, m_nTMNegativeCount(0)
+	, m_nDMNegativeCount(0)
+	, m_manifestParseStats()
 {
 }
 
@@ -124,6 +166,18 @@ void
 ConsumerDrn::StartApplication() {
 	TimeoutApp::StartApplication();
 	NS_LOG_DEBUG("StartApplication");
+	m_startTime = Simulator::Now();
+
+	m_objectContainer->get("Workload", m_workload);
+	m_objectContainer->get("WorkloadIndex", m_nWorkloadIndex);
+	if (m_workload != 0) {
+		// 정확한 topic 이름 또는 wildcard prefix
+		const std::vector<std::string> &subscriptions = m_workload->GetSubscriptions(m_nWorkloadIndex);
+		for (uint32_t i = 0; i < subscriptions.size(); i++) {
+			ns3::Simulator::Schedule(ns3::MilliSeconds(0), &ConsumerDrn::sendInterestTS, this, subscriptions[i]);
+		}
+		return;
+	}
 
 	std::vector<std::string> availableSubscriptions;
 	for (uint32_t i = 0; i < m_nTotalDS; i++) {
@@ -170,6 +224,200 @@ ConsumerDrn::StopApplication() {
 	NS_LOG_INFO(stringf("Recv TMDataCount:     %5u", m_nTMDataCount));
 	NS_LOG_INFO(stringf("Recv DMDataCount:     %5u", m_nDMDataCount));
 	NS_LOG_INFO(stringf("Recv DRDataCount:     %5u", m_nDRDataCount));
+	NS_LOG_INFO(stringf("Skip RedundantDMCount: %5u", m_nRedundantDMCount));
+	NS_LOG_INFO(stringf("Skip StaleDMCount:    %5u", m_nStaleDMCount));
+	NS_LOG_INFO(stringf("Send TMPageCount:     %5u", m_nTMPageCount));
+	NS_LOG_INFO(stringf("Recv TMNegativeCount: %5u", m_nTMNegativeCount));
+	NS_LOG_INFO(stringf("Recv DMNegativeCount: %5u", m_nDMNegativeCount));
+
+	m_retryStats.seconds = (Simulator::Now() - m_startTime).GetSeconds();
+	const RetryStats &retry = m_retryStats;
+	if (0 < retry.firstDeliveries) {
+		NS_LOG_INFO(stringf("First delivery: %llu topics, %.3f s/topic", (unsigned long long)retry.firstDeliveries,
+					retry.firstDeliverySeconds / retry.firstDeliveries));
+	}
+
+	const ManifestParseStats &parse = m_manifestParseStats;
+	if (0 < parse.entries) {
+		NS_LOG_INFO(stringf("TM manifest: %llu entries, %.2f bytes/entry, parse %.1f ns/entry",
+					(unsigned long long)parse.entries, (double)parse.bytes / parse.entries, parse.seconds * 1e9 / parse.entries));
+	}
+
+	const FetchStats &stats = m_fetchStats;
+	if (0 < stats.objects) {
+		NS_LOG_INFO(stringf("Fetch: objects %llu, %.1f KB/object, %.1f segments/object, %.3f Mbps, %.3f s/object, fetching %u",
+					(unsigned long long)stats.objects, stats.bytes / 1024.0 / stats.objects, (double)stats.segments / stats.objects,
+					(0 < stats.seconds) ? stats.bytes * 8 / stats.seconds / 1e6 : 0.0, stats.seconds / stats.objects, (uint32_t)m_fetches.size()));
+	}
+
+	MemoryUsage usage;
+	GetMemoryUsage(usage);
+	for (const TableUsage &table : usage) {
+		if (std::string(table.table) == "subscriptions") {
+			NS_LOG_INFO(stringf("Subscriptions:        %5llu, %.1f bytes/subscription", (unsigned long long)table.entries,
+						(0 < table.entries) ? (double)table.bytes / table.entries : 0.0));
+		}
+	}
+}
+
+void
+ConsumerDrn::appendCurrentSlot(::ndn::Name &interestName, ::ndn::Interest &interest) {
+	if (!m_manifestSlot.IsStrictlyPositive()) {
+		return;
+	}
+
+	// slot 이름은 slot 동안 같은 응답이므로 content store의 Data도 받는다.
+	// ns 단위: 1ms 보다 짧은 slot도 0 으로 나누지 않고, ms 로 잘리지 않는다
+	appendSlot(interestName, Simulator::Now().GetNanoSeconds() / m_manifestSlot.GetNanoSeconds());
+	interest.setMustBeFresh(false);
+}
+
+Subscription &
+ConsumerDrn::getSubscription(NameId topicId) {
+	std::map<NameId, Subscription>::iterator mapIter = m_subscriptions.find(topicId);
+	if (mapIter == m_subscriptions.end()) {
+		Subscription subscription;
+		subscription.requestedSequence = -1;
+		subscription.deliveredSequence = -1;
+		mapIter = m_subscriptions.insert(std::make_pair(topicId, subscription)).first;
+	}
+
+	return mapIter->second;
+}
+
+Name
+ConsumerDrn::getTopicName(const Name &interestName, Name &nodeName) {
+	// /RN-yyyyy/DM/a/b/c/topic-0, regional: /RN/DM/RN-yyyyy/a/b/c/topic-0
+	if (m_rnPrefix.equals(interestName.getPrefix(m_rnPrefix.size()))) {
+		nodeName = interestName.getSubName(m_rnPrefix.size() + 1, 1);
+		return interestName.getSubName(m_rnPrefix.size() + 2, Name::npos);
+	}
+	nodeName = interestName.getPrefix(1);
+
+	return interestName.getSubName(2, Name::npos);
+}
+
+void
+ConsumerDrn::clearPendingDM(const Name &interestName) {
+	Name nodeName;
+	Name topicName = getTopicName(interestName, nodeName);
+
+	std::map<NameId, Subscription>::iterator mapIter = m_subscriptions.find(NameInterner::Get().find(topicName));
+	if (mapIter == m_subscriptions.end()) {
+		return;
+	}
+
+	NameId nodeId = NameInterner::Get().find(nodeName);
+	for (SubscriptionProducer &producer : mapIter->second.producers) {
+		if (producer.node == nodeId) {
+			producer.pendingDM = false;
+		}
+	}
+}
+
+void
+ConsumerDrn::clearRequestedDR(const Name &interestName) {
+	// /RN-yyyyy/DR/a/b/c/topic-0/3: 다음 DM 응답에서 다시 요청한다.
+	Name nodeName;
+	Name qualifiedName = getTopicName(interestName, nodeName);
+	if (qualifiedName.size() == 0) {
+		return;
+	}
+
+	std::map<NameId, Subscription>::iterator mapIter = m_subscriptions.find(NameInterner::Get().find(qualifiedName.getPrefix(-1)));
+	if (mapIter == m_subscriptions.end()) {
+		return;
+	}
+
+	int64_t seq = std::strtoll(qualifiedName.get(-1).toUri().c_str(), nullptr, 10);
+	if (mapIter->second.requestedSequence == seq) {
+		mapIter->second.requestedSequence = mapIter->second.deliveredSequence;
+	}
+}
+
+void
+ConsumerDrn::startFetch(const string &nodeName, const Name &qualifiedName) {
+	if (m_fetches.find(qualifiedName) != m_fetches.end()) {
+		return;
+	}
+
+	// segment 수는 segment 0 의 FinalBlockId 로 안다
+	SegmentFetch &fetch = m_fetches[qualifiedName];
+	fetch.nodeName = nodeName;
+	fetch.segments = 0;
+	fetch.next = 1;
+	fetch.inFlight = 1;
+	fetch.received = 0;
+	fetch.start = Simulator::Now();
+	fetch.bytes = 0;
+
+	sendInterestDRSegment(nodeName, qualifiedName, 0);
+}
+
+void
+ConsumerDrn::sendInterestDRSegment(const string &nodeName, const Name &qualifiedName, uint32_t segment) {
+	// RN-{yyy}/DR/a/b/c/topic-0/3/{segment}, segment는 regional RN 을 거치지 않는다
+	::ndn::Name interestName(nodeName);
+	interestName.append("DR").append(qualifiedName).appendSegment(segment);
+
+	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
+	interest->setName(interestName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	sendInterestTimeout(interest);
+	m_nDRInterestCount += 1;
+}
+
+void
+ConsumerDrn::receiveDataDRSegment(const Data &data) {
+	// /RN-yyyyy/DR/a/b/c/topic-0/3/{segment}
+	const Name &dataName = data.getName();
+	Name qualifiedName = dataName.getSubName(2, dataName.size() - 3);
+	uint64_t segment = dataName.get(-1).toSegment();
+
+	std::map<Name, SegmentFetch>::iterator fetchIter = m_fetches.find(qualifiedName);
+	if (fetchIter == m_fetches.end()) {
+		return;
+	}
+
+	SegmentFetch &fetch = fetchIter->second;
+	if (!data.getFinalBlock()) {
+		// RN에 없는 object: 다음 DM 응답에서 다시 요청한다
+		m_fetches.erase(fetchIter);
+		clearRequestedDR(dataName.getPrefix(-1));
+		return;
+	}
+	if (fetch.segments == 0) {
+		fetch.segments = data.getFinalBlock()->toSegment() + 1;
+		fetch.done.assign(fetch.segments, false);
+	}
+
+	if (segment < fetch.segments && !fetch.done[segment]) {
+		fetch.done[segment] = true;
+		fetch.received += 1;
+		fetch.inFlight -= 1;
+		fetch.bytes += data.getContent().value_size();
+	}
+
+	if (fetch.received == fetch.segments) {
+		m_fetchStats.objects += 1;
+		m_fetchStats.bytes += fetch.bytes;
+		m_fetchStats.segments += fetch.segments;
+		m_fetchStats.seconds += (Simulator::Now() - fetch.start).GetSeconds();
+		m_fetches.erase(fetchIter);
+
+		receiveDataDR(qualifiedName, data.getContent());
+		return;
+	}
+
+	while (fetch.inFlight < m_segmentWindow && fetch.next < fetch.segments) {
+		sendInterestDRSegment(fetch.nodeName, qualifiedName, fetch.next);
+		fetch.next += 1;
+		fetch.inFlight += 1;
+	}
 }
 
 void
@@ -179,9 +427,10 @@ ConsumerDrn::sendInterestTS(string topicPrefix) {
 	interestName.append("TS").append(topicPrefix);
 
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
+	interest->setMustBeFresh(true);
+	appendCurrentSlot(interestName, *interest);
 	interest->setName(interestName);
 	interest->setCanBePrefix(true);
-	interest->setMustBeFresh(true);
 	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
 	interest->setInterestLifetime(interestLifeTime);
 
@@ -197,14 +446,19 @@ ConsumerDrn::sendInterestTS(string topicPrefix) {
 
 void
 ConsumerDrn::sendInterestTM(string topicPrefix) {
-	// RN/TM/a/b/c
+	// RN/TM/a/b/c, binary manifest: RN/TM/a/b/*/{token 0}
+	// 첫 page도 token을 붙인다. 없으면 CanBePrefix로 다음 page가 응답할 수 있다
 	::ndn::Name interestName(m_rnPrefix);
 	interestName.append("TM").append(topicPrefix);
+	if (m_binaryManifest) {
+		appendPageToken(interestName, 0);
+	}
 
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
+	interest->setMustBeFresh(true);
+	appendCurrentSlot(interestName, *interest);
 	interest->setName(interestName);
 	interest->setCanBePrefix(true);
-	interest->setMustBeFresh(true);
 	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
 	interest->setInterestLifetime(interestLifeTime);
 
@@ -218,11 +472,37 @@ ConsumerDrn::sendInterestTM(string topicPrefix) {
 	m_nTMInterestCount += 1;
 }
 
+void
+ConsumerDrn::sendInterestTMPage(string topicPrefix, uint64_t token) {
+	// RN/TM/a/b/*/{token}
+	::ndn::Name interestName(m_rnPrefix);
+	interestName.append("TM").append(topicPrefix);
+	appendPageToken(interestName, token);
+
+	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
+	interest->setMustBeFresh(true);
+	appendCurrentSlot(interestName, *interest);
+	interest->setName(interestName);
+	interest->setCanBePrefix(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	NDN_LOG_DEBUG("send interest: " << interestName);
+
+	sendInterestTimeout(interest);
+	m_nTMInterestCount += 1;
+	m_nTMPageCount += 1;
+}
+
 void
 ConsumerDrn::sendInterestDM(string nodeName, string topicPrefix) {
-	// RN/PA/a/b/c
+	// RN-{yyy}/DM/a/b/c, regional: RN/DM/RN-{yyy}/a/b/c
 	::ndn::Name interestName(nodeName);
 	interestName.append("DM").append(topicPrefix);
+	if (m_regional) {
+		interestName = m_rnPrefix;
+		interestName.append("DM").append(::ndn::Name(nodeName)).append(topicPrefix);
+	}
 
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
 	interest->setName(interestName);
@@ -243,9 +523,13 @@ ConsumerDrn::sendInterestDM(string nodeName, string topicPrefix) {
 
 void
 ConsumerDrn::sendInterestDR(string nodeName, string topicPrefix) {
-	// RN/PA/a/b/c
+	// RN-{yyy}/DR/a/b/c, regional: RN/DR/RN-{yyy}/a/b/c
 	::ndn::Name interestName(nodeName);
 	interestName.append("DR").append(topicPrefix);
+	if (m_regional) {
+		interestName = m_rnPrefix;
+		interestName.append("DR").append(::ndn::Name(nodeName)).append(topicPrefix);
+	}
 
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
 	interest->setName(interestName);
@@ -267,18 +551,25 @@ ConsumerDrn::sendInterestDR(string nodeName, string topicPrefix) {
 void
 ConsumerDrn::OnTimeout(shared_ptr<const Interest> interest) {
 	TimeoutApp::OnTimeout(interest);
+	m_retryStats.timeouts += 1;
 
 	const Name &interestName = interest->getName();
 	int32_t prefixSize = m_rnPrefix.size();
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("TS") == 0) {
+	switch (parseCommand(interestName, prefixSize)) {
+	case CMD_TS:
 		m_nTSInterestCount += 1;
-	} else	if (cmd.compare("TM") == 0) {
+		break;
+	case CMD_TM:
 		m_nTMInterestCount += 1;
-	} else	if (cmd.compare("DM") == 0) {
+		break;
+	case CMD_DM:
 		m_nDMInterestCount += 1;
-	} else	if (cmd.compare("DR") == 0) {
+		break;
+	case CMD_DR:
 		m_nDRInterestCount += 1;
+		break;
+	default:
+		break;
 	}
 	NS_LOG_DEBUG(interestName);
 }
@@ -298,12 +589,13 @@ ConsumerDrn::OnData(shared_ptr<const Data> data) {
 	uint32_t rnPrefixSize = m_rnPrefix.size();
 	Name prefix = dataName.getSubName(0, rnPrefixSize);
 	if (prefix.equals(m_rnPrefix)) {
-		string cmd = dataName.get(rnPrefixSize).toUri();
-		if (cmd.compare("TS") == 0) {
+		DrnCommand cmd = parseCommand(dataName, rnPrefixSize);
+		DRN_PROFILE_COMMAND("ConsumerDrn", "OnData", cmd);
+		if (cmd == CMD_TS) {
 			m_nTSDataCount += 1;
 
 			int32_t attentionIndex = rnPrefixSize + 1;
-			Name topicName = dataName.getSubName(attentionIndex, Name::npos);
+			Name topicName = stripSlot(dataName.getSubName(attentionIndex, Name::npos));
 
 			// data /RN/TS/a/b/* 를 받음
 			ns3::Time delay(ns3::MilliSeconds(0));
@@ -330,16 +622,28 @@ ConsumerDrn::OnData(shared_ptr<const Data> data) {
 				ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestTM, this, topicName.toUri());
 			}
             */
-		} else if (cmd.compare("TM") == 0) {
+		} else if (cmd == CMD_TM) {
 			m_nTMDataCount += 1;
 
 			// /RN-yyyyy/TM/a/b/c : (/a/b/c, RN-00001)
 			// /RN-yyyyy/TM/a/b/* : (/a/b/c, RN-00001)|(/a/b/d, RN-00002)
 			int32_t attentionIndex = rnPrefixSize + 1;
-			Name topicName = dataName.getSubName(attentionIndex, Name::npos);
+			Name topicName = stripPageToken(dataName.getSubName(attentionIndex, Name::npos));
 			string topic = topicName.toUri();
 
 			const Block &content = data->getContent();
+			if (isNegativeReply(content.value(), content.value_size())) {
+				receiveNegativeReply(CMD_TM, "", topicName, content);
+				return;
+			}
+			if (!m_backoffs.empty()) {
+				m_backoffs.erase(getRetryKey(CMD_TM, "", topicName));
+			}
+			if (TopicManifest::isManifest(content.value(), content.value_size())) {
+				receiveDataTMManifest(topicName, content);
+				return;
+			}
+			std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
 			if (0 < content.elements_size()) {
 				content.parse();
 			}
@@ -358,95 +662,271 @@ ConsumerDrn::OnData(shared_ptr<const Data> data) {
 				NDN_LOG_DEBUG(pair.first << " : " << pair.second);
 			}
 
+			std::vector<std::pair<std::string, std::string>> producers;
 			stringIterator = producerList.begin();
 			for (;stringIterator != producerList.end(); stringIterator ++) {
 				if (stringIterator->size() == 0) {
 					continue;
 				}
-				std::pair<std::string, std::string> pair = parsePair(*stringIterator, ':');
-
-				StringListMapIterator stringListPtrIter;
-				StringListPtr stringListPtr;
-				stringListPtrIter = m_publishNodes.find(pair.first);
-				if (stringListPtrIter == m_publishNodes.end()) {
-					stringListPtr = make_shared<std::vector<string>>();
-					m_publishNodes.insert(std::pair<string, StringListPtr>(pair.first, stringListPtr));
-				} else {
-					stringListPtr = stringListPtrIter->second;
-				}
-				stringListPtr->push_back(pair.second);
+				producers.push_back(parsePair(*stringIterator, ':'));
+			}
+			m_manifestParseStats.answers += 1;
+			m_manifestParseStats.entries += producers.size();
+			m_manifestParseStats.bytes += content.value_size();
+			m_manifestParseStats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - parseStart).count();
 
-				ns3::Time delay(ns3::MilliSeconds(0));
-				ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDM, this, pair.second, pair.first);
+			for (const std::pair<std::string, std::string> &pair : producers) {
+				receiveTopicProducer(pair.first, pair.second);
 			}
+		} else if (cmd == CMD_DM) {
+			// regional: /RN/DM/RN-yyyyy/a/b/c/topic-0
+			m_nDMDataCount += 1;
+
+			int32_t nodeIndex = rnPrefixSize + 1;
+			Name topicName = dataName.getSubName(nodeIndex + 1, Name::npos);
+
+			receiveDataDM(dataName.get(nodeIndex).toUri(), topicName, data->getContent());
+		} else if (cmd == CMD_DR) {
+			// regional: /RN/DR/RN-yyyyy/a/b/c/topic-0/0
+			m_nDRDataCount += 1;
+
+			int32_t nodeIndex = rnPrefixSize + 1;
+			Name topicName = dataName.getSubName(nodeIndex + 1, Name::npos);
+
+			receiveDataDR(topicName, data->getContent());
 		}
 	} else {
 		// RN-yyyyy/{cmd}/...
 		uint32_t rnPrefixSize = 1;
-		string cmd = dataName.get(rnPrefixSize).toUri();
-		if (cmd.compare("DM") == 0) {
+		DrnCommand cmd = parseCommand(dataName, rnPrefixSize);
+		DRN_PROFILE_COMMAND("ConsumerDrn", "OnDataRNXXX", cmd);
+		if (cmd == CMD_DM) {
 			m_nDMDataCount += 1;
 
 			int32_t attentionIndex = rnPrefixSize + 1;
 			Name nodeName(dataName.getPrefix(rnPrefixSize));
 			Name topicName = dataName.getSubName(attentionIndex, Name::npos);
-			string topic = topicName.toUri();
 
-			const Block &content = data->getContent();
-			if (0 < content.elements_size()) {
-				content.parse();
-			}
+			receiveDataDM(nodeName.get(0).toUri(), topicName, data->getContent());
+		} else if (cmd == CMD_DR && dataName.get(-1).isSegment()) {
+			m_nDRDataCount += 1;
+
+			receiveDataDRSegment(*data);
+		} else if (cmd == CMD_DR) {
+			m_nDRDataCount += 1;
+
+			int32_t attentionIndex = rnPrefixSize + 1;
+			Name topicName = dataName.getSubName(attentionIndex, Name::npos);
+
+			receiveDataDR(topicName, data->getContent());
+		}
+	}
+}
+
+void
+ConsumerDrn::receiveDataTMManifest(const Name &topicName, const Block &content) {
+	std::chrono::steady_clock::time_point parseStart = std::chrono::steady_clock::now();
+	TopicManifest manifest;
+	if (manifest.wireDecode(content.value(), content.value_size()) != 0) {
+		NS_LOG_DEBUG("malformed manifest: " << topicName);
+		return;
+	}
+	m_manifestParseStats.answers += 1;
+	m_manifestParseStats.entries += manifest.getEntries().size();
+	m_manifestParseStats.bytes += content.value_size();
+	m_manifestParseStats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - parseStart).count();
+
+	for (const std::pair<std::string, std::string> &pair : manifest.getEntries()) {
+		receiveTopicProducer(pair.first, pair.second);
+	}
+
+	// 남은 topic은 다음 page로 바로 받는다
+	if (manifest.hasContinuation()) {
+		sendInterestTMPage(topicName.toUri(), manifest.getContinuation());
+	}
+}
+
+void
+ConsumerDrn::receiveTopicProducer(const string &topic, const string &nodeName) {
+	Subscription &subscription = getSubscription(NameInterner::Get().intern(topic));
+	NameId nodeId = NameInterner::Get().intern(nodeName);
+
+	std::vector<SubscriptionProducer>::iterator producerIter = subscription.producers.begin();
+	for (; producerIter != subscription.producers.end(); producerIter++) {
+		if (producerIter->node == nodeId) {
+			break;
+		}
+	}
+	if (producerIter == subscription.producers.end()) {
+		subscription.producers.push_back(SubscriptionProducer { nodeId, false });
+		producerIter = subscription.producers.end() - 1;
+	}
+
+	// 같은 RN 으로 보낸 DM 이 아직 응답되지 않았다.
+	if (producerIter->pendingDM) {
+		m_nRedundantDMCount += 1;
+		return;
+	}
+	producerIter->pendingDM = true;
+
+	ns3::Time delay(ns3::MilliSeconds(0));
+	ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDM, this, nodeName, topic);
+}
+
+Name
+ConsumerDrn::getRetryKey(DrnCommand cmd, const string &nodeName, const Name &topicName) {
+	Name key;
+	if (cmd == CMD_DM) {
+		key.append(nodeName);
+	}
+	key.append(commandName(cmd)).append(topicName);
+
+	return key;
+}
+
+/**
+ * RN에 아직 응답이 없다: hint 만큼 기다린 뒤 다시 묻는다.
+ * 같은 version 의 negative reply가 이어지면 MaxBackoff 까지 기다리는 시간을 두 배로 늘리고, version이 바뀌면 hint로 돌아간다.
+ * DM 응답에는 version이 없다: 항상 두 배로 늘리되 MaxBackoffDM 까지만.
+ */
+void
+ConsumerDrn::receiveNegativeReply(DrnCommand cmd, const string &nodeName, const Name &topicName, const Block &content) {
+	NegativeReply reply;
+	if (!decodeNegativeReply(content.value(), content.value_size(), reply)) {
+		return;
+	}
+	m_retryStats.negatives += 1;
+
+	int64_t hint = std::max<int64_t>(reply.retryAfter, 1);
+	int64_t delay = hint;
+	Name key = getRetryKey(cmd, nodeName, topicName);
+	std::map<Name, RetryBackoff>::iterator backoffIter = m_backoffs.find(key);
+	if (backoffIter == m_backoffs.end()) {
+		backoffIter = m_backoffs.insert(std::make_pair(key, RetryBackoff { MilliSeconds(hint), reply.version })).first;
+	} else if (backoffIter->second.version == reply.version) {
+		int64_t maxBackoff = (cmd == CMD_TM) ? m_maxBackoff.GetMilliSeconds() : m_maxBackoffDM.GetMilliSeconds();
+		delay = std::max(hint, std::min(backoffIter->second.delay.GetMilliSeconds() * 2, maxBackoff));
+	}
+	backoffIter->second.delay = MilliSeconds(delay);
+	backoffIter->second.version = reply.version;
+
+	// 같은 응답을 받은 consumer들이 한꺼번에 다시 묻지 않도록 [delay, 1.5 delay]
+	// delay 보다 일찍 묻지 않는다: negative reply의 FreshnessPeriod(hint/2)가 지나 content store가 아니라 RN이 답한다
+	std::uniform_int_distribution<int64_t> jitter(delay, delay + delay / 2);
+	Time wait = MilliSeconds(jitter(m_rng));
+	m_retryStats.retries += 1;
+
+	if (cmd == CMD_TM) {
+		m_nTMNegativeCount += 1;
+		ns3::Simulator::Schedule(wait, &ConsumerDrn::sendInterestTM, this, topicName.toUri());
+	} else {
+		// DM 을 다시 보낼 때까지 pendingDM 을 유지한다
+		m_nDMNegativeCount += 1;
+		ns3::Simulator::Schedule(wait, &ConsumerDrn::sendInterestDM, this, nodeName, topicName.toUri());
+	}
+}
+
+void
+ConsumerDrn::receiveDataDM(const string &nodeName, const Name &topicName, const Block &content) {
+	if (isNegativeReply(content.value(), content.value_size())) {
+		receiveNegativeReply(CMD_DM, nodeName, topicName, content);
+		return;
+	}
+	if (!m_backoffs.empty()) {
+		m_backoffs.erase(getRetryKey(CMD_DM, nodeName, topicName));
+	}
+
+	if (0 < content.elements_size()) {
+		content.parse();
+	}
 
 #if 0
-			Block::element_const_iterator iter = content.elements_begin();
-			for (; iter != content.elements_end(); iter ++) {
-				string qualified((const char *)iter->value(), iter->value_size());
-				NDN_LOG_DEBUG(qualified);
+	Block::element_const_iterator iter = content.elements_begin();
+	for (; iter != content.elements_end(); iter ++) {
+		string qualified((const char *)iter->value(), iter->value_size());
+		NDN_LOG_DEBUG(qualified);
 
-				ns3::Time delay(ns3::MilliSeconds(0));
-				ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDR, this, nodeName.toUri(), qualified);
-			}
+		ns3::Time delay(ns3::MilliSeconds(0));
+		ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDR, this, nodeName, qualified);
+	}
 #else
-			string sequence((const char *)content.value(), content.value_size());
+	string sequence((const char *)content.value(), content.value_size());
+
+	Name qualifiedName(topicName);
+	qualifiedName.append(sequence);
 
-			Name qualifiedName(topicName);
-			qualifiedName.append(sequence);
+	NDN_LOG_DEBUG("Data Manifest: " << qualifiedName);
 
-			NDN_LOG_DEBUG("Data Manifest: " << qualifiedName);
+	Subscription &subscription = getSubscription(NameInterner::Get().intern(topicName));
+	NameId nodeId = NameInterner::Get().intern(nodeName);
+	for (SubscriptionProducer &producer : subscription.producers) {
+		if (producer.node == nodeId) {
+			producer.pendingDM = false;
+		}
+	}
+
+	// 이미 요청한 sequence 이면 DR 을 보내지 않는다.
+	int64_t seq = std::strtoll(sequence.c_str(), nullptr, 10);
+	if (seq <= subscription.requestedSequence) {
+		m_nStaleDMCount += 1;
+	} else {
+		subscription.requestedSequence = seq;
 #if 0
-			ns3::Time delay(ns3::MilliSeconds(0));
-			ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDR, this, nodeName.toUri(), qualifiedName.toUri());
+		ns3::Time delay(ns3::MilliSeconds(0));
+		ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestDR, this, nodeName, qualifiedName.toUri());
 #else
-			sendInterestDR(nodeName.toUri(), qualifiedName.toUri());
+		if (0 < m_segmentWindow) {
+			startFetch(nodeName, qualifiedName);
+		} else {
+			sendInterestDR(nodeName, qualifiedName.toUri());
+		}
 #endif
+	}
 #endif
-			Time nextTMDelay;
-			if (m_random == 0) {
-				nextTMDelay = Seconds(m_frequency);
-			} else {
-				nextTMDelay = Seconds(m_random->GetValue());
-			}
+	Time nextTMDelay;
+	if (m_random == 0) {
+		nextTMDelay = Seconds(m_frequency);
+	} else {
+		nextTMDelay = Seconds(m_random->GetValue());
+	}
 #if 0
-			ns3::Simulator::Schedule(nextTMDelay, &ConsumerDrn::sendInterestTM, this, topicName.toUri());
+	ns3::Simulator::Schedule(nextTMDelay, &ConsumerDrn::sendInterestTM, this, topicName.toUri());
 #else
-			sendInterestTM(topicName.toUri());
+	if (m_manifestSlot.IsStrictlyPositive()) {
+		// 다음 slot의 TM: slot 안에서는 같은 응답이다.
+		int64_t slot = m_manifestSlot.GetNanoSeconds();
+		ns3::Time delay = NanoSeconds(slot - Simulator::Now().GetNanoSeconds() % slot);
+		ns3::Simulator::Schedule(delay, &ConsumerDrn::sendInterestTM, this, topicName.toUri());
+	} else {
+		sendInterestTM(topicName.toUri());
+	}
 #endif
-		} else if (cmd.compare("DR") == 0) {
-			m_nDRDataCount += 1;
+}
 
-			int32_t attentionIndex = rnPrefixSize + 1;
-			Name topicName = dataName.getSubName(attentionIndex, Name::npos);
-			string topic = topicName.toUri();
+void
+ConsumerDrn::receiveDataDR(const Name &topicName, const Block &content) {
+	string topic = topicName.toUri();
 
-			const Block &content = data->getContent();
-			if (0 < content.elements_size()) {
-				content.parse();
-			}
+	if (0 < content.elements_size()) {
+		content.parse();
+	}
+
+	NDN_LOG_INFO("RevcDRTopic: " << topic);
 
-            NDN_LOG_INFO("RevcDRTopic: " << topic);
-			NDN_LOG_DEBUG(stringf("Content size: %d", content.value_size()));
+	// /a/b/c/topic-0/3
+	if (topicName.size() == 0) {
+		return;
+	}
+	std::map<NameId, Subscription>::iterator mapIter = m_subscriptions.find(NameInterner::Get().find(topicName.getPrefix(-1)));
+	if (mapIter != m_subscriptions.end()) {
+		if (mapIter->second.deliveredSequence < 0) {
+			m_retryStats.firstDeliveries += 1;
+			m_retryStats.firstDeliverySeconds += (Simulator::Now() - m_startTime).GetSeconds();
 		}
+		int64_t seq = std::strtoll(topicName.get(-1).toUri().c_str(), nullptr, 10);
+		mapIter->second.deliveredSequence = std::max(mapIter->second.deliveredSequence, seq);
 	}
+	NDN_LOG_DEBUG(stringf("Content size: %d", content.value_size()));
 }
 
 void
@@ -457,14 +937,62 @@ ConsumerDrn::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 
 	const Name &interestName = nack->getInterest().getName();
 	int32_t prefixSize = m_rnPrefix.size();
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("TS") == 0) {
+	switch (parseCommand(interestName, prefixSize)) {
+	case CMD_TS:
 		m_nTSNackCount += 1;
-	} else	if (cmd.compare("TM") == 0) {
+		break;
+	case CMD_TM:
 		m_nTMNackCount += 1;
-	} else	if (cmd.compare("DM") == 0) {
+		break;
+	case CMD_DM:
 		m_nDMNackCount += 1;
-	} else	if (cmd.compare("DR") == 0) {
+		clearPendingDM(interestName);
+		break;
+	case CMD_DR:
 		m_nDRNackCount += 1;
+		if (interestName.get(-1).isSegment()) {
+			// segment 하나가 실패하면 object를 다시 받는다
+			Name nodeName;
+			m_fetches.erase(getTopicName(interestName.getPrefix(-1), nodeName));
+			clearRequestedDR(interestName.getPrefix(-1));
+			break;
+		}
+		clearRequestedDR(interestName);
+		break;
+	default:
+		break;
+	}
+}
+
+void
+ConsumerDrn::GetMemoryUsage(MemoryUsage &usage) {
+	TimeoutApp::GetMemoryUsage(usage);
+
+	uint64_t bytes = mapBytes(m_subscriptions);
+	for (std::map<NameId, Subscription>::iterator mapIter = m_subscriptions.begin(); mapIter != m_subscriptions.end(); mapIter++) {
+		if (0 < mapIter->second.producers.capacity()) {
+			bytes += heapChunk(mapIter->second.producers.capacity() * sizeof(SubscriptionProducer));
+		}
+	}
+	usage.push_back(TableUsage { "subscriptions", m_subscriptions.size(), bytes });
+
+	uint64_t entries = 0;
+	bytes = mapBytes(m_topicMap);
+	for (std::map<std::string, StringListPtr>::iterator mapIter = m_topicMap.begin(); mapIter != m_topicMap.end(); mapIter++) {
+		entries += mapIter->second->size();
+		bytes += stringBytes(mapIter->first) + stringListBytes(*mapIter->second);
+	}
+	usage.push_back(TableUsage { "topicMap", entries, bytes });
+
+	bytes = mapBytes(m_fetches);
+	for (std::map<Name, SegmentFetch>::iterator mapIter = m_fetches.begin(); mapIter != m_fetches.end(); mapIter++) {
+		bytes += nameBytes(mapIter->first) + stringBytes(mapIter->second.nodeName) + heapChunk((mapIter->second.done.capacity() + 7) / 8);
+	}
+	usage.push_back(TableUsage { "fetches", m_fetches.size(), bytes });
+
+	bytes = mapBytes(m_backoffs);
+	for (std::map<Name, RetryBackoff>::iterator mapIter = m_backoffs.begin(); mapIter != m_backoffs.end(); mapIter++) {
+		bytes += nameBytes(mapIter->first);
 	}
+	usage.push_back(TableUsage { "backoffs", m_backoffs.size(), bytes });
 }
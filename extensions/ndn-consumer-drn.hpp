@@ -20,8 +20,10 @@
 #ifndef NDN_CONSUMER_APP_H
 #define NDN_CONSUMER_APP_H
 
+#include <map>
 #include <string>
 #include <memory>
+#include <vector>
 #include "ns3/core-module.h"
 
 #include <ns3/ndnSIM/apps/ndn-app.hpp>
@@ -30,8 +32,10 @@
 #include <ns3/ndnSIM/ndn-cxx/util/random.hpp>
 
 #include "object-container.hpp"
+#include "workload-generator.hpp"
 
 #include "ndn-timeout-app.hpp"
+#include "name-interner.hpp"
 
 #include "utils.hpp"
 
@@ -39,6 +43,77 @@ using namespace ns3;
 using namespace ns3::ndn;
 using namespace std;
 
+// publisher RN of a subscribed topic
+struct SubscriptionProducer
+{
+	NameId node;
+	// DM Interest in flight
+	bool pendingDM;
+};
+
+// per topic state, instead of the publisher RN list grown by every TM reply
+struct Subscription
+{
+	std::vector<SubscriptionProducer> producers;
+	// last sequence requested by DR(-1: none)
+	int64_t requestedSequence;
+	// last sequence received by DR(-1: none)
+	int64_t deliveredSequence;
+};
+
+// segmented DR of an object: /RN-yyyyy/DR/a/b/c/topic-0/3/{segment}
+struct SegmentFetch
+{
+	std::string nodeName;
+	// 0: unknown until the first segment
+	uint32_t segments;
+	uint32_t next;
+	uint32_t inFlight;
+	uint32_t received;
+	std::vector<bool> done;
+	Time start;
+	uint64_t bytes;
+};
+
+struct FetchStats
+{
+	uint64_t objects;
+	uint64_t bytes;
+	uint64_t segments;
+	// sum of the fetch times of the objects
+	double seconds;
+};
+
+// TM answers parsed by the consumer: text list or binary manifest
+struct ManifestParseStats
+{
+	uint64_t answers;
+	uint64_t entries;
+	uint64_t bytes;
+	// wall clock seconds of the parse
+	double seconds;
+};
+
+// TM/DM answered by a negative reply: wait before the next try
+struct RetryBackoff
+{
+	::ns3::Time delay;
+	// TopicVersion of the last negative reply
+	uint64_t version;
+};
+
+// Interests without an answer and the time to the first item of the topics
+struct RetryStats
+{
+	uint64_t negatives;
+	uint64_t timeouts;
+	uint64_t retries;
+	uint64_t firstDeliveries;
+	// sum of the times from the start to the first DR of each topic
+	double firstDeliverySeconds;
+	double seconds;
+};
+
 class ConsumerDrn : public TimeoutApp
 {
 public:
@@ -59,12 +134,33 @@ public:
 	void
 	sendInterestTM(string topicPrefix);
 
+	// next page of a binary TM answer
+	void
+	sendInterestTMPage(string topicPrefix, uint64_t token);
+
 	void
 	sendInterestDM(string nodeName, string topicPrefix);
 
 	void
 	sendInterestDR(string nodeName, string topicPrefix);
 
+	void
+	receiveDataDM(const string &nodeName, const Name &topicName, const Block &content);
+
+	void
+	receiveDataDR(const Name &topicName, const Block &content);
+
+	void
+	receiveDataTMManifest(const Name &topicName, const Block &content);
+
+	// a publisher RN of topic from a TM answer: DM unless one is in flight
+	void
+	receiveTopicProducer(const string &topic, const string &nodeName);
+
+	// negative TM/DM reply: the same Interest after the backoff
+	void
+	receiveNegativeReply(DrnCommand cmd, const string &nodeName, const Name &topicName, const Block &content);
+
 	virtual void
 	OnTimeout(shared_ptr<const Interest> interest);
 
@@ -77,6 +173,10 @@ public:
 	virtual void
 	OnNack(shared_ptr<const ::ndn::lp::Nack> nack);
 
+	// state table sizes(MemorySampler)
+	virtual void
+	GetMemoryUsage(MemoryUsage &usage);
+
 	/**
 	 * @brief Set type of frequency randomization
 	 * @param value Either 'none', 'uniform', or 'exponential'
@@ -91,20 +191,89 @@ public:
 	std::string
 	GetRandomize() const;
 
+	/**
+	 * @brief objects fetched by segments and their bytes and time
+	 */
+	const FetchStats &
+	GetFetchStats() const {
+		return m_fetchStats;
+	}
+
+	const ManifestParseStats &
+	GetManifestParseStats() const {
+		return m_manifestParseStats;
+	}
+
+	const RetryStats &
+	GetRetryStats() const {
+		return m_retryStats;
+	}
+
+private:
+	Subscription &
+	getSubscription(NameId topicId);
+
+	// TS/TM name of the current slot
+	void
+	appendCurrentSlot(::ndn::Name &interestName, ::ndn::Interest &interest);
+
+	// topic(DM) or qualified name(DR) of /RN-yyyyy/{cmd}/... and /RN/{cmd}/RN-yyyyy/...
+	Name
+	getTopicName(const Name &interestName, Name &nodeName);
+
+	// DM Interest of the name is answered or dropped
+	void
+	clearPendingDM(const Name &interestName);
+
+	// DR Interest of the name is dropped
+	void
+	clearRequestedDR(const Name &interestName);
+
+	// segment 0 first, then SegmentWindow segments in flight
+	void
+	startFetch(const string &nodeName, const Name &qualifiedName);
+
+	void
+	sendInterestDRSegment(const string &nodeName, const Name &qualifiedName, uint32_t segment);
+
+	void
+	receiveDataDRSegment(const Data &data);
+
+	// key of m_backoffs: /TM/a/b/* or /RN-yyyyy/DM/a/b/c/topic-0
+	Name
+	getRetryKey(DrnCommand cmd, const string &nodeName, const Name &topicName);
+
 private:
 	::ndn::Name m_rnPrefix;
 	string m_topicPrefix;
 	uint32_t m_nSub;
 	uint32_t m_nTotalDS;
 	::ns3::Time m_interestLifeTime; ///< \brief LifeTime for interest packet
+	bool m_regional; ///< \brief DM/DR through the regional RN(/RN/DM/RN-{yyy}/...)
+	::ns3::Time m_manifestSlot; ///< \brief TS/TM name slot(/RN/TM/a/b/c/{slot}), 0: no slot
+	bool m_binaryManifest; ///< \brief TM answers are paged binary manifests, the first TM asks page token 0
+	uint32_t m_segmentWindow; ///< \brief DR segments in flight per object, 0: one DR per object
+	::ns3::Time m_maxBackoff; ///< \brief longest wait after negative TM replies
+	::ns3::Time m_maxBackoffDM; ///< \brief longest wait after negative DM replies, they have no version to reset it
 	double m_frequency;
 	ns3::Ptr<ns3::RandomVariableStream> m_random;
 	std::string m_randomType;
 
 	std::map<std::string, StringListPtr> m_topicMap;
-	std::map<std::string, StringListPtr> m_publishNodes;
+	// topic id -> publisher RNs and delivery state
+	std::map<NameId, Subscription> m_subscriptions;
+	// qualified name(/a/b/c/topic-0/3) -> segments of the object
+	std::map<Name, SegmentFetch> m_fetches;
+	FetchStats m_fetchStats;
+	// TM/DM being retried after negative replies
+	std::map<Name, RetryBackoff> m_backoffs;
+	RetryStats m_retryStats;
+	::ns3::Time m_startTime;
 	vector<string> m_prefixList;
 	ns3::Ptr<ObjectContainer> m_objectContainer;
+	// generated subscriptions, instead of SubscribeTopic x NumSubscribeMessage
+	ns3::Ptr<WorkloadGenerator> m_workload;
+	uint32_t m_nWorkloadIndex;
 
 	::ndn::random::RandomNumberEngine& m_rng;
 	uniform_int_distribution<int> m_rangeUniformRandom;
@@ -121,6 +290,15 @@ private:
 	uint32_t m_nTMDataCount;
 	uint32_t m_nDMDataCount;
 	uint32_t m_nDRDataCount;
+	// DM not sent: the same (topic, RN) DM is in flight
+	uint32_t m_nRedundantDMCount;
+	// DR not sent: the DM answered a sequence already requested
+	uint32_t m_nStaleDMCount;
+	// TM of the next pages of binary manifests
+	uint32_t m_nTMPageCount;
+	uint32_t m_nTMNegativeCount;
+	uint32_t m_nDMNegativeCount;
+	ManifestParseStats m_manifestParseStats;
 };
 
 #endif
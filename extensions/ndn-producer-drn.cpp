@@ -25,6 +25,7 @@
 #include <ndn-cxx/util/random.hpp>
 
 //#include <ndn-cxx/util/random.hpp>
+#include <cstdlib>
 #include <vector>
 #include <iostream>
 #include <algorithm>
@@ -32,6 +33,9 @@
 #include "model/ndn-l3-protocol.hpp"
 #include "helper/ndn-fib-helper.hpp"
 
+#include "drn-protocol.hpp"
+#include "event-tracer.hpp"
+#include "scope-profiler.hpp"
 #include "utils.hpp"
 
 using namespace std;
@@ -69,6 +73,27 @@ ProducerDrn::GetTypeId() {
 		.AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("4s"),
 				        MakeTimeAccessor(&ProducerDrn::m_interestLifeTime), MakeTimeChecker())
 
+		.AddAttribute("AdvertiseBatch", "Topics per PA/PU Interest(1: a PA per topic)", ns3::UintegerValue(1),
+						ns3::MakeUintegerAccessor(&ProducerDrn::m_advertiseBatch), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("AdvertiseRate", "PA Interests per second at startup(0: all at once)", StringValue("0"),
+						MakeDoubleAccessor(&ProducerDrn::m_advertiseRate), MakeDoubleChecker<double>(0))
+
+		.AddAttribute("PublishWindow", "DP Interests in flight per topic(0: the next item is generated after the DP Data)", ns3::UintegerValue(0),
+						ns3::MakeUintegerAccessor(&ProducerDrn::m_publishWindow), ns3::MakeUintegerChecker<uint32_t>())
+
+		.AddAttribute("CoalesceCount", "Items per DP Interest(PublishWindow > 0, 1: a DP per item)", ns3::UintegerValue(1),
+						ns3::MakeUintegerAccessor(&ProducerDrn::m_coalesceCount), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("CoalesceDelay", "Longest wait of a partial DP batch(0: send what the window allows)", StringValue("0us"),
+						MakeTimeAccessor(&ProducerDrn::m_coalesceDelay), MakeTimeChecker())
+
+		.AddAttribute("SegmentSize", "Payload bytes per DP Interest of a larger item(0: a DP per item)", ns3::UintegerValue(0),
+						ns3::MakeUintegerAccessor(&ProducerDrn::m_segmentSize), ns3::MakeUintegerChecker<uint32_t>())
+
+		.AddAttribute("SegmentWindow", "DP segments in flight per item", ns3::UintegerValue(8),
+						ns3::MakeUintegerAccessor(&ProducerDrn::m_segmentWindow), ns3::MakeUintegerChecker<uint32_t>(1))
+
 		.AddAttribute("CustomAttributes", "Custom Attributes", PointerValue (),
 						ns3::MakePointerAccessor(&ProducerDrn::m_objectContainer), ns3::MakePointerChecker<ObjectContainer>())
 						;
@@ -84,8 +109,18 @@ ProducerDrn::ProducerDrn()
 	, m_nDataSize(100)
 	, m_frequency(1.0)
 	, m_nGenTopic(0)
+	, m_nWorkloadIndex(0)
 	, m_rng(::ndn::random::getRandomNumberEngine())
 	, m_rangeUniformRandom(0, 60000)
+	, m_advertiseBatch(1)
+	, m_advertiseRate(0)
+	, m_nBulkSequence(0)
+	, m_nAdvertisedCount(0)
+	, m_publishWindow(0)
+	, m_coalesceCount(1)
+	, m_publishStats()
+	, m_segmentSize(0)
+	, m_segmentWindow(8)
 	, m_nPAInterestCount(0)
 	, m_nPUInterestCount(0)
 	, m_nDPInterestCount(0)
@@ -95,6 +130,8 @@ ProducerDrn::ProducerDrn()
 	, m_nPADataCount(0)
 	, m_nPUDataCount(0)
 	, m_nDPDataCount(0)
+	, m_nDPRetransmitCount(0)
+	, m_nDPSegmentCount(0)
 {
 }
 
@@ -133,6 +170,8 @@ ProducerDrn::StartApplication() {
 	NS_LOG_DEBUG(stringf("AddFIB(%5u): ", GetNode()->GetId()) << m_nodePrefix);
 
 	m_objectContainer->get("PublishTopic", m_prefixList);
+	m_objectContainer->get("Workload", m_workload);
+	m_objectContainer->get("WorkloadIndex", m_nWorkloadIndex);
 
 	initTopics();
 }
@@ -145,9 +184,23 @@ ProducerDrn::StopApplication() {
 	}
 	m_publishEvent.clear();
 
-	for (uint32_t i = 0; i < m_topicLists.size(); i += 1) {
-		ns3::Time delay(ns3::MilliSeconds(0));
-		Simulator::Schedule(Seconds(0.0), &ProducerDrn::sendInterestPU, this, m_topicLists[i]);
+	std::map<NameId, PublishWindow>::iterator flushIter = m_publishWindows.begin();
+	for (; flushIter != m_publishWindows.end(); flushIter++) {
+		Simulator::Cancel(flushIter->second.flushEvent);
+	}
+
+	for (uint32_t i = 0; i < m_advertiseEvents.size(); i++) {
+		Simulator::Cancel(m_advertiseEvents[i]);
+	}
+	m_advertiseEvents.clear();
+
+	for (uint32_t i = 0; i < m_topicLists.size(); i += m_advertiseBatch) {
+		if (m_advertiseBatch <= 1) {
+			Simulator::Schedule(Seconds(0.0), &ProducerDrn::sendInterestPU, this, NameInterner::Get().getUri(m_topicLists[i]));
+			continue;
+		}
+		std::vector<NameId> topics(m_topicLists.begin() + i, m_topicLists.begin() + std::min(i + m_advertiseBatch, (uint32_t)m_topicLists.size()));
+		Simulator::Schedule(Seconds(0.0), &ProducerDrn::sendInterestBulk, this, CMD_PUB, topics);
 	}
 
 	NDN_LOG_INFO("StopApplication");
@@ -160,10 +213,42 @@ ProducerDrn::StopApplication() {
 	NS_LOG_INFO(stringf("Recv PADataCount:     %5u", m_nPADataCount));
 	NS_LOG_INFO(stringf("Recv PUDataCount:     %5u", m_nPUDataCount));
 	NS_LOG_INFO(stringf("Recv DPDataCount:     %5u", m_nDPDataCount));
+	NS_LOG_INFO(stringf("Advertised TopicCount: %5u/%u, %.3fs", m_nAdvertisedCount, (uint32_t)m_topicLists.size(), GetAdvertiseTime()));
+
+	uint64_t inFlight = 0, backlog = 0;
+	std::map<NameId, PublishWindow>::iterator windowIter = m_publishWindows.begin();
+	for (; windowIter != m_publishWindows.end(); windowIter++) {
+		inFlight += windowIter->second.sent.size();
+		backlog += windowIter->second.backlog.size();
+	}
+	m_publishStats.generated = m_nGenTopic;
+	m_publishStats.interests = m_nDPInterestCount;
+	m_publishStats.topics = m_nAdvertisedCount;
+	m_publishStats.seconds = (m_nGenTopic == 0) ? 0 : (Simulator::Now() - m_publishStart).GetSeconds();
+	m_publishStats.targetRate = m_nAdvertisedCount / meanPublishInterval();
+
+	const PublishStats &stats = m_publishStats;
+	double seconds = std::max(stats.seconds, 1e-9);
+	NS_LOG_INFO(stringf("Retransmit DPInterestCount: %5u", m_nDPRetransmitCount));
+	NS_LOG_INFO(stringf("Send DPSegmentCount:  %5u, uploading %u", m_nDPSegmentCount, (uint32_t)m_uploads.size()));
+	NS_LOG_INFO(stringf("Publish rate: target %.3f/s, generated %.3f/s, achieved %.3f/s, RTT %.3fms, window %u, in flight %llu, backlog %llu",
+			stats.targetRate, stats.generated / seconds, stats.acknowledged / seconds,
+			(0 < stats.rttCount) ? stats.rttSum * 1000 / stats.rttCount : 0.0, m_publishWindow, (unsigned long long)inFlight,
+			(unsigned long long)backlog));
+	NS_LOG_INFO(stringf("DP Interests per item: %.3f", (0 < stats.acknowledged) ? (double)stats.interests / stats.acknowledged : 0.0));
 }
 
 void
 ProducerDrn::initTopics() {
+	if (m_workload != 0) {
+		m_workload->GetPublishTopics(m_nWorkloadIndex, m_topicLists);
+
+		for (uint32_t i = 0; i < m_topicLists.size(); i += 1) {
+			m_topicSequences[m_topicLists[i]] = 0;
+		}
+		scheduleAdvertisements();
+		return;
+	}
 
 	std::vector<std::string> availableSubscriptions;
 	for (uint32_t i = 0; i < m_nTotalDS; i++) {
@@ -180,22 +265,70 @@ ProducerDrn::initTopics() {
 			Name topic(*iter);
 			topic.append(availableSubscriptions[i]);
 
-			m_topicLists.push_back(topic.toUri());
+			NameId topicId = NameInterner::Get().intern(topic);
+			m_topicLists.push_back(topicId);
 
-			m_topicSequences[topic.toUri()] = 0;
+			m_topicSequences[topicId] = 0;
 
-			NDN_LOG_DEBUG("init topic sequence: " << topic.toUri());
+			NDN_LOG_DEBUG("init topic sequence: " << topic);
 		}
 	}
 
-	// topic advertise
-	for (uint32_t i = 0; i < m_topicLists.size(); i += 1) {
-		Name topic(m_topicLists[i]);
+	scheduleAdvertisements();
+}
+
+void
+ProducerDrn::scheduleAdvertisements() {
+	m_advertiseStart = Simulator::Now();
+
+	// topic advertise: 한 Interest에 AdvertiseBatch 개의 topic, 초당 AdvertiseRate 개의 Interest
+	uint32_t count = m_topicLists.size();
+	for (uint32_t i = 0, n = 0; i < count; i += m_advertiseBatch, n += 1) {
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &ProducerDrn::sendInterestPA, this, topic.toUri());
+		if (0 < m_advertiseRate) {
+			delay = Seconds(n / m_advertiseRate);
+		} else if (m_workload != 0) {
+			delay = m_workload->GetAdvertiseDelay(i, count);
+		}
+
+		if (m_advertiseBatch <= 1) {
+			m_advertiseEvents.push_back(ns3::Simulator::Schedule(delay, &ProducerDrn::sendInterestPA, this, NameInterner::Get().getUri(m_topicLists[i])));
+			continue;
+		}
+		std::vector<NameId> topics(m_topicLists.begin() + i, m_topicLists.begin() + std::min(i + m_advertiseBatch, count));
+		m_advertiseEvents.push_back(ns3::Simulator::Schedule(delay, &ProducerDrn::sendInterestBulk, this, CMD_PAB, topics));
 	}
 }
 
+Time
+ProducerDrn::nextPublishTime(NameId topicId) {
+	if (m_workload != 0) {
+		return m_workload->NextPublishInterval(topicId);
+	}
+
+	if (m_random == 0) {
+		return Seconds(m_frequency);
+	}
+
+	return Seconds(m_random->GetValue());
+}
+
+// mean of nextPublishTime(), the Bound of the exponential is ignored
+double
+ProducerDrn::meanPublishInterval() const {
+	if (m_workload != 0) {
+		return 1.0 / m_workload->GetPublishRate();
+	}
+
+	if (m_randomType == "uniform") {
+		return 3.0 * m_frequency;
+	} else if (m_randomType == "exponential") {
+		return 2.5 * m_frequency;
+	}
+
+	return m_frequency;
+}
+
 void
 ProducerDrn::sendInterestPA(string topic) {
 	// RN/PA/a/b/c
@@ -212,6 +345,7 @@ ProducerDrn::sendInterestPA(string topic) {
 	NDN_LOG_DEBUG("send interest: " << interestName);
 
 #if 1
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interestName);
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -235,6 +369,7 @@ ProducerDrn::sendInterestPU(string topic) {
 	NDN_LOG_DEBUG("send interest: " << interestName);
 
 #if 1
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interestName);
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -242,41 +377,230 @@ ProducerDrn::sendInterestPU(string topic) {
 	m_nPUInterestCount += 1;
 }
 
+void
+ProducerDrn::sendInterestBulk(DrnCommand cmd, std::vector<NameId> topics) {
+	// RN/PAB/{node id}/{batch}, parameters: Name TLV of each topic
+	uint32_t batch = m_nBulkSequence++;
+	::ndn::Name interestName(m_rnPrefix);
+	interestName.append(commandName(cmd)).appendNumber(GetNode()->GetId()).appendNumber(batch);
+
+	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest > ();
+	interest->setName(interestName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	::ndn::Block params(::ndn::tlv::Parameters);
+	for (NameId topicId : topics) {
+		params.push_back(NameInterner::Get().getName(topicId).wireEncode());
+	}
+	params.encode();
+	interest->setParameters(params);
+
+	if (cmd == CMD_PAB) {
+		m_bulkTopics[batch] = topics;
+		m_nPAInterestCount += 1;
+	} else {
+		m_nPUInterestCount += 1;
+	}
+
+	NDN_LOG_DEBUG("send interest: " << interestName << ", topics: " << topics.size());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interestName, params.size());
+	m_appLink->onReceiveInterest(*interest);
+}
+
+void
+ProducerDrn::startPublish(NameId topicId) {
+	// PA Data after StopApplication
+	if (!m_active) {
+		return;
+	}
+
+	m_topicSequences[topicId] = 0;
+
+	scheduleGenerate(topicId);
+
+	m_nAdvertisedCount += 1;
+	if (m_nAdvertisedCount == m_topicLists.size()) {
+		m_advertiseEnd = Simulator::Now();
+	}
+}
+
+void
+ProducerDrn::scheduleGenerate(NameId topicId) {
+	Time t = nextPublishTime(topicId);
+
+	std::shared_ptr<std::vector<EventId>> eventPtr = std::make_shared<std::vector<EventId>>();
+	EventId eventId = Simulator::Schedule(t, &ProducerDrn::generateTopics, this, NameInterner::Get().getName(topicId), eventPtr);
+	eventPtr->push_back(eventId);
+	m_publishEvent.insert(std::pair<EventId, int>(eventId, 0));
+}
+
+double
+ProducerDrn::GetAdvertiseTime() const {
+	if (m_topicLists.empty() || m_nAdvertisedCount < m_topicLists.size()) {
+		return -1;
+	}
+
+	return (m_advertiseEnd - m_advertiseStart).GetSeconds();
+}
+
 void
 ProducerDrn::generateTopics(Name topicPrefix, std::shared_ptr<std::vector<EventId>> eventPtr)
 {
+	DRN_PROFILE_SCOPE("ProducerDrn", "generateTopics");
 	m_publishEvent.erase((*eventPtr)[0]);
 
-	std::string tempName(topicPrefix.toUri());
-	uint32_t tempSeq = m_topicSequences[tempName];
-	m_topicSequences[tempName] = tempSeq + 1;
+	NameId topicId = NameInterner::Get().intern(topicPrefix);
+	uint32_t tempSeq = m_topicSequences[topicId];
+	m_topicSequences[topicId] = tempSeq + 1;
 
-	std::map<std::string, std::map<uint32_t, uint32_t>>::iterator publishIter;
-	publishIter = m_publishTopics.find(tempName);
+	std::map<NameId, std::map<uint32_t, uint32_t>>::iterator publishIter;
+	publishIter = m_publishTopics.find(topicId);
 	if (publishIter == m_publishTopics.end()) {
-		m_publishTopics.insert(std::make_pair(tempName, std::map<uint32_t, uint32_t>()));
-		m_publishTopics[tempName].insert(std::make_pair(tempSeq, 0)); // seq 100번째 topic은 0번 publish되었다.
+		m_publishTopics.insert(std::make_pair(topicId, std::map<uint32_t, uint32_t>()));
+		m_publishTopics[topicId].insert(std::make_pair(tempSeq, 0)); // seq 100번째 topic은 0번 publish되었다.
 	} else {
 		publishIter->second.insert(std::make_pair(tempSeq, 0));
 	}
 
-	Name newTopicNameSeq = Name(tempName).append(stringf("%u", tempSeq));
+	Name newTopicNameSeq = Name(topicPrefix).append(stringf("%u", tempSeq));
 	NDN_LOG_DEBUG("newTopicNameSeq : " << newTopicNameSeq);
 
+	if (m_nGenTopic == 0) {
+		m_publishStart = Simulator::Now();
+	}
 	m_nGenTopic++;
 	// topic published time
 	NDN_LOG_INFO("PublishTopic: " << newTopicNameSeq);
 
-	SendDataPublishInterest(newTopicNameSeq);
+	PublishWindow &window = m_publishWindows[topicId];
+	if (m_publishWindow == 0) {
+		window.sent[tempSeq] = PublishSent { Simulator::Now(), false, 1 };
+		SendDataPublishInterest(newTopicNameSeq);
+		return;
+	}
+
+	// 생성은 자체 clock으로 계속하고, DP Interest는 window 만큼만 보낸다
+	window.backlog.push_back(tempSeq);
+	scheduleGenerate(topicId);
+	fillWindow(topicId, false);
     //Simulator::Schedule(Seconds(0.0), &ProducerDrn::SendDataPublishInterest, this, newTopicNameSeq);
 }
 
+void
+ProducerDrn::fillWindow(NameId topicId, bool flush) {
+	PublishWindow &window = m_publishWindows[topicId];
+	if (flush) {
+		window.flushEvent = EventId();
+		window.flushDue = true;
+	}
+	if (!m_active || window.backlog.empty()) {
+		return;
+	}
+
+	// backlog의 sequence는 연속이므로 앞에서부터 CoalesceCount 개씩 묶는다
+	Name topicName = NameInterner::Get().getName(topicId);
+	// segment로 나누는 item은 묶지 않는다
+	uint32_t coalesceCount = isSegmented() ? 1 : m_coalesceCount;
+	while (window.sent.size() < m_publishWindow && !window.backlog.empty()) {
+		uint32_t count = std::min((size_t)coalesceCount, window.backlog.size());
+		if (count < coalesceCount && !window.flushDue && m_coalesceDelay.IsStrictlyPositive()) {
+			// 부족한 batch는 CoalesceDelay 까지 기다린다
+			if (!window.flushEvent.IsRunning()) {
+				window.flushEvent = Simulator::Schedule(m_coalesceDelay, &ProducerDrn::fillWindow, this, topicId, true);
+			}
+			return;
+		}
+
+		uint32_t seq = window.backlog.front();
+		window.backlog.erase(window.backlog.begin(), window.backlog.begin() + count);
+
+		window.sent[seq] = PublishSent { Simulator::Now(), false, count };
+		if (count < coalesceCount) {
+			window.flushDue = false;
+		}
+		if (count == 1) {
+			Name topicNameSeq = Name(topicName).append(stringf("%u", seq));
+			SendDataPublishInterest(topicNameSeq);
+		} else {
+			SendDataPublishBatch(topicName, seq, count);
+		}
+	}
+
+	if (window.backlog.empty()) {
+		Simulator::Cancel(window.flushEvent);
+	}
+}
+
+void
+ProducerDrn::retransmitDataPublish(shared_ptr<const Interest> interest) {
+	if (!m_active) {
+		return;
+	}
+
+	NameId topicId;
+	uint32_t seq;
+	if (!parseDataPublish(interest->getName(), topicId, seq)) {
+		return;
+	}
+	std::map<NameId, PublishWindow>::iterator windowIter = m_publishWindows.find(topicId);
+	if (windowIter == m_publishWindows.end()) {
+		return;
+	}
+	std::map<uint32_t, PublishSent>::iterator sentIter = windowIter->second.sent.find(seq);
+	if (sentIter == windowIter->second.sent.end()) {
+		// 그 사이에 응답을 받았다
+		return;
+	}
+	if (interest->getName().get(-1).isSegment()) {
+		std::map<std::pair<NameId, uint32_t>, SegmentUpload>::iterator uploadIter = m_uploads.find(std::make_pair(topicId, seq));
+		uint64_t segment = interest->getName().get(-1).toSegment();
+		if (uploadIter == m_uploads.end() || uploadIter->second.segments <= segment || uploadIter->second.done[segment]) {
+			return;
+		}
+	}
+	sentIter->second.retransmitted = true;
+
+	// 같은 nonce는 dead nonce list에 걸리므로 새 nonce로 보낸다
+	shared_ptr<Interest> retransmit = make_shared<Interest>(*interest);
+	retransmit->refreshNonce();
+	sendInterestTimeout(retransmit);
+
+	m_nDPInterestCount += 1;
+	m_nDPRetransmitCount += 1;
+	m_publishStats.retransmitted += 1;
+}
+
+bool
+ProducerDrn::parseDataPublish(const Name &name, NameId &topicId, uint32_t &seq) const {
+	// /RN/DP/a/b/c/topic-80/{seq}, /RN/DPB/a/b/c/topic-80/{first seq}/{count}, /RN/DP/a/b/c/topic-80/{seq}/{segment}
+	size_t attentionIndex = m_rnPrefix.size() + 1;
+	size_t suffix = (parseCommand(name, m_rnPrefix.size()) == CMD_DPB || name.get(-1).isSegment()) ? 2 : 1;
+	if (name.size() < attentionIndex + suffix + 1) {
+		return false;
+	}
+
+	topicId = NameInterner::Get().find(name.getSubName(attentionIndex, name.size() - attentionIndex - suffix));
+	if (topicId == NAME_ID_NONE) {
+		return false;
+	}
+	seq = std::strtoul(name.get(name.size() - suffix).toUri().c_str(), nullptr, 10);
+
+	return true;
+}
+
 void
 ProducerDrn::SendDataPublishInterest(Name &topicName)
 {
 	if (!m_active) {
 		return;
 	}
+	if (isSegmented()) {
+		startUpload(topicName);
+		return;
+	}
 
 	// /RN/DP/a/b/c/topic-80/0
 	Name interestName(m_rnPrefix);
@@ -304,25 +628,154 @@ ProducerDrn::SendDataPublishInterest(Name &topicName)
 	// Call trace (for logging purposes)
 	m_transmittedInterests(interest, this, m_face);
 
-#if 1
-	m_appLink->onReceiveInterest(*interest);
-#else
+	if (0 < m_publishWindow) {
+		// 응답이 없으면 OnTimeout에서 재전송한다
+		sendInterestTimeout(interest);
+	} else {
+		EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interestName, buffer->size());
+		m_appLink->onReceiveInterest(*interest);
+	}
+	m_nDPInterestCount += 1;
+}
+
+void
+ProducerDrn::SendDataPublishBatch(const Name &topicName, uint32_t firstSeq, uint32_t count) {
+	if (!m_active) {
+		return;
+	}
+
+	// /RN/DPB/a/b/c/topic-80/0/8
+	Name interestName(m_rnPrefix);
+	interestName.append(commandName(CMD_DPB)).append(topicName).append(stringf("%u", firstSeq)).append(stringf("%u", count));
+	NS_LOG_INFO("SentDataPublishInterest: " << interestName);
+
+	shared_ptr<Interest> interest = std::make_shared<Interest>();
+	interest->setName(interestName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	// sequence 순서대로 AppPrivateBlock1 을 하나씩
+	shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>(m_nDataSize);
+	::memset(buffer->get<uint8_t>(), 'a', buffer->size());
+
+	::ndn::Block params(::ndn::tlv::Parameters);
+	for (uint32_t i = 0; i < count; i++) {
+		params.push_back(::ndn::Block(::ndn::tlv::AppPrivateBlock1, buffer));
+	}
+	params.encode();
+	interest->setParameters(params);
+
+	m_transmittedInterests(interest, this, m_face);
+
 	sendInterestTimeout(interest);
-#endif
 	m_nDPInterestCount += 1;
 }
 
 void
-ProducerDrn::OnTimeout(shared_ptr<const Interest> interest) {
-	TimeoutApp::OnTimeout(interest);
+ProducerDrn::startUpload(const Name &topicNameSeq) {
+	NameId topicId = NameInterner::Get().intern(topicNameSeq.getPrefix(-1));
+	uint32_t seq = std::strtoul(topicNameSeq.get(-1).toUri().c_str(), nullptr, 10);
+
+	SegmentUpload &upload = m_uploads[std::make_pair(topicId, seq)];
+	upload.name = topicNameSeq;
+	upload.segments = (m_nDataSize + m_segmentSize - 1) / m_segmentSize;
+	upload.next = 0;
+	upload.inFlight = 0;
+	upload.acked = 0;
+	upload.done.assign(upload.segments, false);
+
+	sendSegments(upload);
+}
+
+void
+ProducerDrn::sendSegments(SegmentUpload &upload) {
+	while (upload.inFlight < m_segmentWindow && upload.next < upload.segments) {
+		sendSegment(upload.name, upload.next, upload.segments);
+		upload.next += 1;
+		upload.inFlight += 1;
+	}
+}
 
+void
+ProducerDrn::sendSegment(const Name &topicNameSeq, uint32_t segment, uint32_t segments) {
+	if (!m_active) {
+		return;
+	}
+
+	// /RN/DP/a/b/c/topic-80/0/%00%03
+	Name interestName(m_rnPrefix);
+	interestName.append(commandName(CMD_DP)).append(topicNameSeq).appendSegment(segment);
+	NS_LOG_INFO("SentDataPublishInterest: " << interestName);
+
+	shared_ptr<Interest> interest = std::make_shared<Interest>();
+	interest->setName(interestName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	// 마지막 segment는 남은 크기만, RN이 완료를 알 수 있도록 FinalBlockId를 같이 보낸다
+	uint32_t offset = segment * m_segmentSize;
+	shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>(std::min(m_segmentSize, m_nDataSize - offset));
+	::memset(buffer->get<uint8_t>(), 'a', buffer->size());
+
+	::ndn::Block params(::ndn::tlv::Parameters);
+	params.push_back(::ndn::Block(::ndn::tlv::AppPrivateBlock1, buffer));
+	params.push_back(::ndn::Block(::ndn::tlv::FinalBlockId, ::ndn::name::Component::fromSegment(segments - 1).wireEncode()));
+	params.encode();
+	interest->setParameters(params);
+
+	m_transmittedInterests(interest, this, m_face);
+
+	sendInterestTimeout(interest);
+	m_nDPInterestCount += 1;
+	m_nDPSegmentCount += 1;
+}
+
+bool
+ProducerDrn::receiveSegmentAck(NameId topicId, uint32_t seq, uint64_t segment) {
+	std::map<std::pair<NameId, uint32_t>, SegmentUpload>::iterator uploadIter = m_uploads.find(std::make_pair(topicId, seq));
+	if (uploadIter == m_uploads.end()) {
+		// 이미 완료된 item의 중복 응답
+		return false;
+	}
+
+	SegmentUpload &upload = uploadIter->second;
+	if (segment < upload.segments && !upload.done[segment]) {
+		upload.done[segment] = true;
+		upload.acked += 1;
+		upload.inFlight -= 1;
+	}
+	if (upload.acked < upload.segments) {
+		sendSegments(upload);
+		return false;
+	}
+
+	m_uploads.erase(uploadIter);
+	return true;
+}
+
+void
+ProducerDrn::OnTimeout(shared_ptr<const Interest> interest) {
 	const Name &interestName = interest->getName();
+	NS_LOG_DEBUG(interestName);
 	int32_t prefixSize = m_rnPrefix.size();
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("PA") == 0) {
+	DrnCommand cmd = parseCommand(interestName, prefixSize);
+	if (cmd == CMD_DP || cmd == CMD_DPB) {
+		EventTracer::Get().record(TRACE_TIMEOUT, GetNode()->GetId(), interestName);
+
+		RemoveTimeoutEvent(interestName);
+		retransmitDataPublish(interest);
+		return;
+	}
+
+	TimeoutApp::OnTimeout(interest);
+
+	if (cmd == CMD_PA) {
 		m_nPAInterestCount += 1;
 	}
-	NS_LOG_DEBUG(interestName);
 }
 
 void
@@ -342,51 +795,63 @@ ProducerDrn::OnData(shared_ptr<const Data> data) {
 
 	// /RN/ 요청 interest에 대한 응답 Data
 	if (prefix.equals(m_rnPrefix)) {
-		string cmd = dataName.get(prefixSize).toUri();
+		DrnCommand cmd = parseCommand(dataName, prefixSize);
+		DRN_PROFILE_COMMAND("ProducerDrn", "OnData", cmd);
 		// /RN/PA/a/b/c/topic-{nnn}
-		if (cmd.compare("PA") == 0) {
+		if (cmd == CMD_PA) {
 			m_nPADataCount += 1;
 
 			int32_t attentionIndex = prefixSize + 1;
 			Name topicPrefix = dataName.getSubName(attentionIndex, Name::npos);
 
-			m_topicSequences[topicPrefix.toUri()] = 0;
+			startPublish(NameInterner::Get().intern(topicPrefix));
+		} else if (cmd == CMD_PAB) {
+			m_nPADataCount += 1;
 
-			Time t;
-			if (m_random == 0) {
-				t = Seconds(m_frequency);
-			} else {
-				t = Seconds(m_random->GetValue());
+			// /RN/PAB/{node id}/{batch}
+			std::map<uint32_t, std::vector<NameId>>::iterator bulkIter = m_bulkTopics.find(dataName.get(-1).toNumber());
+			if (bulkIter != m_bulkTopics.end()) {
+				for (NameId topicId : bulkIter->second) {
+					startPublish(topicId);
+				}
+				m_bulkTopics.erase(bulkIter);
 			}
-
-			std::shared_ptr<std::vector<EventId>> eventPtr = std::make_shared<std::vector<EventId>>();
-			EventId eventId = Simulator::Schedule(t, &ProducerDrn::generateTopics, this, topicPrefix, eventPtr);
-			eventPtr->push_back(eventId);
-			m_publishEvent.insert(std::pair<EventId, int>(eventId, 0));
-		} else if (cmd.compare("PU") == 0) {
+		} else if (cmd == CMD_PU || cmd == CMD_PUB) {
 			m_nPUDataCount += 1;
-		} else if (cmd.compare("DP") == 0) {
+		} else if (cmd == CMD_DP || cmd == CMD_DPB) {
 			m_nDPDataCount += 1;
 
-			int32_t attentionIndex = prefixSize + 1;
-			Name prefix = dataName.getSubName(attentionIndex, Name::npos);
+			// /RN/DP/a/b/c/topic-80/{seq}, /RN/DPB/a/b/c/topic-80/{first seq}/{count}
+			NameId topicId;
+			uint32_t seq;
+			if (!parseDataPublish(dataName, topicId, seq)) {
+				return;
+			}
+			// 모든 segment의 응답을 받아야 item의 응답이다
+			if (dataName.get(-1).isSegment() && !receiveSegmentAck(topicId, seq, dataName.get(-1).toSegment())) {
+				return;
+			}
 
-			Name qualifiedName = dataName.getSubName(2, dataName.size()-1);
-			Name topicName = qualifiedName.getSubName(0, qualifiedName.size()-1);
-			string topicPrefix = topicName.toUri();
+			std::map<NameId, PublishWindow>::iterator windowIter = m_publishWindows.find(topicId);
+			if (windowIter != m_publishWindows.end()) {
+				std::map<uint32_t, PublishSent>::iterator sentIter = windowIter->second.sent.find(seq);
+				if (sentIter != windowIter->second.sent.end()) {
+					// 재전송한 Interest의 RTT는 쓰지 않는다
+					if (!sentIter->second.retransmitted) {
+						m_publishStats.rttSum += (Simulator::Now() - sentIter->second.sent).GetSeconds();
+						m_publishStats.rttCount += 1;
+					}
+					m_publishStats.acknowledged += sentIter->second.count;
+					windowIter->second.sent.erase(sentIter);
+				}
+			}
 
-			// schedule next topic generation
-			Time t;
-			if (m_random == 0) {
-				t = Seconds(m_frequency);
+			if (m_publishWindow == 0) {
+				// schedule next topic generation
+				scheduleGenerate(topicId);
 			} else {
-				t = Seconds(m_random->GetValue());
+				fillWindow(topicId, false);
 			}
-
-			std::shared_ptr<std::vector<EventId>> eventPtr = std::make_shared<std::vector<EventId>>();
-			EventId eventId = Simulator::Schedule(t, &ProducerDrn::generateTopics, this, topicPrefix, eventPtr);
-			eventPtr->push_back(eventId);
-			m_publishEvent.insert(std::pair<EventId, int>(eventId, 0));
 		}
 	}
 }
@@ -400,12 +865,66 @@ ProducerDrn::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 
 	const Name &interestName = nack->getInterest().getName();
 	int32_t prefixSize = m_rnPrefix.size();
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("PA") == 0) {
+	switch (parseCommand(interestName, prefixSize)) {
+	case CMD_PA:
+	case CMD_PAB:
 		m_nPANackCount += 1;
-	} else	if (cmd.compare("PU") == 0) {
+		break;
+	case CMD_PU:
+	case CMD_PUB:
 		m_nPUNackCount += 1;
-	} else	if (cmd.compare("DP") == 0) {
+		break;
+	case CMD_DP:
+	case CMD_DPB:
 		m_nDPNackCount += 1;
+		if (0 < m_publishWindow || interestName.get(-1).isSegment()) {
+			// 재전송은 LifeTime 후에
+			Simulator::Schedule(m_interestLifeTime, &ProducerDrn::retransmitDataPublish, this, make_shared<Interest>(nack->getInterest()));
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void
+ProducerDrn::GetMemoryUsage(MemoryUsage &usage) {
+	TimeoutApp::GetMemoryUsage(usage);
+
+	// entries: sequences of all topics
+	uint64_t entries = 0;
+	uint64_t bytes = mapBytes(m_publishTopics);
+	for (std::map<NameId, std::map<uint32_t, uint32_t>>::iterator mapIter = m_publishTopics.begin(); mapIter != m_publishTopics.end(); mapIter++) {
+		entries += mapIter->second.size();
+		bytes += mapBytes(mapIter->second);
+	}
+	usage.push_back(TableUsage { "publishTopics", entries, bytes });
+
+	usage.push_back(TableUsage { "topicSequences", m_topicSequences.size(), mapBytes(m_topicSequences) });
+	usage.push_back(TableUsage { "publishEvent", m_publishEvent.size(), mapBytes(m_publishEvent) });
+
+	entries = 0;
+	bytes = mapBytes(m_bulkTopics);
+	for (std::map<uint32_t, std::vector<NameId>>::iterator mapIter = m_bulkTopics.begin(); mapIter != m_bulkTopics.end(); mapIter++) {
+		entries += mapIter->second.size();
+		bytes += heapChunk(mapIter->second.capacity() * sizeof(NameId));
+	}
+	usage.push_back(TableUsage { "bulkTopics", entries, bytes });
+
+	// entries: items waiting and in flight, deque: a 512 byte block per 128 items
+	entries = 0;
+	bytes = mapBytes(m_publishWindows);
+	for (std::map<NameId, PublishWindow>::iterator mapIter = m_publishWindows.begin(); mapIter != m_publishWindows.end(); mapIter++) {
+		entries += mapIter->second.backlog.size() + mapIter->second.sent.size();
+		bytes += mapBytes(mapIter->second.sent) + heapChunk(8 * sizeof(void *)) + heapChunk(512) * (mapIter->second.backlog.size() / 128 + 1);
+	}
+	usage.push_back(TableUsage { "publishWindows", entries, bytes });
+
+	entries = 0;
+	bytes = mapBytes(m_uploads);
+	for (std::map<std::pair<NameId, uint32_t>, SegmentUpload>::iterator mapIter = m_uploads.begin(); mapIter != m_uploads.end(); mapIter++) {
+		entries += mapIter->second.segments - mapIter->second.acked;
+		bytes += nameBytes(mapIter->second.name) + heapChunk((mapIter->second.done.capacity() + 7) / 8);
 	}
+	usage.push_back(TableUsage { "uploads", entries, bytes });
 }
@@ -25,18 +25,68 @@
 #include <ns3/ndnSIM/apps/ndn-app.hpp>
 #include <ns3/ndnSIM/ndn-cxx/util/random.hpp>
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <vector>
 
+#include "drn-protocol.hpp"
 #include "ndn-timeout-app.hpp"
+#include "name-interner.hpp"
 
 #include "object-container.hpp"
+#include "workload-generator.hpp"
 
 using namespace std;
 using namespace ns3;
 using namespace ns3::ndn;
 
+// DP Interest in flight, count > 1: DPB of the sequences from its key
+struct PublishSent
+{
+	Time sent;
+	bool retransmitted;
+	uint32_t count;
+};
+
+// publish window of a topic: generated items waiting for a slot, DP Interests in flight
+struct PublishWindow
+{
+	std::deque<uint32_t> backlog;
+	std::map<uint32_t, PublishSent> sent;
+	// CoalesceDelay of a partial batch, due: the delay is over but the window was full
+	EventId flushEvent;
+	bool flushDue = false;
+};
+
+// segmented DP of an item larger than SegmentSize: /RN/DP/a/b/c/topic-80/{seq}/{segment}
+struct SegmentUpload
+{
+	Name name;
+	uint32_t segments;
+	uint32_t next;
+	uint32_t inFlight;
+	uint32_t acked;
+	std::vector<bool> done;
+};
+
+struct PublishStats
+{
+	uint64_t generated;
+	uint64_t acknowledged;
+	uint64_t retransmitted;
+	// DP/DPB Interests sent, retransmissions included
+	uint64_t interests;
+	// RTT of the DP Interests answered without retransmission
+	uint64_t rttCount;
+	double rttSum;
+	// first generated item to StopApplication
+	double seconds;
+	uint32_t topics;
+	// items per second of the advertised topics at the configured publish interval
+	double targetRate;
+};
+
 class ProducerDrn : public TimeoutApp
 {
 public:
@@ -57,6 +107,10 @@ public:
 	void
 	sendInterestPU(string topic);
 
+	// /RN/PAB/{node id}/{batch}, /RN/PUB/...: many topics in one Interest
+	void
+	sendInterestBulk(DrnCommand cmd, std::vector<NameId> topics);
+
 	virtual void
 	OnInterest(shared_ptr<const Interest> interest);
 
@@ -69,12 +123,22 @@ public:
 	virtual void
 	OnNack(shared_ptr<const ::ndn::lp::Nack> nack);
 
+	// state table sizes(MemorySampler)
+	virtual void
+	GetMemoryUsage(MemoryUsage &usage);
+
 	void
 	initTopics();
+	// PA(or PAB of AdvertiseBatch topics) paced by AdvertiseRate
+	void
+	scheduleAdvertisements();
 	void
 	generateTopics(Name topicPrefix, std::shared_ptr<std::vector<EventId>> eventPtr);
 	void
 	SendDataPublishInterest(Name &topicName);
+	// /RN/DPB/a/b/c/topic-80/{first seq}/{count}
+	void
+	SendDataPublishBatch(const Name &topicName, uint32_t firstSeq, uint32_t count);
 
 	/**
 	 * @brief Set type of frequency randomization
@@ -90,6 +154,64 @@ public:
 	std::string
 	GetRandomize() const;
 
+	/**
+	 * @brief seconds from the first PA to the answer of the last topic, -1 if not all topics are advertised
+	 */
+	double
+	GetAdvertiseTime() const;
+
+	/**
+	 * @brief generated and acknowledged DP items and their RTT, complete after StopApplication
+	 */
+	const PublishStats &
+	GetPublishStats() const {
+		return m_publishStats;
+	}
+
+private:
+	Time
+	nextPublishTime(NameId topicId);
+
+	double
+	meanPublishInterval() const;
+
+	// PA answered: schedule the first publish of the topic
+	void
+	startPublish(NameId topicId);
+
+	void
+	scheduleGenerate(NameId topicId);
+
+	// send the backlog of a topic while the window has room, flush: send a partial batch
+	void
+	fillWindow(NameId topicId, bool flush);
+
+	void
+	retransmitDataPublish(shared_ptr<const Interest> interest);
+
+	// /RN/DP/a/b/c/topic-80/{seq}
+	bool
+	parseDataPublish(const Name &name, NameId &topicId, uint32_t &seq) const;
+
+	bool
+	isSegmented() const {
+		return 0 < m_segmentSize && m_segmentSize < m_nDataSize;
+	}
+
+	// DataSize 를 SegmentSize 로 나누어 SegmentWindow 개씩 보낸다
+	void
+	startUpload(const Name &topicNameSeq);
+
+	void
+	sendSegments(SegmentUpload &upload);
+
+	void
+	sendSegment(const Name &topicNameSeq, uint32_t segment, uint32_t segments);
+
+	// false: the item still has segments to upload
+	bool
+	receiveSegmentAck(NameId topicId, uint32_t seq, uint64_t segment);
+
 private:
 	::ndn::Name m_rnPrefix;
 	string m_topicPrefix;
@@ -106,17 +228,46 @@ private:
 	::ns3::Time m_interestLifeTime; ///< \brief LifeTime for interest packet
 
 	ns3::Ptr<ObjectContainer> m_objectContainer;
+	// generated topics and publish intervals, instead of PublishTopic x TotalDataStream
+	ns3::Ptr<WorkloadGenerator> m_workload;
+	uint32_t m_nWorkloadIndex;
 
 	vector<string> m_prefixList;
-	std::map<std::string, std::map<uint32_t, uint32_t>> m_publishTopics;
-	std::map<std::string, uint32_t> m_topicSequences;
-	std::vector<std::string> m_topicLists;
+	std::map<NameId, std::map<uint32_t, uint32_t>> m_publishTopics;
+	std::map<NameId, uint32_t> m_topicSequences;
+	std::vector<NameId> m_topicLists;
 
 	::ndn::random::RandomNumberEngine& m_rng;
 	uniform_int_distribution<int> m_rangeUniformRandom;
 
 	std::map<EventId, int> m_publishEvent;
 
+	// bulk advertisement: topics per PA/PU Interest(1: a PA per topic) and PA Interests per second(0: all at start)
+	uint32_t m_advertiseBatch;
+	double m_advertiseRate;
+	uint32_t m_nBulkSequence;
+	// batch -> topics of the PAB in flight
+	std::map<uint32_t, std::vector<NameId>> m_bulkTopics;
+	// paced PA/PAB sends not sent yet, cancelled at StopApplication
+	std::vector<EventId> m_advertiseEvents;
+	// startup convergence: first PA sent, topics answered, last answer
+	Time m_advertiseStart;
+	Time m_advertiseEnd;
+	uint32_t m_nAdvertisedCount;
+
+	// DP Interests in flight per topic(0: next item generated after the DP Data, no retransmission)
+	uint32_t m_publishWindow;
+	std::map<NameId, PublishWindow> m_publishWindows;
+	// coalescing: items per DP Interest and the longest wait of a partial batch
+	uint32_t m_coalesceCount;
+	Time m_coalesceDelay;
+	Time m_publishStart;
+	PublishStats m_publishStats;
+	// segmentation: payload bytes per DP Interest(0: one DP per item) and segments in flight per item
+	uint32_t m_segmentSize;
+	uint32_t m_segmentWindow;
+	std::map<std::pair<NameId, uint32_t>, SegmentUpload> m_uploads;
+
 	uint32_t m_nPAInterestCount;
 	uint32_t m_nPUInterestCount;
 	uint32_t m_nDPInterestCount;
@@ -126,5 +277,7 @@ private:
 	uint32_t m_nPADataCount;
 	uint32_t m_nPUDataCount;
 	uint32_t m_nDPDataCount;
+	uint32_t m_nDPRetransmitCount;
+	uint32_t m_nDPSegmentCount;
 };
 #endif
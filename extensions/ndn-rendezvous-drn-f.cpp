@@ -17,13 +17,17 @@
  * PSync, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
  **/
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <random>
 #include <vector>
 #include <regex>
 #include <sstream>
 
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/util/random.hpp>
 
@@ -42,6 +46,11 @@
 #include "ndn-consumer-drn.hpp"
 #include "ndn-rendezvous-drn-f.hpp"
 
+#include "drn-protocol.hpp"
+#include "event-tracer.hpp"
+#include "manifest-name.hpp"
+#include "scope-profiler.hpp"
+#include "topic-manifest.hpp"
 #include "utils.hpp"
 
 using namespace ns3::ndn;
@@ -76,16 +85,82 @@ RendezvousDrnF::GetTypeId() {
 
 		.AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("4s"),
 						MakeTimeAccessor(&RendezvousDrnF::m_interestLifeTime), MakeTimeChecker())
+
+		.AddAttribute("Regional", "Aggregate /RN/DM, /RN/DR of the region and cache TM/DM/DR answers", BooleanValue(false),
+						MakeBooleanAccessor(&RendezvousDrnF::m_regional), MakeBooleanChecker())
+
+		.AddAttribute("CacheLifetime", "How long the regional TM/DM answers are reused", StringValue("1s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_cacheLifetime), MakeTimeChecker())
+
+		.AddAttribute("CacheSize", "Max number of regional cache entries", ns3::UintegerValue(1000),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_cacheSize), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("Replicas", "Number of owner RNs of a hot topic(1: no replication)", ns3::UintegerValue(1),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_replicas), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("HotThreshold", "TS/TM requests per HotWindow that make a topic hot", ns3::UintegerValue(100),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_hotThreshold), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("HotWindow", "Period after which the topic request counts are halved", StringValue("10s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_hotWindow), MakeTimeChecker())
+
+		.AddAttribute("HotLifetime", "How long an access RN spreads the requests of a hot topic", StringValue("10s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_hotLifetime), MakeTimeChecker())
+
+		.AddAttribute("SketchWidth", "Counters per row of the topic request sketch", ns3::UintegerValue(256),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_sketchWidth), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("SketchDepth", "Rows of the topic request sketch", ns3::UintegerValue(4),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_sketchDepth), ns3::MakeUintegerChecker<uint32_t>(1))
+
+		.AddAttribute("TSFreshness", "FreshnessPeriod of the TS answers(0: not set)", StringValue("0s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_tsFreshness), MakeTimeChecker())
+
+		.AddAttribute("TMFreshness", "FreshnessPeriod of the TM answers(0: not set)", StringValue("0s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_tmFreshness), MakeTimeChecker())
+
+		.AddAttribute("DMFreshness", "FreshnessPeriod of the DM answers(0: not set)", StringValue("0s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_dmFreshness), MakeTimeChecker())
+
+		.AddAttribute("DRFreshness", "FreshnessPeriod of the DR answers(0: not set)", StringValue("0s"),
+						MakeTimeAccessor(&RendezvousDrnF::m_drFreshness), MakeTimeChecker())
+
+		.AddAttribute("BinaryManifest", "Answer TM with the front coded TLV manifest instead of the text list", BooleanValue(false),
+						MakeBooleanAccessor(&RendezvousDrnF::m_binaryManifest), MakeBooleanChecker())
+
+		.AddAttribute("ManifestPage", "Max bytes of a binary TM answer, the rest is paged by a continuation token(0: no paging)", ns3::UintegerValue(7000),
+						ns3::MakeUintegerAccessor(&RendezvousDrnF::m_manifestPage), ns3::MakeUintegerChecker<uint32_t>())
+
+		.AddAttribute("NegativeReply", "Answer a TM/DM without a match at once by a negative reply instead of keeping it pending", BooleanValue(false),
+						MakeBooleanAccessor(&RendezvousDrnF::m_negativeReply), MakeBooleanChecker())
+
+		.AddAttribute("RetryAfter", "Retry-after hint of the negative replies", StringValue("500ms"),
+						MakeTimeAccessor(&RendezvousDrnF::m_retryAfter), MakeTimeChecker())
 						;
     return tid;
 }
 
 RendezvousDrnF::RendezvousDrnF()
-	: m_nSub(0)
+	: m_drnPrefixId(NAME_ID_NONE)
+	, m_nSub(0)
 	, m_nDataSize(0)
 	, m_rng(::ndn::random::getRandomNumberEngine())
 	, m_appId(std::numeric_limits<uint32_t>::max())
 	, m_signature(0U)
+	, m_regional(false)
+	, m_cacheSize(1000)
+	, m_replicas(1)
+	, m_hotThreshold(100)
+	, m_sketchWidth(256)
+	, m_sketchDepth(4)
+	, m_binaryManifest(false)
+	, m_manifestPage(7000)
+	, m_manifestStats()
+	, m_negativeReply(false)
+	, m_retryAfter(MilliSeconds(500))
+	, m_advertiseVersion(0)
+	, m_nRNsnNegativeTMCount(0)
+	, m_nRNsnNegativeDMCount(0)
 	, m_nRN__TSInterestCount(0)
 	, m_nRNsnTSInterestCount(0)
 	, m_nRNrvTSInterestCount(0)
@@ -114,6 +189,12 @@ RendezvousDrnF::RendezvousDrnF()
 	, m_nRNsnPUInterestCount(0)
 	, m_nRNrvPUInterestCount(0)
 	, m_nRN__DPInterestCount(0)
+	, m_nRN__DPItemCount(0)
+	, m_nRN__DPSegmentCount(0)
+	, m_nRNsnDRSegmentCount(0)
+	, m_nRN__BulkTopicCount(0)
+	, m_nRNrvBulkTopicCount(0)
+	, m_nBulkSequence(0)
 
 	, m_nRNsnPANackCount(0)
 	, m_nRNsnPUNackCount(0)
@@ -125,6 +206,18 @@ RendezvousDrnF::RendezvousDrnF()
 	, m_nRNsnPUDataCount(0)
 	, m_nRNrvPUDataCount(0)
 	, m_nRN__DPDataCount(0)
+	, m_nRN__DMInterestCount(0)
+	, m_nRNsnDMInterestCount(0)
+	, m_nRN__DRInterestCount(0)
+	, m_nRNsnDRInterestCount(0)
+	, m_nRNrvDMDataCount(0)
+	, m_nRNrvDRDataCount(0)
+	, m_nRegionalTMHitCount(0)
+	, m_nRegionalDMHitCount(0)
+	, m_nRegionalDRHitCount(0)
+	, m_nHotTopicCount(0)
+	, m_nRNsnReplicaInterestCount(0)
+	, m_nReplicaSpreadCount(0)
 {
 }
 
@@ -132,10 +225,25 @@ void
 RendezvousDrnF::StartApplication() {
 	TimeoutApp::StartApplication();
 
+	// 재시작(churn) 된 RN은 빈 상태에서 시작한다
+	m_PAMap.clear();
+	m_DPMap.clear();
+	m_segmentedObjects.clear();
+	m_regionalCache.clear();
+	m_regionalCacheOrder.clear();
+	m_upstream.clear();
+
+	m_topicSketch.resize(m_sketchWidth, m_sketchDepth);
+	m_sketchWindowEnd = Simulator::Now() + m_hotWindow;
+	m_replicatedTopics.clear();
+	m_hotTopics.clear();
+
 	FibHelper::AddRoute(GetNode(), m_drnPrefix, m_face, 0);
 	FibHelper::AddRoute(GetNode(), m_rnPrefix, m_face, 0);
 	NS_LOG_DEBUG(stringf("AddFIB(%5u): ", GetNode()->GetId()) << m_drnPrefix);
 
+	m_drnPrefixId = NameInterner::Get().intern(m_drnPrefix);
+
 	m_objectContainer->get("dht-nodes", m_dhtNodes);
 
 #if 0
@@ -148,6 +256,10 @@ RendezvousDrnF::StartApplication() {
 
 void
 RendezvousDrnF::StopApplication() {
+	if(m_active == false) {
+		return;
+	}
+
 	NS_LOG_DEBUG("StopApplication");
     //m_rnTopic->stop();
 
@@ -180,6 +292,11 @@ RendezvousDrnF::StopApplication() {
 	NS_LOG_INFO(stringf("Send RNxx PUInterestCount: %5u", m_nRNsnPUInterestCount));
 	NS_LOG_INFO(stringf("Recv RNxx PUInterestCount: %5u", m_nRNrvPUInterestCount));
 	NS_LOG_INFO(stringf("Recv RN   DPInterestCount: %5u", m_nRN__DPInterestCount));
+	NS_LOG_INFO(stringf("Recv RN   DPItemCount:     %5u", m_nRN__DPItemCount));
+	NS_LOG_INFO(stringf("Recv RN   DPSegmentCount:  %5u", m_nRN__DPSegmentCount));
+	NS_LOG_INFO(stringf("Send RNxx DRSegmentCount:  %5u", m_nRNsnDRSegmentCount));
+	NS_LOG_INFO(stringf("Recv RN   BulkTopicCount:  %5u", m_nRN__BulkTopicCount));
+	NS_LOG_INFO(stringf("Recv RNxx BulkTopicCount:  %5u", m_nRNrvBulkTopicCount));
 
 	NS_LOG_INFO(stringf("Nack RNxx PAInterestCount: %5u", m_nRNsnPANackCount));
 	NS_LOG_INFO(stringf("Nack RNxx PUInterestCount: %5u", m_nRNsnPUNackCount));
@@ -192,13 +309,43 @@ RendezvousDrnF::StopApplication() {
 	NS_LOG_INFO(stringf("Send RNxx PUDataCount:     %5u", m_nRNsnPUDataCount));
 	NS_LOG_INFO(stringf("Recv RNxx PUDataCount:     %5u", m_nRNrvPUDataCount));
 	NS_LOG_INFO(stringf("Recv RN   DPDataCount:     %5u", m_nRN__DPDataCount));
+
+	if (m_regional) {
+		NS_LOG_INFO(stringf("Recv RN   DMInterestCount: %5u", m_nRN__DMInterestCount));
+		NS_LOG_INFO(stringf("Send RNxx DMInterestCount: %5u", m_nRNsnDMInterestCount));
+		NS_LOG_INFO(stringf("Recv RN   DRInterestCount: %5u", m_nRN__DRInterestCount));
+		NS_LOG_INFO(stringf("Send RNxx DRInterestCount: %5u", m_nRNsnDRInterestCount));
+		NS_LOG_INFO(stringf("Recv RNxx DMDataCount:     %5u", m_nRNrvDMDataCount));
+		NS_LOG_INFO(stringf("Recv RNxx DRDataCount:     %5u", m_nRNrvDRDataCount));
+		NS_LOG_INFO(stringf("Regional TMHitCount:       %5u", m_nRegionalTMHitCount));
+		NS_LOG_INFO(stringf("Regional DMHitCount:       %5u", m_nRegionalDMHitCount));
+		NS_LOG_INFO(stringf("Regional DRHitCount:       %5u", m_nRegionalDRHitCount));
+	}
+
+	if (m_negativeReply) {
+		NS_LOG_INFO(stringf("Send RNxx NegativeTMCount: %5u", m_nRNsnNegativeTMCount));
+		NS_LOG_INFO(stringf("Send RNxx NegativeDMCount: %5u", m_nRNsnNegativeDMCount));
+	}
+
+	const ManifestStats &stats = m_manifestStats;
+	if (0 < stats.answers) {
+		NS_LOG_INFO(stringf("TM manifest: %llu answers(%llu paged), %llu entries, %.2f bytes/entry",
+				(unsigned long long)stats.answers, (unsigned long long)stats.pages, (unsigned long long)stats.entries,
+				(0 < stats.entries) ? (double)stats.bytes / stats.entries : 0.0));
+	}
+
+	if (1 < m_replicas) {
+		NS_LOG_INFO(stringf("Hot TopicCount:            %5u", m_nHotTopicCount));
+		NS_LOG_INFO(stringf("Send RNxx ReplicaInterestCount: %5u", m_nRNsnReplicaInterestCount));
+		NS_LOG_INFO(stringf("Replica SpreadCount:       %5u", m_nReplicaSpreadCount));
+	}
 }
 
 void
 RendezvousDrnF::sendData(const Name &dataName, const Block &content) {
 	auto data = make_shared<Data>();
 	data->setName(dataName);
-    //data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
+	setFreshnessPeriod(*data);
 
 	if (0 < content.value_size() || 0 < content.elements_size()) {
 		data->setContent(content);
@@ -224,6 +371,8 @@ RendezvousDrnF::sendData(const Name &dataName, const Block &content) {
 	data->wireEncode();
 
 	// data sent time
+	NS_LOG_DEBUG("send data: " << data->getName());
+	EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 	m_appLink->onReceiveData(*data);
 	removePendingTimeoutEvent(data->getName());
 }
@@ -238,8 +387,13 @@ void
 RendezvousDrnF::sendData(const Name &dataName, shared_ptr<const ::ndn::Buffer> &value) {
 	auto data = make_shared<Data>();
 	data->setName(dataName);
-    //data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
+	setFreshnessPeriod(*data);
+
+	sendData(data, value);
+}
 
+void
+RendezvousDrnF::sendData(shared_ptr<Data> data, shared_ptr<const ::ndn::Buffer> &value) {
 	if (0 < value->size()) {
 		data->setContent(value);
 	}
@@ -264,6 +418,8 @@ RendezvousDrnF::sendData(const Name &dataName, shared_ptr<const ::ndn::Buffer> &
 	data->wireEncode();
 
 	// data sent time
+	NS_LOG_DEBUG("send data: " << data->getName());
+	EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 	m_appLink->onReceiveData(*data);
 }
 
@@ -273,32 +429,88 @@ RendezvousDrnF::sendData(shared_ptr<const Interest> interest, shared_ptr<const :
 	sendData(dataName, value);
 }
 
+/**
+ * 응답할 것이 없는 TM/DM: pending 하지 않고 retry-after와 version을 돌려준다.
+ */
+void
+RendezvousDrnF::sendDataNegative(const Name &interestName, DrnCommand cmd, uint64_t version) {
+	NegativeReply reply { (uint64_t)m_retryAfter.GetMilliSeconds(), version };
+	shared_ptr<const ::ndn::Buffer> buffer = encodeNegativeReply(reply.retryAfter, reply.version);
+	sendDataNegative(interestName, buffer, reply);
+	removePendingTimeoutEvent(interestName);
+
+	if (cmd == CMD_TM) {
+		m_nRNsnNegativeTMCount += 1;
+	} else {
+		m_nRNsnNegativeDMCount += 1;
+	}
+}
+
+/**
+ * consumer는 retry-after 이상 기다린다. 그 전에 content store의 negative reply가 stale 이 되어야 retry가 RN에 간다.
+ */
+void
+RendezvousDrnF::sendDataNegative(const Name &dataName, shared_ptr<const ::ndn::Buffer> &value, const NegativeReply &reply) {
+	auto data = make_shared<Data>();
+	data->setName(dataName);
+	data->setFreshnessPeriod(::ndn::time::milliseconds(reply.retryAfter / 2));
+
+	sendData(data, value);
+}
+
+void
+RendezvousDrnF::setFreshnessPeriod(Data &data) {
+	// /RN/{cmd}/..., /RN-{yyy}/{cmd}/...
+	::ns3::Time freshness;
+	switch (parseCommand(data.getName(), 1)) {
+	case CMD_TS:
+		freshness = m_tsFreshness;
+		break;
+	case CMD_TM:
+		freshness = m_tmFreshness;
+		break;
+	case CMD_DM:
+		freshness = m_dmFreshness;
+		break;
+	case CMD_DR:
+		freshness = m_drFreshness;
+		break;
+	default:
+		return;
+	}
+
+	if (freshness.IsStrictlyPositive()) {
+		data.setFreshnessPeriod(::ndn::time::milliseconds(freshness.GetMilliSeconds()));
+	}
+}
+
 int
 RendezvousDrnF::sendDataTM(const Name &interestName, int32_t attentionIndex) {
 	// /RN-{yyy}/TM/a/b/c/topic-{nnn}
 	// /RN/TM/a/b/c/topic-{nnn}
 	// /RN-{yyy}/TM/a/b/*
 	// /RN/TM/a/b/*
+	// /RN/TM/a/b/c/topic-{nnn}/{slot}: 응답 이름은 slot을 유지한다.
+	// /RN/TM/a/b/*/{token}: binary manifest의 page(0: 첫 page)
 
-	Name topicName = interestName.getSubName(attentionIndex, Name::npos);
+	Name topicName = stripPageToken(interestName.getSubName(attentionIndex, Name::npos));
 	string topic = ::ndn::unescape(topicName.toUri());
+	if (m_binaryManifest) {
+		return sendDataTMManifest(interestName, attentionIndex, topicName, topic);
+	}
 
+	NameInterner &interner = NameInterner::Get();
 	std::stringstream sio;
-	StringMapIterator mapIter;
-
-	mapIter = m_PAMap.begin();
-	for ( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-		NS_LOG_DEBUG(mapIter->first << ": " << mapIter->second);
-	}
+	NameIdMapIterator mapIter;
 
 	// content format: {topic}:{node name},{topic}:{node name},...
 	// ex) /a/b/c:RN-00001,/a/b/d:RN-00002
 
 	int at = topic.find('*');
 	if (at < 0) {
-		mapIter = m_PAMap.find(topic);
+		mapIter = m_PAMap.find(interner.find(topicName));
 		if (mapIter != m_PAMap.end()) {
-			sio << stringf("%s:%s", mapIter->first.c_str(), mapIter->second.c_str());
+			sio << stringf("%s:%s", interner.getUri(mapIter->first).c_str(), nodeLabel(mapIter->second));
 		}
 	} else {
 		string exp(topic);
@@ -306,11 +518,12 @@ RendezvousDrnF::sendDataTM(const Name &interestName, int32_t attentionIndex) {
 		int count = 0;
 		std::regex reg(exp);
 		for ( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-			if (std::regex_match(mapIter->first, reg)) {
+			const string &uri = interner.getUri(mapIter->first);
+			if (std::regex_match(uri, reg)) {
 				if (0 < count) {
 					sio << ',';
 				}
-				sio << stringf("%s:%s", mapIter->first.c_str(), mapIter->second.c_str());
+				sio << stringf("%s:%s", uri.c_str(), nodeLabel(mapIter->second));
 				count ++;
 			}
 		}
@@ -320,12 +533,89 @@ RendezvousDrnF::sendDataTM(const Name &interestName, int32_t attentionIndex) {
 		return 0;
 	}
 
+	// hot topic이면 owner의 응답 앞에 replica 수를 붙인다: *{replicas}|{topic}:{node name},...
+	// access RN이 떼어내고 consumer에게 전달한다.
+	string topicPrefix = interestName.get(attentionIndex).toUri();
+	if (m_drnPrefix.isPrefixOf(interestName) && m_replicatedTopics.find(topicPrefix) != m_replicatedTopics.end()) {
+		nodes = stringf("*%u|", m_replicas) + nodes;
+	}
+
 	shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>((const uint8_t *)nodes.c_str(), nodes.size());
 
 	Name dataName(interestName);
 	sendData(dataName, buffer);
 
 	m_nRNsnTMDataCount += 1;
+	m_manifestStats.answers += 1;
+	m_manifestStats.entries += std::count(nodes.begin(), nodes.end(), ',') + 1;
+	m_manifestStats.bytes += nodes.size();
+
+	return 1;
+}
+
+/**
+ * binary TM 응답: PAMap을 NameId 순서로 훑어 ManifestPage 까지 채우고, 남은 topic은 다음 NameId를 token으로 준다.
+ * NameId 순서는 topic이 추가, 삭제되어도 바뀌지 않으므로 page 사이에 빠지거나 겹치는 topic이 없다.
+ */
+int
+RendezvousDrnF::sendDataTMManifest(const Name &interestName, int32_t attentionIndex, const Name &topicName, const string &topic) {
+	NameInterner &interner = NameInterner::Get();
+	TopicManifest manifest;
+
+	string topicPrefix = interestName.get(attentionIndex).toUri();
+	if (m_drnPrefix.isPrefixOf(interestName) && m_replicatedTopics.find(topicPrefix) != m_replicatedTopics.end()) {
+		manifest.setReplicas(m_replicas);
+	}
+
+	// token 0 은 첫 page, continuation은 첫 entry 보다 큰 NameId 이므로 0 이 아니다
+	Name requestName = stripSlot(interestName.getSubName(attentionIndex, Name::npos));
+	uint64_t token = hasPageToken(requestName) ? requestName.get(-1).toSequenceNumber() : 0;
+	bool paged = 0 < token;
+
+	int at = topic.find('*');
+	if (at < 0) {
+		NameIdMapIterator mapIter = m_PAMap.find(interner.find(topicName));
+		if (mapIter != m_PAMap.end()) {
+			manifest.add(interner.getUri(mapIter->first), nodeLabel(mapIter->second));
+		}
+	} else {
+		string exp(topic);
+		exp.insert(at, 1, '.');
+		std::regex reg(exp);
+
+		NameIdMapIterator mapIter = m_PAMap.begin();
+		if (paged) {
+			mapIter = m_PAMap.lower_bound(token);
+		}
+		for (; mapIter != m_PAMap.end(); mapIter ++) {
+			const string &uri = interner.getUri(mapIter->first);
+			if (!std::regex_match(uri, reg)) {
+				continue;
+			}
+			const char *node = nodeLabel(mapIter->second);
+			if (0 < m_manifestPage && 0 < manifest.size() && m_manifestPage < manifest.getSizeBound(uri, node)) {
+				manifest.setContinuation(mapIter->first);
+				break;
+			}
+			manifest.add(uri, node);
+		}
+	}
+
+	// 다음 page 요청에는 비어 있어도 응답한다
+	if (manifest.size() == 0 && !paged) {
+		return 0;
+	}
+
+	shared_ptr<const ::ndn::Buffer> buffer = manifest.wireEncode();
+
+	Name dataName(interestName);
+	sendData(dataName, buffer);
+
+	m_nRNsnTMDataCount += 1;
+	m_manifestStats.answers += 1;
+	m_manifestStats.pages += manifest.hasContinuation() ? 1 : 0;
+	m_manifestStats.entries += manifest.size();
+	m_manifestStats.bytes += buffer->size();
 
 	return 1;
 }
@@ -358,26 +648,29 @@ RendezvousDrnF::sendDataPA(const Name &interestName, int32_t attentionIndex) {
 	data->wireEncode();
 
 	// data sent time
+	NS_LOG_DEBUG("send data: " << data->getName());
+	EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 	m_appLink->onReceiveData(*data);
 	removePendingTimeoutEvent(data->getName());
 }
 
 void 
 RendezvousDrnF::receiveInterestRNPA(const Name &interestName, int32_t attentionIndex, string topic) {
-	//  topic의 hash값을 계산하고
-	lli topicHash = getHash(topic);
-
-	// 담당 Node를  찾는다.
-	int index = topicHash % m_dhtNodes->size();
-	string nodeName = m_dhtNodes->at(index);
+	// 담당 Node를  찾는다(topic의 hash).
+	const string &nodeName = getTopicRN(topic, 0);
 
 	NS_LOG_DEBUG("TopicRN: " << nodeName);
 
-	if (m_drnPrefix.equals(Name(nodeName))) {
+	if (isSelf(nodeName)) {
 		// self
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 
-		m_PAMap.insert(std::pair<std::string, std::string>(topicName.toUri(), nodeName));
+		m_PAMap.insert(std::make_pair(NameInterner::Get().intern(topicName), m_drnPrefixId));
+		m_advertiseVersion += 1;
+
+		if (m_replicatedTopics.find(topic) != m_replicatedTopics.end()) {
+			sendInterestRNXXXReplica(CMD_PA, topicName, nodeName);
+		}
 		return;
 	}
 
@@ -424,9 +717,9 @@ RendezvousDrnF::sendInterestRNXXXPA(const Name &interestName, int32_t attentionI
 
 	interest->setParameters(params);
 
-	NS_LOG_DEBUG("send interest: " << paInterestName);
-
 #if 1
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -436,17 +729,14 @@ RendezvousDrnF::sendInterestRNXXXPA(const Name &interestName, int32_t attentionI
 
 void 
 RendezvousDrnF::receiveInterestRNPU(const Name &interestName, string topic) {
-	// topic의 hash값을 계산하고
-	lli topicHash = getHash(topic);
-
-	// 담당 Node를  찾는다.
-	int index = topicHash % m_dhtNodes->size();
-	string nodeName = m_dhtNodes->at(index);
+	// 담당 Node를  찾는다(topic의 hash).
+	const string &nodeName = getTopicRN(topic, 0);
 
 	NS_LOG_DEBUG("TopicRN: " << nodeName);
 
-	if (m_drnPrefix.equals(Name(nodeName))) {
-		// self
+	if (isSelf(nodeName)) {
+		// self: PAMap에서 지우고 replica에게도 전달한다
+		advertiseTopic(CMD_PU, interestName.getSubName(2, Name::npos), m_drnPrefix.get(0).toUri());
 		return;
 	}
 
@@ -491,9 +781,9 @@ RendezvousDrnF::receiveInterestRNPU(const Name &interestName, string topic) {
 
 	interest->setParameters(params);
 
-	NS_LOG_DEBUG("send interest: " << puInterestName << ", topic prefix: " << topic << ", value: " << drnPrefix );
-
 #if 1
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -503,22 +793,337 @@ RendezvousDrnF::receiveInterestRNPU(const Name &interestName, string topic) {
 	return;
 }
 
+/**
+ * producer의 /RN/PAB/{node id}/{batch}, /RN/PUB/...
+ * parameters의 topic들을 담당 RN 별로 묶어서 RN 마다 Interest 하나로 보낸다.
+ */
+void
+RendezvousDrnF::receiveInterestRNBulk(shared_ptr<const Interest> interest, DrnCommand cmd) {
+	DrnCommand topicCmd = (cmd == CMD_PAB) ? CMD_PA : CMD_PU;
+	string drnPrefix = m_drnPrefix.get(0).toUri();
+
+	const Block &params = interest->getParameters();
+	params.parse();
+
+	// 담당 RN -> topics
+	std::map<string, std::vector<Name>> owners;
+	Block::element_const_iterator iter = params.elements_begin();
+	for (; iter != params.elements_end(); iter++) {
+		if (iter->type() != ::ndn::tlv::Name) {
+			continue;
+		}
+		Name topicName(*iter);
+		if (topicName.size() == 0) {
+			continue;
+		}
+		m_nRN__BulkTopicCount += 1;
+
+		const string &nodeName = getTopicRN(topicName.get(0).toUri(), 0);
+		if (isSelf(nodeName)) {
+			advertiseTopic(topicCmd, topicName, drnPrefix);
+			continue;
+		}
+		owners[nodeName].push_back(topicName);
+	}
+
+	std::map<string, std::vector<Name>>::iterator ownerIter = owners.begin();
+	for (; ownerIter != owners.end(); ownerIter++) {
+		sendInterestRNXXXBulk(cmd, ownerIter->first, ownerIter->second);
+	}
+
+	Block empty;
+	sendData(interest->getName(), empty);
+}
+
+void
+RendezvousDrnF::sendInterestRNXXXBulk(DrnCommand cmd, const string &nodeName, const std::vector<Name> &topics) {
+	// /RN-{yyy}/PAB/RN-{xxx}/{batch}: RN-{xxx}가 topic들의 publisher RN
+	Name bulkInterestName(nodeName);
+	bulkInterestName.append(commandName(cmd)).append(m_drnPrefix.get(0)).appendNumber(m_nBulkSequence++);
+
+	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
+	interest->setName(bulkInterestName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+
+	::ndn::Block params(::ndn::tlv::Parameters);
+	std::vector<Name>::const_iterator iter = topics.begin();
+	for (; iter != topics.end(); iter++) {
+		params.push_back(iter->wireEncode());
+	}
+	params.encode();
+	interest->setParameters(params);
+
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName(), params.size());
+	m_appLink->onReceiveInterest(*interest);
+	if (cmd == CMD_PAB) {
+		m_nRNsnPAInterestCount += 1;
+	} else {
+		m_nRNsnPUInterestCount += 1;
+	}
+}
+
+void
+RendezvousDrnF::receiveInterestRNXXXBulk(shared_ptr<const Interest> interest, DrnCommand cmd) {
+	const Name &interestName = interest->getName();
+	DrnCommand topicCmd = (cmd == CMD_PAB) ? CMD_PA : CMD_PU;
+
+	// /RN-{xxx}/PAB/RN-{yyy}/{batch}
+	string publisher = interestName.get(m_drnPrefix.size() + 1).toUri();
+
+	const Block &params = interest->getParameters();
+	params.parse();
+
+	Block::element_const_iterator iter = params.elements_begin();
+	for (; iter != params.elements_end(); iter++) {
+		if (iter->type() != ::ndn::tlv::Name) {
+			continue;
+		}
+		Name topicName(*iter);
+		if (topicName.size() == 0) {
+			continue;
+		}
+		m_nRNrvBulkTopicCount += 1;
+
+		advertiseTopic(topicCmd, topicName, publisher);
+	}
+
+	Block empty;
+	sendData(interestName, empty);
+}
+
+void
+RendezvousDrnF::advertiseTopic(DrnCommand cmd, const Name &topicName, const string &publisher) {
+	NameInterner &interner = NameInterner::Get();
+	if (cmd == CMD_PA) {
+		m_PAMap.insert(std::make_pair(interner.intern(topicName), interner.intern(publisher)));
+	} else {
+		NameIdMapIterator iter = m_PAMap.find(interner.find(topicName));
+		if (iter != m_PAMap.end()) {
+			m_PAMap.erase(iter);
+		}
+	}
+	m_advertiseVersion += 1;
+
+	// owner가 복제 중인 hot topic이면 replica에게도 전달한다
+	if (m_replicatedTopics.find(topicName.get(0).toUri()) != m_replicatedTopics.end()) {
+		sendInterestRNXXXReplica(cmd, topicName, publisher);
+	}
+
+	if (cmd == CMD_PA) {
+		Name paInterestName(m_drnPrefix);
+		paInterestName.append("PA").append(topicName);
+		sendDataForPendingInsterestTM(paInterestName);
+	}
+}
+
+/**
+ * DP 여러 개를 한 번에 저장한다: topic의 목록을 한 번 찾고, 마지막 sequence로 pending DM에 응답한다.
+ */
+void
+RendezvousDrnF::receiveInterestRNDPBatch(shared_ptr<const Interest> interest, int32_t attentionIndex) {
+	const Name &interestName = interest->getName();
+	if (interestName.size() < (size_t)attentionIndex + 3) {
+		return;
+	}
+
+	// /RN/DPB/a/b/c/topic-80/{first seq}/{count}
+	Name topicName = interestName.getSubName(attentionIndex, interestName.size() - attentionIndex - 2);
+	uint64_t firstSeq = std::strtoull(interestName.get(-2).toUri().c_str(), nullptr, 10);
+
+	const Block &params = interest->getParameters();
+	params.parse();
+
+	NameId topicId = NameInterner::Get().intern(topicName);
+	BufferListPtr dataListPtr;
+	NameBufferListMapIterator dataListPtrIter = m_DPMap.find(topicId);
+	if (dataListPtrIter == m_DPMap.end()) {
+		dataListPtr = make_shared<std::vector<BufferPtr>>();
+		m_DPMap.insert(std::make_pair(topicId, dataListPtr));
+	} else {
+		dataListPtr = dataListPtrIter->second;
+	}
+	dataListPtr->reserve(dataListPtr->size() + params.elements_size());
+
+	// 여기서도 sequence만 넣는다.
+	uint64_t seq = firstSeq;
+	Block::element_const_iterator iter = params.elements_begin();
+	for (; iter != params.elements_end(); iter++) {
+		if (iter->type() != ::ndn::tlv::AppPrivateBlock1) {
+			continue;
+		}
+		string seqStr = std::to_string(seq++);
+		dataListPtr->push_back(make_shared<::ndn::Buffer>((const void*)seqStr.c_str(), seqStr.size()));
+	}
+	if (seq == firstSeq) {
+		Block empty;
+		sendData(interestName, empty);
+		return;
+	}
+	m_nRN__DPItemCount += seq - firstSeq;
+	EventTracer::Get().record(TRACE_STORE, CMD_DP, GetNode()->GetId(), topicId, seq - 1, dataListPtr->size());
+
+	// Pending 된 DM interest가 있으면 마지막 sequence의 Data를 보낸다.
+	Name lastName(m_rnPrefix);
+	lastName.append(commandName(CMD_DP)).append(topicName).append(std::to_string(seq - 1));
+	sendDataForPendingInsterestDM(lastName);
+
+	Block empty;
+	sendData(interestName, empty);
+}
+
+/**
+ * segment 마다 응답하고, 합치지 않고 크기만 기록한다. 모든 segment를 받으면 sequence를 DP 처럼 저장한다.
+ */
+void
+RendezvousDrnF::receiveInterestRNDPSegment(shared_ptr<const Interest> interest, int32_t attentionIndex) {
+	const Name &interestName = interest->getName();
+	Block empty;
+	if (interestName.size() < (size_t)attentionIndex + 3) {
+		sendData(interestName, empty);
+		return;
+	}
+
+	// /RN/DP/a/b/c/topic-80/{seq}/{segment}
+	Name topicName = interestName.getSubName(attentionIndex, interestName.size() - attentionIndex - 2);
+	string seqStr = interestName.get(-2).toUri();
+	uint64_t seq = std::strtoull(seqStr.c_str(), nullptr, 10);
+	uint64_t segment = interestName.get(-1).toSegment();
+
+	// parameters: AppPrivateBlock1(payload), FinalBlockId(last segment)
+	const Block &params = interest->getParameters();
+	params.parse();
+	Block::element_const_iterator finalIter = params.find(::ndn::tlv::FinalBlockId);
+	if (finalIter == params.elements_end()) {
+		sendData(interestName, empty);
+		return;
+	}
+	uint64_t finalSegment = ::ndn::name::Component(finalIter->blockFromValue()).toSegment();
+	Block::element_const_iterator payloadIter = params.find(::ndn::tlv::AppPrivateBlock1);
+	size_t payload = (payloadIter != params.elements_end()) ? payloadIter->value_size() : 0;
+
+	NameId topicId = NameInterner::Get().intern(topicName);
+	SegmentedObject &object = m_segmentedObjects[std::make_pair(topicId, seq)];
+	if (object.segments == 0) {
+		object.segments = finalSegment + 1;
+		object.received.assign(object.segments, false);
+	}
+
+	// 재전송된 segment는 다시 세지 않는다
+	if (object.receivedCount < object.segments && segment < object.segments && !object.received[segment]) {
+		object.received[segment] = true;
+		object.receivedCount += 1;
+		object.segmentSize = std::max(object.segmentSize, (uint32_t)payload);
+		object.size += payload;
+		m_nRN__DPSegmentCount += 1;
+
+		if (object.receivedCount == object.segments) {
+			std::vector<bool>().swap(object.received);
+
+			BufferListPtr dataListPtr;
+			NameBufferListMapIterator dataListPtrIter = m_DPMap.find(topicId);
+			if (dataListPtrIter == m_DPMap.end()) {
+				dataListPtr = make_shared<std::vector<BufferPtr>>();
+				m_DPMap.insert(std::make_pair(topicId, dataListPtr));
+			} else {
+				dataListPtr = dataListPtrIter->second;
+			}
+			dataListPtr->push_back(make_shared<::ndn::Buffer>((const void*)seqStr.c_str(), seqStr.size()));
+			m_nRN__DPItemCount += 1;
+			EventTracer::Get().record(TRACE_STORE, CMD_DP, GetNode()->GetId(), topicId, seq, dataListPtr->size());
+
+			Name dpName(m_rnPrefix);
+			dpName.append(commandName(CMD_DP)).append(topicName).append(seqStr);
+			sendDataForPendingInsterestDM(dpName);
+		}
+	}
+
+	sendData(interestName, empty);
+}
+
+/**
+ * segment의 응답: 기록한 크기로 content를 만들고 FinalBlockId를 붙인다.
+ * segment 없이 저장된 DP는 segment 0 하나로 응답한다.
+ */
+void
+RendezvousDrnF::sendDataDRSegment(const Name &interestName, int32_t attentionIndex) {
+	auto data = make_shared<Data>();
+	data->setName(interestName);
+	setFreshnessPeriod(*data);
+
+	// /RN-{xxx}/DR/a/b/c/topic-80/{seq}/{segment}
+	if ((size_t)attentionIndex + 3 <= interestName.size()) {
+		Name topicName = interestName.getSubName(attentionIndex, interestName.size() - attentionIndex - 2);
+		string seqStr = interestName.get(-2).toUri();
+		uint64_t segment = interestName.get(-1).toSegment();
+		NameId topicId = NameInterner::Get().find(topicName);
+
+		std::map<std::pair<NameId, uint64_t>, SegmentedObject>::iterator objectIter;
+		objectIter = m_segmentedObjects.find(std::make_pair(topicId, std::strtoull(seqStr.c_str(), nullptr, 10)));
+		if (objectIter != m_segmentedObjects.end()) {
+			const SegmentedObject &object = objectIter->second;
+			if (object.receivedCount == object.segments && segment < object.segments) {
+				uint64_t offset = segment * object.segmentSize;
+				shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>(std::min((uint64_t)object.segmentSize, object.size - offset));
+				::memset(buffer->get<uint8_t>(), 'a', buffer->size());
+				data->setContent(buffer);
+				data->setFinalBlock(::ndn::name::Component::fromSegment(object.segments - 1));
+				m_nRNsnDRSegmentCount += 1;
+			}
+		} else if (segment == 0) {
+			NameBufferListMapIterator mapIter = m_DPMap.find(topicId);
+			if (mapIter != m_DPMap.end()) {
+				BufferListIterator bufferIter = mapIter->second->begin();
+				for (; bufferIter != mapIter->second->end(); bufferIter ++) {
+					if (seqStr.compare(0, string::npos, (const char *)(*bufferIter)->data(), (*bufferIter)->size()) == 0) {
+						shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>(m_nDataSize);
+						::memset(buffer->get<uint8_t>(), 'a', buffer->size());
+						data->setContent(buffer);
+						data->setFinalBlock(::ndn::name::Component::fromSegment(0));
+						m_nRNsnDRSegmentCount += 1;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	Signature signature;
+	SignatureInfo signatureInfo(static_cast<::ndn::tlv::SignatureTypeValue>(255));
+
+	if (m_keyLocator.size() > 0) {
+		signatureInfo.setKeyLocator(m_keyLocator);
+	}
+
+	signature.setInfo(signatureInfo);
+	signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+
+	data->setSignature(signature);
+
+	// to create real wire encoding
+	data->wireEncode();
+
+	NS_LOG_DEBUG("send data: " << data->getName());
+	EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
+	m_appLink->onReceiveData(*data);
+	removePendingTimeoutEvent(data->getName());
+}
+
 void 
 RendezvousDrnF::receiveInterestRNTS(const Name &interestName, int32_t attentionIndex) {
 
 	// /RN/TS/a/b/c/topic-{nnn}에서 3번째를 추출("a")
 	string topicPrefix = interestName.get(attentionIndex).toUri();
 
-	// topic의 hash값을 계산하고
-	lli topicHash = getHash(topicPrefix);
-
-	// 담당 Node를  찾는다.
-	int index = topicHash % m_dhtNodes->size();
-	string nodeName = m_dhtNodes->at(index);
+	// 담당 Node를  찾는다(hot topic이면 replica 중 하나).
+	string nodeName = selectTopicRN(topicPrefix);
 
 	NS_LOG_DEBUG("TopicRN: " << nodeName);
 
-	if (m_drnPrefix.equals(Name(nodeName))) {
+	if (isSelf(nodeName)) {
+		countTopicRequest(topicPrefix);
+
 		Name dataName(interestName);
 
 		Block empty;
@@ -537,13 +1142,14 @@ RendezvousDrnF::receiveInterestRNTS(const Name &interestName, int32_t attentionI
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
 	interest->setName(tsInterestName);
 	interest->setCanBePrefix(true);
-	interest->setMustBeFresh(true);
+	// slot 이름은 slot 동안 같은 응답이므로 cache된 Data도 받는다.
+	interest->setMustBeFresh(!hasSlot(topicName));
     //time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
     //interest->setInterestLifetime(interestLifeTime);
 
-	NS_LOG_DEBUG("send interest: " << tsInterestName );
-
 #if 1
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -558,26 +1164,347 @@ RendezvousDrnF::receiveInterestRNTM(const Name &interestName, int32_t attentionI
 	// /RN/TS/a/b/c/topic-{nnn}에서 3번째를 추출("a")
 	string topicPrefix = interestName.get(attentionIndex).toUri();
 
-	// topic의 hash값을 계산하고
-	lli topicHash = getHash(topicPrefix);
-
-	// 담당 Node를  찾는다.
-	int index = topicHash % m_dhtNodes->size();
-	string nodeName = m_dhtNodes->at(index);
+	// 담당 Node를  찾는다(hot topic이면 replica 중 하나).
+	string nodeName = selectTopicRN(topicPrefix);
 
 	NS_LOG_DEBUG("TopicRN: " << nodeName);
 
-	if (m_drnPrefix.equals(Name(nodeName))) {
+	if (isSelf(nodeName)) {
 		// self
+		countTopicRequest(topicPrefix);
+
 		if(0 < sendDataTM(interestName, attentionIndex)) {
 			removePendingTimeoutEvent(interestName);
+		} else if (m_negativeReply) {
+			sendDataNegative(interestName, CMD_TM, m_advertiseVersion);
 		}
 		return;
 	}
 
+	if (m_regional) {
+		// /RN-{xxx}/TM/a/b/* 의 응답이 cache에 있으면 owner에게 묻지 않는다
+		Name tmInterestName(nodeName);
+		tmInterestName.append("TM").append(interestName.getSubName(attentionIndex, Name::npos));
+
+		BufferPtr cached = findRegionalCache(tmInterestName.toUri());
+		if (cached != nullptr) {
+			shared_ptr<const ::ndn::Buffer> buffer = cached;
+			sendData(interestName, buffer);
+			m_nRegionalTMHitCount += 1;
+			return;
+		}
+	}
+
 	sendInterestRNXXXTM(interestName, attentionIndex, nodeName);
 }
 
+/**
+ * regional RN이 받은 /RN/DM/RN-{yyy}/a/b/c/topic-0, /RN/DR/RN-{yyy}/a/b/c/topic-0/3
+ * cache에 있으면 응답하고, 없으면 topic RN(RN-{yyy})에게 이름 당 하나의 Interest만 보낸다.
+ * 응답은 pending 된 Interest에 전달되고 NFD의 PIT가 region의 consumer들에게 fan-out 한다.
+ */
+void
+RendezvousDrnF::receiveInterestRNDelivery(const Name &interestName, int32_t nodeIndex) {
+	DrnCommand cmd = parseCommand(interestName, nodeIndex-1);
+	string nodeName = interestName.get(nodeIndex).toUri();
+
+	Name qualifiedName = interestName.getSubName(nodeIndex+1, Name::npos);
+
+	if (isSelf(nodeName)) {
+		// topic을 publish 받은 RN이 자신인 경우
+		if (cmd == CMD_DR) {
+			Name topicName = qualifiedName.getPrefix(-1);
+			NameBufferListMapIterator mapIter = m_DPMap.find(NameInterner::Get().find(topicName));
+			shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>();
+			if (mapIter != m_DPMap.end()) {
+				shared_ptr<::ndn::Buffer> content = make_shared<::ndn::Buffer>(m_nDataSize);
+				::memset(content->get<uint8_t>(), 'a', content->size());
+				buffer = content;
+			}
+			sendData(interestName, buffer);
+			removePendingTimeoutEvent(interestName);
+			m_nRNsnDRDataCount += 1;
+		} else {
+			NameBufferListMapIterator mapIter = m_DPMap.find(NameInterner::Get().find(qualifiedName));
+			if (mapIter != m_DPMap.end() && 0 < mapIter->second->size()) {
+				shared_ptr<const ::ndn::Buffer> buffer = mapIter->second->back();
+				sendData(interestName, buffer);
+				removePendingTimeoutEvent(interestName);
+				m_nRNsnDMDataCount += 1;
+			} else if (m_negativeReply) {
+				sendDataNegative(interestName, CMD_DM, 0);
+			}
+			// 없으면 DP를 받을 때 sendDataForPendingInsterestDM 에서 응답한다.
+		}
+		return;
+	}
+
+	Name upstreamName(nodeName);
+	upstreamName.append(commandName(cmd)).append(qualifiedName);
+	string upstream = upstreamName.toUri();
+
+	BufferPtr cached = findRegionalCache(upstream);
+	if (cached != nullptr) {
+		shared_ptr<const ::ndn::Buffer> buffer = cached;
+		sendData(interestName, buffer);
+		removePendingTimeoutEvent(interestName);
+		if (cmd == CMD_DM) {
+			m_nRegionalDMHitCount += 1;
+		} else {
+			m_nRegionalDRHitCount += 1;
+		}
+		return;
+	}
+
+	std::map<std::string, ::ns3::Time>::iterator upstreamIter = m_upstream.find(upstream);
+	if (upstreamIter != m_upstream.end() && Simulator::Now() < upstreamIter->second) {
+		return;
+	}
+	m_upstream[upstream] = Simulator::Now() + m_interestLifeTime;
+
+	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
+	interest->setName(upstreamName);
+	interest->setCanBePrefix(true);
+	interest->setMustBeFresh(true);
+	time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+	interest->setInterestLifetime(interestLifeTime);
+
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
+	m_appLink->onReceiveInterest(*interest);
+
+	if (cmd == CMD_DM) {
+		m_nRNsnDMInterestCount += 1;
+	} else {
+		m_nRNsnDRInterestCount += 1;
+	}
+}
+
+/**
+ * topic RN으로부터 받은 /RN-{yyy}/DM/..., /RN-{yyy}/DR/... 를 cache에 넣고
+ * pending 된 /RN/DM/RN-{yyy}/..., /RN/DR/RN-{yyy}/... 에 응답한다.
+ */
+void
+RendezvousDrnF::receiveDataRNXXXDelivery(shared_ptr<const Data> data) {
+	const Name &dataName = data->getName();
+	DrnCommand cmd = parseCommand(dataName, 1);
+
+	const Block &content = data->getContent();
+	BufferPtr buffer = make_shared<::ndn::Buffer>((const uint8_t *)content.value(), content.value_size());
+
+	string upstream = dataName.toUri();
+	m_upstream.erase(upstream);
+	NegativeReply reply;
+	bool negative = decodeNegativeReply(buffer->data(), buffer->size(), reply);
+	// owner에 아직 없는 DR의 빈 응답은 immutable로 cache 하지 않는다
+	if (!negative && 0 < buffer->size()) {
+		storeRegionalCache(upstream, buffer, cmd == CMD_DR);
+	}
+
+	Name localName(m_rnPrefix);
+	localName.append(commandName(cmd)).append(dataName.get(0)).append(dataName.getSubName(2, Name::npos));
+
+	shared_ptr<const ::ndn::Buffer> value = buffer;
+	if (negative) {
+		sendDataNegative(localName, value, reply);
+	} else {
+		sendData(localName, value);
+	}
+	removePendingTimeoutEvent(localName);
+}
+
+BufferPtr
+RendezvousDrnF::findRegionalCache(const string &name) {
+	std::map<std::string, std::tuple<BufferPtr, ::ns3::Time>>::iterator cacheIter = m_regionalCache.find(name);
+	if (cacheIter == m_regionalCache.end()) {
+		return nullptr;
+	}
+
+	if (std::get<1>(cacheIter->second) <= Simulator::Now()) {
+		m_regionalCache.erase(cacheIter);
+		return nullptr;
+	}
+
+	return std::get<0>(cacheIter->second);
+}
+
+/**
+ * DR 응답은 변하지 않으므로 만료되지 않는다. CacheSize를 넘으면 오래된 것부터 지운다.
+ */
+void
+RendezvousDrnF::storeRegionalCache(const string &name, BufferPtr content, bool immutable) {
+	::ns3::Time expire = immutable ? ::ns3::Time::Max() : Simulator::Now() + m_cacheLifetime;
+
+	if (m_regionalCache.find(name) == m_regionalCache.end()) {
+		m_regionalCacheOrder.push_back(name);
+	}
+	m_regionalCache[name] = std::make_tuple(content, expire);
+
+	while (m_cacheSize < m_regionalCacheOrder.size()) {
+		m_regionalCache.erase(m_regionalCacheOrder.front());
+		m_regionalCacheOrder.pop_front();
+	}
+}
+
+/**
+ * topic prefix의 replica 번째 담당 RN. 0은 원래 owner이고, 나머지는 독립된 hash(topic#replica)로 정한다.
+ */
+const string &
+RendezvousDrnF::getTopicRN(const string &topicPrefix, uint32_t replica) {
+	lli topicHash;
+	if (replica == 0) {
+		topicHash = NameInterner::Get().getPlacementHash(topicPrefix);
+	} else {
+		topicHash = getHash(stringf("%s#%u", topicPrefix.c_str(), replica));
+	}
+
+	int index = topicHash % m_dhtNodes->size();
+	return m_dhtNodes->at(index);
+}
+
+/**
+ * access RN: owner로부터 hot으로 알려진 topic이면 replica 중 하나를 임의로 고른다.
+ */
+string
+RendezvousDrnF::selectTopicRN(const string &topicPrefix) {
+	string owner = getTopicRN(topicPrefix, 0);
+
+	std::map<std::string, std::tuple<uint32_t, ::ns3::Time>>::iterator hotIter = m_hotTopics.find(topicPrefix);
+	if (hotIter == m_hotTopics.end()) {
+		return owner;
+	}
+
+	if (std::get<1>(hotIter->second) < Simulator::Now()) {
+		m_hotTopics.erase(hotIter);
+		return owner;
+	}
+
+	std::uniform_int_distribution<uint32_t> dist(0, std::get<0>(hotIter->second) - 1);
+	string nodeName = getTopicRN(topicPrefix, dist(m_rng));
+	if (nodeName.compare(owner) != 0) {
+		m_nReplicaSpreadCount += 1;
+	}
+
+	return nodeName;
+}
+
+/**
+ * owner: TS/TM 요청 수를 sketch로 세고, HotThreshold를 넘은 topic은 replica에게 PA를 복사한다.
+ */
+void
+RendezvousDrnF::countTopicRequest(const string &topicPrefix) {
+	// window가 지나면 절반으로 줄여 최근 요청 비율을 따라가게 한다
+	while (m_sketchWindowEnd <= Simulator::Now()) {
+		m_topicSketch.decay();
+		m_sketchWindowEnd += m_hotWindow;
+	}
+
+	uint32_t count = m_topicSketch.add(topicPrefix);
+
+	if (m_replicas <= 1 || count < m_hotThreshold) {
+		return;
+	}
+
+	if (m_replicatedTopics.find(topicPrefix) != m_replicatedTopics.end()) {
+		return;
+	}
+
+	if (isSelf(getTopicRN(topicPrefix, 0)) == false) {
+		// replica는 다시 복제하지 않는다
+		return;
+	}
+
+	replicateTopic(topicPrefix);
+}
+
+void
+RendezvousDrnF::replicateTopic(const string &topicPrefix) {
+	NS_LOG_INFO("HotTopic: " << topicPrefix);
+
+	m_replicatedTopics.insert(topicPrefix);
+	m_nHotTopicCount += 1;
+
+	// 이미 advertise 된 topic들을 replica에게 복사한다. 이후의 PA/PU는 받을 때 전달한다.
+	NameInterner &interner = NameInterner::Get();
+	NameIdMapIterator mapIter = m_PAMap.begin();
+	for (; mapIter != m_PAMap.end(); mapIter ++) {
+		const Name &topicName = interner.getName(mapIter->first);
+		if (topicName.size() == 0 || topicName.get(0).toUri().compare(topicPrefix) != 0) {
+			continue;
+		}
+
+		sendInterestRNXXXReplica(CMD_PA, topicName, nodeLabel(mapIter->second));
+	}
+}
+
+/**
+ * /RN-{replica}/PA/a/b/c/topic-{nnn}[RN-{publisher}], /RN-{replica}/PU/...
+ */
+void
+RendezvousDrnF::sendInterestRNXXXReplica(DrnCommand cmd, const Name &topicName, const string &publisher) {
+	string topicPrefix = topicName.get(0).toUri();
+	string owner = getTopicRN(topicPrefix, 0);
+
+	std::set<std::string> sent;
+	for (uint32_t replica = 1; replica < m_replicas; replica++) {
+		string nodeName = getTopicRN(topicPrefix, replica);
+		if (nodeName.compare(owner) == 0 || sent.insert(nodeName).second == false) {
+			continue;
+		}
+
+		Name replicaInterestName(nodeName);
+		replicaInterestName.append(commandName(cmd)).append(topicName);
+
+		std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
+		interest->setName(replicaInterestName);
+		interest->setCanBePrefix(true);
+		interest->setMustBeFresh(true);
+
+		shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>((const void*)publisher.c_str(), publisher.size());
+		::ndn::Block params(::ndn::tlv::Parameters, buffer);
+		params.encode();
+
+		interest->setParameters(params);
+
+		NS_LOG_DEBUG("send interest: " << interest->getName());
+		EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
+		m_appLink->onReceiveInterest(*interest);
+		m_nRNsnReplicaInterestCount += 1;
+	}
+}
+
+/**
+ * access RN: owner의 TM 응답에서 hot topic 표시(*{replicas}|)를 떼어내고 기억한다.
+ */
+void
+RendezvousDrnF::receiveDataRNXXXHotHint(const string &topicPrefix, shared_ptr<const ::ndn::Buffer> &buffer) {
+	if (TopicManifest::isManifest(buffer->data(), buffer->size())) {
+		// binary manifest의 Replicas는 consumer가 무시하므로 그대로 전달한다
+		uint32_t replicas = TopicManifest::peekReplicas(buffer->data(), buffer->size());
+		if (1 < replicas) {
+			m_hotTopics[topicPrefix] = std::make_tuple(replicas, Simulator::Now() + m_hotLifetime);
+		}
+		return;
+	}
+	if (buffer->size() == 0 || (*buffer)[0] != '*') {
+		return;
+	}
+
+	const char *begin = (const char *)buffer->data();
+	const char *end = begin + buffer->size();
+	const char *bar = std::find(begin, end, '|');
+	if (bar == end) {
+		return;
+	}
+
+	uint32_t replicas = std::strtoul(begin + 1, nullptr, 10);
+	if (1 < replicas) {
+		m_hotTopics[topicPrefix] = std::make_tuple(replicas, Simulator::Now() + m_hotLifetime);
+	}
+
+	buffer = make_shared<::ndn::Buffer>((const uint8_t *)(bar + 1), end - bar - 1);
+}
+
 void 
 RendezvousDrnF::sendInterestRNXXXTM(const Name &interestName, int32_t attentionIndex, string nodeName) {
 	// /RN/TM/a/b/* -> /RN-{xxx}/TM/a/b/*
@@ -593,13 +1520,13 @@ RendezvousDrnF::sendInterestRNXXXTM(const Name &interestName, int32_t attentionI
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
 	interest->setName(tmInterestName);
 	interest->setCanBePrefix(true);
-	interest->setMustBeFresh(true);
+	interest->setMustBeFresh(!hasSlot(topicName));
     //time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
     //interest->setInterestLifetime(interestLifeTime);
 
-	NS_LOG_DEBUG("send interest: " << tmInterestName );
-
 #if 1
+	NS_LOG_DEBUG("send interest: " << interest->getName());
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
 	m_appLink->onReceiveInterest(*interest);
 #else
 	sendInterestTimeout(interest);
@@ -620,8 +1547,9 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		return;
 	}
 
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("PA") == 0) {
+	DrnCommand cmd = parseCommand(interestName, prefixSize);
+	DRN_PROFILE_COMMAND("RendezvousDrnF", "OnInterestRN", cmd);
+	if (cmd == CMD_PA) {
 		m_nRN__PAInterestCount += 1;
 		// Publish Advertisement
 		// /RN/PA/a/b/c/topic-{nnn}
@@ -643,7 +1571,7 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		sendData(dataName, empty);
 		m_nRN__PADataCount += 1;
 
-	} else	if (cmd.compare("PU") == 0) {
+	} else	if (cmd == CMD_PU) {
 		m_nRN__PUInterestCount += 1;
 
 		// Publish Unadvertisement
@@ -662,16 +1590,41 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		Block empty;
 		sendData(dataName, empty);
 		m_nRN__PUDataCount += 1;
-	} else	if (cmd.compare("DP") == 0) {
+	} else	if (cmd == CMD_PAB) {
+		m_nRN__PAInterestCount += 1;
+		// Publish Advertisement of many topics
+		// /RN/PAB/{node id}/{batch}[/a/b/c/topic-0, /a/b/c/topic-1, ...]
+
+		receiveInterestRNBulk(interest, cmd);
+		m_nRN__PADataCount += 1;
+	} else	if (cmd == CMD_PUB) {
+		m_nRN__PUInterestCount += 1;
+
+		receiveInterestRNBulk(interest, cmd);
+		m_nRN__PUDataCount += 1;
+	} else	if (cmd == CMD_DPB) {
 		m_nRN__DPInterestCount += 1;
+		// Data Publish of consecutive sequences
+		// /RN/DPB/a/b/c/topic-80/{first seq}/{count}
+
+		receiveInterestRNDPBatch(interest, prefixSize + 1);
+		m_nRN__DPDataCount += 1;
+	} else	if (cmd == CMD_DP && interestName.get(-1).isSegment()) {
+		m_nRN__DPInterestCount += 1;
+		// Data Publish of a segment
+		// /RN/DP/a/b/c/topic-80/0/%00%03
+
+		receiveInterestRNDPSegment(interest, prefixSize + 1);
+		m_nRN__DPDataCount += 1;
+	} else	if (cmd == CMD_DP) {
+		m_nRN__DPInterestCount += 1;
+		m_nRN__DPItemCount += 1;
 		// Data Publish
 		// /RN/DP/a/b/c/topic-80/0
 
 		int32_t attentionIndex = prefixSize + 1;
 		Name qualifiedName = interestName.getSubName(attentionIndex, interestName.size()-1);
-		NS_LOG_DEBUG("qualifiedName: " << qualifiedName);
 		Name topicName = qualifiedName.getSubName(0, qualifiedName.size()-1);
-		string topic = topicName.toUri();
 		string seqStr = qualifiedName.get(qualifiedName.size()-1).toUri();
 
 		const Block &params = interest->getParameters();
@@ -690,21 +1643,22 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 
 		const Block& paramBlock = params.get(::ndn::tlv::AppPrivateBlock1);
 		shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>(paramBlock.value(), paramBlock.value_size());
-		NS_LOG_DEBUG("Published data size: " << buffer->size());
         NS_LOG_INFO("RNStoreData: " << qualifiedName);
 
 		// tuple(seq, data) 를 넣어야 하나 여기서는 sequence만 넣는다.
 		BufferPtr bufferPtr = make_shared<::ndn::Buffer>((const void*)seqStr.c_str(), seqStr.size());
 
+		NameId topicId = NameInterner::Get().intern(topicName);
 		BufferListPtr dataListPtr;
-		BufferListMapIterator dataListPtrIter = m_DPMap.find(topic);
+		NameBufferListMapIterator dataListPtrIter = m_DPMap.find(topicId);
 		if (dataListPtrIter == m_DPMap.end()) {
 			dataListPtr = make_shared<std::vector<BufferPtr>>();
-			m_DPMap.insert(pair<string , BufferListPtr>(topic, dataListPtr));
+			m_DPMap.insert(std::make_pair(topicId, dataListPtr));
 		} else {
 			dataListPtr = dataListPtrIter->second;
 		}
 		dataListPtr->push_back(bufferPtr);
+		EventTracer::Get().record(TRACE_STORE, CMD_DP, GetNode()->GetId(), topicId, std::strtoull(seqStr.c_str(), nullptr, 10), dataListPtr->size());
 
 		// Pending 된 DM interest가 있으면 Data를 보낸다.
 		sendDataForPendingInsterestDM(interestName);
@@ -735,10 +1689,12 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		data->wireEncode();
 
 		// data sent time
+		NS_LOG_DEBUG("send data: " << data->getName());
+		EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 		m_appLink->onReceiveData(*data);
 		m_nRN__DPDataCount += 1;
 		removePendingTimeoutEvent(data->getName());
-	} else	if (cmd.compare("TS") == 0) {
+	} else	if (cmd == CMD_TS) {
 		m_nRN__TSInterestCount += 1;
 		// Topic Subscription
 		// /RN/TS/a/b/*
@@ -757,7 +1713,7 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		Block empty;
 		sendData(dataName, empty);
 		m_nRN__TSDataCount += 1;
-	} else	if (cmd.compare("TM") == 0) {
+	} else	if (cmd == CMD_TM) {
 		m_nRN__TMInterestCount += 1;
 		// Topic Manifest Request
 		// Topic Subscription
@@ -770,6 +1726,18 @@ RendezvousDrnF::OnInterestRN(shared_ptr<const Interest> interest) {
 		int32_t attentionIndex = prefixSize + 1;
 
 		receiveInterestRNTM(interestName, attentionIndex);
+	} else	if (m_regional && cmd == CMD_DM) {
+		m_nRN__DMInterestCount += 1;
+		// Data Manifest Request(regional)
+		// /RN/DM/RN-{yyy}/a/b/c/topic-80
+
+		receiveInterestRNDelivery(interestName, prefixSize + 1);
+	} else	if (m_regional && cmd == CMD_DR) {
+		m_nRN__DRInterestCount += 1;
+		// Data Request(regional)
+		// /RN/DR/RN-{yyy}/a/b/c/topic-80/0
+
+		receiveInterestRNDelivery(interestName, prefixSize + 1);
 	}
 }
 
@@ -779,12 +1747,12 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 	int32_t prefixSize = m_drnPrefix.size();
 
 	int32_t cmdIndex = prefixSize;
-	string cmd = interestName.get(cmdIndex).toUri();
-	if (cmd.compare("PA") == 0) {
+	DrnCommand cmd = parseCommand(interestName, cmdIndex);
+	DRN_PROFILE_COMMAND("RendezvousDrnF", "OnInterestRNXXX", cmd);
+	if (cmd == CMD_PA) {
 		m_nRNrvPAInterestCount += 1;
 		// Publish Advertisement
 		// /RN/PA/topic-{nnn}?RN-{yyy}
-		NS_LOG_DEBUG("recv interest: " << interestName);
 
 		int32_t attentionIndex = prefixSize + 1;
 
@@ -803,7 +1771,14 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 
-		m_PAMap.insert(std::pair<std::string, std::string>(topicName.toUri(), nodeName));
+		NameInterner &interner = NameInterner::Get();
+		m_PAMap.insert(std::make_pair(interner.intern(topicName), interner.intern(nodeName)));
+		m_advertiseVersion += 1;
+
+		// owner가 복제 중인 hot topic이면 replica에게도 전달한다
+		if (m_replicatedTopics.find(topicName.get(0).toUri()) != m_replicatedTopics.end()) {
+			sendInterestRNXXXReplica(CMD_PA, topicName, nodeName);
+		}
 
 		sendDataForPendingInsterestTM(interestName);
 
@@ -821,11 +1796,10 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
         //lli keyHash = Helper::getHash(topic);
         //m_rnTopic->receiveInterestPATopic(keyHash, nodeName);
 		return;
-	} else if (cmd.compare("PU") == 0) {
+	} else if (cmd == CMD_PU) {
 		m_nRNrvPUInterestCount += 1;
 		// Publish Unadvertisement
 		// /RN/PU/topic-{nnn}
-		NS_LOG_DEBUG("recv interest: " << interestName);
 
 		int32_t attentionIndex = prefixSize + 1;
 
@@ -844,11 +1818,16 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 
-		std::map<std::string, std::string>::iterator iter;
-		iter = m_PAMap.find(topicName.toUri());
+		NameIdMapIterator iter;
+		iter = m_PAMap.find(NameInterner::Get().find(topicName));
 		if (iter != m_PAMap.end()) {
 			m_PAMap.erase(iter);
 		}
+		m_advertiseVersion += 1;
+
+		if (m_replicatedTopics.find(topicName.get(0).toUri()) != m_replicatedTopics.end()) {
+			sendInterestRNXXXReplica(CMD_PU, topicName, nodeName);
+		}
 
 		Name dataName(interestName);
 
@@ -860,23 +1839,37 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// /RN-{yyy}/PA/topic-{nnn}[RN-Xxx] Interest를 보낸다.
         //m_rnTopic->receiveInterestPUTopic(keyHash);
 		return;
-	} else if (cmd.compare("TS") == 0) {
+	} else if (cmd == CMD_PAB) {
+		m_nRNrvPAInterestCount += 1;
+		// /RN-{xxx}/PAB/RN-{yyy}/{batch}[/a/b/c/topic-0, ...]
+
+		receiveInterestRNXXXBulk(interest, cmd);
+		m_nRNsnPADataCount += 1;
+		return;
+	} else if (cmd == CMD_PUB) {
+		m_nRNrvPUInterestCount += 1;
+
+		receiveInterestRNXXXBulk(interest, cmd);
+		m_nRNsnPUDataCount += 1;
+		return;
+	} else if (cmd == CMD_TS) {
 		m_nRNrvTSInterestCount += 1;
 
-		NS_LOG_DEBUG("recv interest: " << interestName);
 		//
 		int32_t attentionIndex = prefixSize + 1;
+		countTopicRequest(interestName.get(attentionIndex).toUri());
 
-		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
+		Name topicName = stripSlot(interestName.getSubName(attentionIndex, Name::npos));
 		string topic = ::ndn::unescape(topicName.toUri());
 
+		NameInterner &interner = NameInterner::Get();
 		std::stringstream sio;
-		StringMapIterator mapIter;
+		NameIdMapIterator mapIter;
 		int at = topic.find('*');
 		if (at < 0) {
-			mapIter = m_PAMap.find(topic);
+			mapIter = m_PAMap.find(interner.find(topicName));
 			if (mapIter != m_PAMap.end()) {
-				sio << mapIter->second;
+				sio << nodeLabel(mapIter->second);
 			}
 		} else {
 			string exp(topic);
@@ -884,11 +1877,11 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 			int count = 0;
 			std::regex reg(exp);
 			for ( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-				if (std::regex_match(mapIter->first, reg)) {
+				if (std::regex_match(interner.getUri(mapIter->first), reg)) {
 					if (0 < count) {
 						sio << ':';
 					}
-					sio << mapIter->second;
+					sio << nodeLabel(mapIter->second);
 					count ++;
 				}
 			}
@@ -904,46 +1897,39 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		m_nRNsnTSDataCount += 1;
 
 		return;
-	} else if (cmd.compare("TM") == 0) {
+	} else if (cmd == CMD_TM) {
 		m_nRNrvTMInterestCount += 1;
 
-		NS_LOG_DEBUG("recv interest: " << interestName);
 		//
 		int32_t attentionIndex = prefixSize + 1;
+		countTopicRequest(interestName.get(attentionIndex).toUri());
 		if(0 < sendDataTM(interestName, attentionIndex)) {
 			removePendingTimeoutEvent(interestName);
+		} else if (m_negativeReply) {
+			sendDataNegative(interestName, CMD_TM, m_advertiseVersion);
 		}
 		return;
 		// string value = m_rnDht->receiveInterestSendSuccessorList();
-	} else	if (cmd.compare("DM") == 0) {
+	} else	if (cmd == CMD_DM) {
 		m_nRNrvDMInterestCount += 1;
 
-		NS_LOG_DEBUG("recv interest: " << interestName);
 		// Data Manifest Request
 		int32_t attentionIndex = prefixSize + 1;
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
-		string topic = topicName.toUri();
-
 
-		BufferListMapIterator mapIter = m_DPMap.find(topic);
+		NameBufferListMapIterator mapIter = m_DPMap.find(NameInterner::Get().find(topicName));
 		BufferPtr ptr = nullptr;
 		if (mapIter != m_DPMap.end()) {
 			BufferListPtr listPtr = mapIter->second;
-            //NS_LOG_DEBUG(topic << ": " << listPtr->size());
-
-			std::stringstream sio;
-			BufferListIterator iter = listPtr->begin();
-			for (; iter != listPtr->end(); iter ++) {
-				std::string tmp((const char *)(*iter)->data(), (*iter)->size());
-				sio << tmp << ", ";
-			}
-			NS_LOG_DEBUG(topic << ": " << sio.str());
 
 			// 마지막 1개만 제공한다.
 			ptr = listPtr->at(listPtr->size()-1);
 		} else {
 			// 없으면 나중에 DP interest를 수신하여 pending list에서 찾아 전송한다.
+			if (m_negativeReply) {
+				sendDataNegative(interestName, CMD_DM, 0);
+			}
 			return;
 		}
         /*
@@ -972,7 +1958,7 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// generate data pacaket
 		auto data = make_shared<Data>();
 		data->setName(tmDataName);
-        //data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
+		setFreshnessPeriod(*data);
 
         //data->setContent(content);
 
@@ -999,17 +1985,24 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// to create real wire encoding
 		data->wireEncode();
 
-		NS_LOG_DEBUG("send data: " << tmDataName);
 
 		// data sent time
+		NS_LOG_DEBUG("send data: " << data->getName());
+		EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 		m_appLink->onReceiveData(*data);
 		m_nRNsnDMDataCount += 1;
 
 		removePendingTimeoutEvent(data->getName());
-	} else	if (cmd.compare("DR") == 0) {
+	} else	if (cmd == CMD_DR && interestName.get(-1).isSegment()) {
+		m_nRNrvDRInterestCount += 1;
+		// Data Request of a segment
+		// /RN-{xxx}/DR/a/b/c/topic-80/0/%00%03
+
+		sendDataDRSegment(interestName, prefixSize + 1);
+		m_nRNsnDRDataCount += 1;
+	} else	if (cmd == CMD_DR) {
 		m_nRNrvDRInterestCount += 1;
 
-		NS_LOG_DEBUG("recv interest: " << interestName);
 		// Data Request
 		// Data Manifest Request
 		int32_t attentionIndex = prefixSize + 1;
@@ -1017,16 +2010,15 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		Name qualifiedName = interestName.getSubName(attentionIndex, interestName.size()-1);
 		NS_LOG_DEBUG("qualifiedName: " << qualifiedName);
 		Name topicName = qualifiedName.getSubName(0, qualifiedName.size()-1);
-		string topic = topicName.toUri();
 		string seqStr = qualifiedName.get(qualifiedName.size()-1).toUri();
 
 		Name tmDataName(interestName);
 		// generate data pacaket
 		auto data = make_shared<Data>();
 		data->setName(tmDataName);
-        //data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
+		setFreshnessPeriod(*data);
 
-		BufferListMapIterator mapIter = m_DPMap.find(topic);
+		NameBufferListMapIterator mapIter = m_DPMap.find(NameInterner::Get().find(topicName));
 		if (mapIter != m_DPMap.end()) {
 			// 원래는 Producer가 publish 하는 내용을 Data의 content로 해야 하나
 			// 여기에서는 publish되었는지 확인만 하고 데이터는 생성하여 제공한다.
@@ -1084,6 +2076,8 @@ RendezvousDrnF::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		data->wireEncode();
 
 		// data sent time
+		NS_LOG_DEBUG("send data: " << data->getName());
+		EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 		m_appLink->onReceiveData(*data);
 		m_nRNsnDRDataCount += 1;
 
@@ -1097,8 +2091,8 @@ RendezvousDrnF::sendDataForPendingInsterestTM(const Name &interestName) {
 	// Pending된 TM interest(/RN-xxxxx/TM/a/b/c/topic-0) 에 대한 Data를 전송한다.
 	int32_t prefixSize = m_rnPrefix.size();
 
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("PA") != 0) {
+	DrnCommand cmd = parseCommand(interestName, prefixSize);
+	if (cmd != CMD_PA) {
 		return;
 	}
 
@@ -1117,8 +2111,8 @@ RendezvousDrnF::sendDataForPendingInsterestTM(const Name &interestName) {
 		int32_t drnPrefixSize = m_drnPrefix.size();
 		int32_t drnAttentionIndex = drnPrefixSize + 1;
 
-		string pendingCmd = pendingIter->first.get(drnPrefixSize).toUri();
-		if(pendingCmd.compare(string("TM")) != 0) {
+		DrnCommand pendingCmd = parseCommand(pendingIter->first, drnPrefixSize);
+		if(pendingCmd != CMD_TM) {
 			continue;
 		}
 
@@ -1126,7 +2120,7 @@ RendezvousDrnF::sendDataForPendingInsterestTM(const Name &interestName) {
 		// /RN-xxxxx/TM/a/b/c
 		// /RN-xxxxx/TM/a/b/*
 		// 등 여러 개 일 수 있으니.
-		Name tmTopicName = pendingIter->first.getSubName(drnAttentionIndex, pendingIter->first.size()-1);
+		Name tmTopicName = stripPageToken(pendingIter->first.getSubName(drnAttentionIndex, pendingIter->first.size()-1));
 		string tmTopic = tmTopicName.toUri();
 
 		int at = tmTopic.find('*');
@@ -1164,8 +2158,8 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 	// Pending된 DM interest(/RN-xxxxx/DM/a/b/c/topic-0) 에 대한 Data를 전송한다.
 	int32_t prefixSize = m_rnPrefix.size();
 
-	string cmd = interestName.get(prefixSize).toUri();
-	if (cmd.compare("DP") != 0) {
+	DrnCommand cmd = parseCommand(interestName, prefixSize);
+	if (cmd != CMD_DP) {
 		return;
 	}
 
@@ -1177,7 +2171,7 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 
 	// /a/b/c/topic-0
 	Name dpTopicName = dpQualifiedName.getSubName(0, dpQualifiedName.size()-1);
-	string dpTopic = dpTopicName.toUri();
+	NameId dpTopicId = NameInterner::Get().find(dpTopicName);
 	// sequence: 0
 	string seqStr = dpQualifiedName.get(dpQualifiedName.size()-1).toUri();
 
@@ -1191,40 +2185,37 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 		int32_t drnPrefixSize = m_drnPrefix.size();
 		int32_t drnAttentionIndex = drnPrefixSize + 1;
 
-		string pendingCmd = pendingIter->first.get(drnPrefixSize).toUri();
-		if(pendingCmd.compare(string("DM")) != 0) {
+		DrnCommand pendingCmd = parseCommand(pendingIter->first, drnPrefixSize);
+		if(pendingCmd != CMD_DM) {
 			continue;
 		}
+
+		// regional: /RN/DM/RN-xxxxx/a/b/c/topic-0
+		if (m_rnPrefix.equals(pendingIter->first.getPrefix(1))) {
+			if (m_drnPrefix.equals(pendingIter->first.getSubName(drnAttentionIndex, 1)) == false) {
+				continue;
+			}
+			drnAttentionIndex += 1;
+		}
 		//
 		Name dmTopicName = pendingIter->first.getSubName(drnAttentionIndex, pendingIter->first.size()-1);
-		string dmTopic = dmTopicName.toUri();
 
 		// DM
-		if (dmTopic.compare(dpTopic) != 0) {
+		if (dmTopicName.equals(dpTopicName) == false) {
 			continue;
 		}
 
 		//
-		BufferListMapIterator mapIter = m_DPMap.find(dpTopic);
+		NameBufferListMapIterator mapIter = m_DPMap.find(dpTopicId);
 		BufferPtr ptr = nullptr;
 
 		if (mapIter != m_DPMap.end()) {
 			BufferListPtr listPtr = mapIter->second;
-			NS_LOG_DEBUG(dpTopic << ": " << listPtr->size());
-
 			if (listPtr->size() == 0) {
 				// 보낼 topic이 없다.
 				continue;
 			}
 
-			std::stringstream sio;
-			BufferListIterator iter = listPtr->begin();
-			for (; iter != listPtr->end(); iter ++) {
-				std::string tmp((const char *)(*iter)->data(), (*iter)->size());
-				sio << tmp << ", ";
-			}
-			NS_LOG_DEBUG(dpTopic << ": " << sio.str());
-
 			// 마지막 1개만 제공한다.
 			ptr = listPtr->at(listPtr->size()-1);
 
@@ -1232,6 +2223,7 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 			// generate data pacaket
 			auto data = make_shared<Data>();
 			data->setName(tmDataName);
+			setFreshnessPeriod(*data);
 
 			if (ptr != nullptr) {
 				data->setContent(ptr);
@@ -1255,8 +2247,9 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 			// to create real wire encoding
 			data->wireEncode();
 
-			NS_LOG_DEBUG("send data: " << tmDataName);
 			// data sent time
+			NS_LOG_DEBUG("send data: " << data->getName());
+			EventTracer::Get().record(TRACE_SEND_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 			m_appLink->onReceiveData(*data);
 			removeNameList.push_back(data->getName());
 		} else {
@@ -1273,19 +2266,19 @@ RendezvousDrnF::sendDataForPendingInsterestDM(const Name &interestName) {
 
 void
 RendezvousDrnF::OnInterest(shared_ptr<const Interest> interest) {
+	DRN_PROFILE_SCOPE("RendezvousDrnF", "OnInterest");
 	const Name &interestName = interest->getName();
 
 	// /RN-xxxxx/TM/a/b/c <---- /RN-xxxxx/PA/a/b/c
 	appendPendingTimeoutEvent(interest);
 
-	const name::Component &topPrefix = interestName.get(0);
-	string prefix = topPrefix.toUri();
-
 	NS_LOG_DEBUG("recv interest: " << interestName);
+	EventTracer::Get().record(TRACE_RECV_INTEREST, GetNode()->GetId(), interestName);
 
-	if (prefix == m_rnPrefix) {
+	// 문자열로 바꾸지 않고 component 단위로 비교한다
+	if (m_rnPrefix.isPrefixOf(interestName)) {
 		OnInterestRN(interest);
-	} else if (prefix == m_drnPrefix) {
+	} else if (m_drnPrefix.isPrefixOf(interestName)) {
 		OnInterestRNXXX(interest);
 	}
 }
@@ -1294,47 +2287,65 @@ void
 RendezvousDrnF::OnData(shared_ptr<const Data> data) {
 	const Name &dataName = data->getName();
 
-    //NS_LOG_DEBUG("recv data: " << dataName);
+	NS_LOG_DEBUG("recv data: " << dataName);
+	EventTracer::Get().record(TRACE_RECV_DATA, GetNode()->GetId(), dataName, data->getContent().value_size());
 
 	// /RN/PA/..., /RN/PU/..., /RN/DP/..., /RN/TS/..., /RN/TM/...,
 	// /RN-{yyyyy}/PA/..., /RN-{yyyyy}/PU/..., /RN-{yyyyy}/DP/..., /RN-{yyyyy}/TS/..., /RN-{yyyyy}/TM/...,
 	int32_t prefixSize = 1;
 	int32_t cmdIndex = prefixSize;
 
-	string cmd = dataName.get(cmdIndex).toUri();
-	if (cmd.compare("TS") == 0) {
+	DrnCommand cmd = parseCommand(dataName, cmdIndex);
+	DRN_PROFILE_COMMAND("RendezvousDrnF", "OnData", cmd);
+	if (cmd == CMD_TS) {
 		m_nRNrvTSDataCount += 1;
-		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/TS/...에  대한 응답(Data)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
-	} else if (cmd.compare("PA") == 0) {
+	} else if (cmd == CMD_PA) {
 		m_nRNrvPADataCount += 1;
-		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/PA/...에  대한 응답(Data)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
-	} else if (cmd.compare("PU") == 0) {
+	} else if (cmd == CMD_PU) {
 		m_nRNrvPUDataCount += 1;
-		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/PU/...에  대한 응답(Data)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
-	} else if (cmd.compare("TM") == 0) {
+	} else if (cmd == CMD_TM) {
 		m_nRNrvTMDataCount += 1;
-		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/TM/...에  대한 응답(Data: /RN/TM/...)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
 
 		Name tmpName("RN");
-		tmpName.append(cmd).append(topicName);
+		tmpName.append(commandName(cmd)).append(topicName);
 
 		const Block &content = data->getContent();
 		shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>((const uint8_t *)content.value(), content.value_size());
 
-		sendData(tmpName, buffer);
+		receiveDataRNXXXHotHint(dataName.get(attentionIndex).toUri(), buffer);
+
+		NegativeReply reply;
+		bool negative = decodeNegativeReply(buffer->data(), buffer->size(), reply);
+		if (m_regional && !negative) {
+			storeRegionalCache(dataName.toUri(), make_shared<::ndn::Buffer>(*buffer), false);
+		}
+
+		if (negative) {
+			sendDataNegative(tmpName, buffer, reply);
+		} else {
+			sendData(tmpName, buffer);
+		}
 		m_nRN__TMDataCount += 1;
+	} else if (cmd == CMD_DM) {
+		m_nRNrvDMDataCount += 1;
+
+		receiveDataRNXXXDelivery(data);
+	} else if (cmd == CMD_DR) {
+		m_nRNrvDRDataCount += 1;
+
+		receiveDataRNXXXDelivery(data);
 	}
 }
 
@@ -1343,25 +2354,28 @@ RendezvousDrnF::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 	const Interest &interest = nack->getInterest();
 	const Name &interestName = interest.getName();
 
+	NS_LOG_DEBUG("recv nack: " << interestName);
+	EventTracer::Get().record(TRACE_RECV_NACK, GetNode()->GetId(), interestName, (uint32_t)nack->getReason());
+
 	int32_t rnPrefixSize = m_rnPrefix.size();
 	int32_t drnPrefixSize = m_drnPrefix.size();
 
 	if (m_rnPrefix.equals(interestName.getSubName(0, rnPrefixSize))) {
 		int32_t cmdIndex = rnPrefixSize;
-		string cmd = interestName.get(cmdIndex).toUri();
+		DrnCommand cmd = parseCommand(interestName, cmdIndex);
 
-		if (cmd.compare("TS") == 0) {
+		if (cmd == CMD_TS) {
 			m_nRNsnTSNackCount += 1;
-		} else	if (cmd.compare("TM") == 0) {
+		} else	if (cmd == CMD_TM) {
 			m_nRNsnTMNackCount += 1;
 		}
 	} else if (m_drnPrefix.equals(interestName.getSubName(0, drnPrefixSize))) {
 		int32_t cmdIndex = drnPrefixSize;
-		string cmd = interestName.get(cmdIndex).toUri();
+		DrnCommand cmd = parseCommand(interestName, cmdIndex);
 
-		if (cmd.compare("PA") == 0) {
+		if (cmd == CMD_PA || cmd == CMD_PAB) {
 			m_nRNsnPANackCount += 1;
-		} else	if (cmd.compare("PU") == 0) {
+		} else	if (cmd == CMD_PU || cmd == CMD_PUB) {
 			m_nRNsnPUNackCount += 1;
 		}
 	}
@@ -1376,17 +2390,76 @@ RendezvousDrnF::IsPendingTarget(const Name &name) {
 		return false;
 	}
 
-	const name::Component &topPrefix = name.get(0);
-	string prefix = topPrefix.toUri();
-
-	if(m_drnPrefix.equals(Name(prefix))) {
-		string cmd = name.get(cmdIndex).toUri();
-		if (cmd.compare("TM") == 0) {
+	if(m_drnPrefix.isPrefixOf(name)) {
+		DrnCommand cmd = parseCommand(name, cmdIndex);
+		if (cmd == CMD_TM) {
 			return true;
-		} if (cmd.compare("DM") == 0) {
+		} if (cmd == CMD_DM) {
+			return true;
+		}
+	}
+
+	if(m_regional && m_rnPrefix.isPrefixOf(name)) {
+		DrnCommand cmd = parseCommand(name, cmdIndex);
+		if (cmd == CMD_DM || cmd == CMD_DR) {
 			return true;
 		}
 	}
 
 	return TimeoutApp::IsPendingTarget(name);
 }
+
+uint32_t
+RendezvousDrnF::GetLoad() {
+	return m_nRNrvTSInterestCount + m_nRNrvTMInterestCount + m_nRNrvDMInterestCount + m_nRNrvDRInterestCount;
+}
+
+uint32_t
+RendezvousDrnF::GetManifestLoad() {
+	return m_nRNrvTSInterestCount + m_nRNrvTMInterestCount;
+}
+
+bool
+RendezvousDrnF::isSelf(const string &nodeName) {
+	return NameInterner::Get().intern(nodeName) == m_drnPrefixId;
+}
+
+void
+RendezvousDrnF::GetMemoryUsage(MemoryUsage &usage) {
+	TimeoutApp::GetMemoryUsage(usage);
+
+	usage.push_back(TableUsage { "PAMap", m_PAMap.size(), mapBytes(m_PAMap) });
+
+	// entries: stored sequences of all topics
+	uint64_t entries = 0;
+	uint64_t bytes = mapBytes(m_DPMap);
+	for (std::map<NameId, BufferListPtr>::iterator mapIter = m_DPMap.begin(); mapIter != m_DPMap.end(); mapIter++) {
+		entries += mapIter->second->size();
+		bytes += bufferListBytes(*mapIter->second);
+	}
+	usage.push_back(TableUsage { "DPMap", entries, bytes });
+
+	bytes = mapBytes(m_segmentedObjects);
+	for (std::map<std::pair<NameId, uint64_t>, SegmentedObject>::iterator objectIter = m_segmentedObjects.begin(); objectIter != m_segmentedObjects.end(); objectIter++) {
+		if (0 < objectIter->second.received.capacity()) {
+			bytes += heapChunk((objectIter->second.received.capacity() + 7) / 8);
+		}
+	}
+	usage.push_back(TableUsage { "segmentedObjects", m_segmentedObjects.size(), bytes });
+
+	bytes = mapBytes(m_regionalCache) + m_regionalCacheOrder.size() * sizeof(std::string);
+	for (std::map<std::string, std::tuple<BufferPtr, ::ns3::Time>>::iterator cacheIter = m_regionalCache.begin(); cacheIter != m_regionalCache.end(); cacheIter++) {
+		// key 는 m_regionalCacheOrder 에도 있다
+		bytes += 2 * stringBytes(cacheIter->first);
+		if (std::get<0>(cacheIter->second) != nullptr) {
+			bytes += bufferBytes(*std::get<0>(cacheIter->second));
+		}
+	}
+	usage.push_back(TableUsage { "regionalCache", m_regionalCache.size(), bytes });
+
+	bytes = mapBytes(m_hotTopics);
+	for (std::map<std::string, std::tuple<uint32_t, ::ns3::Time>>::iterator hotIter = m_hotTopics.begin(); hotIter != m_hotTopics.end(); hotIter++) {
+		bytes += stringBytes(hotIter->first);
+	}
+	usage.push_back(TableUsage { "hotTopics", m_hotTopics.size(), bytes });
+}
@@ -20,15 +20,22 @@
 #ifndef NDN_RENDEZVOUS_APP_H
 #define NDN_RENDEZVOUS_APP_H
 
+#include <deque>
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
+#include <tuple>
 #include <ns3/ndnSIM/apps/ndn-app.hpp>
 //#include <ns3/ndnSIM/ndn-cxx/name.hpp>
 #include <ns3/ndnSIM/ndn-cxx/util/random.hpp>
 #include <ns3/ndnSIM/ndn-cxx/encoding/buffer.hpp>
 
 #include "object-container.hpp"
+#include "count-min-sketch.hpp"
+#include "drn-protocol.hpp"
+#include "negative-reply.hpp"
+#include "name-interner.hpp"
 
 #include "ndn-timeout-app.hpp"
 
@@ -38,6 +45,26 @@ using namespace std;
 using namespace ns3;
 using namespace ns3::ndn;
 
+// segmented object of /RN/DP/a/b/c/topic-80/{seq}/{segment}: segments seen until all arrived, then their sizes for the DR
+struct SegmentedObject
+{
+	std::vector<bool> received;
+	uint32_t receivedCount;
+	uint32_t segments;
+	uint32_t segmentSize;
+	uint64_t size;
+};
+
+// TM answers sent by the owner RN
+struct ManifestStats
+{
+	uint64_t answers;
+	// answers with a continuation token
+	uint64_t pages;
+	uint64_t entries;
+	uint64_t bytes;
+};
+
 class RendezvousDrnF : public TimeoutApp
 {
 public:
@@ -52,9 +79,25 @@ public:
 	virtual void
 	StopApplication();
 
+	// FreshnessPeriod of the answer by its command(TSFreshness, TMFreshness, ...)
+	void
+	setFreshnessPeriod(Data &data);
+
 	int
 	sendDataTM(const Name &interestName, int32_t attentionIndex);
 
+	// NegativeReply: retry-after hint and version(negative-reply.hpp) instead of a pending TM/DM
+	void
+	sendDataNegative(const Name &interestName, DrnCommand cmd, uint64_t version);
+
+	// negative reply of the owner RN forwarded to the consumer: FreshnessPeriod below the retry-after hint
+	void
+	sendDataNegative(const Name &dataName, shared_ptr<const ::ndn::Buffer> &value, const NegativeReply &reply);
+
+	// BinaryManifest: a page of the TM answer(topic-manifest.hpp)
+	int
+	sendDataTMManifest(const Name &interestName, int32_t attentionIndex, const Name &topicName, const string &topic);
+
 	void
 	sendDataPA(const Name &interestName, int32_t attentionIndex);
 
@@ -81,13 +124,35 @@ public:
 	virtual void
 	OnNack(shared_ptr<const ::ndn::lp::Nack> nack);
 
+	// state table sizes(MemorySampler)
+	virtual void
+	GetMemoryUsage(MemoryUsage &usage);
+
 	virtual bool
 	IsPendingTarget(const Name &name);
 
+	// rendezvous requests(TS, TM, DM, DR) received on /RN-{xxx}
+	uint32_t
+	GetLoad();
+
+	// TS/TM received on /RN-{xxx}: the polls the owner answers itself
+	uint32_t
+	GetManifestLoad();
+
+	const ManifestStats &
+	GetManifestStats() const {
+		return m_manifestStats;
+	}
+
+	// nodeName(/RN-{xxx}) is this RN
+	bool
+	isSelf(const string &nodeName);
+
 	void sendData(const Name &dataName, const Block &content);
 	void sendData(shared_ptr<const Interest> interest, const Block &content);
 
 	void sendData(const Name &dataName, shared_ptr<const ::ndn::Buffer> &value);
+	void sendData(shared_ptr<Data> data, shared_ptr<const ::ndn::Buffer> &value);
 	void sendData(shared_ptr<const Interest> interest, shared_ptr<const ::ndn::Buffer> &value);
 
 	// /RN
@@ -95,14 +160,44 @@ public:
 	void sendInterestRNXXXPA(const Name &interestName, int32_t attentionIndex, string nodeName);
 	void receiveInterestRNPU(const Name &interestName, string topic);
 
+	// bulk: /RN/PAB/{node id}/{batch} -> one /RN-{yyy}/PAB/RN-{xxx}/{batch} per owner RN
+	void receiveInterestRNBulk(shared_ptr<const Interest> interest, DrnCommand cmd);
+	void sendInterestRNXXXBulk(DrnCommand cmd, const string &nodeName, const std::vector<Name> &topics);
+	void receiveInterestRNXXXBulk(shared_ptr<const Interest> interest, DrnCommand cmd);
+	// PA/PU of a topic owned by this RN
+	void advertiseTopic(DrnCommand cmd, const Name &topicName, const string &publisher);
+
+	// /RN/DPB/a/b/c/topic-80/{first seq}/{count}: the batch is stored in one operation
+	void receiveInterestRNDPBatch(shared_ptr<const Interest> interest, int32_t attentionIndex);
+
+	// segments: /RN/DP/a/b/c/topic-80/{seq}/{segment}, /RN-{yyy}/DR/a/b/c/topic-80/{seq}/{segment}
+	void receiveInterestRNDPSegment(shared_ptr<const Interest> interest, int32_t attentionIndex);
+	void sendDataDRSegment(const Name &interestName, int32_t attentionIndex);
+
 	void receiveInterestRNTS(const Name &interestName, int32_t attentionIndex);
 	void sendInterestRNXXXTM(const Name &interestName, int32_t attentionIndex, string nodeName);
 
 	void receiveInterestRNTM(const Name &interestName, int32_t attentionIndex);
 
+	// regional: /RN/DM/RN-{yyy}/..., /RN/DR/RN-{yyy}/...
+	void receiveInterestRNDelivery(const Name &interestName, int32_t nodeIndex);
+	void receiveDataRNXXXDelivery(shared_ptr<const Data> data);
+
+	BufferPtr findRegionalCache(const string &name);
+	void storeRegionalCache(const string &name, BufferPtr content, bool immutable);
+
+	// hot topic replication
+	const string &getTopicRN(const string &topicPrefix, uint32_t replica);
+	string selectTopicRN(const string &topicPrefix);
+	void countTopicRequest(const string &topicPrefix);
+	void replicateTopic(const string &topicPrefix);
+	void sendInterestRNXXXReplica(DrnCommand cmd, const Name &topicName, const string &publisher);
+	void receiveDataRNXXXHotHint(const string &topicPrefix, shared_ptr<const ::ndn::Buffer> &buffer);
+
 private:
 	::ndn::Name m_rnPrefix;
 	::ndn::Name m_drnPrefix;
+	NameId m_drnPrefixId;
 	uint32_t m_nSub;
 	uint32_t m_nDataSize;
 
@@ -114,11 +209,58 @@ private:
 	uint32_t m_signature;
 	Name m_keyLocator;
 
-	// RN-00001/PA/a/b/c[RN-00002]
-	std::map<std::string, std::string> m_PAMap;
-
-	// RN/DP/a/b/c/topic-0
-	std::map<std::string, BufferListPtr> m_DPMap;
+	// RN-00001/PA/a/b/c[RN-00002]: topic id -> publisher RN id
+	std::map<NameId, NameId> m_PAMap;
+
+	// RN/DP/a/b/c/topic-0: topic id -> published sequences
+	std::map<NameId, BufferListPtr> m_DPMap;
+	// (topic id, sequence) -> segments of a segmented DP, not reassembled
+	std::map<std::pair<NameId, uint64_t>, SegmentedObject> m_segmentedObjects;
+
+	// two level mode: this RN also works as the regional RN of the consumers routed to it by /RN
+	bool m_regional;
+	::ns3::Time m_cacheLifetime;
+	uint32_t m_cacheSize;
+
+	// upstream Data name(/RN-{yyy}/TM/..., /RN-{yyy}/DM/..., /RN-{yyy}/DR/...) -> (content, expire time)
+	std::map<std::string, std::tuple<BufferPtr, ::ns3::Time>> m_regionalCache;
+	std::deque<std::string> m_regionalCacheOrder;
+	// upstream DM/DR Interest in flight -> expire time, one per name toward the topic RN
+	std::map<std::string, ::ns3::Time> m_upstream;
+
+	// hot topics: owner counts TS/TM per topic prefix and copies the PA of hot ones to Replicas-1 more RNs
+	uint32_t m_replicas;
+	uint32_t m_hotThreshold;
+	::ns3::Time m_hotWindow;
+	::ns3::Time m_hotLifetime;
+	uint32_t m_sketchWidth;
+	uint32_t m_sketchDepth;
+
+	// cacheable answers: FreshnessPeriod per command, content stores of the path answer repeated polls
+	::ns3::Time m_tsFreshness;
+	::ns3::Time m_tmFreshness;
+	::ns3::Time m_dmFreshness;
+	::ns3::Time m_drFreshness;
+
+	// TM answer: binary manifest(topic-manifest.hpp) of at most ManifestPage bytes per Data instead of the text list
+	bool m_binaryManifest;
+	uint32_t m_manifestPage;
+	ManifestStats m_manifestStats;
+
+	// TM/DM without an answer: negative reply at once instead of the pending list
+	bool m_negativeReply;
+	::ns3::Time m_retryAfter;
+	// PA/PU of this RN, the TopicVersion of the negative TM replies
+	uint64_t m_advertiseVersion;
+	uint32_t m_nRNsnNegativeTMCount;
+	uint32_t m_nRNsnNegativeDMCount;
+
+	CountMinSketch m_topicSketch;
+	::ns3::Time m_sketchWindowEnd;
+	// owner: replicated topic prefixes
+	std::set<std::string> m_replicatedTopics;
+	// access RN: topic prefix -> (replicas, expire time), learned from the owner's TM answers
+	std::map<std::string, std::tuple<uint32_t, ::ns3::Time>> m_hotTopics;
 
 	std::shared_ptr<std::vector<std::string>> m_dhtNodes;
 	ns3::Ptr<ObjectContainer> m_objectContainer;
@@ -151,6 +293,15 @@ private:
 	uint32_t m_nRNsnPUInterestCount;
 	uint32_t m_nRNrvPUInterestCount;
 	uint32_t m_nRN__DPInterestCount;
+	// sequences carried by DP/DPB
+	uint32_t m_nRN__DPItemCount;
+	// segments of segmented DP, DR answers of a segment
+	uint32_t m_nRN__DPSegmentCount;
+	uint32_t m_nRNsnDRSegmentCount;
+	// topics carried by PAB/PUB
+	uint32_t m_nRN__BulkTopicCount;
+	uint32_t m_nRNrvBulkTopicCount;
+	uint32_t m_nBulkSequence;
 
 	uint32_t m_nRNsnPANackCount;
 	uint32_t m_nRNsnPUNackCount;
@@ -162,6 +313,20 @@ private:
 	uint32_t m_nRNsnPUDataCount;
 	uint32_t m_nRNrvPUDataCount;
 	uint32_t m_nRN__DPDataCount;
+
+	uint32_t m_nRN__DMInterestCount;
+	uint32_t m_nRNsnDMInterestCount;
+	uint32_t m_nRN__DRInterestCount;
+	uint32_t m_nRNsnDRInterestCount;
+	uint32_t m_nRNrvDMDataCount;
+	uint32_t m_nRNrvDRDataCount;
+	uint32_t m_nRegionalTMHitCount;
+	uint32_t m_nRegionalDMHitCount;
+	uint32_t m_nRegionalDRHitCount;
+
+	uint32_t m_nHotTopicCount;
+	uint32_t m_nRNsnReplicaInterestCount;
+	uint32_t m_nReplicaSpreadCount;
 };
 
 #endif
@@ -24,6 +24,7 @@
 
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
+#include "ns3/pointer.h"
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/util/random.hpp>
 
@@ -42,6 +43,8 @@
 #include "ndn-consumer-drn.hpp"
 #include "ndn-rendezvous-drn.hpp"
 
+#include "drn-protocol.hpp"
+#include "scope-profiler.hpp"
 #include "utils.hpp"
 
 
@@ -74,6 +77,24 @@ RendezvousDrn::GetTypeId() {
 
 						.AddAttribute("LifeTime", "LifeTime for interest packet", StringValue("4s"),
 										MakeTimeAccessor(&RendezvousDrn::m_interestLifeTime), MakeTimeChecker())
+
+						.AddAttribute("KeyChunkSize", "Max number of keys per segment of join/leave key handoff", ns3::UintegerValue(256),
+										ns3::MakeUintegerAccessor(&RendezvousDrn::m_keyChunkSize), ns3::MakeUintegerChecker<uint32_t>(1))
+
+						.AddAttribute("Proximity", "Underlay delays for proximity neighbour selection of fingers(null: disabled)", PointerValue(),
+										ns3::MakePointerAccessor(&RendezvousDrn::m_proximity), ns3::MakePointerChecker<TopologyProximity>())
+
+						.AddAttribute("HotThreshold", "TS/TM requests per HotWindow that make a topic hot", ns3::UintegerValue(100),
+										ns3::MakeUintegerAccessor(&RendezvousDrn::m_hotThreshold), ns3::MakeUintegerChecker<uint32_t>(1))
+
+						.AddAttribute("HotWindow", "Period after which the topic request counts are halved", StringValue("10s"),
+										MakeTimeAccessor(&RendezvousDrn::m_hotWindow), MakeTimeChecker())
+
+						.AddAttribute("SketchWidth", "Counters per row of the topic request sketch", ns3::UintegerValue(256),
+										ns3::MakeUintegerAccessor(&RendezvousDrn::m_sketchWidth), ns3::MakeUintegerChecker<uint32_t>(1))
+
+						.AddAttribute("SketchDepth", "Rows of the topic request sketch", ns3::UintegerValue(4),
+										ns3::MakeUintegerAccessor(&RendezvousDrn::m_sketchDepth), ns3::MakeUintegerChecker<uint32_t>(1))
 							;
 
   return tid;
@@ -81,12 +102,29 @@ RendezvousDrn::GetTypeId() {
 
 RendezvousDrn::RendezvousDrn()
 	: m_nSub(0)
+	, m_keyChunkSize(256)
 	, m_rng(::ndn::random::getRandomNumberEngine())
 	, m_appId(std::numeric_limits<uint32_t>::max())
 	, m_signature(0U)
+	, m_hotThreshold(100)
+	, m_sketchWidth(256)
+	, m_sketchDepth(4)
+	, m_nRequestCount(0)
+	, m_nHotTopicCount(0)
+	, m_nControlInterestCount(0)
+	, m_nControlDataCount(0)
 {
 }
 
+/**
+ * chord ring 유지를 위한 명령인지 (PA, PU, DP, TS, TM, DM, DR, k, put 이외)
+ */
+static bool
+isControlCommand(DrnCommand cmd) {
+	return cmd == CMD_JOIN || cmd == CMD_STABILIZE || cmd == CMD_STORE_KEYS || cmd == CMD_SEND_SUCC_LIST
+			|| cmd == CMD_ALIVE || cmd == CMD_P2;
+}
+
 void
 RendezvousDrn::StartApplication() {
 	App::StartApplication();
@@ -95,7 +133,14 @@ RendezvousDrn::StartApplication() {
 	FibHelper::AddRoute(GetNode(), m_rnPrefix, m_face, 0);
 	NS_LOG_DEBUG(stringf("AddFIB(%5u): ", GetNode()->GetId()) << m_drnPrefix);
 
-	m_rnDht.reset(new RendezvousDHT(m_drnPrefix, m_predecessor, m_appLink, m_maxNode));
+	m_rnDht.reset(new RendezvousDHT(m_drnPrefix, m_predecessor, m_appLink, m_maxNode, m_keyChunkSize));
+	if(m_proximity) {
+		m_rnDht->setProximity(m_proximity);
+	}
+
+	m_topicSketch.resize(m_sketchWidth, m_sketchDepth);
+	m_sketchWindowEnd = Simulator::Now() + m_hotWindow;
+	m_hotTopics.clear();
 /*
 	 // This starts the consumer side by sending a hello interest to the producer
 	 // When the producer responds with hello data, afterReceiveHelloData is called
@@ -113,6 +158,10 @@ RendezvousDrn::StartApplication() {
 
 void
 RendezvousDrn::StopApplication() {
+	if(m_active == false) {
+		return;
+	}
+
 	NS_LOG_DEBUG("StopApplication");
 //	m_rnTopic->stop();
 	if(m_drnPrefix.equals(m_predecessor) == false) {
@@ -120,13 +169,28 @@ RendezvousDrn::StopApplication() {
 	}
 
 	m_rnDht.reset();
+	m_PAMap.clear();
+	m_DPMap.clear();
 
 	App::StopApplication();
+
+	NS_LOG_INFO(stringf("Recv RNxx ControlInterestCount: %5u", m_nControlInterestCount));
+	NS_LOG_INFO(stringf("Recv RNxx ControlDataCount:     %5u", m_nControlDataCount));
+	NS_LOG_INFO(stringf("Recv RNxx RequestCount:         %5u", m_nRequestCount));
+	NS_LOG_INFO(stringf("Hot TopicCount:                 %5u", m_nHotTopicCount));
 }
 
 void
 RendezvousDrn::sendInterestJoin() {
-	m_rnDht->sendInterestJoin();
+	// join 전에 leave/fail 된 경우
+	if(m_rnDht) {
+		m_rnDht->sendInterestJoin();
+	}
+}
+
+RendezvousDHT *
+RendezvousDrn::GetDht() {
+	return m_rnDht.get();
 }
 
 void
@@ -139,22 +203,18 @@ RendezvousDrn::sendDataTM(const Name &interestName, int32_t attentionIndex) {
 	Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 	string topic = topicName.toUri();
 
+	NameInterner &interner = NameInterner::Get();
 	std::stringstream sio;
-	StringMapIterator mapIter;
-
-	mapIter = m_PAMap.begin();
-	for( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-		NS_LOG_DEBUG(mapIter->first << ": " << mapIter->second);
-	}
+	NameIdMapIterator mapIter;
 
 	// content format: {topic}:{node name},{topic}:{node name},...
 	// ex) /a/b/c:RN-00001,/a/b/d:RN-00002
 
 	int at = topic.find('*');
 	if(at < 0) {
-		mapIter = m_PAMap.find(topic);
+		mapIter = m_PAMap.find(interner.find(topicName));
 		if(mapIter != m_PAMap.end()) {
-			sio << stringf("%s:%s", mapIter->first.c_str(), mapIter->second.c_str());
+			sio << stringf("%s:%s", interner.getUri(mapIter->first).c_str(), nodeLabel(mapIter->second));
 		}
 	} else {
 		string exp(topic);
@@ -162,11 +222,12 @@ RendezvousDrn::sendDataTM(const Name &interestName, int32_t attentionIndex) {
 		int count = 0;
 		std::regex reg(exp);
 		for( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-			if(std::regex_match(mapIter->first, reg)) {
+			const string &uri = interner.getUri(mapIter->first);
+			if(std::regex_match(uri, reg)) {
 				if(0 < count) {
 					sio << ',';
 				}
-				sio << stringf("%s:%s", mapIter->first.c_str(), mapIter->second.c_str());
+				sio << stringf("%s:%s", uri.c_str(), nodeLabel(mapIter->second));
 				count ++;
 			}
 		}
@@ -248,8 +309,9 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 		return;
 	}
 
-	string cmd = interestName.get(prefixSize).toUri();
-	if(cmd.compare("PA") == 0) {
+	DrnCommand cmd = parseCommand(interestName, prefixSize);
+	DRN_PROFILE_COMMAND("RendezvousDrn", "OnInterestRN", cmd);
+	if(cmd == CMD_PA) {
 		// Publish Advertisement
 		//  /RN/PA/a/b/c/topic-{nnn}
 
@@ -290,7 +352,7 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else	if(cmd.compare("PU") == 0) {
+	} else	if(cmd == CMD_PU) {
 		// Publish Unadvertisement
 		// /RN/PU/a/b/c/topic-{nnn}
 
@@ -329,7 +391,7 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 		// data sent time
 		m_appLink->onReceiveData(*data);
 
-	} else	if(cmd.compare("DP") == 0) {
+	} else	if(cmd == CMD_DP) {
 		// Data Publish
 		// /RN/DP/a/b/c/topic-80/0
 
@@ -337,7 +399,6 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 		Name qualifiedName = interestName.getSubName(attentionIndex, interestName.size()-1);
 		NS_LOG_DEBUG("qualifiedName: " << qualifiedName);
 		Name topicName = qualifiedName.getSubName(0, qualifiedName.size()-1);
-		string topic = topicName.toUri();
 
 		const Block &params = interest->getParameters();
 		if(0 < params.elements_size()) {
@@ -352,11 +413,12 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 //		shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>((const void*)successor.first.c_str(), successor.first.size());
 		shared_ptr<::ndn::Buffer> buffer = make_shared<::ndn::Buffer>();
 
+		NameId topicId = NameInterner::Get().intern(topicName);
 		BufferListPtr dataListPtr;
-		BufferListMapIterator dataListPtrIter = m_DPMap.find(topic);
+		NameBufferListMapIterator dataListPtrIter = m_DPMap.find(topicId);
 		if(dataListPtrIter == m_DPMap.end()) {
 			dataListPtr = make_shared<std::vector<BufferPtr>>();
-			m_DPMap.insert(pair<string , BufferListPtr>(topic, dataListPtr));
+			m_DPMap.insert(std::make_pair(topicId, dataListPtr));
 		} else {
 			dataListPtr = dataListPtrIter->second;
 		}
@@ -390,7 +452,7 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 		// data sent time
 		m_appLink->onReceiveData(*data);
 
-	} else	if(cmd.compare("TS") == 0) {
+	} else	if(cmd == CMD_TS) {
 		// Topic Subscription
 		// /RN/TS/a/b/*
 		// /RN/TS/a/b/c/topic-80/*
@@ -426,7 +488,7 @@ RendezvousDrn::OnInterestRN(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else	if(cmd.compare("TM") == 0) {
+	} else	if(cmd == CMD_TM) {
 		// Topic Manifest Request
 		// Topic Subscription
 		// /RN/TM/a/b/*
@@ -447,76 +509,81 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 	int32_t prefixSize = m_drnPrefix.size();
 
 	int32_t cmdIndex = prefixSize;
-	string cmd = interestName.get(cmdIndex).toUri();
-	if(cmd.compare("join") == 0) {
+	DrnCommand cmd = parseCommand(interestName, cmdIndex);
+	DRN_PROFILE_COMMAND("RendezvousDrn", "OnInterestRNXXX", cmd);
+	if(isControlCommand(cmd)) {
+		m_nControlInterestCount += 1;
+	}
+
+	if(cmd == CMD_JOIN) {
 		// RN-{yyy}/join/join/RN-{xxx}
 		int32_t cmd2ndIndex = prefixSize + 1;
-		string cmd2nd = interestName.get(cmd2ndIndex).toUri();
-		if(cmd2nd.compare("successor") == 0) {
+		DrnCommand cmd2nd = parseCommand(interestName, cmd2ndIndex);
+		if(cmd2nd == CMD_SUCCESSOR) {
 			m_rnDht->receiveInterestJoinSuccessor(interest, cmd2ndIndex);
-		} else if(cmd2nd.compare("finger") == 0) {
+		} else if(cmd2nd == CMD_FINGER) {
 			m_rnDht->receiveInterestJoinFinger(interest, cmd2ndIndex);
-		} else if(cmd2nd.compare("getKeys") == 0) {
+		} else if(cmd2nd == CMD_GET_KEYS) {
 			m_rnDht->receiveInterestJoinGetKeys(interest, cmd2ndIndex);
 		}
-	} else if(cmd.compare("stabilize") == 0) {
+	} else if(cmd == CMD_STABILIZE) {
 		int32_t cmd2ndIndex = cmdIndex + 1;
-		string cmd2nd = interestName.get(cmd2ndIndex).toUri();
-		if(cmd2nd.compare("checkPredecessor") == 0) {
+		DrnCommand cmd2nd = parseCommand(interestName, cmd2ndIndex);
+		if(cmd2nd == CMD_CHECK_PREDECESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				string alive("true");
 				shared_ptr<const ::ndn::Buffer> buffer;
 				buffer = make_shared<::ndn::Buffer>((const void*)alive.c_str(), alive.size());
 				m_rnDht->sendData(interest, buffer);
 			}
-		} else if(cmd2nd.compare("checkSuccessor") == 0) {
+		} else if(cmd2nd == CMD_CHECK_SUCCESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				string alive("true");
 				shared_ptr<const ::ndn::Buffer> buffer;
 				buffer = make_shared<::ndn::Buffer>((const void*)alive.c_str(), alive.size());
 				m_rnDht->sendData(interest, buffer);
-			} else if(cmd3th.compare("sendSuccList") == 0) {
+			} else if(cmd3th == CMD_SEND_SUCC_LIST) {
 				m_rnDht->receiveInterestSendSuccessorList(interest, cmd2ndIndex);
 			}
-		} else if(cmd2nd.compare("alive") == 0) {
+		} else if(cmd2nd == CMD_ALIVE) {
 			string alive("true");
 			shared_ptr<const ::ndn::Buffer> buffer;
 			buffer = make_shared<::ndn::Buffer>((const void*)alive.c_str(), alive.size());
 			m_rnDht->sendData(interest, buffer);
-		} else if(cmd2nd.compare("p1") == 0) {
+		} else if(cmd2nd == CMD_P1) {
 			m_rnDht->receiveInterestStabilizeP1(interest, cmd2ndIndex);
-		} else if(cmd2nd.compare("stabilize") == 0) {
+		} else if(cmd2nd == CMD_STABILIZE) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				string alive("true");
 				shared_ptr<const ::ndn::Buffer> buffer;
 				buffer = make_shared<::ndn::Buffer>((const void*)alive.c_str(), alive.size());
 				m_rnDht->sendData(interest, buffer);
-			} else if(cmd3th.compare("p1") == 0) {
+			} else if(cmd3th == CMD_P1) {
 				m_rnDht->receiveInterestStabilizeP1(interest, cmd3thIndex);
 			}
-		} else if(cmd2nd.compare("updateSuccessorList") == 0) {
+		} else if(cmd2nd == CMD_UPDATE_SUCCESSOR_LIST) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("sendSuccList") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_SEND_SUCC_LIST) {
 				m_rnDht->receiveInterestSendSuccessorList(interest, cmd3thIndex);
 			}
-		} else if(cmd2nd.compare("fixFingers") == 0) {
+		} else if(cmd2nd == CMD_FIX_FINGERS) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				string alive("true");
 				shared_ptr<const ::ndn::Buffer> buffer;
 				buffer = make_shared<::ndn::Buffer>((const void*)alive.c_str(), alive.size());
 				m_rnDht->sendData(interest, buffer);
 			}
 		}
-	} else if (cmd.compare("storeKeys") == 0) {
+	} else if (cmd == CMD_STORE_KEYS) {
 		//
 		const Block &params = interest->getParameters();
 		string keyAndValues((const char *)params.value(), params.value_size());
@@ -550,7 +617,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// data sent time
 		m_appLink->onReceiveData(*data);
 
-	} else if (cmd.compare("k") == 0) {
+	} else if (cmd == CMD_GET) {
 		//
 		name::Component keyName = interestName.get(2);
 		string value = m_rnDht->receiveInterestGet(keyName.toUri());
@@ -585,7 +652,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else if (cmd.compare("sendSuccList") == 0) {
+	} else if (cmd == CMD_SEND_SUCC_LIST) {
 #if 0
 		//
 		int32_t attentionIndex = prefixSize + 1;
@@ -623,7 +690,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// data sent time
 		m_appLink->onReceiveData(*data);
 #endif
-	} else if (cmd.compare("alive") == 0) {
+	} else if (cmd == CMD_ALIVE) {
 		Name dataName(interestName);
 		// generate data pacaket
 		auto data = make_shared<Data>();
@@ -656,7 +723,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else if (cmd.compare("put") == 0) {
+	} else if (cmd == CMD_PUT) {
 		const Block &params = interest->getParameters();
 		if(0 < params.elements_size()) {
 			params.parse();
@@ -671,11 +738,11 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		string value((const char *)valueBlock.value(), valueBlock.size());
 
 		m_rnDht->receiveInterestPut(keyHash, value);
-	} else if (cmd.compare("p2") == 0) {
+	} else if (cmd == CMD_P2) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 
 		m_rnDht->receiveInterestP2(interest);
-	} else if (cmd.compare("PA") == 0) {
+	} else if (cmd == CMD_PA) {
 		// Publish Advertisement
 		//  /RN/PA/topic-{nnn}?RN-{yyy}
 		NS_LOG_DEBUG("recv interest: " << interestName);
@@ -697,7 +764,8 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 
-		m_PAMap.insert(std::pair<std::string, std::string>(topicName.toUri(), nodeName));
+		NameInterner &interner = NameInterner::Get();
+		m_PAMap.insert(std::make_pair(interner.intern(topicName), interner.intern(nodeName)));
 
 		// keyHash 를 저장할 RN-{yyy} 을 찾아서,
 		// /RN-{yyy}/PA/topic-{nnn}[RN-Xxx] Interest를 보낸다.
@@ -706,7 +774,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 //		string topic = topicName.toUri();
 //		lli keyHash = Helper::getHash(topic);
 //		m_rnTopic->receiveInterestPATopic(keyHash, nodeName);
-	} else if (cmd.compare("PU") == 0) {
+	} else if (cmd == CMD_PU) {
 		// Publish Unadvertisement
 		//  /RN/PU/topic-{nnn}
 		NS_LOG_DEBUG("recv interest: " << interestName);
@@ -728,8 +796,8 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 
-		std::map<std::string, std::string>::iterator iter;
-		iter = m_PAMap.find(topicName.toUri());
+		NameIdMapIterator iter;
+		iter = m_PAMap.find(NameInterner::Get().find(topicName));
 		if(iter != m_PAMap.end()) {
 			m_PAMap.erase(iter);
 		}
@@ -737,21 +805,24 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		// keyHash 를 저장할 RN-{yyy} 을 찾아서,
 		// /RN-{yyy}/PA/topic-{nnn}[RN-Xxx] Interest를 보낸다.
 //		m_rnTopic->receiveInterestPUTopic(keyHash);
-	} else if (cmd.compare("TS") == 0) {
+	} else if (cmd == CMD_TS) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 		//
 		int32_t attentionIndex = prefixSize + 1;
+		m_nRequestCount += 1;
+		countTopicRequest(interestName.get(attentionIndex).toUri());
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 		string topic = topicName.toUri();
 
+		NameInterner &interner = NameInterner::Get();
 		std::stringstream sio;
-		StringMapIterator mapIter;
+		NameIdMapIterator mapIter;
 		int at = topic.find('*');
 		if(at < 0) {
-			mapIter = m_PAMap.find(topic);
+			mapIter = m_PAMap.find(interner.find(topicName));
 			if(mapIter != m_PAMap.end()) {
-				sio << mapIter->second;
+				sio << nodeLabel(mapIter->second);
 			}
 		} else {
 			string exp(topic);
@@ -759,11 +830,11 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 			int count = 0;
 			std::regex reg(exp);
 			for( mapIter = m_PAMap.begin(); mapIter != m_PAMap.end(); mapIter ++) {
-				if(std::regex_match(mapIter->first, reg)) {
+				if(std::regex_match(interner.getUri(mapIter->first), reg)) {
 					if(0 < count) {
 						sio << ':';
 					}
-					sio << mapIter->second;
+					sio << nodeLabel(mapIter->second);
 					count ++;
 				}
 			}
@@ -802,7 +873,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else if (cmd.compare("TS") == 0) {
+	} else if (cmd == CMD_TS) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 		//
 		int32_t attentionIndex = prefixSize + 1;
@@ -810,28 +881,31 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
 		string topic = topicName.toUri();
 
-	} else if (cmd.compare("TM") == 0) {
+	} else if (cmd == CMD_TM) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 		//
 		int32_t attentionIndex = prefixSize + 1;
+		m_nRequestCount += 1;
+		countTopicRequest(interestName.get(attentionIndex).toUri());
 		sendDataTM(interestName, attentionIndex);
 		return;
 		// string value = m_rnDht->receiveInterestSendSuccessorList();
-	} else	if(cmd.compare("DM") == 0) {
+	} else	if(cmd == CMD_DM) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 		// Data Manifest Request
 		int32_t attentionIndex = prefixSize + 1;
+		m_nRequestCount += 1;
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
-		string topic = topicName.toUri();
 
 		size_t topicSize = topicName.size();
 
+		NameInterner &interner = NameInterner::Get();
 		::ndn::Block content(::ndn::tlv::Content);
-		BufferListMapIterator mapIter = m_DPMap.begin();
+		NameBufferListMapIterator mapIter = m_DPMap.begin();
 		for(; mapIter != m_DPMap.end(); mapIter ++) {
 			// /a/b/c/topic-0/0
-			Name publishTopicName(mapIter->first);
+			const Name &publishTopicName = interner.getName(mapIter->first);
 			if(publishTopicName.size() < topicSize) {
 				continue;
 			}
@@ -839,7 +913,8 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 			if(publishTopicName.getPrefix(prefixSize).equals(topicName) == false) {
 				continue;
 			}
-			::ndn::Block nameBlock(::ndn::tlv::Name, Block((uint8_t *)mapIter->first.c_str(), mapIter->first.size()));
+			const string &uri = interner.getUri(mapIter->first);
+			::ndn::Block nameBlock(::ndn::tlv::Name, Block((uint8_t *)uri.c_str(), uri.size()));
 			content.push_back(nameBlock);
 		}
 
@@ -872,14 +947,14 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 		// data sent time
 		m_appLink->onReceiveData(*data);
-	} else	if(cmd.compare("DR") == 0) {
+	} else	if(cmd == CMD_DR) {
 		NS_LOG_DEBUG("recv interest: " << interestName);
 		// Data Request
 		// Data Manifest Request
 		int32_t attentionIndex = prefixSize + 1;
+		m_nRequestCount += 1;
 
 		Name topicName = interestName.getSubName(attentionIndex, Name::npos);
-		string topic = topicName.toUri();
 
 		Name tmDataName(interestName);
 		// generate data pacaket
@@ -887,7 +962,7 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 		data->setName(tmDataName);
 //		data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
 
-		BufferListMapIterator mapIter = m_DPMap.find(topic);
+		NameBufferListMapIterator mapIter = m_DPMap.find(NameInterner::Get().find(topicName));
 		if(mapIter != m_DPMap.end()) {
 			// /a/b/c/topic-0/0
 			::ndn::Block content(::ndn::tlv::Content);
@@ -932,15 +1007,14 @@ RendezvousDrn::OnInterestRNXXX(shared_ptr<const Interest> interest) {
 
 void
 RendezvousDrn::OnInterest(shared_ptr<const Interest> interest) {
+	DRN_PROFILE_SCOPE("RendezvousDrn", "OnInterest");
 	const Name &interestName = interest->getName();
-	const name::Component &topPrefix = interest->getName().get(0);
-	string prefix = topPrefix.toUri();
-
 	NS_LOG_DEBUG("recv interest: " << interestName);
 
-	if(prefix == m_rnPrefix) {
+	// 문자열로 바꾸지 않고 component 단위로 비교한다
+	if(m_rnPrefix.isPrefixOf(interestName)) {
 		OnInterestRN(interest);
-	} else if(prefix == m_drnPrefix) {
+	} else if(m_drnPrefix.isPrefixOf(interestName)) {
 		OnInterestRNXXX(interest);
 	}
 }
@@ -961,59 +1035,64 @@ RendezvousDrn::OnDataRNXXX(shared_ptr<const Data> data) {
 	int32_t prefixSize = 1;
 	int32_t cmdIndex = prefixSize;
 
-	string cmd = dataName.get(cmdIndex).toUri();
-	if(cmd.compare("join") == 0) {
+	DrnCommand cmd = parseCommand(dataName, cmdIndex);
+	DRN_PROFILE_COMMAND("RendezvousDrn", "OnDataRNXXX", cmd);
+	if(isControlCommand(cmd)) {
+		m_nControlDataCount += 1;
+	}
+
+	if(cmd == CMD_JOIN) {
 		int32_t cmd2ndIndex = cmdIndex + 1;
-		string cmd2nd = dataName.get(cmd2ndIndex).toUri();
-		if(cmd2nd.compare("successor") == 0) {
+		DrnCommand cmd2nd = parseCommand(dataName, cmd2ndIndex);
+		if(cmd2nd == CMD_SUCCESSOR) {
 			m_rnDht->receiveDataJoinSuccessor(data, cmd2ndIndex);
-		} else if(cmd2nd.compare("finger") == 0) {
+		} else if(cmd2nd == CMD_FINGER) {
 			m_rnDht->receiveDataJoinFinger(data, cmd2ndIndex);
-		} else if(cmd2nd.compare("getKeys") == 0) {
+		} else if(cmd2nd == CMD_GET_KEYS) {
 			m_rnDht->receiveDataJoinGetKeys(data, cmd2ndIndex);
 		}
-	} else if(cmd.compare("stabilize") == 0) {
+	} else if(cmd == CMD_STABILIZE) {
 		int32_t cmd2ndIndex = prefixSize + 1;
-		string cmd2nd = dataName.get(cmd2ndIndex).toUri();
-		if(cmd2nd.compare("checkPredecessor") == 0) {
+		DrnCommand cmd2nd = parseCommand(dataName, cmd2ndIndex);
+		if(cmd2nd == CMD_CHECK_PREDECESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = dataName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(dataName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				m_rnDht->receiveDataPredecessorAlive(data, cmd2ndIndex);
 			}
-		} else if(cmd2nd.compare("checkSuccessor") == 0) {
+		} else if(cmd2nd == CMD_CHECK_SUCCESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = dataName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(dataName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				m_rnDht->receiveDataSuccessorAlive(data, cmd3thIndex);
-			} else if(cmd3th.compare("sendSuccList") == 0) {
+			} else if(cmd3th == CMD_SEND_SUCC_LIST) {
 				m_rnDht->receiveDataSendSuccessorList(data, cmd3thIndex);
 			}
-		} else if(cmd2nd.compare("stabilize") == 0) {
+		} else if(cmd2nd == CMD_STABILIZE) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = dataName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(dataName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				m_rnDht->receiveDataStabilizeAlive(data, cmd3thIndex);
-			} else if(cmd3th.compare("p1") == 0) {
+			} else if(cmd3th == CMD_P1) {
 				m_rnDht->receiveDataStabilizeP1(data, cmd3thIndex);
 			}
-		} else if(cmd2nd.compare("p1") == 0) {
+		} else if(cmd2nd == CMD_P1) {
 			int32_t nodeIndex = cmd2ndIndex + 1;
 			string nodeName = dataName.get(nodeIndex).toUri();
-		} else if(cmd2nd.compare("updateSuccessorList") == 0) {
+		} else if(cmd2nd == CMD_UPDATE_SUCCESSOR_LIST) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = dataName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("sendSuccList") == 0) {
+			DrnCommand cmd3th = parseCommand(dataName, cmd3thIndex);
+			if(cmd3th == CMD_SEND_SUCC_LIST) {
 				m_rnDht->receiveInterestUpdateSuccessorList(data, cmd3thIndex);
 			}
-		} else if(cmd2nd.compare("fixFingers") == 0) {
+		} else if(cmd2nd == CMD_FIX_FINGERS) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = dataName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(dataName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				m_rnDht->receiveDataFixFingersAlive(data, cmd3thIndex);
 			}
 		}
-	} else if(cmd.compare("sendSuccList") == 0) {
+	} else if(cmd == CMD_SEND_SUCC_LIST) {
 #if 0
 		// TODO: SuccList는 ;를 구분자로 문자열로 넘어온다.
 		const Block &content = data->getContent();
@@ -1023,9 +1102,9 @@ RendezvousDrn::OnDataRNXXX(shared_ptr<const Data> data) {
 
 		m_rnDht->receiveDataSendSuccessorList(successorList);
 #endif
-	} else if(cmd.compare("storeKeys") == 0) {
+	} else if(cmd == CMD_STORE_KEYS) {
 		// TODO: storeKeys 명령을 실행한 결과를 처리한다.
-	} else if(cmd.compare("k") == 0) {
+	} else if(cmd == CMD_GET) {
 		int32_t attentionIndex = prefixSize + 1;
 		string key = data->getName().get(attentionIndex).toUri();
 
@@ -1035,7 +1114,7 @@ RendezvousDrn::OnDataRNXXX(shared_ptr<const Data> data) {
 		NS_LOG_DEBUG("contents: value: " << value);
 
 		m_rnDht->receiveDataGet(key, value);
-	} else if(cmd.compare("alive") == 0) {
+	} else if(cmd == CMD_ALIVE) {
 		const Block &content = data->getContent();
 		string isAlive((const char *)content.value(), content.value_size());
 
@@ -1044,20 +1123,20 @@ RendezvousDrn::OnDataRNXXX(shared_ptr<const Data> data) {
 		Name keyName = data->getName().getPrefix(1);
 
 		m_rnDht->receiveDataAlive(keyName.toUri(), isAlive);
-	} else	if(cmd.compare("TS") == 0) {
+	} else	if(cmd == CMD_TS) {
 		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/TS/...에  대한 응답(Data)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
 
-	} else if(cmd.compare("TM") == 0) {
+	} else if(cmd == CMD_TM) {
 		NS_LOG_DEBUG("recv data: " << dataName);
 		// /RN-{yyyyy}/TM/...에  대한 응답(Data)
 		int32_t attentionIndex = prefixSize + 1;
 		Name topicName = dataName.getSubName(attentionIndex, Name::npos);
 
 		Name tmpName("RN");
-		tmpName.append(cmd);
+		tmpName.append(commandName(cmd));
 		tmpName.append(topicName);
 		// generate data pacaket
 		auto data = make_shared<Data>();
@@ -1128,28 +1207,28 @@ RendezvousDrn::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 	int32_t prefixSize = 1;
 
 	int32_t cmdIndex = prefixSize;
-	string cmd = interestName.get(cmdIndex).toUri();
-	if(cmd.compare("stabilize") == 0) {
+	DrnCommand cmd = parseCommand(interestName, cmdIndex);
+	if(cmd == CMD_STABILIZE) {
 		int32_t cmd2ndIndex = cmdIndex + 1;
-		string cmd2nd = interestName.get(cmd2ndIndex).toUri();
-		if(cmd2nd.compare("predecessor") == 0) {
+		DrnCommand cmd2nd = parseCommand(interestName, cmd2ndIndex);
+		if(cmd2nd == CMD_PREDECESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				// /RN-yyyyy/stabilize/checkPredecessor/alive
 				m_rnDht->setDeadPredecessor();
 			}
-		} else if(cmd2nd.compare("successor") == 0) {
+		} else if(cmd2nd == CMD_SUCCESSOR) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				// /RN-yyyyy/stabilize/checkSuccessor/alive
 				m_rnDht->sendInterestCheckSuccessorUpdateSuccessorList();
 			}
-		} else if(cmd2nd.compare("stabilize") == 0) {
+		} else if(cmd2nd == CMD_STABILIZE) {
 			int32_t cmd3thIndex = cmd2ndIndex + 1;
-			string cmd3th = interestName.get(cmd3thIndex).toUri();
-			if(cmd3th.compare("alive") == 0) {
+			DrnCommand cmd3th = parseCommand(interestName, cmd3thIndex);
+			if(cmd3th == CMD_ALIVE) {
 				// /RN-yyyyy/stabilize/stabilize/alive
 				int step = 3;
 			#if 0
@@ -1162,3 +1241,50 @@ RendezvousDrn::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 		}
 	}
 }
+
+uint32_t
+RendezvousDrn::GetLoad() {
+	return m_nRequestCount;
+}
+
+/**
+ * hot topic 검출만 한다. chord lookup은 hop 마다 topic의 hash로 다음 노드를 정하므로
+ * replica(topic#r) 로의 분산은 RendezvousDrnF에서만 한다.
+ */
+void
+RendezvousDrn::countTopicRequest(const string &topicPrefix) {
+	while(m_sketchWindowEnd <= Simulator::Now()) {
+		m_topicSketch.decay();
+		m_sketchWindowEnd += m_hotWindow;
+	}
+
+	uint32_t count = m_topicSketch.add(topicPrefix);
+	if(count < m_hotThreshold || m_hotTopics.find(topicPrefix) != m_hotTopics.end()) {
+		return;
+	}
+
+	NS_LOG_INFO("HotTopic: " << topicPrefix << ", count: " << count);
+	m_hotTopics.insert(topicPrefix);
+	m_nHotTopicCount += 1;
+}
+
+void
+RendezvousDrn::GetMemoryUsage(MemoryUsage &usage) {
+	TimeoutApp::GetMemoryUsage(usage);
+
+	usage.push_back(TableUsage { "PAMap", m_PAMap.size(), mapBytes(m_PAMap) });
+
+	// entries: stored sequences of all topics
+	uint64_t entries = 0;
+	uint64_t bytes = mapBytes(m_DPMap);
+	for (std::map<NameId, BufferListPtr>::iterator mapIter = m_DPMap.begin(); mapIter != m_DPMap.end(); mapIter++) {
+		entries += mapIter->second->size();
+		bytes += bufferListBytes(*mapIter->second);
+	}
+	usage.push_back(TableUsage { "DPMap", entries, bytes });
+
+	RendezvousDHT *dht = GetDht();
+	if (dht != nullptr) {
+		usage.push_back(TableUsage { "dictionary", dht->m_dhtNode.getKeyCount(), dht->m_dhtNode.getKeyMemoryUsage() });
+	}
+}
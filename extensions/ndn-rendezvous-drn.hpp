@@ -21,6 +21,7 @@
 #define NDN_RENDEZVOUS_APP_H
 
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
 #include <ns3/ndnSIM/apps/ndn-app.hpp>
@@ -30,6 +31,8 @@
 
 #include "Chord-DHT/nodeInformation.hpp"
 #include "rendezvous-dht.hpp"
+#include "count-min-sketch.hpp"
+#include "name-interner.hpp"
 
 #include "utils.hpp"
 
@@ -54,6 +57,10 @@ public:
 	void
 	sendInterestJoin();
 
+	// null if the application is not running
+	RendezvousDHT *
+	GetDht();
+
 	void
 	sendDataTM(const Name &interestName, int32_t attentionIndex);
 
@@ -77,14 +84,27 @@ public:
 	virtual void
 	OnNack(shared_ptr<const ::ndn::lp::Nack> nack);
 
+	// state table sizes(MemorySampler)
+	virtual void
+	GetMemoryUsage(MemoryUsage &usage);
+
+	// rendezvous requests(TS, TM, DM, DR) received on /RN-{xxx}
+	uint32_t
+	GetLoad();
+
+	void
+	countTopicRequest(const string &topicPrefix);
+
 private:
 	::ndn::Name m_rnPrefix;
 	::ndn::Name m_drnPrefix;
 	uint32_t m_nSub;
 	uint32_t m_maxNode;
+	uint32_t m_keyChunkSize;
 	::ndn::Name m_predecessor;
 
 	std::unique_ptr<RendezvousDHT> m_rnDht;
+	ns3::Ptr<TopologyProximity> m_proximity;
 	::ndn::random::RandomNumberEngine& m_rng;
 	uint32_t m_appId;
 
@@ -93,11 +113,28 @@ private:
 	uint32_t m_signature;
 	Name m_keyLocator;
 
-	// RN-00001/PA/a/b/c[RN-00002]
-	std::map<std::string, std::string> m_PAMap;
+	// RN-00001/PA/a/b/c[RN-00002]: topic id -> publisher RN id
+	std::map<NameId, NameId> m_PAMap;
+
+	// RN/DP/a/b/c/topic-0: topic id -> published sequences
+	std::map<NameId, BufferListPtr> m_DPMap;
+
+	// hot topic detection: TS/TM per topic prefix
+	uint32_t m_hotThreshold;
+	::ns3::Time m_hotWindow;
+	uint32_t m_sketchWidth;
+	uint32_t m_sketchDepth;
+
+	CountMinSketch m_topicSketch;
+	::ns3::Time m_sketchWindowEnd;
+	std::set<std::string> m_hotTopics;
+
+	uint32_t m_nRequestCount;
+	uint32_t m_nHotTopicCount;
 
-	// RN/DP/a/b/c/topic-0
-	std::map<std::string, BufferListPtr> m_DPMap;
+	// ring maintenance(join, stabilize, key handoff) messages
+	uint32_t m_nControlInterestCount;
+	uint32_t m_nControlDataCount;
 };
 
 #endif
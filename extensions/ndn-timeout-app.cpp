@@ -2,6 +2,8 @@
 
 #include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
 
+#include "event-tracer.hpp"
+
 NS_LOG_COMPONENT_DEFINE("drn.TimeoutApp");
 
 //using namespace ns3::ndn;
@@ -39,6 +41,12 @@ TimeoutApp::StopApplication() {
 		Simulator::Remove(std::get<0>(timeoutIter->second));
 	}
 	m_timeoutEvent.clear();
+
+	timeoutIter = m_pendingEvent.begin();
+	for (; timeoutIter != m_pendingEvent.end(); timeoutIter ++) {
+		Simulator::Remove(std::get<0>(timeoutIter->second));
+	}
+	m_pendingEvent.clear();
 }
 
 void
@@ -51,6 +59,7 @@ TimeoutApp::OnData(shared_ptr<const Data> data) {
 	App::OnData(data);
 
 	NS_LOG_DEBUG(data->getName());
+	EventTracer::Get().record(TRACE_RECV_DATA, GetNode()->GetId(), data->getName(), data->getContent().value_size());
 
 	RemoveTimeoutEvent(data->getName());
 }
@@ -58,6 +67,7 @@ TimeoutApp::OnData(shared_ptr<const Data> data) {
 void
 TimeoutApp::OnTimeout(shared_ptr<const Interest> interest) {
 	NS_LOG_DEBUG(interest->getName());
+	EventTracer::Get().record(TRACE_TIMEOUT, GetNode()->GetId(), interest->getName());
 
 	RemoveTimeoutEvent(interest->getName());
 	sendInterestTimeout(interest);
@@ -68,6 +78,7 @@ TimeoutApp::OnNack(shared_ptr<const ::ndn::lp::Nack> nack) {
 	App::OnNack(nack);
 
 	NS_LOG_DEBUG(nack->getInterest().getName());
+	EventTracer::Get().record(TRACE_RECV_NACK, GetNode()->GetId(), nack->getInterest().getName(), (uint32_t)nack->getReason());
 
 	RemoveTimeoutEvent(nack->getInterest().getName());
 }
@@ -76,6 +87,7 @@ void
 TimeoutApp::sendInterestTimeout(shared_ptr<const Interest> interest) {
 
 	// 전송하고
+	EventTracer::Get().record(TRACE_SEND_INTEREST, GetNode()->GetId(), interest->getName());
 	m_appLink->onReceiveInterest(*interest);
 
 	time::milliseconds t = interest->getInterestLifetime();
@@ -157,3 +169,20 @@ TimeoutApp::removePendingTimeoutEvent(const Name &name) {
 	}
 }
 
+static uint64_t
+eventMapBytes(const std::map<::ndn::Name, std::tuple<::ns3::EventId, std::shared_ptr<const Interest>>> &events) {
+	uint64_t bytes = mapBytes(events);
+	std::map<::ndn::Name, std::tuple<::ns3::EventId, std::shared_ptr<const Interest>>>::const_iterator eventIter;
+	for (eventIter = events.begin(); eventIter != events.end(); eventIter++) {
+		// interest 는 map 이 살려둔다
+		bytes += nameBytes(eventIter->first) + heapChunk(sizeof(Interest)) + nameBytes(std::get<1>(eventIter->second)->getName());
+	}
+
+	return bytes;
+}
+
+void
+TimeoutApp::GetMemoryUsage(MemoryUsage &usage) {
+	usage.push_back(TableUsage { "timeoutEvent", m_timeoutEvent.size(), eventMapBytes(m_timeoutEvent) });
+	usage.push_back(TableUsage { "pendingEvent", m_pendingEvent.size(), eventMapBytes(m_pendingEvent) });
+}
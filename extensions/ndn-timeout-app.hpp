@@ -19,6 +19,7 @@
 
 #include "object-container.hpp"
 
+#include "memory-usage.hpp"
 #include "utils.hpp"
 
 using namespace ns3;
@@ -71,6 +72,10 @@ public:
 	virtual void
 	removePendingTimeoutEvent(const Name &name);
 
+	// entries and estimated bytes of the state tables, sampled by MemorySampler
+	virtual void
+	GetMemoryUsage(MemoryUsage &usage);
+
 protected:
 	std::map<::ndn::Name, std::tuple<::ns3::EventId, std::shared_ptr<const Interest>>> m_timeoutEvent;
 
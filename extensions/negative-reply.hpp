@@ -0,0 +1,80 @@
+/*
+ * negative-reply.hpp
+ */
+
+#ifndef EXTENSIONS_NEGATIVE_REPLY_HPP_
+#define EXTENSIONS_NEGATIVE_REPLY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+/**
+ * negative reply of a TM/DM that has no answer yet(RendezvousDrnF NegativeReply=true), instead of keeping the
+ * Interest pending until its lifetime:
+ *
+ *   NegativeReply = 210 20 RetryAfter TopicVersion
+ *   RetryAfter    = 211 8 milliseconds          the consumer asks again after this
+ *   TopicVersion  = 212 8 version               TM: PA/PU seen by the RN, DM: 0(no version)
+ *
+ * a DM is asked of the RN that keeps the items, nothing of the topic changes there before its first item,
+ * so the DM replies claim no version and the consumer backs off to its lower MaxBackoffDM.
+ *
+ * the numbers have a fixed size, so a reply is 22 bytes, and its first byte tells it from a text or manifest answer.
+ */
+enum NegativeReplyTlv : uint8_t {
+	TLV_NEGATIVE_REPLY = 210,
+	TLV_RETRY_AFTER = 211,
+	TLV_TOPIC_VERSION = 212,
+};
+
+static const size_t NEGATIVE_REPLY_SIZE = 22;
+
+struct NegativeReply
+{
+	uint64_t retryAfter;
+	uint64_t version;
+};
+
+inline std::shared_ptr<::ndn::Buffer>
+encodeNegativeReply(uint64_t retryAfter, uint64_t version) {
+	std::shared_ptr<::ndn::Buffer> wire = std::make_shared<::ndn::Buffer>(NEGATIVE_REPLY_SIZE);
+	uint8_t *at = wire->data();
+	*at++ = TLV_NEGATIVE_REPLY;
+	*at++ = NEGATIVE_REPLY_SIZE - 2;
+	const uint64_t numbers[2][2] = { { TLV_RETRY_AFTER, retryAfter }, { TLV_TOPIC_VERSION, version } };
+	for (int i = 0; i < 2; i++) {
+		*at++ = (uint8_t)numbers[i][0];
+		*at++ = 8;
+		for (int shift = 56; 0 <= shift; shift -= 8) {
+			*at++ = (uint8_t)(numbers[i][1] >> shift);
+		}
+	}
+
+	return wire;
+}
+
+inline bool
+isNegativeReply(const uint8_t *value, size_t size) {
+	return size == NEGATIVE_REPLY_SIZE && value[0] == TLV_NEGATIVE_REPLY;
+}
+
+inline bool
+decodeNegativeReply(const uint8_t *value, size_t size, NegativeReply &reply) {
+	if (!isNegativeReply(value, size) || value[2] != TLV_RETRY_AFTER || value[12] != TLV_TOPIC_VERSION) {
+		return false;
+	}
+
+	reply.retryAfter = 0;
+	reply.version = 0;
+	for (int i = 0; i < 8; i++) {
+		reply.retryAfter = (reply.retryAfter << 8) | value[4 + i];
+		reply.version = (reply.version << 8) | value[14 + i];
+	}
+
+	return true;
+}
+
+#endif /* EXTENSIONS_NEGATIVE_REPLY_HPP_ */
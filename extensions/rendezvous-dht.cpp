@@ -18,6 +18,8 @@
 
 #include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
 
+#include "drn-protocol.hpp"
+#include "scope-profiler.hpp"
 #include "utils.hpp"
 #include "../Chord-DHT/headers.h"
 #include "../Chord-DHT/helperClass.h"
@@ -37,17 +39,22 @@ RendezvousDHT::GetTypeId() {
   return tid;
 }
 
-RendezvousDHT::RendezvousDHT(const ::ndn::Name& drnPrefix, const ::ndn::Name& predecessor, ns3::ndn::AppLinkService *appLink, int maxNode)
+RendezvousDHT::RendezvousDHT(const ::ndn::Name& drnPrefix, const ::ndn::Name& predecessor, ns3::ndn::AppLinkService *appLink, int maxNode, uint32_t keyChunkSize)
 	: m_drnPrefix(drnPrefix)
+	, m_drnPrefixId(NameInterner::Get().intern(drnPrefix))
 	, m_predecessor(predecessor)
 	, m_appLink(appLink)
 	, m_signature(0U)
+	, m_keyChunkSize(keyChunkSize)
 	, m_dhtNode(drnPrefix.get(0).toUri(), maxNode)
 {
 }
 
 RendezvousDHT::~RendezvousDHT() {
-
+	// the node may leave the ring (StopApplication) while stabilize steps are still scheduled
+	for(std::list<ns3::EventId>::iterator iter = m_events.begin(); iter != m_events.end(); iter++) {
+		ns3::Simulator::Cancel(*iter);
+	}
 }
 
 void
@@ -138,7 +145,7 @@ RendezvousDHT::create() {
 	int step = 0;
 #if 1
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+	schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 	doStabilize(step);
 #endif
@@ -297,28 +304,34 @@ RendezvousDHT::receiveInterestJoinFinger(shared_ptr<const Interest> interest, in
 
 void
 RendezvousDHT::receiveInterestJoinGetKeys(shared_ptr<const Interest> interest, int32_t subcmdIndex) {
+	// RN-{yyy}/join/getKeys/RN-{xxx}/{segment}
 	const Name &interestName = interest->getName();
 	int32_t nodeNameIndex = subcmdIndex + 1;
+	int32_t segmentIndex = nodeNameIndex + 1;
 	string nodeName = interestName.get(nodeNameIndex).toUri();
 	lli idHash = Helper::getHash(nodeName);
-	vector< pair<lli , string> > keysAndValuesVector = m_dhtNode.getKeysForPredecessor(idHash);
 
-	std::stringstream sio;
-    /* will arrange all keys and val in form of key1:val1;key2:val2; */
-    for(size_t i=0;i<keysAndValuesVector.size();i++){
-		if(0 < i) {
-			sio << ';';
-		}
-    	sio << to_string(keysAndValuesVector[i].first) + ":" + keysAndValuesVector[i].second;
-    }
+	// without a segment number the whole range is handed off at once
+	size_t maxCount = m_dhtNode.getKeyCount();
+	bool isSegmented = segmentIndex < (int32_t)interestName.size() && interestName.get(segmentIndex).isSegment();
+	if(isSegmented) {
+		maxCount = m_keyChunkSize;
+	}
 
-    string keysAndValues = sio.str();
+	bool done = false;
+	vector< pair<lli , string> > keysAndValuesVector = m_dhtNode.getKeysForPredecessor(idHash, maxCount, done);
+	string keysAndValues = Helper::joinKeysAndValues(keysAndValuesVector);
+
+	NS_LOG_DEBUG("getKeys: " << nodeName << " keys: " << keysAndValuesVector.size() << " done: " << done);
 
 	Name dataName(interestName);
 	// generate data pacaket
 	auto data = make_shared<Data>();
 	data->setName(dataName);
 //		data->setFreshnessPeriod(::ndn::time::milliseconds(4000));
+	if(isSegmented && done) {
+		data->setFinalBlock(interestName.get(segmentIndex));
+	}
 
 	//
 	shared_ptr<const ::ndn::Buffer> buffer = make_shared<::ndn::Buffer>((const void*)keysAndValues.c_str(), keysAndValues.size());
@@ -366,10 +379,11 @@ RendezvousDHT::receiveDataJoinSuccessor(shared_ptr<const Data> data, int32_t sub
 	m_dhtNode.setStatus();
 
 	// successor에 key 목록을 묻는다.
-	sendInterestJoinGetKeys(successor);
+	sendInterestJoinGetKeys(successor, 0);
 }
 
 void RendezvousDHT::sendInterestLeave() {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestLeave");
 	pair<string, lli> successor = m_dhtNode.getSuccessor();
 
     lli id = m_dhtNode.getId();
@@ -377,42 +391,47 @@ void RendezvousDHT::sendInterestLeave() {
         return;
     }
 
-    vector< pair<lli , string> > keysAndValuesVector = m_dhtNode.getAllKeysForSuccessor();
-    if(keysAndValuesVector.size() == 0) {
-        return;
-    }
+    // the node is going away, so every segment is sent right now instead of one per round trip
+    bool done = false;
+    for(uint64_t segment = 0; done == false; segment++) {
+        vector< pair<lli , string> > keysAndValuesVector = m_dhtNode.getAllKeysForSuccessor(m_keyChunkSize, done);
+        if(keysAndValuesVector.size() == 0) {
+            break;
+        }
 
-    string keysAndValues = "";
-    /* will arrange all keys and val in form of key1:val1;key2:val2; */
-    for(size_t i=0;i<keysAndValuesVector.size();i++){
-        keysAndValues += to_string(keysAndValuesVector[i].first) + ":" + keysAndValuesVector[i].second;
-        keysAndValues += ";";
-    }
+        string keysAndValues = Helper::joinKeysAndValues(keysAndValuesVector);
 
-//    keysAndValues += "storeKeys";
+        // RN-{successor}/storeKeys/RN-{nnn}/{segment}
+        Name name(successor.first);
+        name.append("storeKeys");
+        name.append(m_dhtNode.m_nodeName);
+        name.appendSegment(segment);
 
-    //RN-nnn/sendSuccList
-	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>(successor.first);
-	interest->setName("storeKeys");
-	interest->setCanBePrefix(true);
-	interest->setMustBeFresh(true);
-//    time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-//    interest->setInterestLifetime(interestLifeTime);
+        std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
+        interest->setName(name);
+        interest->setCanBePrefix(true);
+        interest->setMustBeFresh(true);
+//        time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+//        interest->setInterestLifetime(interestLifeTime);
 
-    interest->setParameters((const uint8_t *)keysAndValues.c_str(), keysAndValues.size());
+        interest->setParameters((const uint8_t *)keysAndValues.c_str(), keysAndValues.size());
 
-    m_appLink->onReceiveInterest(*interest);
+        m_appLink->onReceiveInterest(*interest);
+    }
 }
 
 void RendezvousDHT::receiveDataLeave(string successor) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataLeave");
 
 }
 
 void RendezvousDHT::receiveInterestStoreAllKeys(string keyAndValues) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestStoreAllKeys");
 	Helper::storeAllKeys(m_dhtNode, keyAndValues);
 }
 
 void RendezvousDHT::doStabilize(int step) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "doStabilize");
 	// 각 단계에서 여러 번 데이터를 주고 받으므로 작업을 유지하기 위하여 Name에 목적을 표시한다.
 
 	pair< string, lli > xcessor;
@@ -425,7 +444,7 @@ void RendezvousDHT::doStabilize(int step) {
 		if (0 < std::get<0>(result)) {
 			// Predecessor가 설정 되어 있으면, Predecessor가 동작 중인지 확인한다.
 			ns3::Time delay(ns3::MilliSeconds(0));
-			m_stablilizeEventId = ns3::Simulator::Schedule(delay, &RendezvousDHT::sendInterestPredecessorAlive, this, xcessor.first);
+			m_stablilizeEventId = schedule(delay, &RendezvousDHT::sendInterestPredecessorAlive, xcessor.first);
 			return;
 		}
 		step = 1;
@@ -436,7 +455,7 @@ void RendezvousDHT::doStabilize(int step) {
 		result = m_dhtNode.checkSuccessor(xcessor);
 		if (0 < std::get<0>(result)) {
 			ns3::Time delay(ns3::MilliSeconds(0));
-			m_stablilizeEventId = ns3::Simulator::Schedule(delay, &RendezvousDHT::sendInterestSuccessorAlive, this, xcessor.first);
+			m_stablilizeEventId = schedule(delay, &RendezvousDHT::sendInterestSuccessorAlive, xcessor.first);
 			return;
 		}
 		step = 2;
@@ -468,16 +487,17 @@ void RendezvousDHT::doStabilize(int step) {
 
 	if(step == 5) {
 		ns3::Time delay(ns3::MilliSeconds(300));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, 0);
+		schedule(delay, &RendezvousDHT::doStabilize, 0);
 	}
 }
 
 void RendezvousDHT::sendInterestPredecessorAlive(string nodeName) {
-	if (m_drnPrefix.equals(Name(nodeName))) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestPredecessorAlive");
+	if (isSelf(nodeName)) {
 		int step = 1;
 #if 1
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+		schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 		doStabilize(step);
 #endif
@@ -499,6 +519,7 @@ void RendezvousDHT::sendInterestPredecessorAlive(string nodeName) {
 }
 
 void RendezvousDHT::receiveDataPredecessorAlive(shared_ptr<const Data> data, int32_t subcmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataPredecessorAlive");
 	// 응답이 왔다는 것은 살아 있다는 것.
 	const Block &content = data->getContent();
 	string alive((const char *)content.value(), content.value_size());
@@ -508,7 +529,7 @@ void RendezvousDHT::receiveDataPredecessorAlive(shared_ptr<const Data> data, int
 	int step = 1;
 #if 1
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+	schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 	doStabilize(step);
 #endif
@@ -519,6 +540,7 @@ void RendezvousDHT::setDeadPredecessor() {
 }
 
 void RendezvousDHT::sendInterestCheckSuccessorUpdateSuccessorList() {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestCheckSuccessorUpdateSuccessorList");
 	m_dhtNode.updateSuccessor();
 
 	pair<string, lli > successor = m_dhtNode.getSuccessor();
@@ -540,11 +562,12 @@ void RendezvousDHT::sendInterestCheckSuccessorUpdateSuccessorList() {
 }
 
 void RendezvousDHT::sendInterestSuccessorAlive(string nodeName) {
-	if (m_drnPrefix.equals(Name(nodeName))) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestSuccessorAlive");
+	if (isSelf(nodeName)) {
 		int step = 2;
 #if 1
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+		schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 		doStabilize(step);
 #endif
@@ -568,6 +591,7 @@ void RendezvousDHT::sendInterestSuccessorAlive(string nodeName) {
 }
 
 void RendezvousDHT::receiveDataSuccessorAlive(shared_ptr<const Data> data, int32_t subcmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataSuccessorAlive");
 	// 응답이 왔다는 것은 살아 있다는 것.
 	const Block &content = data->getContent();
 	string alive((const char *)content.value(), content.value_size());
@@ -577,16 +601,17 @@ void RendezvousDHT::receiveDataSuccessorAlive(shared_ptr<const Data> data, int32
 	int step = 2;
 #if 1
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+	schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 	doStabilize(step);
 #endif
 }
 
 void RendezvousDHT::receiveInterestSendSuccessorList(shared_ptr<const Interest> interest, int32_t cmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestSendSuccessorList");
 	const Name &interestName = interest->getName();
-	string cmd = interestName.get(cmdIndex).toUri();
-	if(cmd.compare("sendSuccList") == 0) {
+	DrnCommand cmd = parseCommand(interestName, cmdIndex);
+	if(cmd == CMD_SEND_SUCC_LIST) {
 		vector< pair<string, lli > > list = m_dhtNode.getSuccessorList();
 		string successorList = Helper::splitSuccessorList(list);
 
@@ -623,6 +648,7 @@ void RendezvousDHT::receiveInterestSendSuccessorList(shared_ptr<const Interest>
 }
 
 void RendezvousDHT::receiveDataSendSuccessorList(shared_ptr<const Data> data, int32_t cmd3thIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataSendSuccessorList");
 	const Block &content = data->getContent();
 
 	string successorList((const char *)content.value(), content.value_size());
@@ -632,8 +658,9 @@ void RendezvousDHT::receiveDataSendSuccessorList(shared_ptr<const Data> data, in
 }
 
 void RendezvousDHT::sendInterestStabilizeAlive(string nodeName) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestStabilizeAlive");
 	//
-	if(m_drnPrefix.equals(Name(nodeName))) {
+	if(isSelf(nodeName)) {
 		pair<string, lli > successor = m_dhtNode.getSuccessor();
 		sendInterestStabilizeP1(successor.first);
 		return;
@@ -658,12 +685,14 @@ void RendezvousDHT::sendInterestStabilizeAlive(string nodeName) {
 }
 
 void RendezvousDHT::receiveDataStabilizeAlive(shared_ptr<const Data> data, int32_t cmd3thIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataStabilizeAlive");
 	pair<string, lli > successor = m_dhtNode.getSuccessor();
 	sendInterestStabilizeP1(successor.first);
 }
 
 void RendezvousDHT::sendInterestStabilizeP1(string nodeName) {
-	if(m_drnPrefix.equals(Name(nodeName))) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestStabilizeP1");
+	if(isSelf(nodeName)) {
 		pair<string, lli > self(nodeName, m_dhtNode.getId());
 		m_dhtNode.notify(self);
 
@@ -678,7 +707,7 @@ void RendezvousDHT::sendInterestStabilizeP1(string nodeName) {
 			int step = 3;
 	#if 1
 			ns3::Time delay(ns3::MilliSeconds(0));
-			ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+			schedule(delay, &RendezvousDHT::doStabilize, step);
 	#else
 			doStabilize(step);
 	#endif
@@ -693,7 +722,7 @@ void RendezvousDHT::sendInterestStabilizeP1(string nodeName) {
 		int step = 3;
 	#if 1
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+		schedule(delay, &RendezvousDHT::doStabilize, step);
 	#else
 		doStabilize(step);
 	#endif
@@ -720,6 +749,7 @@ void RendezvousDHT::sendInterestStabilizeP1(string nodeName) {
 }
 
 void RendezvousDHT::receiveInterestStabilizeP1(shared_ptr<const Interest> interest, int32_t cmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestStabilizeP1");
 	const Name &interestName = interest->getName();
 	int32_t nodeIndex = cmdIndex + 1;
 	string nodeName = interestName.get(nodeIndex).toUri();
@@ -755,6 +785,7 @@ void RendezvousDHT::receiveInterestStabilizeP1(shared_ptr<const Interest> intere
 }
 
 void RendezvousDHT::receiveDataStabilizeP1(shared_ptr<const Data> data, int32_t cmd3ndIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataStabilizeP1");
 	const Block &content = data->getContent();
 	content.parse();
 
@@ -770,7 +801,7 @@ void RendezvousDHT::receiveDataStabilizeP1(shared_ptr<const Data> data, int32_t
 		int step = 3;
 #if 1
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+		schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 		doStabilize(step);
 #endif
@@ -785,19 +816,20 @@ void RendezvousDHT::receiveDataStabilizeP1(shared_ptr<const Data> data, int32_t
 	int step = 3;
 #if 1
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+	schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 	doStabilize(step);
 #endif
 }
 
 void RendezvousDHT::sendInterestUpdateSuccessorList() {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestUpdateSuccessorList");
 	pair<string, lli > successor = m_dhtNode.getSuccessor();
-	if(m_drnPrefix.equals(Name(successor.first))) {
+	if(isSelf(successor.first)) {
 		int step = 4;
 	#if 1
 		ns3::Time delay(ns3::MilliSeconds(0));
-		ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+		schedule(delay, &RendezvousDHT::doStabilize, step);
 	#else
 		doStabilize(step);
 	#endif
@@ -822,6 +854,7 @@ void RendezvousDHT::sendInterestUpdateSuccessorList() {
 }
 
 void RendezvousDHT::receiveInterestUpdateSuccessorList(shared_ptr<const Data> data, int32_t cmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestUpdateSuccessorList");
 	const Block &content = data->getContent();
 
 	string successorList((const char *)content.value(), content.value_size());
@@ -832,15 +865,37 @@ void RendezvousDHT::receiveInterestUpdateSuccessorList(shared_ptr<const Data> da
 	int step = 4;
 #if 1
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+	schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 	doStabilize(step);
 #endif
 	return;
 }
 
+void RendezvousDHT::setProximity(ns3::Ptr<TopologyProximity> proximity) {
+	m_proximity = proximity;
+}
+
+/*
+ * finger 구간 안의 알려진 노드(successor list, finger table) 중 underlay delay가 가장 작은 노드를 사용한다.
+ */
+void RendezvousDHT::setFinger(int fingerIndex, const pair<string, lli> &finger) {
+	pair<string, lli> selected = finger;
+
+	if(m_proximity) {
+		vector< pair<string, lli> > candidates = m_dhtNode.getSuccessorList();
+		vector< pair<string, lli> > fingers = m_dhtNode.getFingerTable();
+		candidates.insert(candidates.end(), fingers.begin(), fingers.end());
+
+		selected = m_proximity->SelectFinger(m_dhtNode.m_nodeName, m_dhtNode.getId(), fingerIndex, finger, candidates);
+	}
+
+	m_dhtNode.setFingerTable(fingerIndex, selected.first, selected.second);
+}
+
 void RendezvousDHT::sendInterestFixFingersAlive(string nodeName, int fingerIndex) {
-	if(m_drnPrefix.equals(Name(nodeName))) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestFixFingersAlive");
+	if(isSelf(nodeName)) {
 
 		lli mod = pow(2,M);
 		lli newId = m_dhtNode.getId() + pow(2,fingerIndex-1);
@@ -856,14 +911,14 @@ void RendezvousDHT::sendInterestFixFingersAlive(string nodeName, int fingerIndex
 				int step = 5;
 	#if 1
 				ns3::Time delay(ns3::MilliSeconds(0));
-				ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+				schedule(delay, &RendezvousDHT::doStabilize, step);
 	#else
 				doStabilize(step);
 	#endif
 				return;
 			}
 
-			m_dhtNode.setFingerTable(fingerIndex, successor.first, successor.second);
+			setFinger(fingerIndex, successor);
 
 			if(fingerIndex < M) {
 				pair< string, lli > xcessor;
@@ -874,7 +929,7 @@ void RendezvousDHT::sendInterestFixFingersAlive(string nodeName, int fingerIndex
 				int step = 5;
 	#if 1
 				ns3::Time delay(ns3::MilliSeconds(0));
-				ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+				schedule(delay, &RendezvousDHT::doStabilize, step);
 	#else
 				doStabilize(step);
 	#endif
@@ -909,6 +964,7 @@ void RendezvousDHT::sendInterestFixFingersAlive(string nodeName, int fingerIndex
 }
 
 void RendezvousDHT::receiveDataFixFingersAlive(shared_ptr<const Data> data, int32_t cmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataFixFingersAlive");
 	const Name &dataName = data->getName();
 	int32_t indexIndex = cmdIndex + 1;
 
@@ -928,14 +984,14 @@ void RendezvousDHT::receiveDataFixFingersAlive(shared_ptr<const Data> data, int3
 			int step = 5;
 #if 1
 			ns3::Time delay(ns3::MilliSeconds(0));
-			ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+			schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 			doStabilize(step);
 #endif
 			return;
 		}
 
-		m_dhtNode.setFingerTable(fingerIndex, successor.first, successor.second);
+		setFinger(fingerIndex, successor);
 
 		if(fingerIndex < M) {
 			pair< string, lli > xcessor;
@@ -946,7 +1002,7 @@ void RendezvousDHT::receiveDataFixFingersAlive(shared_ptr<const Data> data, int3
 			int step = 5;
 #if 1
 			ns3::Time delay(ns3::MilliSeconds(0));
-			ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, step);
+			schedule(delay, &RendezvousDHT::doStabilize, step);
 #else
 			doStabilize(step);
 #endif
@@ -965,6 +1021,7 @@ void RendezvousDHT::receiveDataFixFingersAlive(shared_ptr<const Data> data, int3
 }
 
 void RendezvousDHT::sendInterestAlive(string nodeName, Name subCmd) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestAlive");
 	// RN-{nnn}/alive
 	ndn::Name name(nodeName);
 	name.append("alive");
@@ -981,16 +1038,19 @@ void RendezvousDHT::sendInterestAlive(string nodeName, Name subCmd) {
 }
 
 void RendezvousDHT::receiveDataAlive(string nodeName, string aliave) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataAlive");
 
 }
 
-void RendezvousDHT::sendInterestJoinGetKeys(string nodeName) {
-	// RN-{nnn}/getKeys/{keyhash}
+void RendezvousDHT::sendInterestJoinGetKeys(string nodeName, uint64_t segment) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestJoinGetKeys");
+	// RN-{nnn}/join/getKeys/RN-{xxx}/{segment}
 	Name name(nodeName);
 	name.append("join");
 	name.append("getKeys");
 //	name.append(to_string(m_dhtNode.getId()));
 	name.append(m_dhtNode.m_nodeName);
+	name.appendSegment(segment);
 
 	std::shared_ptr<::ndn::Interest> interest = std::make_shared<::ndn::Interest>();
 	interest->setName(name);
@@ -1006,6 +1066,7 @@ void RendezvousDHT::sendInterestJoinGetKeys(string nodeName) {
  * key에 대한 value를 요청하는 Interest를 보낸다.
  */
 void RendezvousDHT::sendInterestGet(string key) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestGet");
 	lli keyHash = Helper::getHash(key);
 
 	// keyHash에 대하여 노드의 ID에 대하여 현재 노드의 successor, predecessor 또는
@@ -1034,6 +1095,7 @@ void RendezvousDHT::sendInterestGet(string key) {
 }
 
 string RendezvousDHT::receiveInterestGet(string key) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestGet");
 	lli keyHash = std::stoll(key);
 	string value = m_dhtNode.getValue(keyHash);
 
@@ -1041,10 +1103,12 @@ string RendezvousDHT::receiveInterestGet(string key) {
 }
 
 void RendezvousDHT::receiveDataGet(string key, string value) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataGet");
 //	lli keyHash = std::stoll(key);
 }
 
 void RendezvousDHT::sendInterestPut(string key, string value) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestPut");
 	lli keyHash = Helper::getHash(key);
 
 	pair<string, lli > node;
@@ -1086,14 +1150,17 @@ void RendezvousDHT::sendInterestPut(string key, string value) {
 }
 
 void RendezvousDHT::receiveInterestPut(lli keyHash, string value) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestPut");
 	m_dhtNode.storeKey(keyHash, value);
 }
 
 void RendezvousDHT::receiveDataPut(string key) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataPut");
 
 }
 
 void RendezvousDHT::receiveDataJoinFinger(shared_ptr<const Data> data, int32_t subcmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataJoinFinger");
 
 	int32_t attentionIndex = subcmdIndex + 1;
 	// /RN-{nnn}/join/finger/{index}/{node name}
@@ -1183,6 +1250,11 @@ void RendezvousDHT::receiveDataJoinFinger(shared_ptr<const Data> data, int32_t s
 }
 
 void RendezvousDHT::receiveDataJoinGetKeys(shared_ptr<const Data> data, int32_t subcmdIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataJoinGetKeys");
+	// RN-{yyy}/join/getKeys/RN-{xxx}/{segment}
+	const Name &dataName = data->getName();
+	int32_t segmentIndex = subcmdIndex + 2;
+
 	const Block &content = data->getContent();
 	string keysAndValues((const char *)content.value(), content.value_size());
 
@@ -1192,11 +1264,22 @@ void RendezvousDHT::receiveDataJoinGetKeys(shared_ptr<const Data> data, int32_t
     	m_dhtNode.storeKey(keysAndValuesVector[i].first , keysAndValuesVector[i].second);
     }
 
+	// the successor still has keys of our range: fetch the next segment before stabilizing
+	if(segmentIndex < (int32_t)dataName.size() && dataName.get(segmentIndex).isSegment()) {
+		const name::Component &segment = dataName.get(segmentIndex);
+		const auto &finalBlock = data->getFinalBlock();
+		if(!finalBlock || *finalBlock != segment) {
+			sendInterestJoinGetKeys(dataName.get(0).toUri(), segment.toSegment() + 1);
+			return;
+		}
+	}
+
 	ns3::Time delay(ns3::MilliSeconds(0));
-	ns3::Simulator::Schedule(delay, &RendezvousDHT::doStabilize, this, 0);
+	schedule(delay, &RendezvousDHT::doStabilize, 0);
 }
 
 void RendezvousDHT::receiveInterestP2(shared_ptr<const Interest> interest) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestP2");
 	Name name = interest->getName();
 	pair<string, lli > predecessor = m_dhtNode.getPredecessor();
 
@@ -1237,6 +1320,7 @@ void RendezvousDHT::receiveInterestP2(shared_ptr<const Interest> interest) {
 }
 
 void RendezvousDHT::receiveDataP2(shared_ptr<const Data> data) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveDataP2");
 
 	// /RN-{nnn}/finger/{index}/PA/topic-{nnn}/.../...
 	Name dataName = data->getName();
@@ -1247,8 +1331,6 @@ void RendezvousDHT::receiveDataP2(shared_ptr<const Data> data) {
 	pair<string, lli> predecessor;
 	predecessor.first = string((const char *)nameBlock.value(), nameBlock.value_size());
 	predecessor.second = atoll((const char *)hashBlock.value_size());
-
-	string cmd = dataName.get(2).toUri();
 	string indexStr = dataName.get(3).toUri();
 	int  index =atoi(indexStr.c_str());
 
@@ -1352,10 +1434,11 @@ void RendezvousDHT::receiveDataP2(shared_ptr<const Data> data) {
 }
 
 void RendezvousDHT::receiveInterestPA(const Name &interestName, int32_t attentionIndex, string topic) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestPA");
 	pair<string, lli> successor;
 
 	//  topic의 hash값을 계산하여
-	lli topicHash = Helper::getHash(topic);
+	lli topicHash = NameInterner::Get().getPlacementHash(topic);
 
 	// successor를 찾는다.
 	std::tuple<int, int> result;
@@ -1433,6 +1516,7 @@ void RendezvousDHT::receiveInterestPA(const Name &interestName, int32_t attentio
 }
 
 void RendezvousDHT::sendInterestPA(const Name &interestName, int32_t attentionIndex, string nodeName) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestPA");
 	// 찾으면
 	// /RN-{yyy}/PA/a/b/c/topic-{nnn}
 	Name paInterestName(nodeName);
@@ -1478,9 +1562,10 @@ void RendezvousDHT::sendInterestPA(const Name &interestName, int32_t attentionIn
 }
 
 void RendezvousDHT::receiveInterestPU(const Name &interestName, string topic) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestPU");
 	pair<string, lli> successor;
 
-	lli topicHash = Helper::getHash(topic);
+	lli topicHash = NameInterner::Get().getPlacementHash(topic);
 
 	// successor를 찾는다.
 	std::tuple<int, int> result;
@@ -1561,21 +1646,24 @@ void RendezvousDHT::receiveInterestPU(const Name &interestName, string topic) {
 }
 
 void RendezvousDHT::receiveInterestPATopic(lli keyHash, string nodeName) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestPATopic");
 	m_dhtNode.storeKey(keyHash, nodeName);
 }
 
 void RendezvousDHT::receiveInterestPUTopic(lli keyHash) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestPUTopic");
 	m_dhtNode.removeKey(keyHash);
 }
 
 void RendezvousDHT::receiveInterestRNTS(const Name &interestName, int32_t attentionIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestRNTS");
 	pair<string, lli> successor;
 
 	// /RN/TS/a/b/c/topic-{nnn}에서 3번째를 추출("a")
 	string topicPrefix = interestName.get(attentionIndex).toUri();
 
 	//  topic의 hash값을 계산하여
-	lli topicHash = Helper::getHash(topicPrefix);
+	lli topicHash = NameInterner::Get().getPlacementHash(topicPrefix);
 
 	// successor를 찾는다.
 	std::tuple<int, int> result;
@@ -1589,7 +1677,7 @@ void RendezvousDHT::receiveInterestRNTS(const Name &interestName, int32_t attent
 		// 찾으면
 		// /RN-{yyy}/TS/a/b/c
 
-		if(m_drnPrefix.equals(Name(successor.first))) {
+		if(isSelf(successor.first)) {
 		}
 
 		Name tsInterestName(successor.first);
@@ -1634,13 +1722,14 @@ void RendezvousDHT::receiveInterestRNTS(const Name &interestName, int32_t attent
 }
 
 void RendezvousDHT::receiveInterestTM(const Name &interestName, int32_t attentionIndex) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "receiveInterestTM");
 	pair<string, lli> successor;
 
 	// /RN/TS/a/b/c/topic-{nnn}에서 3번째를 추출("a")
 	string topicPrefix = interestName.get(attentionIndex).toUri();
 
 	//  topic의 hash값을 계산하여
-	lli topicHash = Helper::getHash(topicPrefix);
+	lli topicHash = NameInterner::Get().getPlacementHash(topicPrefix);
 
 	// successor를 찾는다.
 	std::tuple<int, int> result;
@@ -1695,6 +1784,7 @@ void RendezvousDHT::receiveInterestTM(const Name &interestName, int32_t attentio
 }
 
 void RendezvousDHT::sendInterestTM(const Name &interestName, int32_t attentionIndex, string nodeName) {
+	DRN_PROFILE_SCOPE("RendezvousDHT", "sendInterestTM");
 	// /RN/TM/a/b/* -> /RN-{xxx}/TM/a/b/*
 	// /RN/TM/a/b/c/topic-80/* -> /RN-{xxx}/TM/a/b/c/topic-80/*
 	// /RN/TM/a/b/c/topic-80/0 -> /RN-{xxx}/TM/a/b/c/topic-80/0
@@ -1718,3 +1808,8 @@ void RendezvousDHT::sendInterestTM(const Name &interestName, int32_t attentionIn
 	m_appLink->onReceiveInterest(*interest);
 	return;
 }
+
+bool
+RendezvousDHT::isSelf(const string &nodeName) {
+	return NameInterner::Get().intern(nodeName) == m_drnPrefixId;
+}
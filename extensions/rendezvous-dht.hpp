@@ -8,6 +8,7 @@
 #ifndef EXTENSIONS_RENDEZVOUS_DHT_HPP_
 #define EXTENSIONS_RENDEZVOUS_DHT_HPP_
 
+#include <list>
 #include <memory>
 #include <cstdint>
 #include <string>
@@ -18,8 +19,11 @@
 
 #include <ns3/ndnSIM/model/ndn-common.hpp>
 #include <ns3/ndnSIM/model/ndn-app-link-service.hpp>
+#include <ns3/simulator.h>
 
 #include "Chord-DHT/nodeInformation.hpp"
+#include "topology-proximity.hpp"
+#include "name-interner.hpp"
 
 using namespace ns3::ndn;
 
@@ -29,10 +33,13 @@ public:
 	static ns3::TypeId
 	GetTypeId();
 
-	RendezvousDHT(const ::ndn::Name& drnPrefix, const ::ndn::Name& predecessor, ns3::ndn::AppLinkService *appLink, int maxNode);
+	RendezvousDHT(const ::ndn::Name& drnPrefix, const ::ndn::Name& predecessor, ns3::ndn::AppLinkService *appLink, int maxNode, uint32_t keyChunkSize);
 
 	virtual ~RendezvousDHT();
 
+	// proximity neighbour selection of fingers, null: the first node of each finger interval
+	void setProximity(ns3::Ptr<TopologyProximity> proximity);
+
 	void sendData(shared_ptr<const Interest> interest, const Block &content);
 
 	void sendData(shared_ptr<const Interest> interest, shared_ptr<const ::ndn::Buffer> &value);
@@ -74,13 +81,14 @@ public:
 	void sendInterestUpdateSuccessorList();
 	void receiveInterestUpdateSuccessorList(shared_ptr<const Data> data, int32_t cmdIndex);
 
+	void setFinger(int fingerIndex, const pair<string, lli> &finger);
 	void sendInterestFixFingersAlive(string nodeName, int fingerIndex);
 	void receiveDataFixFingersAlive(shared_ptr<const Data> data, int32_t cmdIndex);
 
 	void sendInterestAlive(string nodeName, Name subCmd);
 	void receiveDataAlive(string nodeName, string aliave);
 
-	void sendInterestJoinGetKeys(string nodeName);
+	void sendInterestJoinGetKeys(string nodeName, uint64_t segment);
 
 	void sendInterestGet(string key);
 	string receiveInterestGet(string key);
@@ -106,15 +114,34 @@ public:
 
 	void receiveInterestTM(const Name &interestName, int32_t attentionIndex);
 
+	// nodeName(/RN-{xxx}) is this node
+	bool isSelf(const string &nodeName);
+
 	::ndn::Name m_drnPrefix;
+	NameId m_drnPrefixId;
 	::ndn::Name m_predecessor;
 	ns3::ndn::AppLinkService *m_appLink;
 
 	uint32_t m_signature;
 	Name m_keyLocator;
 
+	// max number of keys per getKeys/storeKeys segment
+	uint32_t m_keyChunkSize;
+
 	::ns3::EventId m_stablilizeEventId;
 
+	// every event scheduled on this object, cancelled on destruction
+	std::list<::ns3::EventId> m_events;
+
+	template<typename MEM, typename... Ts>
+	::ns3::EventId schedule(const ::ns3::Time &delay, MEM mem, Ts... args) {
+		m_events.remove_if([](const ::ns3::EventId &eventId) { return eventId.IsExpired(); });
+		m_events.push_back(::ns3::Simulator::Schedule(delay, mem, this, args...));
+		return m_events.back();
+	}
+
+	ns3::Ptr<TopologyProximity> m_proximity;
+
 	NodeInformation m_dhtNode;
 };
 
@@ -0,0 +1,311 @@
+/*
+ * route-cache.cpp
+ */
+
+#include "route-cache.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ns3/ndnSIM/model/ndn-l3-protocol.hpp>
+#include <ns3/ndnSIM/model/ndn-global-router.hpp>
+#include <ns3/ndnSIM/helper/ndn-fib-helper.hpp>
+#include <ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp>
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "Chord-DHT/sha1.hpp"
+
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.RouteCache");
+
+NS_OBJECT_ENSURE_REGISTERED(RouteCache);
+
+static const char ROUTE_CACHE_MAGIC[8] = { 'D', 'R', 'N', 'F', 'I', 'B', '0', '1' };
+
+struct RouteCacheHeader
+{
+	char magic[8];
+	char key[48];
+	uint32_t nodeCount;
+	uint32_t prefixCount;
+	uint32_t routeCount;
+	// bytes of the prefix TLVs, padded to 4
+	uint32_t nameBytes;
+};
+
+struct RouteCacheRecord
+{
+	uint32_t node;
+	uint32_t prefix;
+	uint32_t face;
+	int32_t cost;
+};
+
+ns3::TypeId
+RouteCache::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("RouteCache")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<RouteCache>()
+
+			.AddAttribute("Directory", "Directory of the cached routes(empty: always calculate)", ns3::StringValue(""),
+							ns3::MakeStringAccessor(&RouteCache::m_directory), ns3::MakeStringChecker())
+
+			.AddAttribute("Calculator", "Calculator of the routes, part of the key: global(CalculateRoutes), graph(RouteCalculator)", ns3::StringValue("global"),
+							ns3::MakeStringAccessor(&RouteCache::m_calculator), ns3::MakeStringChecker())
+			;
+
+	return tid;
+}
+
+RouteCache::RouteCache()
+	: m_hit(false)
+	, m_installTime(0.0)
+	, m_nRouteCount(0)
+{
+}
+
+RouteCache::~RouteCache() {
+}
+
+void
+RouteCache::Install(const std::string &topology, ns3::Callback<void> calculate) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::string path;
+	if (0 < m_directory.size()) {
+		path = m_directory + "/" + MakeKey(topology) + ".fib";
+	}
+
+	m_hit = 0 < path.size() && Load(path);
+	if (m_hit == false) {
+		calculate();
+
+		if (0 < path.size() && Save(path) == false) {
+			NS_LOG_WARN("cannot save routes to " << path);
+		}
+	}
+
+	m_installTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void
+RouteCache::Report() {
+	NS_LOG_INFO(stringf("RouteCache Hit:         %5u", m_hit ? 1 : 0));
+	NS_LOG_INFO(stringf("RouteCache RouteCount:  %5u", m_nRouteCount));
+	NS_LOG_INFO(stringf("RouteCache InstallTime: %8.3f", m_installTime));
+}
+
+bool
+RouteCache::IsHit() const {
+	return m_hit;
+}
+
+double
+RouteCache::GetInstallTime() const {
+	return m_installTime;
+}
+
+std::string
+RouteCache::MakeKey(const std::string &topology) {
+	sha1 s;
+
+	std::ifstream file(topology.c_str(), std::ios::binary);
+	char buffer[65536];
+	while (file.read(buffer, sizeof(buffer)) || 0 < file.gcount()) {
+		s.add(buffer, (uint32_t)file.gcount());
+	}
+
+	std::string origins = stringf("calculator:%s\nnodes:%u\n", m_calculator.c_str(), ns3::NodeList::GetNNodes());
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::GlobalRouter>();
+		if (router == 0) {
+			continue;
+		}
+
+		ns3::ndn::GlobalRouter::LocalPrefixList::const_iterator iter = router->GetLocalPrefixes().begin();
+		for (; iter != router->GetLocalPrefixes().end(); iter++) {
+			origins += stringf("%u %s\n", id, (*iter)->toUri().c_str());
+		}
+	}
+	s.add(origins.data(), (uint32_t)origins.size());
+	s.finalize();
+
+	char hex[41];
+	s.print_hex(hex);
+
+	return hex;
+}
+
+/**
+ * 모든 face가 있는지 먼저 확인하고 설치한다. 중간에 실패하면 일부만 설치된 FIB가 남기 때문이다.
+ */
+bool
+RouteCache::Load(const std::string &path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RouteCacheHeader)) {
+		::close(fd);
+		return false;
+	}
+
+	size_t size = st.st_size;
+	void *map = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED) {
+		return false;
+	}
+
+	const uint8_t *data = (const uint8_t *)map;
+	const RouteCacheHeader *header = (const RouteCacheHeader *)data;
+
+	size_t offsetsAt = sizeof(RouteCacheHeader);
+	size_t namesAt = offsetsAt + (header->prefixCount + 1) * sizeof(uint32_t);
+	size_t recordsAt = namesAt + header->nameBytes;
+	if (std::memcmp(header->magic, ROUTE_CACHE_MAGIC, sizeof(ROUTE_CACHE_MAGIC)) != 0
+			|| header->nodeCount != ns3::NodeList::GetNNodes()
+			|| size < recordsAt
+			|| size != recordsAt + (size_t)header->routeCount * sizeof(RouteCacheRecord)) {
+		::munmap(map, size);
+		return false;
+	}
+
+	const uint32_t *offsets = (const uint32_t *)(data + offsetsAt);
+	std::vector<::ndn::Name> prefixes;
+	for (uint32_t i = 0; i < header->prefixCount; i++) {
+		if (header->nameBytes < offsets[i + 1] || offsets[i + 1] <= offsets[i]) {
+			::munmap(map, size);
+			return false;
+		}
+		prefixes.push_back(::ndn::Name(::ndn::Block(data + namesAt + offsets[i], offsets[i + 1] - offsets[i])));
+	}
+
+	const RouteCacheRecord *records = (const RouteCacheRecord *)(data + recordsAt);
+	std::vector<std::shared_ptr<nfd::Face>> faces(header->routeCount);
+	for (uint32_t i = 0; i < header->routeCount; i++) {
+		const RouteCacheRecord &record = records[i];
+		if (header->nodeCount <= record.node || header->prefixCount <= record.prefix) {
+			::munmap(map, size);
+			return false;
+		}
+
+		ns3::Ptr<ns3::ndn::L3Protocol> l3 = ns3::NodeList::GetNode(record.node)->GetObject<ns3::ndn::L3Protocol>();
+		faces[i] = (l3 == 0) ? nullptr : l3->getFaceById(record.face);
+		if (faces[i] == nullptr) {
+			::munmap(map, size);
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < header->routeCount; i++) {
+		const RouteCacheRecord &record = records[i];
+		ns3::ndn::FibHelper::AddRoute(ns3::NodeList::GetNode(record.node), prefixes[record.prefix], faces[i], record.cost);
+	}
+	m_nRouteCount = header->routeCount;
+
+	::munmap(map, size);
+
+	return true;
+}
+
+/**
+ * 계산된 FIB 중 origin prefix 의 next hop 만 저장한다.
+ * 다른 프로세스가 읽는 중일 수 있으므로 임시 파일에 쓰고 rename 한다.
+ */
+bool
+RouteCache::Save(const std::string &path) {
+	std::map<::ndn::Name, uint32_t> prefixIndex;
+	std::vector<::ndn::Name> prefixes;
+
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::GlobalRouter>();
+		if (router == 0) {
+			continue;
+		}
+
+		ns3::ndn::GlobalRouter::LocalPrefixList::const_iterator iter = router->GetLocalPrefixes().begin();
+		for (; iter != router->GetLocalPrefixes().end(); iter++) {
+			if (prefixIndex.insert(std::make_pair(**iter, (uint32_t)prefixes.size())).second) {
+				prefixes.push_back(**iter);
+			}
+		}
+	}
+
+	std::vector<RouteCacheRecord> records;
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::ndn::L3Protocol> l3 = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::L3Protocol>();
+		if (l3 == 0) {
+			continue;
+		}
+
+		const nfd::Fib &fib = l3->getForwarder()->getFib();
+		for (const nfd::fib::Entry &entry : fib) {
+			std::map<::ndn::Name, uint32_t>::iterator indexIter = prefixIndex.find(entry.getPrefix());
+			if (indexIter == prefixIndex.end()) {
+				continue;
+			}
+
+			for (const nfd::fib::NextHop &nextHop : entry.getNextHops()) {
+				RouteCacheRecord record;
+				record.node = id;
+				record.prefix = indexIter->second;
+				record.face = (uint32_t)nextHop.getFace().getId();
+				record.cost = (int32_t)nextHop.getCost();
+				records.push_back(record);
+			}
+		}
+	}
+
+	std::vector<uint32_t> offsets;
+	std::string names;
+	for (uint32_t i = 0; i < prefixes.size(); i++) {
+		offsets.push_back(names.size());
+		const ::ndn::Block &wire = prefixes[i].wireEncode();
+		names.append((const char *)wire.wire(), wire.size());
+	}
+	offsets.push_back(names.size());
+	names.resize((names.size() + 3) & ~(size_t)3, '\0');
+
+	RouteCacheHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, ROUTE_CACHE_MAGIC, sizeof(ROUTE_CACHE_MAGIC));
+	std::strncpy(header.key, path.c_str() + path.rfind('/') + 1, sizeof(header.key) - 1);
+	header.nodeCount = ns3::NodeList::GetNNodes();
+	header.prefixCount = prefixes.size();
+	header.routeCount = records.size();
+	header.nameBytes = names.size();
+
+	std::string temp = stringf("%s.%d", path.c_str(), (int)::getpid());
+	std::ofstream file(temp.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file.write((const char *)&header, sizeof(header));
+	file.write((const char *)offsets.data(), offsets.size() * sizeof(uint32_t));
+	file.write(names.data(), names.size());
+	file.write((const char *)records.data(), records.size() * sizeof(RouteCacheRecord));
+	file.close();
+
+	if (file.fail() || ::rename(temp.c_str(), path.c_str()) != 0) {
+		::unlink(temp.c_str());
+		return false;
+	}
+
+	m_nRouteCount = records.size();
+
+	return true;
+}
@@ -0,0 +1,74 @@
+/*
+ * route-cache.hpp
+ *
+ * FIB entries computed by ndn::GlobalRoutingHelper::CalculateRoutes() or RouteCalculator, saved to a binary file and
+ * installed from it on the next run of the same topology.
+ *
+ *  - key   : sha1 of the topology file, the node count, the origins(GlobalRouter local prefixes) and the Calculator,
+ *            the two calculators may pick different next hops of equal cost. RouteCalculator Threads is not part of
+ *            it, the next hops do not depend on the thread count(build/route-calculation checks it)
+ *  - file  : {Directory}/{key}.fib, header, prefix name TLVs and (node, prefix, face, cost) records
+ *  - load  : the file is memory mapped and the records are installed with FibHelper::AddRoute,
+ *            a missing face or any mismatch falls back to the calculation
+ *
+ * face ids are valid because the topology reader creates the same faces in the same order
+ * for the same file.
+ */
+
+#ifndef EXTENSIONS_ROUTE_CACHE_HPP_
+#define EXTENSIONS_ROUTE_CACHE_HPP_
+
+#include <string>
+
+#include "ns3/core-module.h"
+
+class RouteCache : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	RouteCache();
+
+	virtual
+	~RouteCache();
+
+	/**
+	 * @brief install the cached routes of topology or calculate them with calculate and save them.
+	 * call after all origins are added
+	 */
+	void
+	Install(const std::string &topology, ns3::Callback<void> calculate);
+
+	void
+	Report();
+
+	bool
+	IsHit() const;
+
+	/**
+	 * @brief wall clock seconds of Install
+	 */
+	double
+	GetInstallTime() const;
+
+private:
+	std::string
+	MakeKey(const std::string &topology);
+
+	bool
+	Load(const std::string &path);
+
+	bool
+	Save(const std::string &path);
+
+private:
+	std::string m_directory;
+	std::string m_calculator;
+
+	bool m_hit;
+	double m_installTime;
+	uint32_t m_nRouteCount;
+};
+
+#endif /* EXTENSIONS_ROUTE_CACHE_HPP_ */
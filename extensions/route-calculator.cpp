@@ -0,0 +1,277 @@
+/*
+ * route-calculator.cpp
+ */
+
+#include "route-calculator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <set>
+#include <vector>
+
+#include <ns3/ndnSIM/model/ndn-l3-protocol.hpp>
+#include <ns3/ndnSIM/model/ndn-global-router.hpp>
+#include <ns3/ndnSIM/helper/ndn-fib-helper.hpp>
+#include <ns3/ndnSIM/helper/ndn-global-routing-helper.hpp>
+#include <ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp>
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "route-graph.hpp"
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.RouteCalculator");
+
+NS_OBJECT_ENSURE_REGISTERED(RouteCalculator);
+
+ns3::TypeId
+RouteCalculator::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("RouteCalculator")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<RouteCalculator>()
+
+			.AddAttribute("Threads", "Threads of the shortest path computation(0: all cores)", ns3::UintegerValue(0),
+							ns3::MakeUintegerAccessor(&RouteCalculator::m_nThreads), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("Check", "Compare the routes with the FIB of GlobalRoutingHelper::CalculateRoutes() per node and prefix", ns3::BooleanValue(false),
+							ns3::MakeBooleanAccessor(&RouteCalculator::m_check), ns3::MakeBooleanChecker())
+			;
+
+	return tid;
+}
+
+RouteCalculator::RouteCalculator()
+	: m_nThreads(0)
+	, m_check(false)
+	, m_computeTime(0.0)
+	, m_installTime(0.0)
+	, m_nTargetCount(0)
+	, m_nRouteCount(0)
+	, m_nSameCount(0)
+	, m_nTieCount(0)
+	, m_nMismatchCount(0)
+{
+}
+
+RouteCalculator::~RouteCalculator() {
+}
+
+/**
+ * CalculateRoutes()의 FIB 를 기록하고 지운다. 이어서 설치하는 route 와 섞이지 않도록.
+ */
+void
+RouteCalculator::CalculateReferenceRoutes(RouteTable &routes) {
+	ns3::ndn::GlobalRoutingHelper::CalculateRoutes();
+	SnapshotRoutes(routes);
+
+	RouteTable::const_iterator routeIter = routes.begin();
+	for (; routeIter != routes.end(); routeIter++) {
+		ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(routeIter->first.first);
+		ns3::Ptr<ns3::ndn::L3Protocol> l3 = node->GetObject<ns3::ndn::L3Protocol>();
+		for (const std::pair<uint64_t, uint64_t> &nextHop : routeIter->second) {
+			ns3::ndn::FibHelper::RemoveRoute(node, routeIter->first.second, l3->getFaceById(nextHop.first));
+		}
+	}
+}
+
+void
+RouteCalculator::SnapshotRoutes(RouteTable &routes) {
+	std::set<::ndn::Name> prefixes;
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::GlobalRouter>();
+		if (router == 0) {
+			continue;
+		}
+		ns3::ndn::GlobalRouter::LocalPrefixList::const_iterator iter = router->GetLocalPrefixes().begin();
+		for (; iter != router->GetLocalPrefixes().end(); iter++) {
+			prefixes.insert(**iter);
+		}
+	}
+
+	for (uint32_t id = 0; id < ns3::NodeList::GetNNodes(); id++) {
+		ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(id);
+		ns3::Ptr<ns3::ndn::L3Protocol> l3 = node->GetObject<ns3::ndn::L3Protocol>();
+		if (l3 == 0) {
+			continue;
+		}
+
+		const nfd::Fib &fib = l3->getForwarder()->getFib();
+		for (const nfd::fib::Entry &entry : fib) {
+			if (prefixes.find(entry.getPrefix()) == prefixes.end()) {
+				continue;
+			}
+			for (const nfd::fib::NextHop &nextHop : entry.getNextHops()) {
+				routes[std::make_pair(id, entry.getPrefix())].push_back(std::make_pair(nextHop.getFace().getId(), nextHop.getCost()));
+			}
+		}
+	}
+
+	RouteTable::iterator routeIter = routes.begin();
+	for (; routeIter != routes.end(); routeIter++) {
+		std::sort(routeIter->second.begin(), routeIter->second.end());
+	}
+}
+
+/**
+ * 한 face에 여러 origin의 route가 겹치면 FIB에는 마지막 AddRoute의 cost가 남는다. 두 계산의 origin 순서가
+ * 달라 cost가 다를 수 있으므로, 그 face로 가는 최단 경로인 origin 중 하나의 거리이면 맞는 route로 본다.
+ */
+bool
+RouteCalculator::isShortestRoute(const RouteGraph &graph, const FaceEdgeMap &faceEdges, uint32_t node, const ::ndn::Name &prefix,
+		const std::pair<uint64_t, uint64_t> &nextHop) {
+	FaceEdgeMap::const_iterator edgeIter = faceEdges.find(std::make_pair(node, nextHop.first));
+	if (edgeIter == faceEdges.end()) {
+		return false;
+	}
+
+	const std::vector<uint32_t> &targets = graph.getTargets();
+	for (uint32_t t = 0; t < targets.size(); t++) {
+		if (graph.getDistance(node, t) != nextHop.second || !graph.isShortestEdge(edgeIter->second, t)) {
+			continue;
+		}
+
+		ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(targets[t])->GetObject<ns3::ndn::GlobalRouter>();
+		ns3::ndn::GlobalRouter::LocalPrefixList::const_iterator iter = router->GetLocalPrefixes().begin();
+		for (; iter != router->GetLocalPrefixes().end(); iter++) {
+			if (**iter == prefix) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void
+RouteCalculator::CheckRoutes(const RouteGraph &graph, const FaceEdgeMap &faceEdges, const RouteTable &reference, const RouteTable &installed) {
+	std::set<std::pair<uint32_t, ::ndn::Name>> keys;
+	for (const RouteTable::value_type &route : reference) {
+		keys.insert(route.first);
+	}
+	for (const RouteTable::value_type &route : installed) {
+		keys.insert(route.first);
+	}
+
+	static const std::vector<std::pair<uint64_t, uint64_t>> s_empty;
+	for (const std::pair<uint32_t, ::ndn::Name> &key : keys) {
+		RouteTable::const_iterator referenceIter = reference.find(key);
+		RouteTable::const_iterator installedIter = installed.find(key);
+		const std::vector<std::pair<uint64_t, uint64_t>> &expected = (referenceIter != reference.end()) ? referenceIter->second : s_empty;
+		const std::vector<std::pair<uint64_t, uint64_t>> &actual = (installedIter != installed.end()) ? installedIter->second : s_empty;
+
+		if (expected == actual) {
+			m_nSameCount += 1;
+			continue;
+		}
+
+		bool tie = 0 < expected.size() && 0 < actual.size();
+		for (const std::pair<uint64_t, uint64_t> &nextHop : expected) {
+			tie = tie && isShortestRoute(graph, faceEdges, key.first, key.second, nextHop);
+		}
+		for (const std::pair<uint64_t, uint64_t> &nextHop : actual) {
+			tie = tie && isShortestRoute(graph, faceEdges, key.first, key.second, nextHop);
+		}
+
+		if (tie) {
+			m_nTieCount += 1;
+			continue;
+		}
+
+		m_nMismatchCount += 1;
+		std::stringstream sio;
+		for (const std::pair<uint64_t, uint64_t> &nextHop : expected) {
+			sio << " " << nextHop.first << ":" << nextHop.second;
+		}
+		sio << " |";
+		for (const std::pair<uint64_t, uint64_t> &nextHop : actual) {
+			sio << " " << nextHop.first << ":" << nextHop.second;
+		}
+		NS_LOG_WARN("route mismatch: node " << key.first << " " << key.second << " (face:cost) CalculateRoutes" << sio.str() << " RouteCalculator");
+	}
+}
+
+void
+RouteCalculator::CalculateRoutes() {
+	RouteTable reference;
+	if (m_check) {
+		CalculateReferenceRoutes(reference);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	uint32_t nodes = ns3::NodeList::GetNNodes();
+	RouteGraph graph(nodes);
+	// edge index -> face of the edge
+	std::vector<std::shared_ptr<nfd::Face>> faces;
+	FaceEdgeMap faceEdges;
+
+	for (uint32_t id = 0; id < nodes; id++) {
+		ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(id)->GetObject<ns3::ndn::GlobalRouter>();
+		if (router == 0) {
+			continue;
+		}
+
+		ns3::ndn::GlobalRouter::IncidencyList::const_iterator iter = router->GetIncidencies().begin();
+		for (; iter != router->GetIncidencies().end(); iter++) {
+			ns3::Ptr<ns3::Node> peer = std::get<2>(*iter)->GetObject<ns3::Node>();
+			std::shared_ptr<nfd::Face> face = std::get<1>(*iter);
+
+			uint32_t edge = graph.addEdge(id, peer->GetId(), face->getMetric());
+			faces.push_back(face);
+			faceEdges[std::make_pair(id, (uint64_t)face->getId())] = edge;
+		}
+
+		if (0 < router->GetLocalPrefixes().size()) {
+			graph.addTarget(id);
+		}
+	}
+
+	graph.compute(m_nThreads);
+
+	std::chrono::steady_clock::time_point computed = std::chrono::steady_clock::now();
+
+	const std::vector<uint32_t> &targets = graph.getTargets();
+	for (uint32_t id = 0; id < nodes; id++) {
+		ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(id);
+
+		for (uint32_t t = 0; t < targets.size(); t++) {
+			uint32_t edge = graph.getNextHop(id, t);
+			if (edge == RouteGraph::NO_EDGE) {
+				continue;
+			}
+
+			ns3::Ptr<ns3::ndn::GlobalRouter> router = ns3::NodeList::GetNode(targets[t])->GetObject<ns3::ndn::GlobalRouter>();
+			ns3::ndn::GlobalRouter::LocalPrefixList::const_iterator iter = router->GetLocalPrefixes().begin();
+			for (; iter != router->GetLocalPrefixes().end(); iter++) {
+				ns3::ndn::FibHelper::AddRoute(node, **iter, faces[edge], (int32_t)graph.getDistance(id, t));
+				m_nRouteCount += 1;
+			}
+		}
+	}
+
+	m_nTargetCount = targets.size();
+	m_computeTime = std::chrono::duration<double>(computed - start).count();
+	m_installTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - computed).count();
+
+	// 모든 target을 설치한 뒤 (node, prefix)의 next hop 전체를 비교한다
+	if (m_check) {
+		RouteTable installed;
+		SnapshotRoutes(installed);
+		CheckRoutes(graph, faceEdges, reference, installed);
+	}
+}
+
+void
+RouteCalculator::Report() {
+	NS_LOG_INFO(stringf("RouteCalculator Threads:     %5u", m_nThreads));
+	NS_LOG_INFO(stringf("RouteCalculator TargetCount: %5u", m_nTargetCount));
+	NS_LOG_INFO(stringf("RouteCalculator RouteCount:  %5u", m_nRouteCount));
+	NS_LOG_INFO(stringf("RouteCalculator ComputeTime: %8.3f", m_computeTime));
+	NS_LOG_INFO(stringf("RouteCalculator InstallTime: %8.3f", m_installTime));
+	if (m_check) {
+		NS_LOG_INFO(stringf("RouteCalculator Check: (node, prefix) %u same, %u equal cost ties, %u mismatches",
+				m_nSameCount, m_nTieCount, m_nMismatchCount));
+	}
+}
@@ -0,0 +1,96 @@
+/*
+ * route-calculator.hpp
+ *
+ * parallel replacement of ndn::GlobalRoutingHelper::CalculateRoutes() for the DRN scenarios.
+ *
+ * the GlobalRouter incidencies(face metric as the weight) are put in a RouteGraph whose targets are
+ * the routers with origins(/RN, /RN-{nnnnn}), the next hops are computed on Threads threads and the
+ * FIB entries of all prefixes are installed afterwards in one pass in node order.
+ *
+ * the cost of a route is the distance(sum of the face metrics), as CalculateRoutes() installs it. on equal cost
+ * paths CalculateRoutes() keeps the first hop its boost Dijkstra reaches first and RouteGraph the lowest edge index,
+ * so the next hop of a tie may differ. Check=true also runs CalculateRoutes() and compares the full next hop sets of
+ * the two FIBs per (node, prefix), /RN has one next hop per RN origin:
+ *  - same     : the same (face, cost) set
+ *  - tie      : other sets, every (face, cost) of both is on a shortest path to an origin of the prefix at that cost
+ *  - mismatch : any other (face, cost), or a (node, prefix) in one FIB only
+ */
+
+#ifndef EXTENSIONS_ROUTE_CALCULATOR_HPP_
+#define EXTENSIONS_ROUTE_CALCULATOR_HPP_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include <ndn-cxx/name.hpp>
+
+class RouteGraph;
+
+class RouteCalculator : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	RouteCalculator();
+
+	virtual
+	~RouteCalculator();
+
+	/**
+	 * @brief calculate and install the routes to all origins, call after all origins are added
+	 */
+	void
+	CalculateRoutes();
+
+	void
+	Report();
+
+private:
+	// (node, prefix) -> (face id, cost) of the origin prefixes in the FIBs
+	typedef std::map<std::pair<uint32_t, ::ndn::Name>, std::vector<std::pair<uint64_t, uint64_t>>> RouteTable;
+
+	// (node, face id) -> edge index of RouteGraph
+	typedef std::map<std::pair<uint32_t, uint64_t>, uint32_t> FaceEdgeMap;
+
+	/**
+	 * @brief routes of the origin prefixes installed by CalculateRoutes(), removed again from the FIBs
+	 */
+	void
+	CalculateReferenceRoutes(RouteTable &routes);
+
+	/**
+	 * @brief next hops of the origin prefixes in the FIBs of all nodes
+	 */
+	void
+	SnapshotRoutes(RouteTable &routes);
+
+	/**
+	 * @brief compare the installed routes with the ones of CalculateRoutes() per (node, prefix)
+	 */
+	void
+	CheckRoutes(const RouteGraph &graph, const FaceEdgeMap &faceEdges, const RouteTable &reference, const RouteTable &installed);
+
+	// (face, cost) of node is on a shortest path to an origin of prefix
+	bool
+	isShortestRoute(const RouteGraph &graph, const FaceEdgeMap &faceEdges, uint32_t node, const ::ndn::Name &prefix,
+			const std::pair<uint64_t, uint64_t> &nextHop);
+
+private:
+	uint32_t m_nThreads;
+	bool m_check;
+
+	double m_computeTime;
+	double m_installTime;
+	uint32_t m_nTargetCount;
+	uint32_t m_nRouteCount;
+	// Check: (node, prefix) of the two FIBs with the same next hops, equal cost ties or a mismatch
+	uint32_t m_nSameCount;
+	uint32_t m_nTieCount;
+	uint32_t m_nMismatchCount;
+};
+
+#endif /* EXTENSIONS_ROUTE_CALCULATOR_HPP_ */
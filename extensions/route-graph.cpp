@@ -0,0 +1,162 @@
+/*
+ * route-graph.cpp
+ */
+
+#include "route-graph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+
+const uint32_t RouteGraph::NO_EDGE;
+const uint64_t RouteGraph::UNREACHABLE;
+
+RouteGraph::RouteGraph(uint32_t vertices)
+	: m_vertices(vertices)
+{
+}
+
+uint32_t
+RouteGraph::addEdge(uint32_t from, uint32_t to, uint32_t weight) {
+	Edge edge;
+	edge.from = from;
+	edge.to = to;
+	edge.weight = weight;
+	m_edges.push_back(edge);
+
+	return m_edges.size() - 1;
+}
+
+void
+RouteGraph::addTarget(uint32_t target) {
+	m_targets.push_back(target);
+}
+
+void
+RouteGraph::compute(uint32_t threads) {
+	// edges grouped by tail and by head, each group in edge index order
+	m_outStart.assign(m_vertices + 1, 0);
+	m_inStart.assign(m_vertices + 1, 0);
+	for (uint32_t e = 0; e < m_edges.size(); e++) {
+		m_outStart[m_edges[e].from + 1] += 1;
+		m_inStart[m_edges[e].to + 1] += 1;
+	}
+	for (uint32_t v = 0; v < m_vertices; v++) {
+		m_outStart[v + 1] += m_outStart[v];
+		m_inStart[v + 1] += m_inStart[v];
+	}
+
+	m_outEdges.resize(m_edges.size());
+	m_inEdges.resize(m_edges.size());
+	std::vector<uint32_t> outNext(m_outStart.begin(), m_outStart.end() - 1);
+	std::vector<uint32_t> inNext(m_inStart.begin(), m_inStart.end() - 1);
+	for (uint32_t e = 0; e < m_edges.size(); e++) {
+		m_outEdges[outNext[m_edges[e].from]++] = e;
+		m_inEdges[inNext[m_edges[e].to]++] = e;
+	}
+
+	m_distances.assign((size_t)m_targets.size() * m_vertices, UNREACHABLE);
+	m_nextHops.assign((size_t)m_targets.size() * m_vertices, NO_EDGE);
+
+	if (threads == 0) {
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	threads = std::min(threads, (uint32_t)std::max(m_targets.size(), (size_t)1));
+
+	std::atomic<uint32_t> next(0);
+	std::function<void()> worker = [this, &next]() {
+		uint32_t index;
+		while ((index = next.fetch_add(1)) < m_targets.size()) {
+			computeTarget(index);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (uint32_t i = 1; i < threads; i++) {
+		pool.push_back(std::thread(worker));
+	}
+	worker();
+
+	for (uint32_t i = 0; i < pool.size(); i++) {
+		pool[i].join();
+	}
+}
+
+uint32_t
+RouteGraph::getVertexCount() const {
+	return m_vertices;
+}
+
+const std::vector<uint32_t> &
+RouteGraph::getTargets() const {
+	return m_targets;
+}
+
+uint32_t
+RouteGraph::getNextHop(uint32_t vertex, uint32_t index) const {
+	return m_nextHops[(size_t)index * m_vertices + vertex];
+}
+
+uint64_t
+RouteGraph::getDistance(uint32_t vertex, uint32_t index) const {
+	return m_distances[(size_t)index * m_vertices + vertex];
+}
+
+bool
+RouteGraph::isShortestEdge(uint32_t edge, uint32_t index) const {
+	const Edge &e = m_edges[edge];
+	uint64_t from = getDistance(e.from, index);
+	uint64_t to = getDistance(e.to, index);
+
+	return from != UNREACHABLE && to != UNREACHABLE && to + e.weight == from;
+}
+
+void
+RouteGraph::computeTarget(uint32_t index) {
+	uint64_t *distances = &m_distances[(size_t)index * m_vertices];
+	uint32_t *nextHops = &m_nextHops[(size_t)index * m_vertices];
+	uint32_t target = m_targets[index];
+
+	typedef std::pair<uint64_t, uint32_t> QueueEntry;
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+	// 역방향 edge 로 target 까지의 거리
+	distances[target] = 0;
+	queue.push(std::make_pair(0, target));
+	while (!queue.empty()) {
+		QueueEntry top = queue.top();
+		queue.pop();
+
+		uint32_t v = top.second;
+		if (distances[v] < top.first) {
+			continue;
+		}
+
+		for (uint32_t i = m_inStart[v]; i < m_inStart[v + 1]; i++) {
+			const Edge &edge = m_edges[m_inEdges[i]];
+			uint64_t distance = top.first + edge.weight;
+			if (distance < distances[edge.from]) {
+				distances[edge.from] = distance;
+				queue.push(std::make_pair(distance, edge.from));
+			}
+		}
+	}
+
+	// next hop: 거리가 같으면 index 가 작은 edge
+	for (uint32_t v = 0; v < m_vertices; v++) {
+		if (v == target || distances[v] == UNREACHABLE) {
+			continue;
+		}
+
+		for (uint32_t i = m_outStart[v]; i < m_outStart[v + 1]; i++) {
+			const Edge &edge = m_edges[m_outEdges[i]];
+			if (distances[edge.to] != UNREACHABLE && distances[edge.to] + edge.weight == distances[v]) {
+				nextHops[v] = m_outEdges[i];
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * route-graph.hpp
+ *
+ * shortest path next hops towards a set of target vertices, computed on a thread pool.
+ *
+ * one Dijkstra per target over the reversed edges gives the distance of every vertex to it,
+ * the next hop of a vertex is its out edge with the smallest weight + distance of the edge's head
+ * (the lowest edge index on ties). each target is computed independently, so the result does
+ * not depend on the number of threads.
+ */
+
+#ifndef EXTENSIONS_ROUTE_GRAPH_HPP_
+#define EXTENSIONS_ROUTE_GRAPH_HPP_
+
+#include <cstdint>
+#include <vector>
+
+class RouteGraph
+{
+public:
+	static const uint32_t NO_EDGE = 0xffffffff;
+	static const uint64_t UNREACHABLE = 0xffffffffffffffffULL;
+
+	explicit
+	RouteGraph(uint32_t vertices);
+
+	/**
+	 * @brief edge index, in the order of the calls
+	 */
+	uint32_t
+	addEdge(uint32_t from, uint32_t to, uint32_t weight);
+
+	void
+	addTarget(uint32_t target);
+
+	/**
+	 * @brief distances and next hops of all vertices towards all targets, threads 0 uses all cores
+	 */
+	void
+	compute(uint32_t threads);
+
+	uint32_t
+	getVertexCount() const;
+
+	const std::vector<uint32_t> &
+	getTargets() const;
+
+	/**
+	 * @brief out edge of vertex on a shortest path to the index-th target, NO_EDGE if unreachable or vertex is the target
+	 */
+	uint32_t
+	getNextHop(uint32_t vertex, uint32_t index) const;
+
+	uint64_t
+	getDistance(uint32_t vertex, uint32_t index) const;
+
+	/**
+	 * @brief edge is on a shortest path to the index-th target(an equal cost alternative of getNextHop)
+	 */
+	bool
+	isShortestEdge(uint32_t edge, uint32_t index) const;
+
+private:
+	void
+	computeTarget(uint32_t index);
+
+private:
+	struct Edge
+	{
+		uint32_t from;
+		uint32_t to;
+		uint32_t weight;
+	};
+
+	uint32_t m_vertices;
+	std::vector<Edge> m_edges;
+	std::vector<uint32_t> m_targets;
+
+	// csr adjacency, built by compute()
+	std::vector<uint32_t> m_outStart;
+	std::vector<uint32_t> m_outEdges;
+	std::vector<uint32_t> m_inStart;
+	std::vector<uint32_t> m_inEdges;
+
+	// [target index * vertices + vertex]
+	std::vector<uint64_t> m_distances;
+	std::vector<uint32_t> m_nextHops;
+};
+
+#endif /* EXTENSIONS_ROUTE_GRAPH_HPP_ */
@@ -0,0 +1,183 @@
+/*
+ * scope-profiler.cpp
+ */
+
+#include "scope-profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "ns3/log.h"
+
+#include "utils.hpp"
+
+ScopeProfiler &
+ScopeProfiler::Get() {
+	static ScopeProfiler profiler;
+	return profiler;
+}
+
+ScopeProfiler::ScopeProfiler()
+	: m_enabled(false)
+	, m_runNs(0)
+	, m_current(&m_root)
+	, m_top(nullptr)
+{
+	m_root.site = nullptr;
+	m_root.parent = nullptr;
+	m_root.selfNs = 0;
+}
+
+ScopeProfiler::~ScopeProfiler() {
+}
+
+void
+ScopeProfiler::enable() {
+	m_enabled = true;
+	m_start = std::chrono::steady_clock::now();
+}
+
+void
+ScopeProfiler::disable() {
+	if (m_enabled) {
+		m_runNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+	}
+	m_enabled = false;
+}
+
+ProfileSite *
+ScopeProfiler::site(const std::string &app, const std::string &handler) {
+	std::unique_ptr<ProfileSite> site(new ProfileSite());
+	site->app = app;
+	site->handler = handler;
+	site->count = 0;
+	site->totalNs = 0;
+	site->selfNs = 0;
+	std::memset(site->histogram, 0, sizeof(site->histogram));
+
+	m_sites.push_back(std::move(site));
+	return m_sites.back().get();
+}
+
+void
+ScopeProfiler::enter(ProfileScope *scope) {
+	// 같은 site 의 자식 node 를 찾거나 만든다
+	ProfileNode *node = nullptr;
+	for (ProfileNode *child : m_current->children) {
+		if (child->site == scope->m_site) {
+			node = child;
+			break;
+		}
+	}
+	if (node == nullptr) {
+		m_nodes.push_back(std::unique_ptr<ProfileNode>(new ProfileNode()));
+		node = m_nodes.back().get();
+		node->site = scope->m_site;
+		node->parent = m_current;
+		node->selfNs = 0;
+		m_current->children.push_back(node);
+	}
+
+	scope->m_parent = m_top;
+	scope->m_node = node;
+	m_top = scope;
+	m_current = node;
+}
+
+void
+ScopeProfiler::leave(ProfileScope *scope, uint64_t elapsedNs) {
+	uint64_t selfNs = (scope->m_childNs < elapsedNs) ? elapsedNs - scope->m_childNs : 0;
+
+	ProfileSite *site = scope->m_site;
+	site->count += 1;
+	site->totalNs += elapsedNs;
+	site->selfNs += selfNs;
+
+	int bucket = 0;
+	while (bucket < PROFILE_BUCKETS - 1 && (1ULL << bucket) <= elapsedNs) {
+		bucket++;
+	}
+	site->histogram[bucket] += 1;
+
+	scope->m_node->selfNs += selfNs;
+
+	m_top = scope->m_parent;
+	m_current = scope->m_node->parent;
+	if (m_top != nullptr) {
+		m_top->m_childNs += elapsedNs;
+	}
+}
+
+static double
+percentileUs(const ProfileSite *site, double percentile) {
+	uint64_t rank = (uint64_t)(site->count * percentile);
+	uint64_t seen = 0;
+	for (int i = 0; i < PROFILE_BUCKETS; i++) {
+		seen += site->histogram[i];
+		if (rank < seen) {
+			// bucket 의 상한
+			return (1ULL << i) / 1000.0;
+		}
+	}
+
+	return (1ULL << (PROFILE_BUCKETS - 1)) / 1000.0;
+}
+
+void
+ScopeProfiler::report() const {
+	double runNs = m_runNs;
+	if (m_enabled) {
+		runNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+	std::vector<const ProfileSite *> sites;
+	uint64_t profiledNs = 0;
+	for (const std::unique_ptr<ProfileSite> &site : m_sites) {
+		if (0 < site->count) {
+			sites.push_back(site.get());
+			profiledNs += site->selfNs;
+		}
+	}
+	std::sort(sites.begin(), sites.end(), [](const ProfileSite *a, const ProfileSite *b) {
+		return a->selfNs > b->selfNs;
+	});
+
+	NS_LOG_UNCOND(stringf("profile: %-16s %-36s %10s %10s %10s %6s %9s %9s %9s", "app", "handler", "calls", "total(ms)", "self(ms)",
+			"self%", "mean(us)", "p50(us)", "p99(us)"));
+	for (const ProfileSite *site : sites) {
+		NS_LOG_UNCOND(stringf("profile: %-16s %-36s %10llu %10.1f %10.1f %5.1f%% %9.2f %9.2f %9.2f", site->app.c_str(), site->handler.c_str(),
+				(unsigned long long)site->count, site->totalNs / 1e6, site->selfNs / 1e6, (0 < runNs) ? 100.0 * site->selfNs / runNs : 0.0,
+				site->totalNs / 1e3 / site->count, percentileUs(site, 0.5), percentileUs(site, 0.99)));
+	}
+
+	double unprofiledNs = (profiledNs < runNs) ? runNs - profiledNs : 0;
+	NS_LOG_UNCOND(stringf("profile: %-16s %-36s %10s %10.1f %10.1f %5.1f%%", "unprofiled", "ns-3, NFD forwarding, links", "",
+			unprofiledNs / 1e6, unprofiledNs / 1e6, (0 < runNs) ? 100.0 * unprofiledNs / runNs : 0.0));
+}
+
+int
+ScopeProfiler::writeCollapsed(const std::string &path) const {
+	std::ofstream file(path.c_str(), std::ios::trunc);
+	if (!file.is_open()) {
+		return -1;
+	}
+
+	for (const ProfileNode *child : m_root.children) {
+		writeNode(file, child, "");
+	}
+
+	return file.good() ? 0 : -1;
+}
+
+void
+ScopeProfiler::writeNode(std::ostream &os, const ProfileNode *node, const std::string &stack) const {
+	std::string frame = stack + (stack.empty() ? "" : ";") + node->site->app + "::" + node->site->handler;
+	if (0 < node->selfNs) {
+		os << frame << " " << node->selfNs << "\n";
+	}
+
+	for (const ProfileNode *child : node->children) {
+		writeNode(os, child, frame);
+	}
+}
@@ -0,0 +1,165 @@
+/*
+ * scope-profiler.hpp
+ *
+ * wall clock time of the DRN app handlers, opt-in(--profile=<file> of the scenarios):
+ *
+ *  - site     : (app, handler) or (app, handler/{command}), one per DRN_PROFILE_SCOPE/DRN_PROFILE_COMMAND
+ *  - scope    : steady clock time from the macro to the end of the block, a scope inside another one is
+ *               its child, so self time = total time - child time
+ *  - report() : sites ranked by self time with call count, total, self and log2 latency histogram
+ *               percentiles, the rest of the run(ns-3 scheduler, NFD forwarding, links) is "unprofiled"
+ *  - collapsed stacks of the scope tree(self ns) for flamegraph.pl
+ *
+ * a disabled profiler costs one branch per scope.
+ */
+
+#ifndef EXTENSIONS_SCOPE_PROFILER_HPP_
+#define EXTENSIONS_SCOPE_PROFILER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "drn-protocol.hpp"
+
+#define DRN_PROFILE_SCOPE(app, handler) \
+	static ProfileSite *drnProfileSite = ScopeProfiler::Get().site(app, handler); \
+	ProfileScope drnProfileScope(drnProfileSite)
+
+// handler of a parsed command: a site per command
+#define DRN_PROFILE_COMMAND(app, handler, cmd) \
+	static ProfileSite *drnProfileSites[CMD_COUNT] = {}; \
+	ProfileScope drnProfileScope(ScopeProfiler::Get().commandSite(drnProfileSites, app, handler, cmd))
+
+static const int PROFILE_BUCKETS = 40;
+
+struct ProfileSite
+{
+	std::string app;
+	std::string handler;
+	uint64_t count;
+	uint64_t totalNs;
+	uint64_t selfNs;
+	// bucket i: latency < 2^i ns
+	uint64_t histogram[PROFILE_BUCKETS];
+};
+
+struct ProfileNode
+{
+	ProfileSite *site;
+	ProfileNode *parent;
+	std::vector<ProfileNode *> children;
+	uint64_t selfNs;
+};
+
+class ProfileScope;
+
+class ScopeProfiler
+{
+public:
+	static ScopeProfiler &
+	Get();
+
+	ScopeProfiler();
+
+	~ScopeProfiler();
+
+	/**
+	 * @brief start measuring, call right before Simulator::Run()
+	 */
+	void
+	enable();
+
+	void
+	disable();
+
+	bool
+	isEnabled() const {
+		return m_enabled;
+	}
+
+	ProfileSite *
+	site(const std::string &app, const std::string &handler);
+
+	ProfileSite *
+	commandSite(ProfileSite **sites, const char *app, const char *handler, DrnCommand cmd) {
+		if (!m_enabled || CMD_COUNT <= cmd) {
+			return nullptr;
+		}
+		if (sites[cmd] == nullptr) {
+			sites[cmd] = site(app, std::string(handler) + "/" + (cmd == CMD_UNKNOWN ? "unknown" : commandName(cmd)));
+		}
+
+		return sites[cmd];
+	}
+
+	void
+	enter(ProfileScope *scope);
+
+	void
+	leave(ProfileScope *scope, uint64_t elapsedNs);
+
+	/**
+	 * @brief ranked table of the sites
+	 */
+	void
+	report() const;
+
+	/**
+	 * @brief "app::handler;app::handler <self ns>" lines of the scope tree, -1 on error
+	 */
+	int
+	writeCollapsed(const std::string &path) const;
+
+private:
+	void
+	writeNode(std::ostream &os, const ProfileNode *node, const std::string &stack) const;
+
+private:
+	bool m_enabled;
+	std::chrono::steady_clock::time_point m_start;
+	double m_runNs;
+
+	std::vector<std::unique_ptr<ProfileSite>> m_sites;
+	std::vector<std::unique_ptr<ProfileNode>> m_nodes;
+	ProfileNode m_root;
+	ProfileNode *m_current;
+	ProfileScope *m_top;
+};
+
+class ProfileScope
+{
+public:
+	explicit
+	ProfileScope(ProfileSite *site)
+		: m_site(nullptr)
+	{
+		if (site != nullptr && ScopeProfiler::Get().isEnabled()) {
+			m_site = site;
+			m_childNs = 0;
+			ScopeProfiler::Get().enter(this);
+			m_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~ProfileScope() {
+		if (m_site != nullptr) {
+			uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+			ScopeProfiler::Get().leave(this, elapsed);
+		}
+	}
+
+private:
+	friend class ScopeProfiler;
+
+	ProfileSite *m_site;
+	ProfileScope *m_parent;
+	ProfileNode *m_node;
+	uint64_t m_childNs;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+#endif /* EXTENSIONS_SCOPE_PROFILER_HPP_ */
@@ -0,0 +1,149 @@
+/*
+ * sim-stats.cpp
+ */
+
+#include "sim-stats.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "utils.hpp"
+
+SimStats::SimStats()
+	: m_start(std::chrono::steady_clock::now())
+	, m_runStart(m_start)
+	, m_appHeap(0)
+	, m_startupTime(0)
+	, m_runTime(0)
+	, m_nEventCount(0)
+	, m_peakRss(0)
+	, m_heap(0)
+{
+}
+
+void
+SimStats::setParameter(const std::string &key, const std::string &value) {
+	std::string quoted("\"");
+	for (char c : value) {
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+		}
+		quoted += c;
+	}
+	quoted += '"';
+
+	m_parameters.push_back(std::make_pair(key, quoted));
+}
+
+void
+SimStats::setParameter(const std::string &key, double value) {
+	m_parameters.push_back(std::make_pair(key, stringf("%.17g", value)));
+}
+
+void
+SimStats::beginApps() {
+	m_appHeap = getHeapInUse();
+}
+
+void
+SimStats::endApps(const std::string &type, uint32_t count) {
+	uint64_t heap = getHeapInUse();
+
+	AppMemory apps;
+	apps.type = type;
+	apps.count = count;
+	apps.heap = (m_appHeap < heap) ? heap - m_appHeap : 0;
+	m_apps.push_back(apps);
+}
+
+void
+SimStats::beginRun() {
+	m_runStart = std::chrono::steady_clock::now();
+	m_startupTime = std::chrono::duration<double>(m_runStart - m_start).count();
+	m_nEventCount = ns3::Simulator::GetEventCount();
+}
+
+void
+SimStats::endRun() {
+	m_runTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_runStart).count();
+	m_nEventCount = ns3::Simulator::GetEventCount() - m_nEventCount;
+	m_peakRss = getPeakRss();
+	m_heap = getHeapInUse();
+}
+
+void
+SimStats::report() const {
+	NS_LOG_UNCOND(stringf("performance: run %.3fs, %llu events, %.0f events/s, peak rss %.1fMB, heap %.1fMB",
+			m_runTime, (unsigned long long)m_nEventCount, (0 < m_runTime) ? m_nEventCount / m_runTime : 0.0,
+			m_peakRss / 1048576.0, m_heap / 1048576.0));
+
+	for (const AppMemory &apps : m_apps) {
+		NS_LOG_UNCOND(stringf("performance: %s %u apps, %.0f bytes/app at install", apps.type.c_str(), apps.count,
+				(0 < apps.count) ? (double)apps.heap / apps.count : 0.0));
+	}
+}
+
+int
+SimStats::write(const std::string &path) const {
+	std::ofstream file(path.c_str(), std::ios::trunc);
+	if (!file.is_open()) {
+		return -1;
+	}
+
+	file << "{\n";
+	file << "  \"parameters\": {";
+	for (size_t i = 0; i < m_parameters.size(); i++) {
+		file << (i == 0 ? "\n" : ",\n") << "    \"" << m_parameters[i].first << "\": " << m_parameters[i].second;
+	}
+	file << "\n  },\n";
+
+	file << stringf("  \"startup_s\": %.6f,\n", m_startupTime);
+	file << stringf("  \"wall_s\": %.6f,\n", m_runTime);
+	file << stringf("  \"events\": %llu,\n", (unsigned long long)m_nEventCount);
+	file << stringf("  \"events_per_s\": %.1f,\n", (0 < m_runTime) ? m_nEventCount / m_runTime : 0.0);
+	file << stringf("  \"peak_rss_bytes\": %llu,\n", (unsigned long long)m_peakRss);
+	file << stringf("  \"heap_bytes\": %llu,\n", (unsigned long long)m_heap);
+
+	file << "  \"apps\": {";
+	for (size_t i = 0; i < m_apps.size(); i++) {
+		const AppMemory &apps = m_apps[i];
+		file << (i == 0 ? "\n" : ",\n")
+			<< stringf("    \"%s\": {\"count\": %u, \"install_bytes\": %llu, \"bytes_per_app\": %.1f}", apps.type.c_str(), apps.count,
+					(unsigned long long)apps.heap, (0 < apps.count) ? (double)apps.heap / apps.count : 0.0);
+	}
+	file << "\n  }\n";
+	file << "}\n";
+
+	return file.good() ? 0 : -1;
+}
+
+double
+SimStats::getRunTime() const {
+	return m_runTime;
+}
+
+uint64_t
+SimStats::getPeakRss() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+
+	// linux: kilobytes
+	return (uint64_t)usage.ru_maxrss * 1024;
+}
+
+uint64_t
+SimStats::getHeapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	return mallinfo2().uordblks;
+#else
+	return mallinfo().uordblks;
+#endif
+}
@@ -0,0 +1,96 @@
+/*
+ * sim-stats.hpp
+ *
+ * simulator cost of a scenario run, read by perf-harness.py:
+ *
+ *  - time    : wall clock seconds of the startup(topology, apps, routes) and of Simulator::Run()
+ *  - events  : ns-3 events executed by Run() and events per wall clock second
+ *  - memory  : peak RSS of the process, heap in use after the run, and the heap allocated by the
+ *              install of each app type divided by its app count
+ *
+ * write() saves them with the scenario parameters as one json object.
+ */
+
+#ifndef EXTENSIONS_SIM_STATS_HPP_
+#define EXTENSIONS_SIM_STATS_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SimStats
+{
+public:
+	SimStats();
+
+	void
+	setParameter(const std::string &key, const std::string &value);
+
+	void
+	setParameter(const std::string &key, double value);
+
+	/**
+	 * @brief heap mark before the apps of type are installed
+	 */
+	void
+	beginApps();
+
+	void
+	endApps(const std::string &type, uint32_t count);
+
+	/**
+	 * @brief end of the startup, call right before Simulator::Run()
+	 */
+	void
+	beginRun();
+
+	void
+	endRun();
+
+	void
+	report() const;
+
+	/**
+	 * @brief json file of the parameters and the measurements, -1 on error
+	 */
+	int
+	write(const std::string &path) const;
+
+	double
+	getRunTime() const;
+
+	/**
+	 * @brief peak resident set size of the process(bytes)
+	 */
+	static uint64_t
+	getPeakRss();
+
+	/**
+	 * @brief bytes allocated from the heap
+	 */
+	static uint64_t
+	getHeapInUse();
+
+private:
+	struct AppMemory {
+		std::string type;
+		uint32_t count;
+		uint64_t heap;
+	};
+
+	std::chrono::steady_clock::time_point m_start;
+	std::chrono::steady_clock::time_point m_runStart;
+
+	std::vector<std::pair<std::string, std::string>> m_parameters;
+	std::vector<AppMemory> m_apps;
+	uint64_t m_appHeap;
+
+	double m_startupTime;
+	double m_runTime;
+	uint64_t m_nEventCount;
+	uint64_t m_peakRss;
+	uint64_t m_heap;
+};
+
+#endif /* EXTENSIONS_SIM_STATS_HPP_ */
@@ -0,0 +1,295 @@
+/*
+ * topic-manifest.cpp
+ */
+
+#include "topic-manifest.hpp"
+
+#include <algorithm>
+
+// NDN VarNumber: < 253 in one byte, else 253/254/255 and a 2/4/8 byte number
+static void
+appendVarNumber(std::vector<uint8_t> &wire, uint64_t number) {
+	if (number < 253) {
+		wire.push_back((uint8_t)number);
+		return;
+	}
+
+	int bytes = 8;
+	if (number <= 0xffff) {
+		wire.push_back(253);
+		bytes = 2;
+	} else if (number <= 0xffffffff) {
+		wire.push_back(254);
+		bytes = 4;
+	} else {
+		wire.push_back(255);
+	}
+	for (int i = bytes - 1; 0 <= i; i--) {
+		wire.push_back((uint8_t)(number >> (8 * i)));
+	}
+}
+
+static bool
+readVarNumber(const uint8_t *&at, const uint8_t *end, uint64_t &number) {
+	if (end <= at) {
+		return false;
+	}
+
+	uint8_t first = *at++;
+	if (first < 253) {
+		number = first;
+		return true;
+	}
+
+	int bytes = (first == 253) ? 2 : (first == 254) ? 4 : 8;
+	if (end - at < bytes) {
+		return false;
+	}
+	number = 0;
+	for (int i = 0; i < bytes; i++) {
+		number = (number << 8) | *at++;
+	}
+
+	return true;
+}
+
+// NonNegativeInteger TLV: 1, 2, 4 or 8 byte value
+static void
+appendNumberTlv(std::vector<uint8_t> &wire, uint8_t type, uint64_t number) {
+	int bytes = (number <= 0xff) ? 1 : (number <= 0xffff) ? 2 : (number <= 0xffffffff) ? 4 : 8;
+	wire.push_back(type);
+	wire.push_back((uint8_t)bytes);
+	for (int i = bytes - 1; 0 <= i; i--) {
+		wire.push_back((uint8_t)(number >> (8 * i)));
+	}
+}
+
+static uint64_t
+readNumber(const uint8_t *value, uint64_t size) {
+	uint64_t number = 0;
+	for (uint64_t i = 0; i < size && i < 8; i++) {
+		number = (number << 8) | value[i];
+	}
+
+	return number;
+}
+
+static size_t
+sizeOfVarNumber(uint64_t number) {
+	return (number < 253) ? 1 : (number <= 0xffff) ? 3 : (number <= 0xffffffff) ? 5 : 9;
+}
+
+// type 1 byte, length 9 bytes at most
+static const size_t s_headerBound = 10;
+
+static size_t
+sharedPrefix(const std::string &a, const std::string &b) {
+	size_t limit = std::min(a.size(), b.size());
+	size_t shared = 0;
+	while (shared < limit && a[shared] == b[shared]) {
+		shared++;
+	}
+
+	return shared;
+}
+
+TopicManifest::TopicManifest() {
+	clear();
+}
+
+void
+TopicManifest::clear() {
+	m_topics.clear();
+	m_entries.clear();
+	m_nodes.clear();
+	m_nodeList.clear();
+	m_entryBytes = 0;
+	m_nodeBytes = 0;
+	m_replicas = 0;
+	m_hasContinuation = false;
+	m_continuation = 0;
+}
+
+size_t
+TopicManifest::entrySize(const std::string *previous, const std::string &topic, uint32_t index) {
+	size_t shared = (previous == nullptr) ? 0 : sharedPrefix(*previous, topic);
+	size_t value = sizeOfVarNumber(shared) + sizeOfVarNumber(index) + topic.size() - shared;
+
+	return 1 + sizeOfVarNumber(value) + value;
+}
+
+size_t
+TopicManifest::entryDelta(const std::string &topic, uint32_t index, std::map<std::string, uint32_t>::const_iterator next,
+		int64_t &nextDelta) const {
+	const std::string *previous = nullptr;
+	if (next != m_topics.begin()) {
+		std::map<std::string, uint32_t>::const_iterator previousIter = next;
+		previous = &(--previousIter)->first;
+	}
+
+	// 뒤 entry는 새 topic과 공유하는 앞부분으로 다시 계산한다
+	nextDelta = 0;
+	if (next != m_topics.end()) {
+		nextDelta = (int64_t)entrySize(&topic, next->first, next->second) - (int64_t)entrySize(previous, next->first, next->second);
+	}
+
+	return entrySize(previous, topic, index);
+}
+
+void
+TopicManifest::add(const std::string &topic, const std::string &node) {
+	std::map<std::string, uint32_t>::iterator nodeIter = m_nodes.find(node);
+	if (nodeIter == m_nodes.end()) {
+		nodeIter = m_nodes.insert(std::make_pair(node, (uint32_t)m_nodeList.size())).first;
+		m_nodeList.push_back(node);
+		m_nodeBytes += 1 + sizeOfVarNumber(node.size()) + node.size();
+	}
+
+	std::map<std::string, uint32_t>::const_iterator next = m_topics.lower_bound(topic);
+	if (next != m_topics.end() && next->first == topic) {
+		return;
+	}
+
+	int64_t nextDelta;
+	m_entryBytes += entryDelta(topic, nodeIter->second, next, nextDelta);
+	m_entryBytes += nextDelta;
+	m_topics.insert(next, std::make_pair(topic, nodeIter->second));
+}
+
+size_t
+TopicManifest::getSizeBound(const std::string &topic, const std::string &node) const {
+	// Replicas, Continuation: 10 bytes each
+	size_t bytes = s_headerBound + 20 + m_entryBytes + m_nodeBytes;
+
+	uint32_t index = m_nodeList.size();
+	std::map<std::string, uint32_t>::const_iterator nodeIter = m_nodes.find(node);
+	if (nodeIter != m_nodes.end()) {
+		index = nodeIter->second;
+	} else if (0 < node.size()) {
+		bytes += 1 + sizeOfVarNumber(node.size()) + node.size();
+	}
+
+	if (0 < topic.size()) {
+		int64_t nextDelta;
+		bytes += entryDelta(topic, index, m_topics.lower_bound(topic), nextDelta);
+		bytes += nextDelta;
+	}
+
+	return bytes;
+}
+
+std::shared_ptr<::ndn::Buffer>
+TopicManifest::wireEncode() const {
+	std::vector<uint8_t> value;
+	value.reserve(m_entryBytes + m_nodeBytes + 20);
+	if (0 < m_replicas) {
+		appendNumberTlv(value, TLV_MANIFEST_REPLICAS, m_replicas);
+	}
+	if (m_hasContinuation) {
+		appendNumberTlv(value, TLV_MANIFEST_CONTINUATION, m_continuation);
+	}
+	for (const std::string &node : m_nodeList) {
+		value.push_back(TLV_MANIFEST_NODE);
+		appendVarNumber(value, node.size());
+		value.insert(value.end(), node.begin(), node.end());
+	}
+
+	// 앞 topic과 같은 앞부분은 길이만 쓴다
+	const std::string *previous = nullptr;
+	std::map<std::string, uint32_t>::const_iterator topicIter = m_topics.begin();
+	for (; topicIter != m_topics.end(); topicIter++) {
+		const std::string &topic = topicIter->first;
+		size_t shared = (previous == nullptr) ? 0 : sharedPrefix(*previous, topic);
+		previous = &topic;
+
+		value.push_back(TLV_MANIFEST_ENTRY);
+		appendVarNumber(value, sizeOfVarNumber(shared) + sizeOfVarNumber(topicIter->second) + topic.size() - shared);
+		appendVarNumber(value, shared);
+		appendVarNumber(value, topicIter->second);
+		value.insert(value.end(), topic.begin() + shared, topic.end());
+	}
+
+	std::vector<uint8_t> header;
+	header.push_back(TLV_MANIFEST);
+	appendVarNumber(header, value.size());
+
+	std::shared_ptr<::ndn::Buffer> wire = std::make_shared<::ndn::Buffer>(header.size() + value.size());
+	std::copy(header.begin(), header.end(), wire->begin());
+	std::copy(value.begin(), value.end(), wire->begin() + header.size());
+
+	return wire;
+}
+
+int
+TopicManifest::wireDecode(const uint8_t *wire, size_t size) {
+	clear();
+
+	const uint8_t *at = wire;
+	const uint8_t *end = wire + size;
+	uint64_t type, length;
+	if (!readVarNumber(at, end, type) || type != TLV_MANIFEST || !readVarNumber(at, end, length) || (uint64_t)(end - at) < length) {
+		return -1;
+	}
+	end = at + length;
+
+	while (at < end) {
+		if (!readVarNumber(at, end, type) || !readVarNumber(at, end, length) || (uint64_t)(end - at) < length) {
+			return -1;
+		}
+		const uint8_t *value = at;
+		at += length;
+
+		switch (type) {
+		case TLV_MANIFEST_REPLICAS:
+			m_replicas = (uint32_t)readNumber(value, length);
+			break;
+		case TLV_MANIFEST_CONTINUATION:
+			setContinuation(readNumber(value, length));
+			break;
+		case TLV_MANIFEST_NODE:
+			m_nodeList.push_back(std::string((const char *)value, length));
+			break;
+		case TLV_MANIFEST_ENTRY: {
+			uint64_t shared, index;
+			if (!readVarNumber(value, at, shared) || !readVarNumber(value, at, index) || m_nodeList.size() <= index) {
+				return -1;
+			}
+			const std::string *previous = m_entries.empty() ? nullptr : &m_entries.back().first;
+			if ((previous == nullptr && 0 < shared) || (previous != nullptr && previous->size() < shared)) {
+				return -1;
+			}
+
+			std::string topic;
+			topic.reserve(shared + (at - value));
+			if (0 < shared) {
+				topic.assign(*previous, 0, shared);
+			}
+			topic.append((const char *)value, at - value);
+			m_entries.push_back(std::make_pair(std::move(topic), m_nodeList[index]));
+			break;
+		}
+		default:
+			// 모르는 element는 건너뛴다
+			break;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t
+TopicManifest::peekReplicas(const uint8_t *wire, size_t size) {
+	const uint8_t *at = wire;
+	const uint8_t *end = wire + size;
+	uint64_t type, length;
+	if (!readVarNumber(at, end, type) || type != TLV_MANIFEST || !readVarNumber(at, end, length)) {
+		return 0;
+	}
+
+	// Replicas 는 첫 element 이다
+	if (!readVarNumber(at, end, type) || type != TLV_MANIFEST_REPLICAS || !readVarNumber(at, end, length) || (uint64_t)(end - at) < length) {
+		return 0;
+	}
+
+	return (uint32_t)readNumber(at, length);
+}
@@ -0,0 +1,139 @@
+/*
+ * topic-manifest.hpp
+ *
+ * binary TM answer of RendezvousDrnF(BinaryManifest=true), instead of the text list "/a/b/c:RN-00001,/a/b/d:RN-00002":
+ *
+ *   Manifest     = 200 len [Replicas] [Continuation] *Node *Entry
+ *   Replicas     = 201 len nonNegativeInteger        owner RNs of a hot topic(the "*{replicas}|" of the text list)
+ *   Continuation = 202 len nonNegativeInteger        token of the next page, absent on the last page
+ *   Node         = 203 len bytes                     RN label, referenced by its position
+ *   Entry        = 204 len VarNumber(shared) VarNumber(node index) suffix
+ *
+ * entries are sorted and front coded: an entry keeps the first {shared} bytes of the previous topic uri and
+ * appends {suffix}. the numbers are NDN VarNumbers, so a topic of a page costs its new suffix and 4 bytes.
+ * the encoder keeps the entries sorted and its size exact while they are added, so an RN fills a page up to
+ * its byte limit without encoding it first.
+ */
+
+#ifndef EXTENSIONS_TOPIC_MANIFEST_HPP_
+#define EXTENSIONS_TOPIC_MANIFEST_HPP_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ndn-cxx/encoding/buffer.hpp>
+
+enum ManifestTlv : uint8_t {
+	TLV_MANIFEST = 200,
+	TLV_MANIFEST_REPLICAS = 201,
+	TLV_MANIFEST_CONTINUATION = 202,
+	TLV_MANIFEST_NODE = 203,
+	TLV_MANIFEST_ENTRY = 204,
+};
+
+class TopicManifest
+{
+public:
+	TopicManifest();
+
+	void
+	clear();
+
+	void
+	add(const std::string &topic, const std::string &node);
+
+	size_t
+	size() const {
+		return m_topics.size();
+	}
+
+	/**
+	 * @brief encoded size with an entry of topic and node added(empty topic: as it is), at most 30 bytes more
+	 * than wireEncode() for the Replicas/Continuation and length fields that are not known yet
+	 */
+	size_t
+	getSizeBound(const std::string &topic, const std::string &node) const;
+
+	void
+	setReplicas(uint32_t replicas) {
+		m_replicas = replicas;
+	}
+
+	uint32_t
+	getReplicas() const {
+		return m_replicas;
+	}
+
+	void
+	setContinuation(uint64_t token) {
+		m_continuation = token;
+		m_hasContinuation = true;
+	}
+
+	bool
+	hasContinuation() const {
+		return m_hasContinuation;
+	}
+
+	uint64_t
+	getContinuation() const {
+		return m_continuation;
+	}
+
+	/**
+	 * @brief (topic uri, node) pairs of wireDecode(), sorted by topic
+	 */
+	const std::vector<std::pair<std::string, std::string>> &
+	getEntries() const {
+		return m_entries;
+	}
+
+	std::shared_ptr<::ndn::Buffer>
+	wireEncode() const;
+
+	/**
+	 * @brief entries, replicas and continuation of an encoded manifest, -1 on a malformed one
+	 */
+	int
+	wireDecode(const uint8_t *wire, size_t size);
+
+	static bool
+	isManifest(const uint8_t *wire, size_t size) {
+		return 0 < size && wire[0] == TLV_MANIFEST;
+	}
+
+	/**
+	 * @brief Replicas of an encoded manifest without decoding the entries, 0 if absent
+	 */
+	static uint32_t
+	peekReplicas(const uint8_t *wire, size_t size);
+
+private:
+	// bytes of the Entry element of topic after previous(nullptr: the first entry)
+	static size_t
+	entrySize(const std::string *previous, const std::string &topic, uint32_t index);
+
+	// change of the entry bytes if topic were added
+	size_t
+	entryDelta(const std::string &topic, uint32_t index, std::map<std::string, uint32_t>::const_iterator next,
+			int64_t &nextDelta) const;
+
+private:
+	// encoder: topic -> node index
+	std::map<std::string, uint32_t> m_topics;
+	// decoder
+	std::vector<std::pair<std::string, std::string>> m_entries;
+	// node -> index, in the order of the first entry of the node
+	std::map<std::string, uint32_t> m_nodes;
+	std::vector<std::string> m_nodeList;
+	size_t m_entryBytes;
+	size_t m_nodeBytes;
+	uint32_t m_replicas;
+	bool m_hasContinuation;
+	uint64_t m_continuation;
+};
+
+#endif /* EXTENSIONS_TOPIC_MANIFEST_HPP_ */
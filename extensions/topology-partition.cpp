@@ -0,0 +1,367 @@
+/*
+ * topology-partition.cpp
+ */
+
+#include "topology-partition.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <sstream>
+
+TopologyPartition::TopologyPartition()
+	: m_nParts(1)
+{
+}
+
+int
+TopologyPartition::read(const std::string &path) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return -1;
+	}
+
+	m_path = path;
+	m_names.clear();
+	m_ids.clear();
+	m_links.clear();
+
+	std::string line;
+	int section = 0;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		if (line.compare(0, 6, "router") == 0) {
+			section = 1;
+			continue;
+		}
+		if (line.compare(0, 4, "link") == 0) {
+			section = 2;
+			continue;
+		}
+
+		std::istringstream tokens(line);
+		std::string from, to, bandwidth, metric, delay;
+		if (section == 1 && (tokens >> from)) {
+			m_ids[from] = m_names.size();
+			m_names.push_back(from);
+		} else if (section == 2 && (tokens >> from >> to)) {
+			tokens >> bandwidth >> metric >> delay;
+			if (m_ids.count(from) == 0 || m_ids.count(to) == 0) {
+				continue;
+			}
+
+			Link link;
+			link.a = m_ids[from];
+			link.b = m_ids[to];
+			link.delay = parseDelay(delay);
+			link.cost = 1 + (uint32_t)(100000 / std::max(link.delay, (uint64_t)1));
+			m_links.push_back(link);
+		}
+	}
+
+	m_adjacency.assign(m_names.size(), std::vector<std::pair<uint32_t, uint32_t>>());
+	for (uint32_t i = 0; i < m_links.size(); i++) {
+		m_adjacency[m_links[i].a].push_back(std::make_pair(m_links[i].b, i));
+		m_adjacency[m_links[i].b].push_back(std::make_pair(m_links[i].a, i));
+	}
+
+	m_loads.resize(m_names.size());
+	for (uint32_t v = 0; v < m_names.size(); v++) {
+		m_loads[v] = 1 + m_adjacency[v].size();
+	}
+
+	m_nParts = 1;
+	m_parts.assign(m_names.size(), 0);
+
+	return 0;
+}
+
+void
+TopologyPartition::partition(uint32_t parts, double imbalance) {
+	m_nParts = std::max(parts, (uint32_t)1);
+	m_parts.assign(m_names.size(), 0);
+	m_partLoads.assign(m_nParts, 0);
+	if (m_nParts == 1 || m_names.empty()) {
+		for (uint32_t v = 0; v < m_names.size(); v++) {
+			m_partLoads[0] += m_loads[v];
+		}
+		return;
+	}
+
+	grow(m_nParts);
+
+	uint64_t total = 0;
+	for (uint32_t load : m_loads) {
+		total += load;
+	}
+	uint64_t maxLoad = (uint64_t)((1.0 + imbalance) * total / m_nParts) + 1;
+	refine(m_nParts, maxLoad);
+}
+
+void
+TopologyPartition::grow(uint32_t parts) {
+	const uint32_t NONE = (uint32_t)-1;
+	uint32_t nodes = m_names.size();
+
+	// seeds far apart: the most loaded node, then each time the node with the most hops to all seeds
+	std::vector<uint32_t> seeds;
+	std::vector<uint32_t> hops(nodes, NONE);
+	seeds.push_back(std::max_element(m_loads.begin(), m_loads.end()) - m_loads.begin());
+	while (seeds.size() < parts && seeds.size() < nodes) {
+		std::queue<uint32_t> queue;
+		queue.push(seeds.back());
+		hops[seeds.back()] = 0;
+		while (!queue.empty()) {
+			uint32_t v = queue.front();
+			queue.pop();
+			for (const std::pair<uint32_t, uint32_t> &next : m_adjacency[v]) {
+				if (hops[v] + 1 < hops[next.first]) {
+					hops[next.first] = hops[v] + 1;
+					queue.push(next.first);
+				}
+			}
+		}
+
+		uint32_t farthest = NONE;
+		for (uint32_t v = 0; v < nodes; v++) {
+			if (0 < hops[v] && (farthest == NONE || hops[farthest] < hops[v])) {
+				farthest = v;
+			}
+		}
+		if (farthest == NONE) {
+			break;
+		}
+		seeds.push_back(farthest);
+	}
+
+	// lightest part takes the frontier node it has the most link cost to, stale heap entries are skipped
+	typedef std::pair<uint64_t, uint32_t> Candidate;
+	std::vector<std::priority_queue<Candidate>> frontiers(parts);
+	std::vector<std::vector<uint64_t>> gains(parts);
+	std::vector<uint32_t> assigned(nodes, NONE);
+	uint32_t remaining = nodes;
+	uint32_t nextFree = 0;
+
+	for (uint32_t p = 0; p < parts; p++) {
+		gains[p].assign(nodes, 0);
+	}
+
+	std::vector<uint32_t> order(parts);
+	for (uint32_t p = 0; p < parts; p++) {
+		order[p] = p;
+	}
+
+	for (uint32_t p = 0; p < seeds.size(); p++) {
+		gains[p][seeds[p]] = 1;
+		frontiers[p].push(std::make_pair(1, seeds[p]));
+	}
+
+	while (0 < remaining) {
+		std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			return m_partLoads[a] < m_partLoads[b];
+		});
+
+		uint32_t p = order[0];
+		uint32_t v = NONE;
+		while (!frontiers[p].empty()) {
+			Candidate top = frontiers[p].top();
+			frontiers[p].pop();
+			if (assigned[top.second] == NONE && top.first == gains[p][top.second]) {
+				v = top.second;
+				break;
+			}
+		}
+		if (v == NONE) {
+			// no frontier left(disconnected component or all neighbours taken), any free node
+			while (assigned[nextFree] != NONE) {
+				nextFree++;
+			}
+			v = nextFree;
+		}
+
+		assigned[v] = p;
+		m_partLoads[p] += m_loads[v];
+		remaining -= 1;
+
+		for (const std::pair<uint32_t, uint32_t> &next : m_adjacency[v]) {
+			if (assigned[next.first] == NONE) {
+				gains[p][next.first] += m_links[next.second].cost;
+				frontiers[p].push(std::make_pair(gains[p][next.first], next.first));
+			}
+		}
+	}
+
+	m_parts = assigned;
+}
+
+void
+TopologyPartition::refine(uint32_t parts, uint64_t maxLoad) {
+	uint32_t nodes = m_names.size();
+	std::vector<uint64_t> costs(parts);
+
+	// boundary moves with a positive gain or, at no gain, towards a lighter part
+	for (int pass = 0; pass < 16; pass++) {
+		uint32_t moves = 0;
+
+		for (uint32_t v = 0; v < nodes; v++) {
+			uint32_t from = m_parts[v];
+			std::fill(costs.begin(), costs.end(), 0);
+			for (const std::pair<uint32_t, uint32_t> &next : m_adjacency[v]) {
+				costs[m_parts[next.first]] += m_links[next.second].cost;
+			}
+
+			uint32_t best = from;
+			int64_t bestGain = 0;
+			for (uint32_t to = 0; to < parts; to++) {
+				if (to == from || costs[to] == 0 || maxLoad < m_partLoads[to] + m_loads[v]) {
+					continue;
+				}
+				// a part is never emptied
+				if (m_partLoads[from] == m_loads[v]) {
+					continue;
+				}
+
+				int64_t gain = (int64_t)costs[to] - (int64_t)costs[from];
+				bool balances = (m_partLoads[to] + m_loads[v] < m_partLoads[from]);
+				if (bestGain < gain || (gain == 0 && bestGain == 0 && best == from && balances)) {
+					best = to;
+					bestGain = gain;
+				}
+			}
+
+			if (best != from) {
+				m_parts[v] = best;
+				m_partLoads[from] -= m_loads[v];
+				m_partLoads[best] += m_loads[v];
+				moves += 1;
+			}
+		}
+
+		if (moves == 0) {
+			break;
+		}
+	}
+}
+
+int
+TopologyPartition::write(const std::string &path) const {
+	std::ifstream in(m_path);
+	std::ofstream out(path);
+	if (!in.is_open() || !out.is_open()) {
+		return -1;
+	}
+
+	std::string line;
+	int section = 0;
+	while (std::getline(in, line)) {
+		if (line.empty() || line[0] == '#') {
+			out << line << "\n";
+			continue;
+		}
+		if (line.compare(0, 6, "router") == 0) {
+			section = 1;
+		} else if (line.compare(0, 4, "link") == 0) {
+			section = 2;
+		} else if (section == 1) {
+			// name comment yPos xPos systemId, the optional columns are filled in so the id lands in the 5th
+			std::istringstream tokens(line);
+			std::string name, comment = "NA", y = "0", x = "0";
+			if (tokens >> name) {
+				tokens >> comment >> y >> x;
+				out << name << "\t" << comment << "\t" << y << "\t" << x << "\t" << getPart(name) << "\n";
+				continue;
+			}
+		}
+		out << line << "\n";
+	}
+
+	return out.good() ? 0 : -1;
+}
+
+uint32_t
+TopologyPartition::getPart(const std::string &name) const {
+	std::map<std::string, uint32_t>::const_iterator iter = m_ids.find(name);
+	if (iter == m_ids.end() || m_parts.size() <= iter->second) {
+		return 0;
+	}
+
+	return m_parts[iter->second];
+}
+
+uint32_t
+TopologyPartition::getNodeCount() const {
+	return m_names.size();
+}
+
+uint32_t
+TopologyPartition::getCutCount() const {
+	uint32_t count = 0;
+	for (const Link &link : m_links) {
+		count += (m_parts[link.a] != m_parts[link.b]);
+	}
+
+	return count;
+}
+
+uint64_t
+TopologyPartition::getCutCost() const {
+	uint64_t cost = 0;
+	for (const Link &link : m_links) {
+		if (m_parts[link.a] != m_parts[link.b]) {
+			cost += link.cost;
+		}
+	}
+
+	return cost;
+}
+
+uint64_t
+TopologyPartition::getLookahead() const {
+	uint64_t lookahead = 0;
+	for (const Link &link : m_links) {
+		if (m_parts[link.a] != m_parts[link.b] && (lookahead == 0 || link.delay < lookahead)) {
+			lookahead = link.delay;
+		}
+	}
+
+	return lookahead;
+}
+
+double
+TopologyPartition::getImbalance() const {
+	uint64_t total = 0, largest = 0;
+	for (uint64_t load : m_partLoads) {
+		total += load;
+		largest = std::max(largest, load);
+	}
+	if (total == 0) {
+		return 1.0;
+	}
+
+	return (double)largest * m_partLoads.size() / total;
+}
+
+uint64_t
+TopologyPartition::parseDelay(const std::string &delay) {
+	// ns3 time string: 7631us, 10ms, 1s, 500ns. no unit is seconds
+	char *end = 0;
+	double value = strtod(delay.c_str(), &end);
+	std::string unit(end != 0 ? end : "");
+	if (delay.empty()) {
+		return 0;
+	}
+	if (unit == "us") {
+		return (uint64_t)value;
+	}
+	if (unit == "ms") {
+		return (uint64_t)(value * 1000);
+	}
+	if (unit == "ns") {
+		return (uint64_t)(value / 1000);
+	}
+
+	return (uint64_t)(value * 1000000);
+}
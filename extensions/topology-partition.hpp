@@ -0,0 +1,101 @@
+/*
+ * topology-partition.hpp
+ *
+ * partition of an annotated topology over the ranks of a distributed(MPI) simulation.
+ *
+ *  - cost of a link   : 1 + 100ms / delay, a cut link bounds the lookahead of the ranks by its delay,
+ *                       so short links are the expensive ones to cut
+ *  - load of a node   : 1 + degree, the links a node forwards over
+ *  - partition        : greedy graph growing from seeds far apart(the lightest part takes its most
+ *                       connected frontier node), then boundary moves with a positive cut gain that keep
+ *                       every part under (1 + imbalance) * mean load
+ *
+ * write() copies the topology file with the system id as the 5th column of the router lines,
+ * the column AnnotatedTopologyReader creates the nodes with.
+ */
+
+#ifndef EXTENSIONS_TOPOLOGY_PARTITION_HPP_
+#define EXTENSIONS_TOPOLOGY_PARTITION_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class TopologyPartition
+{
+public:
+	TopologyPartition();
+
+	/**
+	 * @brief routers and links of an annotated topology file, -1 if it cannot be read
+	 */
+	int
+	read(const std::string &path);
+
+	void
+	partition(uint32_t parts, double imbalance = 0.05);
+
+	/**
+	 * @brief annotated topology with the system ids, -1 if it cannot be written
+	 */
+	int
+	write(const std::string &path) const;
+
+	uint32_t
+	getPart(const std::string &name) const;
+
+	uint32_t
+	getNodeCount() const;
+
+	uint32_t
+	getCutCount() const;
+
+	uint64_t
+	getCutCost() const;
+
+	/**
+	 * @brief smallest delay(us) of the cut links, the lookahead of the ranks. 0 if nothing is cut
+	 */
+	uint64_t
+	getLookahead() const;
+
+	/**
+	 * @brief largest part load / mean part load
+	 */
+	double
+	getImbalance() const;
+
+private:
+	void
+	grow(uint32_t parts);
+
+	void
+	refine(uint32_t parts, uint64_t maxLoad);
+
+	static uint64_t
+	parseDelay(const std::string &delay);
+
+private:
+	struct Link
+	{
+		uint32_t a;
+		uint32_t b;
+		uint64_t delay;
+		uint32_t cost;
+	};
+
+	std::string m_path;
+	std::vector<std::string> m_names;
+	std::map<std::string, uint32_t> m_ids;
+	std::vector<Link> m_links;
+	// node -> (neighbour, link index)
+	std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_adjacency;
+	std::vector<uint32_t> m_loads;
+
+	uint32_t m_nParts;
+	std::vector<uint32_t> m_parts;
+	std::vector<uint64_t> m_partLoads;
+};
+
+#endif /* EXTENSIONS_TOPOLOGY_PARTITION_HPP_ */
@@ -0,0 +1,370 @@
+/*
+ * topology-proximity.cpp
+ */
+
+#include "topology-proximity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.TopologyProximity");
+
+NS_OBJECT_ENSURE_REGISTERED(TopologyProximity);
+
+static const double UNREACHABLE = std::numeric_limits<double>::max();
+
+/* clockwise distance from a to b on the chord ring */
+static lli
+ringDistance(lli a, lli b) {
+	lli mod = (lli)1 << M;
+	return ((b - a) % mod + mod) % mod;
+}
+
+ns3::TypeId
+TopologyProximity::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("TopologyProximity")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<TopologyProximity>()
+			;
+
+	return tid;
+}
+
+TopologyProximity::TopologyProximity()
+	: m_nStretchCount(0)
+	, m_nOverlayHopCount(0)
+	, m_stretchSum(0.0)
+	, m_stretchMax(0.0)
+{
+	m_key = ns3::CreateObject<ns3::UniformRandomVariable>();
+}
+
+TopologyProximity::~TopologyProximity() {
+}
+
+void
+TopologyProximity::Build(const ns3::NodeContainer &nodes) {
+	m_links.assign(ns3::NodeList::GetNNodes(), std::vector<std::pair<uint32_t, double>>());
+	m_distances.clear();
+
+	ns3::NodeContainer::Iterator iter = nodes.Begin();
+	for (; iter != nodes.End(); iter++) {
+		ns3::Ptr<ns3::Node> node = *iter;
+
+		for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+			ns3::Ptr<ns3::Channel> channel = node->GetDevice(i)->GetChannel();
+			if (channel == 0) {
+				continue;
+			}
+
+			ns3::TimeValue delay;
+			if (channel->GetAttributeFailSafe("Delay", delay) == false) {
+				continue;
+			}
+
+			for (uint32_t j = 0; j < channel->GetNDevices(); j++) {
+				ns3::Ptr<ns3::Node> peer = channel->GetDevice(j)->GetNode();
+				if (peer == node) {
+					continue;
+				}
+				m_links[node->GetId()].push_back(std::make_pair(peer->GetId(), delay.Get().GetSeconds() * 1000.0));
+			}
+		}
+	}
+}
+
+void
+TopologyProximity::AddName(const std::string &name, ns3::Ptr<ns3::Node> node) {
+	m_names[name] = node->GetId();
+}
+
+double
+TopologyProximity::GetDelay(uint32_t from, uint32_t to) {
+	const std::vector<double> &distances = GetDistances(from);
+	if (distances.size() <= to || distances[to] == UNREACHABLE) {
+		return -1.0;
+	}
+
+	return distances[to];
+}
+
+double
+TopologyProximity::GetDelay(const std::string &from, const std::string &to) {
+	std::map<std::string, uint32_t>::iterator fromIter = m_names.find(from);
+	std::map<std::string, uint32_t>::iterator toIter = m_names.find(to);
+	if (fromIter == m_names.end() || toIter == m_names.end()) {
+		return -1.0;
+	}
+
+	return GetDelay(fromIter->second, toIter->second);
+}
+
+std::vector<ns3::Ptr<ns3::Node>>
+TopologyProximity::SelectByCentrality(const std::vector<ns3::Ptr<ns3::Node>> &candidates, const std::vector<ns3::Ptr<ns3::Node>> &clients, uint32_t count) {
+	std::vector<std::pair<double, uint32_t>> scores;
+
+	for (uint32_t index = 0; index < candidates.size(); index++) {
+		double sum = 0.0;
+		for (uint32_t c = 0; c < clients.size(); c++) {
+			double delay = GetDelay(candidates[index]->GetId(), clients[c]->GetId());
+			sum += (delay < 0) ? UNREACHABLE / clients.size() : delay;
+		}
+		scores.push_back(std::make_pair(sum, index));
+	}
+
+	std::sort(scores.begin(), scores.end());
+
+	std::vector<ns3::Ptr<ns3::Node>> selected;
+	for (uint32_t index = 0; index < scores.size() && index < count; index++) {
+		selected.push_back(candidates[scores[index].second]);
+	}
+
+	return selected;
+}
+
+std::vector<ns3::Ptr<ns3::Node>>
+TopologyProximity::SelectByKMedian(const std::vector<ns3::Ptr<ns3::Node>> &candidates, const std::vector<ns3::Ptr<ns3::Node>> &clients, uint32_t count) {
+	std::vector<ns3::Ptr<ns3::Node>> selected;
+	std::vector<bool> used(candidates.size(), false);
+	// client 별 가장 가까운 선택된 노드까지의 delay
+	std::vector<double> nearest(clients.size(), UNREACHABLE);
+
+	while (selected.size() < count && selected.size() < candidates.size()) {
+		double bestCost = UNREACHABLE;
+		int32_t best = -1;
+
+		for (uint32_t index = 0; index < candidates.size(); index++) {
+			if (used[index]) {
+				continue;
+			}
+
+			double cost = 0.0;
+			for (uint32_t c = 0; c < clients.size(); c++) {
+				double delay = GetDelay(candidates[index]->GetId(), clients[c]->GetId());
+				if (delay < 0) {
+					delay = UNREACHABLE;
+				}
+				cost += std::min(nearest[c], delay) / clients.size();
+			}
+
+			if (best < 0 || cost < bestCost) {
+				bestCost = cost;
+				best = index;
+			}
+		}
+
+		used[best] = true;
+		selected.push_back(candidates[best]);
+
+		for (uint32_t c = 0; c < clients.size(); c++) {
+			double delay = GetDelay(candidates[best]->GetId(), clients[c]->GetId());
+			if (0 <= delay && delay < nearest[c]) {
+				nearest[c] = delay;
+			}
+		}
+	}
+
+	return selected;
+}
+
+/**
+ * finger i 의 구간은 [self + 2^(i-1), self + 2^i) 이며, 구간 안의 어떤 노드를 finger로 사용해도
+ * lookup의 hop 수(O(log N))는 유지된다.
+ */
+std::pair<std::string, lli>
+TopologyProximity::SelectFinger(const std::string &self, lli selfId, int fingerIndex, const std::pair<std::string, lli> &finger,
+		const std::vector<std::pair<std::string, lli>> &candidates) {
+	lli lower = (lli)1 << (fingerIndex - 1);
+	lli upper = (lli)1 << fingerIndex;
+
+	std::pair<std::string, lli> best = finger;
+	double bestDelay = GetDelay(self, finger.first);
+	if (bestDelay < 0) {
+		bestDelay = UNREACHABLE;
+	}
+
+	std::vector<std::pair<std::string, lli>>::const_iterator iter = candidates.begin();
+	for (; iter != candidates.end(); iter++) {
+		if (iter->first == "" || iter->second == -1 || iter->first == self) {
+			continue;
+		}
+
+		lli distance = ringDistance(selfId, iter->second);
+		if (distance < lower || upper <= distance) {
+			continue;
+		}
+
+		double delay = GetDelay(self, iter->first);
+		if (0 <= delay && delay < bestDelay) {
+			bestDelay = delay;
+			best = *iter;
+		}
+	}
+
+	return best;
+}
+
+void
+TopologyProximity::MeasureStretch(const std::map<std::string, NodeInformation *> &ring, uint32_t samples) {
+	std::map<std::string, NodeInformation *>::const_iterator sourceIter = ring.begin();
+	for (; sourceIter != ring.end(); sourceIter++) {
+		if (sourceIter->second == 0) {
+			continue;
+		}
+
+		for (uint32_t sample = 0; sample < samples; sample++) {
+			lli key = (lli)m_key->GetValue(0, std::pow(2.0, M));
+
+			std::string current = sourceIter->first;
+			double overlayDelay = 0.0;
+			uint32_t hops = 0;
+			bool found = false;
+
+			// 경로가 깨진 경우(churn 중 등)를 대비하여 hop 수를 제한한다
+			while (hops <= ring.size()) {
+				std::map<std::string, NodeInformation *>::const_iterator iter = ring.find(current);
+				if (iter == ring.end() || iter->second == 0) {
+					break;
+				}
+
+				NodeInformation *node = iter->second;
+				lli id = node->getId();
+				pair<string, lli> successor = node->getSuccessor();
+				if (successor.first == "" || successor.second == -1) {
+					break;
+				}
+
+				if (successor.second == id) {
+					found = true;
+					break;
+				}
+
+				std::string next = successor.first;
+				bool last = (0 < ringDistance(id, key) && ringDistance(id, key) <= ringDistance(id, successor.second));
+				if (last == false) {
+					vector<pair<string, lli>> fingers = node->getFingerTable();
+					for (int i = M; i >= 1; i--) {
+						if (fingers[i].first == "" || fingers[i].second == -1 || fingers[i].first == current) {
+							continue;
+						}
+						lli distance = ringDistance(id, fingers[i].second);
+						if (0 < distance && distance < ringDistance(id, key)) {
+							next = fingers[i].first;
+							break;
+						}
+					}
+				}
+
+				double delay = GetDelay(current, next);
+				if (delay < 0) {
+					break;
+				}
+
+				overlayDelay += delay;
+				hops += 1;
+				current = next;
+
+				if (last) {
+					found = true;
+					break;
+				}
+			}
+
+			if (found == false || current == sourceIter->first) {
+				continue;
+			}
+
+			double direct = GetDelay(sourceIter->first, current);
+			if (direct <= 0) {
+				continue;
+			}
+
+			double stretch = overlayDelay / direct;
+			m_stretchSum += stretch;
+			m_stretchMax = std::max(m_stretchMax, stretch);
+			m_nStretchCount += 1;
+			m_nOverlayHopCount += hops;
+		}
+	}
+
+	NS_LOG_INFO(stringf("Stretch Count: %u, Mean: %.3f, Max: %.3f, Hops: %.3f",
+			m_nStretchCount, GetMeanStretch(), GetMaxStretch(), GetMeanOverlayHops()));
+}
+
+uint32_t
+TopologyProximity::GetStretchCount() {
+	return m_nStretchCount;
+}
+
+double
+TopologyProximity::GetMeanStretch() {
+	if (m_nStretchCount == 0) {
+		return 0.0;
+	}
+
+	return m_stretchSum / m_nStretchCount;
+}
+
+double
+TopologyProximity::GetMaxStretch() {
+	return m_stretchMax;
+}
+
+double
+TopologyProximity::GetMeanOverlayHops() {
+	if (m_nStretchCount == 0) {
+		return 0.0;
+	}
+
+	return (double)m_nOverlayHopCount / m_nStretchCount;
+}
+
+/**
+ * from 으로부터 모든 노드까지의 최단 경로 delay(Dijkstra)
+ */
+const std::vector<double> &
+TopologyProximity::GetDistances(uint32_t from) {
+	std::map<uint32_t, std::vector<double>>::iterator cached = m_distances.find(from);
+	if (cached != m_distances.end()) {
+		return cached->second;
+	}
+
+	std::vector<double> &distances = m_distances[from];
+	distances.assign(m_links.size(), UNREACHABLE);
+	if (m_links.size() <= from) {
+		return distances;
+	}
+
+	typedef std::pair<double, uint32_t> QueueItem;
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+	distances[from] = 0.0;
+	queue.push(QueueItem(0.0, from));
+
+	while (queue.empty() == false) {
+		QueueItem item = queue.top();
+		queue.pop();
+
+		if (distances[item.second] < item.first) {
+			continue;
+		}
+
+		std::vector<std::pair<uint32_t, double>>::iterator link = m_links[item.second].begin();
+		for (; link != m_links[item.second].end(); link++) {
+			double distance = item.first + link->second;
+			if (distance < distances[link->first]) {
+				distances[link->first] = distance;
+				queue.push(QueueItem(distance, link->first));
+			}
+		}
+	}
+
+	return distances;
+}
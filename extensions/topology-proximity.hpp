@@ -0,0 +1,114 @@
+/*
+ * topology-proximity.hpp
+ *
+ * underlay(link delay) distances of the loaded topology.
+ *
+ *  - rendezvous placement  : closeness centrality or greedy k-median over the clients
+ *  - proximity neighbour selection of chord fingers
+ *  - stretch(overlay latency / direct path latency) of chord lookups
+ */
+
+#ifndef EXTENSIONS_TOPOLOGY_PROXIMITY_HPP_
+#define EXTENSIONS_TOPOLOGY_PROXIMITY_HPP_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+#include "Chord-DHT/nodeInformation.hpp"
+
+class TopologyProximity : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	TopologyProximity();
+
+	virtual
+	~TopologyProximity();
+
+	/**
+	 * @brief build the link graph from the channels of nodes, link weight is the channel Delay
+	 */
+	void
+	Build(const ns3::NodeContainer &nodes);
+
+	/**
+	 * @brief name(RN-{nnnnn}) of the overlay node on node
+	 */
+	void
+	AddName(const std::string &name, ns3::Ptr<ns3::Node> node);
+
+	/**
+	 * @brief shortest path delay(ms), negative if unreachable
+	 */
+	double
+	GetDelay(uint32_t from, uint32_t to);
+
+	double
+	GetDelay(const std::string &from, const std::string &to);
+
+	/**
+	 * @brief count candidates with the smallest total delay to the clients
+	 */
+	std::vector<ns3::Ptr<ns3::Node>>
+	SelectByCentrality(const std::vector<ns3::Ptr<ns3::Node>> &candidates, const std::vector<ns3::Ptr<ns3::Node>> &clients, uint32_t count);
+
+	/**
+	 * @brief greedy k-median, each step adds the candidate that reduces the clients' delay to the nearest selected node most
+	 */
+	std::vector<ns3::Ptr<ns3::Node>>
+	SelectByKMedian(const std::vector<ns3::Ptr<ns3::Node>> &candidates, const std::vector<ns3::Ptr<ns3::Node>> &clients, uint32_t count);
+
+	/**
+	 * @brief among the known nodes in the interval of finger fingerIndex of self, the nearest one.
+	 * returns finger itself if no other node is closer
+	 */
+	std::pair<std::string, lli>
+	SelectFinger(const std::string &self, lli selfId, int fingerIndex, const std::pair<std::string, lli> &finger,
+			const std::vector<std::pair<std::string, lli>> &candidates);
+
+	/**
+	 * @brief route samples random keys from each ring node over the successors/fingers of ring
+	 * and accumulate the stretch of each lookup
+	 */
+	void
+	MeasureStretch(const std::map<std::string, NodeInformation *> &ring, uint32_t samples);
+
+	uint32_t
+	GetStretchCount();
+
+	double
+	GetMeanStretch();
+
+	double
+	GetMaxStretch();
+
+	double
+	GetMeanOverlayHops();
+
+private:
+	const std::vector<double> &
+	GetDistances(uint32_t from);
+
+private:
+	// node id -> (neighbour node id, delay(ms))
+	std::vector<std::vector<std::pair<uint32_t, double>>> m_links;
+	// single source shortest path delays, computed on demand
+	std::map<uint32_t, std::vector<double>> m_distances;
+	std::map<std::string, uint32_t> m_names;
+
+	ns3::Ptr<ns3::UniformRandomVariable> m_key;
+
+	uint32_t m_nStretchCount;
+	uint32_t m_nOverlayHopCount;
+	double m_stretchSum;
+	double m_stretchMax;
+};
+
+#endif /* EXTENSIONS_TOPOLOGY_PROXIMITY_HPP_ */
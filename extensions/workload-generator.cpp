@@ -0,0 +1,283 @@
+/*
+ * workload-generator.cpp
+ */
+
+#include "workload-generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include <ns3/ndnSIM/ndn-cxx/util/logger.hpp>
+
+#include "utils.hpp"
+
+NS_LOG_COMPONENT_DEFINE("drn.WorkloadGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(WorkloadGenerator);
+
+ns3::TypeId
+WorkloadGenerator::GetTypeId() {
+	static ns3::TypeId tid = ns3::TypeId("WorkloadGenerator")
+			.SetGroupName("Ndn")
+			.SetParent<ns3::Object>()
+			.AddConstructor<WorkloadGenerator>()
+
+			.AddAttribute("Seed", "Seed of the topics, subscriptions and publish intervals", ns3::UintegerValue(1),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_seed), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("Topics", "Number of topics", ns3::UintegerValue(1000),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nTopics), ns3::MakeUintegerChecker<uint32_t>(1))
+
+			.AddAttribute("Depth", "Prefix components above the topic-{i} component", ns3::UintegerValue(3),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nDepth), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("RootFanOut", "Number of first components, the placement keys of the rendezvous(0: FanOut)", ns3::UintegerValue(0),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nRootFanOut), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("FanOut", "Children of a prefix below the first component", ns3::UintegerValue(4),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nFanOut), ns3::MakeUintegerChecker<uint32_t>(1))
+
+			.AddAttribute("ZipfExponent", "Exponent of the Zipf topic popularity(0: uniform)", ns3::DoubleValue(1.0),
+							ns3::MakeDoubleAccessor(&WorkloadGenerator::m_zipfExponent), ns3::MakeDoubleChecker<double>(0.0))
+
+			.AddAttribute("Subscriptions", "Subscriptions per consumer", ns3::UintegerValue(10),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nSubscriptions), ns3::MakeUintegerChecker<uint32_t>())
+
+			.AddAttribute("WildcardRatio", "Fraction of the subscriptions that are wildcard prefixes", ns3::DoubleValue(0.0),
+							ns3::MakeDoubleAccessor(&WorkloadGenerator::m_wildcardRatio), ns3::MakeDoubleChecker<double>(0.0, 1.0))
+
+			.AddAttribute("PublishProcess", "Publications of a topic: periodic, poisson (default), bursty", ns3::StringValue("poisson"),
+							ns3::MakeStringAccessor(&WorkloadGenerator::SetPublishProcess, &WorkloadGenerator::GetPublishProcess), ns3::MakeStringChecker())
+
+			.AddAttribute("PublishRate", "Mean publications per second of a topic", ns3::DoubleValue(0.2),
+							ns3::MakeDoubleAccessor(&WorkloadGenerator::m_publishRate), ns3::MakeDoubleChecker<double>(1e-6))
+
+			.AddAttribute("BurstSize", "Publications of a burst(bursty)", ns3::UintegerValue(10),
+							ns3::MakeUintegerAccessor(&WorkloadGenerator::m_nBurstSize), ns3::MakeUintegerChecker<uint32_t>(1))
+
+			.AddAttribute("BurstGap", "Time between the publications of a burst(bursty)", ns3::StringValue("10ms"),
+							ns3::MakeTimeAccessor(&WorkloadGenerator::m_burstGap), ns3::MakeTimeChecker())
+
+			.AddAttribute("AdvertiseTime", "The first advertisements of a producer are spread over this time", ns3::StringValue("1s"),
+							ns3::MakeTimeAccessor(&WorkloadGenerator::m_advertiseTime), ns3::MakeTimeChecker())
+			;
+
+	return tid;
+}
+
+WorkloadGenerator::WorkloadGenerator()
+	: m_seed(1)
+	, m_nTopics(1000)
+	, m_nDepth(3)
+	, m_nRootFanOut(0)
+	, m_nFanOut(4)
+	, m_zipfExponent(1.0)
+	, m_nSubscriptions(10)
+	, m_wildcardRatio(0.0)
+	, m_publishProcess(PUBLISH_POISSON)
+	, m_publishRate(0.2)
+	, m_nBurstSize(10)
+	, m_nProducers(1)
+	, m_nSubscriptionCount(0)
+	, m_nWildcardCount(0)
+	, m_nPublishCount(0)
+	, m_nBurstCount(0)
+{
+}
+
+WorkloadGenerator::~WorkloadGenerator() {
+}
+
+void
+WorkloadGenerator::SetPublishProcess(const std::string &value) {
+	if (value == "periodic") {
+		m_publishProcess = PUBLISH_PERIODIC;
+	} else if (value == "bursty") {
+		m_publishProcess = PUBLISH_BURSTY;
+	} else {
+		m_publishProcess = PUBLISH_POISSON;
+	}
+}
+
+std::string
+WorkloadGenerator::GetPublishProcess() const {
+	switch (m_publishProcess) {
+	case PUBLISH_PERIODIC: return "periodic";
+	case PUBLISH_BURSTY: return "bursty";
+	default: return "poisson";
+	}
+}
+
+void
+WorkloadGenerator::Generate(uint32_t producers, uint32_t consumers) {
+	m_rng.seed(m_seed);
+	m_nProducers = std::max(producers, 1u);
+
+	// popular topics are not all under the same prefix or producer
+	m_rankToTopic.resize(m_nTopics);
+	for (uint32_t i = 0; i < m_nTopics; i++) {
+		m_rankToTopic[i] = i;
+	}
+	std::shuffle(m_rankToTopic.begin(), m_rankToTopic.end(), m_rng);
+
+	m_zipfCdf.resize(m_nTopics);
+	double sum = 0.0;
+	for (uint32_t i = 0; i < m_nTopics; i++) {
+		sum += std::pow((double)(i + 1), -m_zipfExponent);
+		m_zipfCdf[i] = sum;
+	}
+
+	m_subscriptions.assign(consumers, std::vector<std::string>());
+	m_nSubscriptionCount = 0;
+	m_nWildcardCount = 0;
+
+	std::uniform_real_distribution<double> coin(0.0, 1.0);
+	for (uint32_t c = 0; c < consumers; c++) {
+		std::set<std::string> subscribed;
+		uint32_t count = std::min(m_nSubscriptions, m_nTopics);
+
+		// 인기 topic은 여러번 뽑히므로 시도 횟수를 제한한다
+		for (uint32_t tries = 0; subscribed.size() < count && tries < count * 8; tries++) {
+			uint32_t topic = DrawTopic();
+			bool wildcard = 0 < m_nDepth && coin(m_rng) < m_wildcardRatio;
+
+			std::string name = wildcard ? GetWildcard(topic) : GetTopicName(topic);
+			if (subscribed.insert(name).second) {
+				m_subscriptions[c].push_back(name);
+				m_nSubscriptionCount += 1;
+				m_nWildcardCount += wildcard ? 1 : 0;
+			}
+		}
+	}
+
+	m_streams.clear();
+}
+
+void
+WorkloadGenerator::Report() {
+	// share of the subscriptions drawn from the most popular 1% of the topics
+	uint32_t top = std::max(m_nTopics / 100, 1u);
+	double share = m_zipfCdf.empty() ? 0.0 : m_zipfCdf[top - 1] / m_zipfCdf.back();
+
+	NS_LOG_INFO(stringf("Workload Topics:                %8u", m_nTopics));
+	NS_LOG_INFO(stringf("Workload Producers:             %8u", m_nProducers));
+	NS_LOG_INFO(stringf("Workload Consumers:             %8u", (uint32_t)m_subscriptions.size()));
+	NS_LOG_INFO(stringf("Workload SubscriptionCount:     %8u", m_nSubscriptionCount));
+	NS_LOG_INFO(stringf("Workload WildcardCount:         %8u", m_nWildcardCount));
+	NS_LOG_INFO(stringf("Workload Top1%%Popularity:       %8.3f", share));
+	NS_LOG_INFO(stringf("Workload PublishCount:          %8u", m_nPublishCount));
+	NS_LOG_INFO(stringf("Workload BurstCount:            %8u", m_nBurstCount));
+}
+
+/**
+ * /p{topic % RootFanOut}/p{..}/.../topic-{topic}
+ */
+std::string
+WorkloadGenerator::GetTopicName(uint32_t topic) const {
+	uint32_t rootFanOut = 0 < m_nRootFanOut ? m_nRootFanOut : m_nFanOut;
+	uint32_t rest = topic;
+	std::string name;
+
+	for (uint32_t level = 0; level < m_nDepth; level++) {
+		uint32_t fanOut = level == 0 ? rootFanOut : m_nFanOut;
+		name += stringf("/p%u", rest % fanOut);
+		rest /= fanOut;
+	}
+	name += stringf("/topic-%u", topic);
+
+	return name;
+}
+
+void
+WorkloadGenerator::GetPublishTopics(uint32_t index, std::vector<NameId> &topics) {
+	NameInterner &interner = NameInterner::Get();
+
+	for (uint32_t topic = index % m_nProducers; topic < m_nTopics; topic += m_nProducers) {
+		// Name으로 넣어야 interner에 uri 문자열이 한번 더 저장되지 않는다
+		NameId id = interner.intern(::ndn::Name(GetTopicName(topic)));
+		topics.push_back(id);
+
+		// topic 별 난수열: 다른 producer 의 publish 순서(MPI rank 분할)와 관계없이 같은 간격이 나온다
+		PublishStream &stream = m_streams[id];
+		stream.rng.seed(((uint64_t)m_seed << 32) ^ (topic * 0x9e3779b97f4a7c15ULL));
+		stream.burstLeft = 0;
+	}
+}
+
+const std::vector<std::string> &
+WorkloadGenerator::GetSubscriptions(uint32_t index) const {
+	static const std::vector<std::string> none;
+
+	return index < m_subscriptions.size() ? m_subscriptions[index] : none;
+}
+
+ns3::Time
+WorkloadGenerator::GetAdvertiseDelay(uint32_t n, uint32_t count) const {
+	if (count == 0) {
+		return ns3::Seconds(0);
+	}
+
+	return ns3::NanoSeconds(m_advertiseTime.GetNanoSeconds() / count * n);
+}
+
+ns3::Time
+WorkloadGenerator::NextPublishInterval(NameId topic) {
+	m_nPublishCount += 1;
+
+	if (m_publishProcess == PUBLISH_PERIODIC) {
+		return ns3::Seconds(1.0 / m_publishRate);
+	}
+
+	PublishStream &stream = m_streams[topic];
+
+	if (m_publishProcess == PUBLISH_POISSON) {
+		std::exponential_distribution<double> interval(m_publishRate);
+		return ns3::Seconds(interval(stream.rng));
+	}
+
+	uint32_t &left = stream.burstLeft;
+	if (0 < left) {
+		left -= 1;
+		return m_burstGap;
+	}
+
+	// 다음 burst: 평균 주기 BurstSize/PublishRate 에서 burst 길이를 뺀 만큼 쉰다
+	left = m_nBurstSize - 1;
+	m_nBurstCount += 1;
+
+	double idle = m_nBurstSize / m_publishRate - (m_nBurstSize - 1) * m_burstGap.GetSeconds();
+	if (idle <= 0.0) {
+		return m_burstGap;
+	}
+
+	std::exponential_distribution<double> interval(1.0 / idle);
+	return ns3::Seconds(interval(stream.rng));
+}
+
+uint32_t
+WorkloadGenerator::DrawTopic() {
+	std::uniform_real_distribution<double> uniform(0.0, m_zipfCdf.back());
+
+	std::vector<double>::iterator iter = std::lower_bound(m_zipfCdf.begin(), m_zipfCdf.end(), uniform(m_rng));
+	size_t rank = std::min((size_t)(iter - m_zipfCdf.begin()), m_zipfCdf.size() - 1);
+
+	return m_rankToTopic[rank];
+}
+
+/**
+ * topic 의 prefix 중 임의의 깊이(1..Depth)에 '*'를 붙인다. ex) /p3/p1/*
+ */
+std::string
+WorkloadGenerator::GetWildcard(uint32_t topic) {
+	std::uniform_int_distribution<uint32_t> depth(1, m_nDepth);
+	uint32_t level = depth(m_rng);
+
+	std::string name = GetTopicName(topic);
+	size_t at = 0;
+	for (uint32_t i = 0; i < level; i++) {
+		at = name.find('/', at + 1);
+	}
+
+	return name.substr(0, at + 1) + "*";
+}
@@ -0,0 +1,156 @@
+/*
+ * workload-generator.hpp
+ *
+ * seedable pub-sub workload for ProducerDrn/ConsumerDrn, instead of the topic lists of drn.cfg.
+ *
+ *  - namespace     : Topics names /p{a}/p{b}/.../topic-{i}, Depth prefix components, RootFanOut
+ *                    first components(the rendezvous placement key) and FanOut below them
+ *  - producers     : topic i is published by producer i % producers
+ *  - popularity    : subscriptions draw topics from a Zipf(ZipfExponent) distribution over a
+ *                    seeded permutation of the topics, so popular topics are spread over the prefixes
+ *  - subscriptions : Subscriptions per consumer, WildcardRatio of them are '{prefix}/*' of the
+ *                    drawn topic at a random depth
+ *  - publishing    : PublishRate publications per second per topic, periodic, poisson or bursty
+ *                    (BurstSize publications BurstGap apart, bursts separated so that the mean
+ *                    rate stays PublishRate)
+ *
+ * the same Seed gives the same topics, subscriptions and publish intervals. every topic draws its
+ * intervals from its own stream, so they do not depend on the order in which producers publish
+ * or on which producers run in the same MPI rank.
+ */
+
+#ifndef EXTENSIONS_WORKLOAD_GENERATOR_HPP_
+#define EXTENSIONS_WORKLOAD_GENERATOR_HPP_
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+#include "name-interner.hpp"
+
+class WorkloadGenerator : public ns3::Object
+{
+public:
+	static ns3::TypeId
+	GetTypeId();
+
+	WorkloadGenerator();
+
+	virtual
+	~WorkloadGenerator();
+
+	/**
+	 * @brief draw the topic popularity and the subscriptions of every consumer
+	 */
+	void
+	Generate(uint32_t producers, uint32_t consumers);
+
+	void
+	Report();
+
+	/**
+	 * @brief uri of topic i
+	 */
+	std::string
+	GetTopicName(uint32_t topic) const;
+
+	/**
+	 * @brief the topics published by producer index, interned
+	 */
+	void
+	GetPublishTopics(uint32_t index, std::vector<NameId> &topics);
+
+	/**
+	 * @brief the topics and wildcard prefixes subscribed by consumer index
+	 */
+	const std::vector<std::string> &
+	GetSubscriptions(uint32_t index) const;
+
+	/**
+	 * @brief delay of the first advertisement of the n-th of count topics of a producer,
+	 * spread over AdvertiseTime so that 10^5 PA do not leave at the same instant
+	 */
+	ns3::Time
+	GetAdvertiseDelay(uint32_t n, uint32_t count) const;
+
+	/**
+	 * @brief time until the next publication of topic
+	 */
+	ns3::Time
+	NextPublishInterval(NameId topic);
+
+	/**
+	 * @brief mean publications per second of a topic
+	 */
+	double
+	GetPublishRate() const {
+		return m_publishRate;
+	}
+
+private:
+	uint32_t
+	DrawTopic();
+
+	std::string
+	GetWildcard(uint32_t topic);
+
+	void
+	SetPublishProcess(const std::string &value);
+
+	std::string
+	GetPublishProcess() const;
+
+private:
+	enum PublishProcess {
+		PUBLISH_PERIODIC,
+		PUBLISH_POISSON,
+		PUBLISH_BURSTY
+	};
+
+	uint32_t m_seed;
+	uint32_t m_nTopics;
+	uint32_t m_nDepth;
+	uint32_t m_nRootFanOut;
+	uint32_t m_nFanOut;
+	double m_zipfExponent;
+	uint32_t m_nSubscriptions;
+	double m_wildcardRatio;
+	PublishProcess m_publishProcess;
+	double m_publishRate;
+	uint32_t m_nBurstSize;
+	ns3::Time m_burstGap;
+	ns3::Time m_advertiseTime;
+
+	std::mt19937_64 m_rng;
+
+	uint32_t m_nProducers;
+	// popularity rank -> topic
+	std::vector<uint32_t> m_rankToTopic;
+	// cumulative Zipf weights of the ranks
+	std::vector<double> m_zipfCdf;
+	std::vector<std::vector<std::string>> m_subscriptions;
+	struct PublishStream
+	{
+		PublishStream()
+			: burstLeft(0)
+		{
+		}
+
+		std::mt19937_64 rng;
+		// publications left in the current burst
+		uint32_t burstLeft;
+	};
+
+	// publish intervals of a topic, seeded by Seed and the topic
+	std::unordered_map<NameId, PublishStream> m_streams;
+
+	uint32_t m_nSubscriptionCount;
+	uint32_t m_nWildcardCount;
+	uint32_t m_nPublishCount;
+	uint32_t m_nBurstCount;
+};
+
+#endif /* EXTENSIONS_WORKLOAD_GENERATOR_HPP_ */
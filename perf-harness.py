@@ -0,0 +1,159 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# simulator cost of drn-rocketfuel and drnf-rocketfuel over a fixed scenario matrix
+#
+#   ./perf-harness.py                         run the matrix, write results/perf.json and compare with the baseline
+#   ./perf-harness.py --save-baseline         ... and save the results as the new baseline
+#   ./perf-harness.py --runs drnf-1221-sm10   only the named runs
+#   ./perf-harness.py --csv                   results as csv on stdout
+#
+# each run writes its measurements with --stats=<file>(extensions/sim-stats.hpp): wall time of Simulator::Run(),
+# events executed, events/s, peak RSS, heap after the run and install bytes per app type.
+# a run regresses when its wall time, peak RSS or bytes per app grow, or its events/s drops, by more than --threshold.
+
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+TOPOLOGY = 'topologies/bw-delay-rand-1/%s.r0-conv-annotated.txt'
+
+# (name, scenario, arguments)
+MATRIX = [
+    ('drn-1221-sm10', 'drn-rocketfuel', ['--topology=' + TOPOLOGY % '1221', '--sm=10', '--ds=20', '--duration=60']),
+    ('drn-1221-sm100', 'drn-rocketfuel', ['--topology=' + TOPOLOGY % '1221', '--sm=100', '--ds=200', '--duration=60']),
+    ('drn-1239-sm100', 'drn-rocketfuel', ['--topology=' + TOPOLOGY % '1239', '--sm=100', '--ds=200', '--duration=60']),
+    ('drnf-1221-sm10', 'drnf-rocketfuel', ['--topology=' + TOPOLOGY % '1221', '--config=drn.cfg', '--sm=10', '--ds=20', '--duration=60', '--seed=1']),
+    ('drnf-1221-sm100', 'drnf-rocketfuel', ['--topology=' + TOPOLOGY % '1221', '--config=drn.cfg', '--sm=100', '--ds=200', '--duration=60', '--seed=1']),
+    ('drnf-1239-sm100', 'drnf-rocketfuel', ['--topology=' + TOPOLOGY % '1239', '--config=drn.cfg', '--sm=100', '--ds=200', '--duration=60', '--seed=1']),
+    ('drnf-1239-w1000', 'drnf-rocketfuel', ['--topology=' + TOPOLOGY % '1239', '--config=drn.cfg', '--workload=1000', '--w_producers=20',
+                                            '--w_consumers=50', '--duration=60', '--seed=1']),
+]
+
+# (key, larger is worse)
+METRICS = [
+    ('wall_s', True),
+    ('events_per_s', False),
+    ('peak_rss_bytes', True),
+]
+
+parser = argparse.ArgumentParser(description='DRN scenario performance harness')
+parser.add_argument('--runs', type=str, default='', help='comma separated run names(default: the whole matrix)')
+parser.add_argument('--repeat', type=int, default=1, help='runs of each entry, the fastest one is kept')
+parser.add_argument('--output', type=str, default='results/perf.json', help='results file')
+parser.add_argument('--baseline', type=str, default='results/perf-baseline.json', help='baseline file')
+parser.add_argument('--save-baseline', dest='save', action='store_true', default=False, help='save the results as the baseline')
+parser.add_argument('--threshold', type=float, default=0.10, help='relative change that is a regression')
+parser.add_argument('--csv', dest='csv', action='store_true', default=False, help='csv output')
+parser.add_argument('--list', dest='list', action='store_true', default=False, help='list the matrix')
+args = parser.parse_args()
+
+if args.list:
+    for name, scenario, arguments in MATRIX:
+        print('%-18s %s %s' % (name, scenario, ' '.join(arguments)))
+    sys.exit(0)
+
+names = [name for name in args.runs.split(',') if name]
+matrix = [entry for entry in MATRIX if not names or entry[0] in names]
+if not matrix:
+    print('no run matches %s, see --list' % args.runs, file=sys.stderr)
+    sys.exit(1)
+
+def simulate(name, scenario, arguments):
+    fd, statsPath = tempfile.mkstemp(prefix='drn-stats-', suffix='.json')
+    os.close(fd)
+    logPath = os.path.join(os.path.dirname(args.output) or '.', 'perf-%s.log' % name)
+    try:
+        with open(logPath, 'w') as log:
+            code = subprocess.call(['./build/%s' % scenario] + arguments + ['--stats=' + statsPath], stdout=log, stderr=subprocess.STDOUT)
+        if code != 0:
+            print('%s: exit code %d, see %s' % (name, code, logPath), file=sys.stderr)
+            return None
+        with open(statsPath) as f:
+            return json.load(f)
+    finally:
+        os.remove(statsPath)
+
+def bytesPerApp(run, kind):
+    apps = run.get('apps', {}).get(kind)
+    return apps['bytes_per_app'] if apps else 0
+
+if os.path.dirname(args.output) and not os.path.isdir(os.path.dirname(args.output)):
+    os.makedirs(os.path.dirname(args.output))
+
+results = []
+for name, scenario, arguments in matrix:
+    best = None
+    for i in range(args.repeat):
+        print('%s(%d/%d): %s %s' % (name, i + 1, args.repeat, scenario, ' '.join(arguments)), file=sys.stderr)
+        run = simulate(name, scenario, arguments)
+        if run is not None and (best is None or run['wall_s'] < best['wall_s']):
+            best = run
+    if best is None:
+        continue
+    best['name'] = name
+    best['arguments'] = arguments
+    results.append(best)
+
+with open(args.output, 'w') as f:
+    json.dump({'runs': results}, f, indent=2, sort_keys=True)
+
+baseline = {}
+try:
+    with open(args.baseline) as f:
+        baseline = dict((run['name'], run) for run in json.load(f)['runs'])
+except (IOError, ValueError, KeyError):
+    print('no baseline %s' % args.baseline, file=sys.stderr)
+
+# 결과 표와 baseline 대비 변화
+columns = ['name', 'wall_s', 'events', 'events_per_s', 'peak_rss_mb', 'rn_bytes', 'producer_bytes', 'consumer_bytes', 'status']
+rows = []
+regressions = 0
+for run in results:
+    status = []
+    base = baseline.get(run['name'])
+    if base is not None:
+        if base['events'] != run['events']:
+            status.append('events %+d' % (run['events'] - base['events']))
+        checks = [(key, worse, run[key], base[key]) for key, worse in METRICS]
+        checks += [(kind + '_bytes', True, bytesPerApp(run, kind), bytesPerApp(base, kind)) for kind in ('rendezvous', 'producer', 'consumer')]
+        for key, worse, value, reference in checks:
+            if reference <= 0:
+                continue
+            change = float(value - reference) / reference
+            if (change if worse else -change) > args.threshold:
+                status.append('REGRESSION %s %+.1f%%' % (key, change * 100))
+                regressions += 1
+    rows.append([
+        run['name'],
+        '%.3f' % run['wall_s'],
+        str(run['events']),
+        '%.0f' % run['events_per_s'],
+        '%.1f' % (run['peak_rss_bytes'] / 1048576.0),
+        '%.0f' % bytesPerApp(run, 'rendezvous'),
+        '%.0f' % bytesPerApp(run, 'producer'),
+        '%.0f' % bytesPerApp(run, 'consumer'),
+        '; '.join(status) if status else ('ok' if base is not None else 'new'),
+    ])
+
+if args.csv:
+    out = csv.writer(sys.stdout)
+    out.writerow(columns)
+    out.writerows(rows)
+else:
+    print('%-18s %9s %12s %12s %12s %10s %14s %14s  %s' % tuple(columns))
+    for row in rows:
+        print('%-18s %9s %12s %12s %12s %10s %14s %14s  %s' % tuple(row))
+
+if args.save:
+    with open(args.baseline, 'w') as f:
+        json.dump({'runs': results}, f, indent=2, sort_keys=True)
+    print('baseline saved to %s' % args.baseline, file=sys.stderr)
+
+sys.exit(1 if regressions and not args.save else 0)
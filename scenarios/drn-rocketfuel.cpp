@@ -33,6 +33,13 @@
 
 #include "ns3-dev/ns3/ndnSIM/utils/topology/rocketfuel-map-reader.hpp"
 
+#include "extensions/churn-generator.hpp"
+#include "extensions/memory-sampler.hpp"
+#include "extensions/scope-profiler.hpp"
+#include "extensions/sim-stats.hpp"
+#include "extensions/topology-proximity.hpp"
+#include "extensions/ndn-producer-drn.hpp"
+#include "extensions/ndn-rendezvous-drn.hpp"
 #include "extensions/utils.hpp"
 
 namespace ns3 {
@@ -50,6 +57,8 @@ int g_simulationTime = 300;
 
 string g_zPRandomize("none");
 double g_fPFrequency = 1.0;
+// DP Interests in flight per topic(0: the next item is generated after the DP Data)
+uint32_t g_nPWindow = 0;
 
 double g_nRStart = 3.0;
 double g_nPStart = 5.0;
@@ -57,6 +66,29 @@ double g_nCStart = 8.0;
 
 bool g_infoonly = false;
 
+// rendezvous churn(events per second), 0 이면 사용하지 않는다
+double g_fChurnJoin = 0.0;
+double g_fChurnLeave = 0.0;
+double g_fChurnFail = 0.0;
+uint32_t g_nChurnRadius = 0;
+double g_fChurnRepair = 0.0;
+double g_nChurnStart = 30.0;
+std::string g_churnTrace("");
+
+// rendezvous placement: random, centrality, kmedian
+std::string g_placement("random");
+// proximity neighbour selection of chord fingers
+bool g_pns = false;
+// random lookups per rendezvous for the stretch report(0: none)
+uint32_t g_stretchSamples = 100;
+// time series of the app state table sizes(empty: none)
+std::string g_memory("");
+double g_fMemoryInterval = 10.0;
+// collapsed stacks of the handler profiler, for flamegraph.pl(empty: no profiling)
+std::string g_profile("");
+// json file of the simulator cost(wall time, events/s, peak RSS, per-app memory) of the run(empty: none)
+std::string g_stats("");
+
 std::vector<std::tuple<int, int>> g_rendezvousIds;
 std::vector<std::tuple<int, int>> g_producerIds;
 std::vector<std::tuple<int, int>> g_consumerIds;
@@ -202,6 +234,80 @@ addToContainer(NodeContainer &container, std::vector<Ptr<Node>> &nodes, int sele
 	}
 }
 
+/**
+ * 실행 중인 rendezvous 의 finger/successor 로 lookup 경로를 따라가서 stretch 를 계산한다.
+ */
+void
+measureStretch(Ptr<TopologyProximity> proximity, std::vector<Ptr<RendezvousDrn>> apps) {
+	std::map<std::string, NodeInformation *> ring;
+
+	std::vector<Ptr<RendezvousDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		RendezvousDHT *dht = (*iter)->GetDht();
+		if (dht != 0 && dht->m_dhtNode.getStatus()) {
+			ring[dht->m_dhtNode.m_nodeName] = &dht->m_dhtNode;
+		}
+	}
+
+	proximity->MeasureStretch(ring, g_stretchSamples);
+}
+
+/**
+ * rendezvous 별 요청(TS, TM, DM, DR) 수의 최대/평균 비. 1에 가까울수록 고르게 분산된 것이다.
+ */
+void
+reportLoad(std::vector<Ptr<RendezvousDrn>> apps) {
+	uint32_t total = 0;
+	uint32_t max = 0;
+
+	std::vector<Ptr<RendezvousDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		uint32_t load = (*iter)->GetLoad();
+		total += load;
+		max = std::max(max, load);
+	}
+
+	if (apps.size() == 0 || total == 0) {
+		return;
+	}
+
+	double mean = (double)total / apps.size();
+	NS_LOG_UNCOND(stringf("rendezvous load: max %u, mean %.2f, max/mean %.3f", max, mean, max / mean));
+}
+
+/**
+ * producer 전체의 publish rate: 설정된 목표, DP Data로 확인된 rate, 그리고 DP Data 마다 다음 item을 만들 때의
+ * 상한(topic 수 / (주기 + RTT))
+ */
+void
+reportPublish(std::vector<Ptr<ProducerDrn>> apps) {
+	double target = 0, achieved = 0, bound = 0, rttSum = 0;
+	uint64_t rttCount = 0, retransmitted = 0;
+
+	std::vector<Ptr<ProducerDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		const PublishStats &stats = (*iter)->GetPublishStats();
+		if (stats.seconds <= 0 || stats.topics == 0 || stats.targetRate <= 0) {
+			continue;
+		}
+		double rtt = (0 < stats.rttCount) ? stats.rttSum / stats.rttCount : 0;
+		target += stats.targetRate;
+		achieved += stats.acknowledged / stats.seconds;
+		bound += stats.topics / (stats.topics / stats.targetRate + rtt);
+		rttSum += stats.rttSum;
+		rttCount += stats.rttCount;
+		retransmitted += stats.retransmitted;
+	}
+
+	if (target <= 0) {
+		return;
+	}
+
+	NS_LOG_UNCOND(stringf("publish rate: target %.2f/s, achieved %.2f/s(%.1f%%), ack-clocked bound %.2f/s, RTT %.2fms, retransmitted %llu",
+			target, achieved, achieved * 100 / target, bound, (0 < rttCount) ? rttSum * 1000 / rttCount : 0.0,
+			(unsigned long long)retransmitted));
+}
+
 int parse_arguments(int argc, char *argv[]) {
 	// Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
 	CommandLine cmd;
@@ -215,9 +321,24 @@ int parse_arguments(int argc, char *argv[]) {
 	cmd.AddValue ("duration", "Duration of simulation", g_simulationTime);
 	cmd.AddValue ("p_random", "Type of send time randomization: none (default), uniform, exponential", g_zPRandomize);
 	cmd.AddValue ("p_freq", "Frequency of topic generation / interest packets", g_fPFrequency);
+	cmd.AddValue ("p_window", "DP Interests in flight per topic, generation runs on its own clock(0: next item after the DP Data)", g_nPWindow);
 	cmd.AddValue ("c_start", "consumer's start time", g_nCStart);
 	cmd.AddValue ("p_start", "producer's start time", g_nPStart);
 	cmd.AddValue ("r_start", "rendezvous's start time", g_nRStart);
+	cmd.AddValue ("churn_join", "Rate(per second) of rendezvous joins", g_fChurnJoin);
+	cmd.AddValue ("churn_leave", "Rate(per second) of rendezvous graceful leaves", g_fChurnLeave);
+	cmd.AddValue ("churn_fail", "Rate(per second) of rendezvous crash failures", g_fChurnFail);
+	cmd.AddValue ("churn_radius", "Hops around a crashed rendezvous that fail together", g_nChurnRadius);
+	cmd.AddValue ("churn_repair", "Mean repair time(seconds) of crashed rendezvous, 0: never", g_fChurnRepair);
+	cmd.AddValue ("churn_start", "churn's start time", g_nChurnStart);
+	cmd.AddValue ("churn_trace", "churn trace file(<seconds> <join|leave|fail|recover> <node name>)", g_churnTrace);
+	cmd.AddValue ("placement", "rendezvous placement: random (default), centrality, kmedian", g_placement);
+	cmd.AddValue ("pns", "proximity neighbour selection of chord fingers", g_pns);
+	cmd.AddValue ("stretch_samples", "random lookups per rendezvous for the stretch report", g_stretchSamples);
+	cmd.AddValue ("memory", "Time series file of the entries and bytes of the app state tables(empty: none)", g_memory);
+	cmd.AddValue ("memory_interval", "Seconds between the memory samples", g_fMemoryInterval);
+	cmd.AddValue ("profile", "Collapsed stack file of the handler profiler, prints the ranked handler table(empty: no profiling)", g_profile);
+	cmd.AddValue ("stats", "Json file of wall time, events/s, peak RSS and per-app memory, read by perf-harness.py(empty: none)", g_stats);
 	cmd.AddValue ("infoonly", "only print of topology node info.", g_infoonly);
 	cmd.Parse(argc, argv);
 
@@ -236,9 +357,24 @@ int parse_arguments(int argc, char *argv[]) {
 	NS_LOG_UNCOND("--duration      : " << g_simulationTime);
 	NS_LOG_UNCOND("--p_random      : " << g_zPRandomize);
 	NS_LOG_UNCOND("--p_freq        : " << g_fPFrequency);
+	NS_LOG_UNCOND("--p_window      : " << g_nPWindow);
 	NS_LOG_UNCOND("--c_start       : " << g_nPStart);
 	NS_LOG_UNCOND("--p_start       : " << g_nCStart);
 	NS_LOG_UNCOND("--r_start       : " << g_nRStart);
+	NS_LOG_UNCOND("--churn_join    : " << g_fChurnJoin);
+	NS_LOG_UNCOND("--churn_leave   : " << g_fChurnLeave);
+	NS_LOG_UNCOND("--churn_fail    : " << g_fChurnFail);
+	NS_LOG_UNCOND("--churn_radius  : " << g_nChurnRadius);
+	NS_LOG_UNCOND("--churn_repair  : " << g_fChurnRepair);
+	NS_LOG_UNCOND("--churn_start   : " << g_nChurnStart);
+	NS_LOG_UNCOND("--churn_trace   : " << g_churnTrace);
+	NS_LOG_UNCOND("--placement     : " << g_placement);
+	NS_LOG_UNCOND("--pns           : " << g_pns);
+	NS_LOG_UNCOND("--stretch_samples: " << g_stretchSamples);
+	NS_LOG_UNCOND("--memory        : " << g_memory);
+	NS_LOG_UNCOND("--memory_interval: " << g_fMemoryInterval);
+	NS_LOG_UNCOND("--profile       : " << g_profile);
+	NS_LOG_UNCOND("--stats         : " << g_stats);
 	NS_LOG_UNCOND("--infoonly      : " << g_infoonly);
 
 	if (0 < g_rendezvousIndexes.size()) {
@@ -273,6 +409,7 @@ int
 main(int argc, char* argv[])
 {
 	int retval;
+	SimStats stats;
 
 	// setting default parameters for PointToPoint links and channels
 //	Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
@@ -284,6 +421,13 @@ main(int argc, char* argv[])
 		return retval;
 	}
 
+	stats.setParameter("scenario", "drn-rocketfuel");
+	stats.setParameter("topology", g_topology);
+	stats.setParameter("sm", g_numberOfSubscribeMessages);
+	stats.setParameter("ds", g_numberOfDataStream);
+	stats.setParameter("duration", g_simulationTime);
+	stats.setParameter("pns", g_pns);
+
     // Print Simulation Topology, Command Line Variables
     NS_LOG_UNCOND("simulation topology : " << g_topology);
 
@@ -299,6 +443,10 @@ main(int argc, char* argv[])
 	topologyReader.SetFileName(g_topology);
 	NodeContainer nodeContainer = topologyReader.Read();
 
+	// link delay 기반 underlay 거리
+	Ptr<TopologyProximity> proximity = CreateObject<TopologyProximity>();
+	proximity->Build(nodeContainer);
+
 	// Install NDN stack on all nodes
 	ndn::StackHelper ndnHelper;
 	ndnHelper.SetDefaultRoutes(true);
@@ -337,7 +485,15 @@ main(int argc, char* argv[])
 	std::vector<Ptr<Node>> rendezvousNodes;
 	NodeContainer rendezvousContainer;
 	selectNodes(rendezvousNodes, leafNode, g_rendezvousIds);
-	addToContainer(rendezvousContainer, rendezvousNodes, g_rendezvousCount);
+	if (0 < g_rendezvousCount && g_placement.compare("centrality") == 0) {
+		std::vector<Ptr<Node>> placed = proximity->SelectByCentrality(rendezvousNodes, leafNode, g_rendezvousCount);
+		addToContainer(rendezvousContainer, placed, 0);
+	} else if (0 < g_rendezvousCount && g_placement.compare("kmedian") == 0) {
+		std::vector<Ptr<Node>> placed = proximity->SelectByKMedian(rendezvousNodes, leafNode, g_rendezvousCount);
+		addToContainer(rendezvousContainer, placed, 0);
+	} else {
+		addToContainer(rendezvousContainer, rendezvousNodes, g_rendezvousCount);
+	}
 
 	for (int index = 0; index < (int)rendezvousContainer.size(); index++) {
 		Ptr<Node> node = rendezvousContainer[index];
@@ -386,8 +542,25 @@ main(int argc, char* argv[])
 //	consumerHelper.SetAttribute("TotalDataStream", UintegerValue(g_numberOfDataStream)); // 200 DS
 	//consumerHelper.Install(nodes.Get(0)).Start(Seconds(10.0));
 
+	// Rendezvous churn
+	Ptr<ChurnGenerator> churnGenerator = CreateObject<ChurnGenerator>();
+	churnGenerator->SetAttribute("JoinRate", DoubleValue(g_fChurnJoin));
+	churnGenerator->SetAttribute("LeaveRate", DoubleValue(g_fChurnLeave));
+	churnGenerator->SetAttribute("FailureRate", DoubleValue(g_fChurnFail));
+	churnGenerator->SetAttribute("FailureRadius", UintegerValue(g_nChurnRadius));
+	churnGenerator->SetAttribute("RepairTime", TimeValue(Seconds(g_fChurnRepair)));
+	churnGenerator->SetAttribute("StartTime", TimeValue(Seconds(g_nChurnStart)));
+	churnGenerator->SetAttribute("StopTime", TimeValue(Seconds(g_simulationTime-10.0)));
+	churnGenerator->SetAttribute("TraceFile", StringValue(g_churnTrace));
+
+	if (g_pns) {
+		rendezvousHelper.SetAttribute("Proximity", PointerValue(proximity));
+	}
+	std::vector<Ptr<RendezvousDrn>> rendezvousApps;
+
 	std::string predecessor;
 	int rnSeq = 0;
+	stats.beginApps();
 	NodeContainer::Iterator rendezvousIter = rendezvousContainer.Begin();
 	for (; rendezvousIter != rendezvousContainer.End(); rendezvousIter++) {
 		uint32_t nodeId = (*rendezvousIter)->GetId();
@@ -407,10 +580,23 @@ main(int argc, char* argv[])
 		container.Start(Seconds(g_nRStart+rnSeq));
 		container.Stop(Seconds(g_simulationTime-1.0));
 
+		Ptr<RendezvousDrn> app = DynamicCast<RendezvousDrn>(container.Get(0));
+		rendezvousApps.push_back(app);
+		// chord 노드 이름은 '/' 가 없는 RN-{nnnnn}
+		proximity->AddName(drnNodePrefix.substr(1), *rendezvousIter);
+
+		// ring을 생성한 첫번째 RN은 churn 대상에서 제외한다
+		if(rnSeq != 0) {
+			churnGenerator->AddTarget(*rendezvousIter,
+					MakeCallback(&RendezvousDrn::StartApplication, app), MakeCallback(&RendezvousDrn::StopApplication, app),
+					Seconds(g_nRStart+rnSeq));
+		}
+
 //		ndnGlobalRoutingHelper.AddOrigins(drnNodePrefix, rendezvousContainer);
 
 		rnSeq += 1;
 	}
+	stats.endApps("rendezvous", rendezvousApps.size());
 
 	// Producer
 	ndn::AppHelper producerHelper("ProducerDrn");
@@ -418,9 +604,12 @@ main(int argc, char* argv[])
 	producerHelper.SetAttribute("TotalDataStream", UintegerValue(g_numberOfDataStream));
 	producerHelper.SetAttribute("Randomize", StringValue(g_zPRandomize));
 	producerHelper.SetAttribute("Frequency", DoubleValue(g_fPFrequency));
+	producerHelper.SetAttribute("PublishWindow", UintegerValue(g_nPWindow));
 	//producerHelper.Install(nodes.Get(2)).Start(Seconds(2.0)); // last node
 
 	//producerApp.Install(producerContainer).Start(Seconds(5));
+	std::vector<Ptr<ProducerDrn>> producerApps;
+	stats.beginApps();
 	NodeContainer::Iterator producerIter = producerContainer.Begin();
 	for (; producerIter != producerContainer.End(); producerIter++) {
 		uint32_t nodeId = (*producerIter)->GetId();
@@ -433,7 +622,9 @@ main(int argc, char* argv[])
 		ApplicationContainer container = producerHelper.Install(*producerIter);
 		container.Start(Seconds(g_nPStart));
 		container.Stop(Seconds(g_simulationTime-5.0));
+		producerApps.push_back(DynamicCast<ProducerDrn>(container.Get(0)));
 	}
+	stats.endApps("producer", producerContainer.size());
 
 	// Consumer
 	ndn::AppHelper consumerHelper("ConsumerDrn");
@@ -443,6 +634,7 @@ main(int argc, char* argv[])
 	//consumerHelper.Install(nodes.Get(0)).Start(Seconds(10.0));
 
 	//consumerApp.Install(consumerContainer).Start(Seconds(8));
+	stats.beginApps();
 	NodeContainer::Iterator consumerIter = consumerContainer.Begin();
 	for (; consumerIter != consumerContainer.End(); consumerIter++) {
 		consumerHelper.SetAttribute("TopicPrefix", StringValue("/a/b/*"));
@@ -452,6 +644,7 @@ main(int argc, char* argv[])
 		container.Start(Seconds(g_nCStart));
 		container.Stop(Seconds(g_simulationTime-5.0));
 	}
+	stats.endApps("consumer", consumerContainer.size());
 
 	rendezvousIter = rendezvousContainer.Begin();
 	for (; rendezvousIter != rendezvousContainer.End(); rendezvousIter++) {
@@ -468,7 +661,51 @@ main(int argc, char* argv[])
 
 	Simulator::Stop(Seconds(g_simulationTime));
 
+	// rendezvous 가 멈추기 직전의 ring 으로 측정한다
+	if (0 < g_stretchSamples) {
+		Simulator::Schedule(Seconds(g_simulationTime-2.0), &measureStretch, proximity, rendezvousApps);
+	}
+
+	if (churnGenerator->Install() != 0) {
+		Simulator::Destroy();
+		return -1;
+	}
+
+	Ptr<MemorySampler> memorySampler = CreateObject<MemorySampler>();
+	memorySampler->SetAttribute("File", StringValue(g_memory));
+	memorySampler->SetAttribute("Interval", TimeValue(Seconds(g_fMemoryInterval)));
+	if (0 < g_memory.size() && memorySampler->Install() != 0) {
+		NS_LOG_UNCOND("cannot open " << g_memory << ": " << strerror(errno));
+		Simulator::Destroy();
+		return 1;
+	}
+
+	if (0 < g_profile.size()) {
+		ScopeProfiler::Get().enable();
+	}
+	stats.beginRun();
 	Simulator::Run();
+	stats.endRun();
+	ScopeProfiler::Get().disable();
+
+	churnGenerator->Report();
+	memorySampler->Report();
+	if (0 < g_stretchSamples) {
+		NS_LOG_UNCOND(stringf("stretch: %.3f (max %.3f), overlay hops: %.3f, lookups: %u",
+				proximity->GetMeanStretch(), proximity->GetMaxStretch(), proximity->GetMeanOverlayHops(), proximity->GetStretchCount()));
+	}
+	reportLoad(rendezvousApps);
+	reportPublish(producerApps);
+	stats.report();
+	if (0 < g_profile.size()) {
+		ScopeProfiler::Get().report();
+		if (ScopeProfiler::Get().writeCollapsed(g_profile) != 0) {
+			NS_LOG_UNCOND("cannot write " << g_profile << ": " << strerror(errno));
+		}
+	}
+	if (0 < g_stats.size() && stats.write(g_stats) != 0) {
+		NS_LOG_UNCOND("cannot write " << g_stats << ": " << strerror(errno));
+	}
 	Simulator::Destroy();
 
 	return 0;
@@ -25,16 +25,37 @@
 #include <tuple>
 #include <regex>
 #include <random>
+#include <chrono>
+
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/ndnSIM-module.h"
+#ifdef DRN_MPI
+#include "ns3/mpi-interface.h"
+#endif
 
 #include "ns3-dev/ns3/ndnSIM/utils/topology/rocketfuel-map-reader.hpp"
 
 #include "extensions/object-container.hpp"
 
+#include "extensions/churn-generator.hpp"
+#include "extensions/cs-counter.hpp"
+#include "extensions/event-tracer.hpp"
+#include "extensions/workload-generator.hpp"
+#include "extensions/route-cache.hpp"
+#include "extensions/route-calculator.hpp"
+#include "extensions/memory-sampler.hpp"
+#include "extensions/scope-profiler.hpp"
+#include "extensions/sim-stats.hpp"
+#include "extensions/topology-proximity.hpp"
+#include "extensions/topology-partition.hpp"
+#include "extensions/ndn-consumer-drn.hpp"
+#include "extensions/ndn-producer-drn.hpp"
+#include "extensions/ndn-rendezvous-drn-f.hpp"
 #include "extensions/utils.hpp"
 
 namespace ns3 {
@@ -58,6 +79,17 @@ int g_packetSize=100;
 
 string g_zPRandomize("uniform");
 double g_fPFrequency = 1.0;
+// DP Interests in flight per topic(0: the next item is generated after the DP Data)
+uint32_t g_nPWindow = 0;
+// coalesced publish: items per DP Interest and the longest wait(microseconds) of a partial batch
+uint32_t g_nCoalesceCount = 1;
+uint32_t g_nCoalesceDelay = 0;
+// large objects: bytes per DP/DR segment(0: one packet per item) and segments in flight per object
+uint32_t g_nSegmentSize = 0;
+uint32_t g_nSegmentWindow = 8;
+// TM answer: front coded TLV manifest instead of the text list, and its bytes per page
+bool g_bBinaryManifest = false;
+uint32_t g_nManifestPage = 7000;
 
 string g_zCRandomize("uniform");
 double g_fCFrequency = 1.0;
@@ -68,6 +100,81 @@ double g_nCStart = 8.0;
 
 bool g_infoonly = false;
 
+// rendezvous churn(events per second), 0 이면 사용하지 않는다
+double g_fChurnJoin = 0.0;
+double g_fChurnLeave = 0.0;
+double g_fChurnFail = 0.0;
+uint32_t g_nChurnRadius = 0;
+double g_fChurnRepair = 0.0;
+double g_nChurnStart = 30.0;
+std::string g_churnTrace("");
+
+// rendezvous placement: random, centrality, kmedian
+std::string g_placement("random");
+
+// two level rendezvous: consumers send DM/DR through their regional RN
+bool g_regional = false;
+double g_fRegionalCache = 1.0;
+
+// cacheable TS/TM: slot(seconds) of the TS/TM names and FreshnessPeriod(seconds) of the answers(0: none)
+double g_fManifestSlot = 0.0;
+double g_fTSFreshness = 0.0;
+double g_fTMFreshness = 0.0;
+double g_fDMFreshness = 0.0;
+double g_fDRFreshness = 0.0;
+// content store entries per node
+uint32_t g_nCsSize = 100;
+// TM/DM without an answer: negative reply with a retry-after(seconds) hint, consumer backoff cap(seconds)
+bool g_bNegativeReply = false;
+double g_fRetryAfter = 0.5;
+double g_fMaxBackoff = 8.0;
+double g_fMaxBackoffDM = 2.0;
+
+// producer startup: topics per PA/PU Interest(1: one topic per Interest), PA Interests per second(0: at once)
+uint32_t g_nAdvertiseBatch = 1;
+double g_fAdvertiseRate = 0.0;
+
+// hot topic replication: owners per hot topic(1: none), TS/TM requests per 10s that make a topic hot
+uint32_t g_nReplicas = 1;
+uint32_t g_nHotThreshold = 100;
+
+// generated workload of g_nWorkloadTopics topics instead of the producer/consumer topics of the config file(0: config file)
+uint32_t g_nWorkloadTopics = 0;
+uint32_t g_nWorkloadProducers = 10;
+uint32_t g_nWorkloadConsumers = 10;
+uint32_t g_nWorkloadSubs = 10;
+double g_fWorkloadZipf = 1.0;
+double g_fWorkloadWildcard = 0.0;
+string g_zWorkloadPublish("poisson");
+double g_fWorkloadRate = 0.2;
+
+// seed of the workload and of the node selection(0: random)
+uint32_t g_nSeed = 0;
+
+// directory of the cached FIBs of topology + origins(empty: always calculate routes)
+std::string g_routeCache("");
+// threads of the parallel route calculation(0: GlobalRoutingHelper::CalculateRoutes)
+uint32_t g_nRouteThreads = 0;
+// compare the FIB of RouteCalculator with the one of GlobalRoutingHelper::CalculateRoutes per node and prefix
+bool g_bRouteCheck = false;
+
+// binary event trace file(empty: no trace) and its ring buffer records
+std::string g_trace("");
+uint64_t g_nTraceRecords = 1 << 20;
+
+// time series of the app state table sizes(empty: none)
+std::string g_memory("");
+double g_fMemoryInterval = 10.0;
+
+// collapsed stacks of the handler profiler, for flamegraph.pl(empty: no profiling)
+std::string g_profile("");
+
+// json file of the simulator cost(wall time, events/s, peak RSS, per-app memory) of the run(empty: none)
+std::string g_stats("");
+
+// distributed simulation over MPI ranks(./waf --run ... --mpi=<ranks> adds --mpi=1)
+bool g_mpi = false;
+
 std::vector<std::tuple<int, int>> g_rendezvousIds;
 std::vector<std::tuple<int, int>> g_producerIds;
 std::vector<std::tuple<int, int>> g_consumerIds;
@@ -202,8 +309,9 @@ selectNodes(std::vector<Ptr<Node>> &selectedNodes, std::vector<Ptr<Node>> &leafN
 void
 addToContainer(NodeContainer &container, std::vector<Ptr<Node>> &nodes, int selectCount) {
 	// random
-	std::random_device rd;
-	std::mt19937 g(rd());
+	// producer 와 consumer 가 같은 seed 로 같은 노드를 고르지 않도록 호출간에 이어서 사용한다
+	static std::random_device rd;
+	static std::mt19937 g(0 < g_nSeed ? g_nSeed : rd());
 
 	if (0 < selectCount) {
 		std::shuffle(nodes.begin(), nodes.end(), g);
@@ -346,6 +454,201 @@ ReadConfig(std::string fileName) {
     return 0;
 }
 
+/**
+ * rendezvous 별 요청(TS, TM, DM, DR) 수의 최대/평균 비. 1에 가까울수록 고르게 분산된 것이다.
+ */
+void
+reportLoad(std::vector<Ptr<RendezvousDrnF>> apps) {
+	uint32_t total = 0;
+	uint32_t max = 0;
+	uint32_t manifest = 0;
+	uint32_t manifestMax = 0;
+
+	std::vector<Ptr<RendezvousDrnF>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		uint32_t load = (*iter)->GetLoad();
+		total += load;
+		max = std::max(max, load);
+
+		manifest += (*iter)->GetManifestLoad();
+		manifestMax = std::max(manifestMax, (*iter)->GetManifestLoad());
+	}
+
+	if (apps.size() == 0 || total == 0) {
+		return;
+	}
+
+	double mean = (double)total / apps.size();
+	NS_LOG_UNCOND(stringf("rendezvous load: max %u, mean %.2f, max/mean %.3f", max, mean, max / mean));
+	// cache 되지 않고 owner 까지 온 TS/TM
+	NS_LOG_UNCOND(stringf("owner TS/TM load: total %u, max %u", manifest, manifestMax));
+}
+
+/**
+ * producer 전체의 publish rate: 설정된 목표, DP Data로 확인된 rate, 그리고 DP Data 마다 다음 item을 만들 때의
+ * 상한(topic 수 / (주기 + RTT))
+ */
+void
+reportPublish(std::vector<Ptr<ProducerDrn>> apps) {
+	double target = 0, achieved = 0, bound = 0, rttSum = 0;
+	uint64_t rttCount = 0, retransmitted = 0, interests = 0, acknowledged = 0;
+
+	std::vector<Ptr<ProducerDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		const PublishStats &stats = (*iter)->GetPublishStats();
+		if (stats.seconds <= 0 || stats.topics == 0 || stats.targetRate <= 0) {
+			continue;
+		}
+		double rtt = (0 < stats.rttCount) ? stats.rttSum / stats.rttCount : 0;
+		target += stats.targetRate;
+		achieved += stats.acknowledged / stats.seconds;
+		bound += stats.topics / (stats.topics / stats.targetRate + rtt);
+		rttSum += stats.rttSum;
+		rttCount += stats.rttCount;
+		retransmitted += stats.retransmitted;
+		interests += stats.interests;
+		acknowledged += stats.acknowledged;
+	}
+
+	if (target <= 0) {
+		return;
+	}
+
+	NS_LOG_UNCOND(stringf("publish rate: target %.2f/s, achieved %.2f/s(%.1f%%), ack-clocked bound %.2f/s, RTT %.2fms, retransmitted %llu",
+			target, achieved, achieved * 100 / target, bound, (0 < rttCount) ? rttSum * 1000 / rttCount : 0.0,
+			(unsigned long long)retransmitted));
+	if (0 < acknowledged) {
+		NS_LOG_UNCOND(stringf("DP Interests per item: %.3f(%llu/%llu)", (double)interests / acknowledged, (unsigned long long)interests,
+				(unsigned long long)acknowledged));
+	}
+}
+
+/**
+ * segment로 받은 object의 크기, 받는 시간과 throughput(consumer 전체)
+ */
+void
+reportFetch(std::vector<Ptr<ConsumerDrn>> apps) {
+	uint64_t objects = 0, bytes = 0, segments = 0;
+	double seconds = 0;
+
+	std::vector<Ptr<ConsumerDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		const FetchStats &stats = (*iter)->GetFetchStats();
+		objects += stats.objects;
+		bytes += stats.bytes;
+		segments += stats.segments;
+		seconds += stats.seconds;
+	}
+
+	if (objects == 0) {
+		return;
+	}
+
+	NS_LOG_UNCOND(stringf("object fetch: %llu objects, %.1f KB/object, %.1f segments/object, %.3f s/object, throughput %.3f Mbps",
+			(unsigned long long)objects, bytes / 1024.0 / objects, (double)segments / objects, seconds / objects,
+			(0 < seconds) ? bytes * 8 / seconds / 1e6 : 0.0));
+}
+
+/**
+ * TM 응답의 크기(RN)와 consumer 의 parse 시간
+ */
+void
+reportManifest(std::vector<Ptr<RendezvousDrnF>> rendezvousApps, std::vector<Ptr<ConsumerDrn>> consumerApps) {
+	uint64_t answers = 0, pages = 0, entries = 0, bytes = 0;
+	std::vector<Ptr<RendezvousDrnF>>::iterator rnIter = rendezvousApps.begin();
+	for (; rnIter != rendezvousApps.end(); rnIter++) {
+		const ManifestStats &stats = (*rnIter)->GetManifestStats();
+		answers += stats.answers;
+		pages += stats.pages;
+		entries += stats.entries;
+		bytes += stats.bytes;
+	}
+
+	uint64_t parsed = 0;
+	double seconds = 0;
+	std::vector<Ptr<ConsumerDrn>>::iterator consumerIter = consumerApps.begin();
+	for (; consumerIter != consumerApps.end(); consumerIter++) {
+		const ManifestParseStats &stats = (*consumerIter)->GetManifestParseStats();
+		parsed += stats.entries;
+		seconds += stats.seconds;
+	}
+
+	if (entries == 0) {
+		return;
+	}
+
+	NS_LOG_UNCOND(stringf("TM manifest(%s): %llu answers(%llu paged), %.2f bytes/entry, parse %.0f entries/s",
+			g_bBinaryManifest ? "tlv" : "text", (unsigned long long)answers, (unsigned long long)pages, (double)bytes / entries,
+			(0 < seconds) ? parsed / seconds : 0.0));
+}
+
+/**
+ * 응답 없는 Interest(negative reply, timeout)의 부하와 topic의 첫 item 까지 걸린 시간(consumer 전체)
+ */
+void
+reportRetry(std::vector<Ptr<ConsumerDrn>> apps) {
+	uint64_t negatives = 0, timeouts = 0, firstDeliveries = 0;
+	double firstDeliverySeconds = 0, idleRate = 0;
+	uint32_t consumers = 0;
+
+	std::vector<Ptr<ConsumerDrn>>::iterator iter = apps.begin();
+	for (; iter != apps.end(); iter++) {
+		const RetryStats &stats = (*iter)->GetRetryStats();
+		negatives += stats.negatives;
+		timeouts += stats.timeouts;
+		firstDeliveries += stats.firstDeliveries;
+		firstDeliverySeconds += stats.firstDeliverySeconds;
+		if (0 < stats.seconds) {
+			idleRate += (stats.negatives + stats.timeouts) / stats.seconds;
+			consumers += 1;
+		}
+	}
+
+	if (consumers == 0) {
+		return;
+	}
+
+	NS_LOG_UNCOND(stringf("idle Interests: %llu negative replies, %llu timeouts, %.3f/s per consumer",
+			(unsigned long long)negatives, (unsigned long long)timeouts, idleRate / consumers));
+	if (0 < firstDeliveries) {
+		NS_LOG_UNCOND(stringf("first delivery: %llu topics, %.3f s/topic after the consumer start", (unsigned long long)firstDeliveries,
+				firstDeliverySeconds / firstDeliveries));
+	}
+}
+
+/**
+ * rank 수 만큼 나눈 topology 를 router 의 system id 열과 함께 임시 파일에 쓰고 그 경로를 돌려준다.
+ * 분할은 파일만으로 정해지므로 모든 rank 가 통신없이 같은 분할을 얻는다.
+ */
+std::string
+partitionTopology(const std::string &topology, uint32_t systemCount, uint32_t systemId) {
+	TopologyPartition partition;
+	if (partition.read(topology) != 0) {
+		return "";
+	}
+	partition.partition(systemCount);
+
+	char path[] = "/tmp/drnf-topology-XXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		return "";
+	}
+	close(fd);
+
+	if (partition.write(path) != 0) {
+		unlink(path);
+		return "";
+	}
+
+	if (systemId == 0) {
+		NS_LOG_UNCOND(stringf("partition: %u ranks, %u nodes, %u cut links, lookahead %lluus, imbalance %.3f",
+				systemCount, partition.getNodeCount(), partition.getCutCount(),
+				(unsigned long long)partition.getLookahead(), partition.getImbalance()));
+	}
+
+	return path;
+}
+
 int 
 parse_arguments(int argc, char *argv[]) {
 	// Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
@@ -363,10 +666,60 @@ parse_arguments(int argc, char *argv[]) {
 	cmd.AddValue ("p_random", "Type of send time randomization: none (default), uniform, exponential", g_zPRandomize);
 	cmd.AddValue ("c_random", "Type of send time randomization: none (default), uniform, exponential", g_zCRandomize);
 	cmd.AddValue ("p_freq", "Frequency of topic generation / interest packets", g_fPFrequency);
+	cmd.AddValue ("p_window", "DP Interests in flight per topic, generation runs on its own clock(0: next item after the DP Data)", g_nPWindow);
+	cmd.AddValue ("coalesce_count", "Items per DP Interest with --p_window(1: a DP per item)", g_nCoalesceCount);
+	cmd.AddValue ("coalesce_delay", "Longest wait(microseconds) of a partial DP batch", g_nCoalesceDelay);
+	cmd.AddValue ("segment_size", "Bytes per DP/DR segment of an item larger than --size(0: one packet per item)", g_nSegmentSize);
+	cmd.AddValue ("segment_window", "Segments in flight per object with --segment_size", g_nSegmentWindow);
+	cmd.AddValue ("binary_manifest", "TM answers as a front coded TLV manifest with continuation paging", g_bBinaryManifest);
+	cmd.AddValue ("manifest_page", "Bytes per TM manifest page with --binary_manifest", g_nManifestPage);
 	cmd.AddValue ("c_freq", "Frequency of topic generation / interest packets", g_fCFrequency);
 	cmd.AddValue ("c_start", "consumer's start time", g_nCStart);
 	cmd.AddValue ("p_start", "producer's start time", g_nPStart);
 	cmd.AddValue ("r_start", "rendezvous's start time", g_nRStart);
+	cmd.AddValue ("churn_join", "Rate(per second) of rendezvous joins", g_fChurnJoin);
+	cmd.AddValue ("churn_leave", "Rate(per second) of rendezvous graceful leaves", g_fChurnLeave);
+	cmd.AddValue ("churn_fail", "Rate(per second) of rendezvous crash failures", g_fChurnFail);
+	cmd.AddValue ("churn_radius", "Hops around a crashed rendezvous that fail together", g_nChurnRadius);
+	cmd.AddValue ("churn_repair", "Mean repair time(seconds) of crashed rendezvous, 0: never", g_fChurnRepair);
+	cmd.AddValue ("churn_start", "churn's start time", g_nChurnStart);
+	cmd.AddValue ("churn_trace", "churn trace file(<seconds> <join|leave|fail|recover> <node name>)", g_churnTrace);
+	cmd.AddValue ("placement", "rendezvous placement: random (default), centrality, kmedian", g_placement);
+	cmd.AddValue ("regional", "two level rendezvous(regional RN aggregates DM/DR and caches TM/DM/DR)", g_regional);
+	cmd.AddValue ("regional_cache", "lifetime(seconds) of the regional TM/DM answers", g_fRegionalCache);
+	cmd.AddValue ("manifest_slot", "Time slot(seconds) of the consumer TS/TM names, shared by the consumers of a slot(0: no slot)", g_fManifestSlot);
+	cmd.AddValue ("ts_freshness", "FreshnessPeriod(seconds) of the TS answers(0: not set)", g_fTSFreshness);
+	cmd.AddValue ("tm_freshness", "FreshnessPeriod(seconds) of the TM answers(0: not set)", g_fTMFreshness);
+	cmd.AddValue ("dm_freshness", "FreshnessPeriod(seconds) of the DM answers(0: not set)", g_fDMFreshness);
+	cmd.AddValue ("dr_freshness", "FreshnessPeriod(seconds) of the DR answers(0: not set)", g_fDRFreshness);
+	cmd.AddValue ("cs_size", "Content store entries per node", g_nCsSize);
+	cmd.AddValue ("negative_reply", "Answer a TM/DM without a match by a negative reply instead of keeping it pending", g_bNegativeReply);
+	cmd.AddValue ("retry_after", "Retry-after hint(seconds) of the negative replies", g_fRetryAfter);
+	cmd.AddValue ("max_backoff", "Longest wait(seconds) of a consumer before a TM retry", g_fMaxBackoff);
+	cmd.AddValue ("max_backoff_dm", "Longest wait(seconds) of a consumer before a DM retry", g_fMaxBackoffDM);
+	cmd.AddValue ("advertise_batch", "Topics per PA/PU Interest of the producers(1: one topic per Interest)", g_nAdvertiseBatch);
+	cmd.AddValue ("advertise_rate", "PA Interests per second of a producer at startup(0: all at once)", g_fAdvertiseRate);
+	cmd.AddValue ("replicas", "Number of owner RNs of a hot topic(1: no replication)", g_nReplicas);
+	cmd.AddValue ("hot_threshold", "TS/TM requests per 10 seconds that make a topic hot", g_nHotThreshold);
+	cmd.AddValue ("workload", "Number of generated topics, replaces the producer/consumer topics of the config file(0: config file)", g_nWorkloadTopics);
+	cmd.AddValue ("w_producers", "Number of random producer nodes of the generated workload", g_nWorkloadProducers);
+	cmd.AddValue ("w_consumers", "Number of random consumer nodes of the generated workload", g_nWorkloadConsumers);
+	cmd.AddValue ("w_subs", "Subscriptions per consumer of the generated workload", g_nWorkloadSubs);
+	cmd.AddValue ("w_zipf", "Zipf exponent of the topic popularity(0: uniform)", g_fWorkloadZipf);
+	cmd.AddValue ("w_wildcard", "Fraction of the subscriptions that are wildcard prefixes", g_fWorkloadWildcard);
+	cmd.AddValue ("w_publish", "Publications of a topic: periodic, poisson (default), bursty", g_zWorkloadPublish);
+	cmd.AddValue ("w_rate", "Mean publications per second of a topic", g_fWorkloadRate);
+	cmd.AddValue ("seed", "Seed of the workload and of the node selection(0: random)", g_nSeed);
+	cmd.AddValue ("route_cache", "Directory of the cached routes of the topology and the RN origins(empty: no cache)", g_routeCache);
+	cmd.AddValue ("route_threads", "Threads of the parallel route calculation(0: serial CalculateRoutes)", g_nRouteThreads);
+	cmd.AddValue ("route_check", "Compare the parallel routes with CalculateRoutes per node and prefix(no route cache)", g_bRouteCheck);
+	cmd.AddValue ("trace", "Binary event trace file, decoded by trace-decode.py(empty: no trace)", g_trace);
+	cmd.AddValue ("trace_records", "Records of the trace ring buffer, the oldest are overwritten", g_nTraceRecords);
+	cmd.AddValue ("memory", "Time series file of the entries and bytes of the app state tables(empty: none)", g_memory);
+	cmd.AddValue ("memory_interval", "Seconds between the memory samples", g_fMemoryInterval);
+	cmd.AddValue ("profile", "Collapsed stack file of the handler profiler, prints the ranked handler table(empty: no profiling)", g_profile);
+	cmd.AddValue ("stats", "Json file of wall time, events/s, peak RSS and per-app memory, read by perf-harness.py(empty: none)", g_stats);
+	cmd.AddValue ("mpi", "Distributed simulation, the topology is partitioned over the MPI ranks", g_mpi);
 	cmd.AddValue ("infoonly", "only print of topology node info.", g_infoonly);
 	cmd.Parse(argc, argv);
 
@@ -387,16 +740,79 @@ parse_arguments(int argc, char *argv[]) {
 	NS_LOG_UNCOND("--p_random      : " << g_zPRandomize);
 	NS_LOG_UNCOND("--c_random      : " << g_zCRandomize);
 	NS_LOG_UNCOND("--p_freq        : " << g_fPFrequency);
+	NS_LOG_UNCOND("--p_window      : " << g_nPWindow);
+	NS_LOG_UNCOND("--coalesce_count: " << g_nCoalesceCount);
+	NS_LOG_UNCOND("--coalesce_delay: " << g_nCoalesceDelay);
+	NS_LOG_UNCOND("--segment_size  : " << g_nSegmentSize);
+	NS_LOG_UNCOND("--segment_window: " << g_nSegmentWindow);
+	NS_LOG_UNCOND("--binary_manifest: " << g_bBinaryManifest);
+	NS_LOG_UNCOND("--manifest_page : " << g_nManifestPage);
 	NS_LOG_UNCOND("--c_freq        : " << g_fCFrequency);
 	NS_LOG_UNCOND("--c_start       : " << g_nPStart);
 	NS_LOG_UNCOND("--p_start       : " << g_nCStart);
 	NS_LOG_UNCOND("--r_start       : " << g_nRStart);
+	NS_LOG_UNCOND("--churn_join    : " << g_fChurnJoin);
+	NS_LOG_UNCOND("--churn_leave   : " << g_fChurnLeave);
+	NS_LOG_UNCOND("--churn_fail    : " << g_fChurnFail);
+	NS_LOG_UNCOND("--churn_radius  : " << g_nChurnRadius);
+	NS_LOG_UNCOND("--churn_repair  : " << g_fChurnRepair);
+	NS_LOG_UNCOND("--churn_start   : " << g_nChurnStart);
+	NS_LOG_UNCOND("--churn_trace   : " << g_churnTrace);
+	NS_LOG_UNCOND("--placement     : " << g_placement);
+	NS_LOG_UNCOND("--regional      : " << g_regional);
+	NS_LOG_UNCOND("--regional_cache: " << g_fRegionalCache);
+	NS_LOG_UNCOND("--manifest_slot : " << g_fManifestSlot);
+	NS_LOG_UNCOND("--ts_freshness  : " << g_fTSFreshness);
+	NS_LOG_UNCOND("--tm_freshness  : " << g_fTMFreshness);
+	NS_LOG_UNCOND("--dm_freshness  : " << g_fDMFreshness);
+	NS_LOG_UNCOND("--dr_freshness  : " << g_fDRFreshness);
+	NS_LOG_UNCOND("--cs_size       : " << g_nCsSize);
+	NS_LOG_UNCOND("--negative_reply: " << g_bNegativeReply);
+	NS_LOG_UNCOND("--retry_after   : " << g_fRetryAfter);
+	NS_LOG_UNCOND("--max_backoff   : " << g_fMaxBackoff);
+	NS_LOG_UNCOND("--max_backoff_dm: " << g_fMaxBackoffDM);
+	NS_LOG_UNCOND("--advertise_batch: " << g_nAdvertiseBatch);
+	NS_LOG_UNCOND("--advertise_rate: " << g_fAdvertiseRate);
+	NS_LOG_UNCOND("--replicas      : " << g_nReplicas);
+	NS_LOG_UNCOND("--hot_threshold : " << g_nHotThreshold);
+	NS_LOG_UNCOND("--workload      : " << g_nWorkloadTopics);
+	NS_LOG_UNCOND("--w_producers   : " << g_nWorkloadProducers);
+	NS_LOG_UNCOND("--w_consumers   : " << g_nWorkloadConsumers);
+	NS_LOG_UNCOND("--w_subs        : " << g_nWorkloadSubs);
+	NS_LOG_UNCOND("--w_zipf        : " << g_fWorkloadZipf);
+	NS_LOG_UNCOND("--w_wildcard    : " << g_fWorkloadWildcard);
+	NS_LOG_UNCOND("--w_publish     : " << g_zWorkloadPublish);
+	NS_LOG_UNCOND("--w_rate        : " << g_fWorkloadRate);
+	NS_LOG_UNCOND("--seed          : " << g_nSeed);
+	NS_LOG_UNCOND("--route_cache   : " << g_routeCache);
+	NS_LOG_UNCOND("--route_threads : " << g_nRouteThreads);
+	NS_LOG_UNCOND("--route_check   : " << g_bRouteCheck);
+	NS_LOG_UNCOND("--trace         : " << g_trace);
+	NS_LOG_UNCOND("--trace_records : " << g_nTraceRecords);
+	NS_LOG_UNCOND("--memory        : " << g_memory);
+	NS_LOG_UNCOND("--memory_interval: " << g_fMemoryInterval);
+	NS_LOG_UNCOND("--profile       : " << g_profile);
+	NS_LOG_UNCOND("--stats         : " << g_stats);
+	NS_LOG_UNCOND("--mpi           : " << g_mpi);
 	NS_LOG_UNCOND("--infoonly      : " << g_infoonly);
 
+	if (g_placement != "random" && g_placement != "centrality" && g_placement != "kmedian") {
+		NS_LOG_UNCOND("unknown --placement: " << g_placement << " (random, centrality, kmedian)");
+		return -1;
+	}
+
 	if (ReadConfig(g_configure) == -1) {
 		return -1;
 	}
 
+	// 생성된 workload 는 config 파일의 producer/consumer 대신 임의의 leaf 노드를 사용한다
+	if (0 < g_nWorkloadTopics) {
+		g_producerIndexes = stringf("-#%u", g_nWorkloadProducers);
+		g_consumerIndexes = stringf("-#%u", g_nWorkloadConsumers);
+		g_producerConfig.clear();
+		g_consumerConfig.clear();
+	}
+
 	if (0 < g_rendezvousIndexes.size()) {
 		g_rendezvousCount = parse_indexes(g_rendezvousIds, g_rendezvousIndexes);
 		if(g_producerCount < 0) {
@@ -430,6 +846,8 @@ int
 main(int argc, char* argv[])
 {
 	int retval;
+	std::chrono::steady_clock::time_point startup = std::chrono::steady_clock::now();
+	SimStats stats;
 
 	// setting default parameters for PointToPoint links and channels
     //Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
@@ -441,6 +859,35 @@ main(int argc, char* argv[])
 		return retval;
 	}
 
+	// MPI rank 는 system id 가 같은 노드의 application 만 설치한다
+	uint32_t systemId = 0;
+	uint32_t systemCount = 1;
+	if (g_mpi) {
+#ifdef DRN_MPI
+		MpiInterface::Enable(&argc, &argv);
+		systemId = MpiInterface::GetSystemId();
+		systemCount = MpiInterface::GetSize();
+
+		// 모든 rank 가 같은 rendezvous/producer/consumer 노드를 골라야 한다
+		if (g_nSeed == 0) {
+			g_nSeed = 1;
+		}
+#else
+		NS_LOG_UNCOND("--mpi: ns-3 is built without the mpi module");
+		return 1;
+#endif
+	}
+
+	stats.setParameter("scenario", "drnf-rocketfuel");
+	stats.setParameter("topology", g_topology);
+	stats.setParameter("sm", g_numberOfSubscribeMessages);
+	stats.setParameter("ds", g_numberOfDataStream);
+	stats.setParameter("duration", g_simulationTime);
+	stats.setParameter("workload", g_nWorkloadTopics);
+	stats.setParameter("regional", g_regional);
+	stats.setParameter("ranks", systemCount);
+	stats.setParameter("rank", systemId);
+
     // Print Simulation Topology, Command Line Variables
     NS_LOG_UNCOND("simulation topology : " << g_topology);
 
@@ -452,15 +899,36 @@ main(int argc, char* argv[])
     }
 
     // Read topologies and set parameters
+	std::string topology = g_topology;
+	if (1 < systemCount) {
+		topology = partitionTopology(g_topology, systemCount, systemId);
+		if (topology.size() == 0) {
+			NS_LOG_UNCOND("cannot partition " << g_topology);
+			Simulator::Destroy();
+			return 1;
+		}
+	}
+
 	AnnotatedTopologyReader topologyReader("", 25);
-	topologyReader.SetFileName(g_topology);
+	topologyReader.SetFileName(topology);
 	NodeContainer nodeContainer = topologyReader.Read();
+	if (topology != g_topology) {
+		unlink(topology.c_str());
+	}
+
+	// link delay 기반 underlay 거리
+	Ptr<TopologyProximity> proximity = CreateObject<TopologyProximity>();
+	proximity->Build(nodeContainer);
 
 	// Install NDN stack on all nodes
 	ndn::StackHelper ndnHelper;
 	ndnHelper.SetDefaultRoutes(true);
+	ndnHelper.setCsSize(g_nCsSize);
 	ndnHelper.InstallAll();
 
+	Ptr<CsCounter> csCounter = CreateObject<CsCounter>();
+	csCounter->Install();
+
 	std::string rnPrefix = "/RN";
 	std::string drnPrefix = "/RN-%05d";
 	std::string userPrefix = "topic";
@@ -495,7 +963,15 @@ main(int argc, char* argv[])
 	NodeContainer rendezvousContainer;
 	std::map<uint32_t, int> selectedRendezvous;
 	selectNodes(rendezvousNodes, bbNode, g_rendezvousIds, selectedRendezvous);
-	addToContainer(rendezvousContainer, rendezvousNodes, g_rendezvousCount);
+	if (0 < g_rendezvousCount && g_placement.compare("centrality") == 0) {
+		std::vector<Ptr<Node>> placed = proximity->SelectByCentrality(rendezvousNodes, leafNode, g_rendezvousCount);
+		addToContainer(rendezvousContainer, placed, 0);
+	} else if (0 < g_rendezvousCount && g_placement.compare("kmedian") == 0) {
+		std::vector<Ptr<Node>> placed = proximity->SelectByKMedian(rendezvousNodes, leafNode, g_rendezvousCount);
+		addToContainer(rendezvousContainer, placed, 0);
+	} else {
+		addToContainer(rendezvousContainer, rendezvousNodes, g_rendezvousCount);
+	}
 
 	for (int index = 0; index < (int)rendezvousContainer.size(); index++) {
 		Ptr<Node> node = rendezvousContainer[index];
@@ -547,6 +1023,18 @@ main(int argc, char* argv[])
 	//consumerHelper.Install(nodes.Get(0)).Start(Seconds(10.0));
 	rendezvousHelper.SetAttribute("LifeTime", TimeValue(Seconds(g_nInterestLifetime)));
 	rendezvousHelper.SetAttribute("DataSize", UintegerValue(g_packetSize));
+	rendezvousHelper.SetAttribute("Regional", BooleanValue(g_regional));
+	rendezvousHelper.SetAttribute("CacheLifetime", TimeValue(Seconds(g_fRegionalCache)));
+	rendezvousHelper.SetAttribute("Replicas", UintegerValue(g_nReplicas));
+	rendezvousHelper.SetAttribute("HotThreshold", UintegerValue(g_nHotThreshold));
+	rendezvousHelper.SetAttribute("TSFreshness", TimeValue(Seconds(g_fTSFreshness)));
+	rendezvousHelper.SetAttribute("TMFreshness", TimeValue(Seconds(g_fTMFreshness)));
+	rendezvousHelper.SetAttribute("DMFreshness", TimeValue(Seconds(g_fDMFreshness)));
+	rendezvousHelper.SetAttribute("DRFreshness", TimeValue(Seconds(g_fDRFreshness)));
+	rendezvousHelper.SetAttribute("BinaryManifest", BooleanValue(g_bBinaryManifest));
+	rendezvousHelper.SetAttribute("ManifestPage", UintegerValue(g_nManifestPage));
+	rendezvousHelper.SetAttribute("NegativeReply", BooleanValue(g_bNegativeReply));
+	rendezvousHelper.SetAttribute("RetryAfter", TimeValue(Seconds(g_fRetryAfter)));
 
 	// 목록 데이터를 App에 전달하기 위한 container
 	ns3::Ptr<ObjectContainer> objectContainer = ns3::Create<ObjectContainer>();
@@ -557,6 +1045,21 @@ main(int argc, char* argv[])
 	// 전체 Rendezvous 노드에 container를 지정한다.
 	rendezvousHelper.SetAttribute("CustomAttributes", ns3::PointerValue(objectContainer));
 
+	// Rendezvous churn
+	Ptr<ChurnGenerator> churnGenerator = CreateObject<ChurnGenerator>();
+	churnGenerator->SetAttribute("JoinRate", DoubleValue(g_fChurnJoin));
+	churnGenerator->SetAttribute("LeaveRate", DoubleValue(g_fChurnLeave));
+	churnGenerator->SetAttribute("FailureRate", DoubleValue(g_fChurnFail));
+	churnGenerator->SetAttribute("FailureRadius", UintegerValue(g_nChurnRadius));
+	churnGenerator->SetAttribute("RepairTime", TimeValue(Seconds(g_fChurnRepair)));
+	churnGenerator->SetAttribute("StartTime", TimeValue(Seconds(g_nChurnStart)));
+	churnGenerator->SetAttribute("StopTime", TimeValue(Seconds(g_simulationTime-10.0)));
+	churnGenerator->SetAttribute("TraceFile", StringValue(g_churnTrace));
+	churnGenerator->AssignStreams(1000);
+
+	std::vector<Ptr<RendezvousDrnF>> rendezvousApps;
+
+	stats.beginApps();
 	NodeContainer::Iterator rendezvousIter = rendezvousContainer.Begin();
 	for (; rendezvousIter != rendezvousContainer.End(); rendezvousIter++) {
 		uint32_t nodeId = (*rendezvousIter)->GetId();
@@ -564,6 +1067,12 @@ main(int argc, char* argv[])
 
 		dhtNodes->push_back(drnNodePrefix);
 
+		// 다른 rank 의 RN 은 DHT 목록과 churn 상태에만 들어간다
+		if ((*rendezvousIter)->GetSystemId() != systemId) {
+			churnGenerator->AddTarget(*rendezvousIter, MakeNullCallback<void>(), MakeNullCallback<void>(), Seconds(g_nRStart));
+			continue;
+		}
+
 		rendezvousHelper.SetAttribute("RnPrefix", StringValue(rnPrefix));
 		rendezvousHelper.SetAttribute("DRnPrefix", StringValue(drnNodePrefix));
 
@@ -574,8 +1083,31 @@ main(int argc, char* argv[])
 		container.Start(Seconds(g_nRStart));
 		container.Stop(Seconds(g_simulationTime-1.0));
 
+		Ptr<RendezvousDrnF> app = DynamicCast<RendezvousDrnF>(container.Get(0));
+		rendezvousApps.push_back(app);
+		churnGenerator->AddTarget(*rendezvousIter,
+				MakeCallback(&RendezvousDrnF::StartApplication, app), MakeCallback(&RendezvousDrnF::StopApplication, app),
+				Seconds(g_nRStart));
+
         //ndnGlobalRoutingHelper.AddOrigins(drnNodePrefix, rendezvousContainer);
 	}
+	stats.endApps("rendezvous", rendezvousApps.size());
+
+	// pub-sub workload
+	Ptr<WorkloadGenerator> workload;
+	if (0 < g_nWorkloadTopics) {
+		workload = CreateObject<WorkloadGenerator>();
+		workload->SetAttribute("Topics", UintegerValue(g_nWorkloadTopics));
+		workload->SetAttribute("Subscriptions", UintegerValue(g_nWorkloadSubs));
+		workload->SetAttribute("ZipfExponent", DoubleValue(g_fWorkloadZipf));
+		workload->SetAttribute("WildcardRatio", DoubleValue(g_fWorkloadWildcard));
+		workload->SetAttribute("PublishProcess", StringValue(g_zWorkloadPublish));
+		workload->SetAttribute("PublishRate", DoubleValue(g_fWorkloadRate));
+		if (0 < g_nSeed) {
+			workload->SetAttribute("Seed", UintegerValue(g_nSeed));
+		}
+		workload->Generate(producerContainer.size(), consumerContainer.size());
+	}
 
 	// Producer
 	ndn::AppHelper producerHelper("ProducerDrn");
@@ -585,20 +1117,41 @@ main(int argc, char* argv[])
 	producerHelper.SetAttribute("Frequency", DoubleValue(g_fPFrequency));
 	producerHelper.SetAttribute("LifeTime", TimeValue(Seconds(g_nInterestLifetime)));
 	producerHelper.SetAttribute("DataSize", UintegerValue(g_packetSize));
+	producerHelper.SetAttribute("AdvertiseBatch", UintegerValue(g_nAdvertiseBatch));
+	producerHelper.SetAttribute("AdvertiseRate", DoubleValue(g_fAdvertiseRate));
+	producerHelper.SetAttribute("PublishWindow", UintegerValue(g_nPWindow));
+	producerHelper.SetAttribute("CoalesceCount", UintegerValue(g_nCoalesceCount));
+	producerHelper.SetAttribute("CoalesceDelay", TimeValue(MicroSeconds(g_nCoalesceDelay)));
+	producerHelper.SetAttribute("SegmentSize", UintegerValue(g_nSegmentSize));
+	producerHelper.SetAttribute("SegmentWindow", UintegerValue(std::max(g_nSegmentWindow, (uint32_t)1)));
 
 	//producerHelper.Install(nodes.Get(2)).Start(Seconds(2.0)); // last node
 
 	//producerApp.Install(producerContainer).Start(Seconds(5));
+	uint32_t producerCount = 0;
+	std::vector<Ptr<ProducerDrn>> producerApps;
+	stats.beginApps();
 	NodeContainer::Iterator producerIter = producerContainer.Begin();
 	for (; producerIter != producerContainer.End(); producerIter++) {
 		uint32_t nodeId = (*producerIter)->GetId();
 		string nodePrefix = stringf("NODE-%05d", nodeId);
+		if ((*producerIter)->GetSystemId() != systemId) {
+			continue;
+		}
 		producerHelper.SetAttribute("NodePrefix", StringValue(nodePrefix));
 
 		std::map<uint32_t, int>::iterator id2idxIter;
 		// 노드 ID로 입력된 Index를 찾고
 		id2idxIter = selectedProducer.find(nodeId);
-		if (id2idxIter != selectedProducer.end()) {
+		if (workload != 0) {
+			uint32_t workloadIndex = producerIter - producerContainer.Begin();
+
+			ns3::Ptr<ObjectContainer> workloadContainer = ns3::Create<ObjectContainer>();
+			workloadContainer->set("Workload", workload);
+			workloadContainer->set("WorkloadIndex", workloadIndex);
+
+			producerHelper.SetAttribute("CustomAttributes", ns3::PointerValue(workloadContainer));
+		} else if (id2idxIter != selectedProducer.end()) {
 			std::map<string, std::vector<string>>::iterator cfgIter;
 
 			// producer 별 publish topic을 찾는다.
@@ -616,7 +1169,10 @@ main(int argc, char* argv[])
 		ApplicationContainer container = producerHelper.Install(*producerIter);
 		container.Start(Seconds(g_nPStart));
 		container.Stop(Seconds(g_simulationTime-2.0));
+		producerApps.push_back(DynamicCast<ProducerDrn>(container.Get(0)));
+		producerCount += 1;
 	}
+	stats.endApps("producer", producerCount);
 
 	// Consumer
 	ndn::AppHelper consumerHelper("ConsumerDrn");
@@ -626,17 +1182,37 @@ main(int argc, char* argv[])
 	consumerHelper.SetAttribute("Randomize", StringValue(g_zCRandomize));
 	consumerHelper.SetAttribute("Frequency", DoubleValue(g_fCFrequency));
 	consumerHelper.SetAttribute("LifeTime", TimeValue(Seconds(g_nInterestLifetime)));
+	consumerHelper.SetAttribute("Regional", BooleanValue(g_regional));
+	consumerHelper.SetAttribute("ManifestSlot", TimeValue(Seconds(g_fManifestSlot)));
+	consumerHelper.SetAttribute("BinaryManifest", BooleanValue(g_bBinaryManifest));
+	consumerHelper.SetAttribute("SegmentWindow", UintegerValue((0 < g_nSegmentSize) ? g_nSegmentWindow : 0));
+	consumerHelper.SetAttribute("MaxBackoff", TimeValue(Seconds(g_fMaxBackoff)));
+	consumerHelper.SetAttribute("MaxBackoffDM", TimeValue(Seconds(g_fMaxBackoffDM)));
 	//consumerHelper.Install(nodes.Get(0)).Start(Seconds(10.0));
 
 	//consumerApp.Install(consumerContainer).Start(Seconds(8));
+	uint32_t consumerCount = 0;
+	std::vector<Ptr<ConsumerDrn>> consumerApps;
+	stats.beginApps();
 	NodeContainer::Iterator consumerIter = consumerContainer.Begin();
 	for (; consumerIter != consumerContainer.End(); consumerIter++) {
 		uint32_t nodeId = (*consumerIter)->GetId();
+		if ((*consumerIter)->GetSystemId() != systemId) {
+			continue;
+		}
 
 		std::map<uint32_t, int>::iterator id2idxIter;
 		// 노드 ID로 입력된 Index를 찾고
 		id2idxIter = selectedConsumer.find(nodeId);
-		if (id2idxIter != selectedConsumer.end()) {
+		if (workload != 0) {
+			uint32_t workloadIndex = consumerIter - consumerContainer.Begin();
+
+			ns3::Ptr<ObjectContainer> workloadContainer = ns3::Create<ObjectContainer>();
+			workloadContainer->set("Workload", workload);
+			workloadContainer->set("WorkloadIndex", workloadIndex);
+
+			consumerHelper.SetAttribute("CustomAttributes", ns3::PointerValue(workloadContainer));
+		} else if (id2idxIter != selectedConsumer.end()) {
 			std::map<string, std::vector<string>>::iterator cfgIter;
 
 			// consumer 별 subscribe topic을 찾는다.
@@ -655,7 +1231,10 @@ main(int argc, char* argv[])
 
 		container.Start(Seconds(g_nCStart));
 		container.Stop(Seconds(g_simulationTime-2.0));
+		consumerApps.push_back(DynamicCast<ConsumerDrn>(container.Get(0)));
+		consumerCount += 1;
 	}
+	stats.endApps("consumer", consumerCount);
 
 	rendezvousIter = rendezvousContainer.Begin();
 	for (; rendezvousIter != rendezvousContainer.End(); rendezvousIter++) {
@@ -668,13 +1247,115 @@ main(int argc, char* argv[])
 	// Add /RN origins to ndn::GlobalRouter
 	ndnGlobalRoutingHelper.AddOrigins(rnPrefix, rendezvousContainer);
 
-	// Calculate and install FIBs
-	ndn::GlobalRoutingHelper::CalculateRoutes();
+	// Calculate and install FIBs, or install the ones cached by a previous run
+	Ptr<RouteCalculator> routeCalculator = CreateObject<RouteCalculator>();
+	routeCalculator->SetAttribute("Threads", UintegerValue(g_nRouteThreads));
+	routeCalculator->SetAttribute("Check", BooleanValue(g_bRouteCheck));
+	bool parallelRoutes = 0 < g_nRouteThreads || g_bRouteCheck;
+	Callback<void> calculateRoutes = parallelRoutes
+			? MakeCallback(&RouteCalculator::CalculateRoutes, routeCalculator) : MakeCallback(&ndn::GlobalRoutingHelper::CalculateRoutes);
+
+	// the check needs both calculations, a cache hit would skip them
+	Ptr<RouteCache> routeCache = CreateObject<RouteCache>();
+	routeCache->SetAttribute("Directory", StringValue(g_bRouteCheck ? "" : g_routeCache));
+	routeCache->SetAttribute("Calculator", StringValue(parallelRoutes ? "graph" : "global"));
+	routeCache->Install(g_topology, calculateRoutes);
+
+	double startupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startup).count();
+	NS_LOG_UNCOND(stringf("startup: %.3fs, routes %.3fs(%s)", startupTime, routeCache->GetInstallTime(),
+			g_routeCache.size() == 0 ? "no cache" : (routeCache->IsHit() ? "warm cache" : "cold cache")));
 
 	Simulator::Stop(Seconds(g_simulationTime));
 
+	// rank 마다 따로 trace 파일을 쓴다
+	std::string tracePath = (1 < systemCount) ? stringf("%s.%u", g_trace.c_str(), systemId) : g_trace;
+	if (0 < g_trace.size() && EventTracer::Get().open(tracePath, g_nTraceRecords) != 0) {
+		NS_LOG_UNCOND("cannot open " << tracePath << ": " << strerror(errno));
+		Simulator::Destroy();
+		return 1;
+	}
+
+	if (churnGenerator->Install() != 0) {
+		Simulator::Destroy();
+		return -1;
+	}
+
+	Ptr<MemorySampler> memorySampler = CreateObject<MemorySampler>();
+	memorySampler->SetAttribute("File", StringValue((1 < systemCount) ? stringf("%s.%u", g_memory.c_str(), systemId) : g_memory));
+	memorySampler->SetAttribute("Interval", TimeValue(Seconds(g_fMemoryInterval)));
+	if (0 < g_memory.size() && memorySampler->Install() != 0) {
+		NS_LOG_UNCOND("cannot open " << g_memory << ": " << strerror(errno));
+		Simulator::Destroy();
+		return 1;
+	}
+
+	if (0 < g_profile.size()) {
+		ScopeProfiler::Get().enable();
+	}
+	stats.beginRun();
 	Simulator::Run();
+	stats.endRun();
+	ScopeProfiler::Get().disable();
+
+	churnGenerator->Report();
+	memorySampler->Report();
+	csCounter->Report();
+	routeCache->Report();
+	routeCalculator->Report();
+	if (workload != 0) {
+		workload->Report();
+	}
+	if (1 < systemCount) {
+		NS_LOG_UNCOND(stringf("rank %u/%u: %u rendezvous, simulation %.3fs", systemId, systemCount, (uint32_t)rendezvousApps.size(),
+				stats.getRunTime()));
+	}
+	reportLoad(rendezvousApps);
+	reportPublish(producerApps);
+	reportFetch(consumerApps);
+	reportManifest(rendezvousApps, consumerApps);
+	reportRetry(consumerApps);
+	uint64_t csHits = csCounter->getHitCount(CMD_TS) + csCounter->getHitCount(CMD_TM);
+	uint64_t csLookups = csHits + csCounter->getMissCount(CMD_TS) + csCounter->getMissCount(CMD_TM);
+	if (0 < csLookups) {
+		NS_LOG_UNCOND(stringf("CS TS/TM hit: %llu/%llu, ratio %.3f", (unsigned long long)csHits, (unsigned long long)csLookups,
+				(double)csHits / csLookups));
+	}
+	// PA 시작부터 모든 topic의 PA 응답까지
+	double advertiseMax = 0;
+	uint32_t advertised = 0;
+	for (uint32_t i = 0; i < producerApps.size(); i++) {
+		double advertiseTime = producerApps[i]->GetAdvertiseTime();
+		if (advertiseTime < 0) {
+			continue;
+		}
+		advertiseMax = std::max(advertiseMax, advertiseTime);
+		advertised += 1;
+	}
+	NS_LOG_UNCOND(stringf("advertise convergence: max %.3fs, producers converged %u/%u", advertiseMax, advertised,
+			(uint32_t)producerApps.size()));
+	stats.report();
+	std::string profilePath = (1 < systemCount) ? stringf("%s.%u", g_profile.c_str(), systemId) : g_profile;
+	if (0 < g_profile.size()) {
+		ScopeProfiler::Get().report();
+		if (ScopeProfiler::Get().writeCollapsed(profilePath) != 0) {
+			NS_LOG_UNCOND("cannot write " << profilePath << ": " << strerror(errno));
+		}
+	}
+	std::string statsPath = (1 < systemCount) ? stringf("%s.%u", g_stats.c_str(), systemId) : g_stats;
+	if (0 < g_stats.size() && stats.write(statsPath) != 0) {
+		NS_LOG_UNCOND("cannot write " << statsPath << ": " << strerror(errno));
+	}
+	if (EventTracer::Get().isOpen()) {
+		NS_LOG_UNCOND(stringf("trace: %s, %llu records", tracePath.c_str(), (unsigned long long)EventTracer::Get().getCount()));
+		// node 이름이 필요하므로 Destroy 전에 닫는다
+		EventTracer::Get().close();
+	}
 	Simulator::Destroy();
+#ifdef DRN_MPI
+	if (g_mpi) {
+		MpiInterface::Disable();
+	}
+#endif
 
 	return 0;
 }
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# decoder of the binary event trace(extensions/event-tracer.hpp) written by --trace=<file>
+#
+#   ./trace-decode.py results/drnf.trace            time, node, event, command, topic, seq, value as text
+#   ./trace-decode.py results/drnf.trace --csv      the same as csv
+
+from __future__ import print_function
+
+import argparse
+import csv
+import struct
+import sys
+
+HEADER = struct.Struct('<8sIIQQ32x')
+RECORD = struct.Struct('<qQIIBBHI')
+NO_ID = 0xffffffff
+NO_SEQ = 0xffffffffffffffff
+
+parser = argparse.ArgumentParser(description='DRN event trace decoder')
+parser.add_argument('trace', type=str, help='trace file')
+parser.add_argument('--names', type=str, default=None, help='names file(default: <trace>.names)')
+parser.add_argument('--csv', dest='csv', action='store_true', default=False, help='csv output')
+args = parser.parse_args()
+
+names = {'event': {}, 'command': {}, 'node': {}, 'topic': {}}
+try:
+    with open(args.names or args.trace + '.names') as f:
+        for line in f:
+            fields = line.rstrip('\n').split('\t', 2)
+            if len(fields) == 3 and fields[0] in names:
+                names[fields[0]][int(fields[1])] = fields[2]
+except IOError:
+    print('no names file, ids are printed', file=sys.stderr)
+
+def lookup(kind, id):
+    if kind == 'topic' and id == NO_ID:
+        return ''
+    return names[kind].get(id, str(id))
+
+with open(args.trace, 'rb') as f:
+    magic, version, recordSize, capacity, count = HEADER.unpack(f.read(HEADER.size))
+    if magic != b'DRNTRC01' or recordSize != RECORD.size:
+        print('%s: not a DRN trace' % args.trace, file=sys.stderr)
+        sys.exit(1)
+    ring = f.read(capacity * recordSize)
+
+# 가득 찬 ring buffer 는 가장 오래된 record 부터 읽는다
+first = count - capacity if capacity < count else 0
+if capacity < count:
+    print('%u of %u records were overwritten' % (count - capacity, count), file=sys.stderr)
+
+out = csv.writer(sys.stdout) if args.csv else None
+if out:
+    out.writerow(['time', 'node', 'event', 'command', 'topic', 'seq', 'value'])
+
+for n in range(first, count):
+    offset = (n % capacity) * recordSize
+    time, seq, node, topic, event, command, reserved, value = RECORD.unpack_from(ring, offset)
+    row = [
+        '%.9f' % (time / 1e9),
+        lookup('node', node),
+        lookup('event', event),
+        lookup('command', command),
+        lookup('topic', topic),
+        '' if seq == NO_SEQ else str(seq),
+        str(value),
+    ]
+    if out:
+        out.writerow(row)
+    else:
+        print(' '.join(field or '-' for field in row))